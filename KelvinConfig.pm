@@ -189,11 +189,16 @@ my %directives = (
 		  progresslevel=> {canon => 'ProgressLevel'},
 		  progressdelayseconds=> {canon => 'ProgressDelaySeconds'},
 		  polynomialscale=> {canon => 'PolynomialScale'},
+		  polynomialcachepath=> {canon => 'PolynomialCachePath',
+					 singlearg => 'true',
+					 parser => \&parseFilename},
 		  nonpolynomial=> {canon => 'NonPolynomial'},
 		  fixedmodels => {canon => 'FixedModels'},
 		  allowkosambimap => {canon => 'AllowKosambiMap'},
 		  dryrun => {canon => 'DryRun'},
 		  maxiterations => {canon => 'MaxIterations'},
+		  splitsperiteration => {canon => 'SplitsPerIteration'},
+		  warmstart => {canon => 'WarmStart'},
 		  log=> {canon => 'Log',
 			 regex => '\w+\s+\w+'},
 		  dropemptyclasses => {canon => 'DropEmptyClasses'},
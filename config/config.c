@@ -211,9 +211,12 @@ st_dispatch dispatchTable[] = { {"FrequencyFile", set_optionfile, &staticModelOp
 				{"ForceBRFile", set_flag, &staticModelOptions.forceAvghetFile},
 
 				{"PolynomialScale", set_int, &staticModelOptions.polynomialScale},
+				{"PolynomialCachePath", set_optionfile, &staticModelOptions.polynomialCachePath},
 				{"LiabilityClasses", set_int, &staticModelRange.nlclass},
 				{"DiseaseAlleles", set_int, &staticModelRange.nalleles},
 				{"MaxIterations", set_int, &staticModelOptions.maxIterations},
+				{"SplitsPerIteration", set_int, &staticModelOptions.splitsPerIteration},
+				{"WarmStart", set_int, &staticModelOptions.warmStart},
 
                                 {"QTMeanMode", set_qt_mean_mode, NULL},
                                 {"QTStandardDevMode", set_qt_standarddev_mode, NULL},
@@ -290,6 +293,8 @@ void initializeDefaults ()
   staticModelOptions.polynomial = TRUE;
   staticModelOptions.integration = TRUE;
   staticModelOptions.maxIterations = -1;
+  staticModelOptions.splitsPerIteration = 1;
+  staticModelOptions.warmStart = 0;
   staticModelOptions.imprintingFlag = FALSE;
   staticModelOptions.mapFlag = SA;
   staticModelOptions.sexLinked = FALSE;
@@ -442,6 +447,16 @@ void validateConfig ()
 
   if (staticModelOptions.polynomialScale && ! staticModelOptions.polynomial)
     fault ("PolynomialScale is incompatible with NonPolynomial\n");
+  if (staticModelOptions.polynomialCachePath[0] != '\0' && ! staticModelOptions.polynomial)
+    fault ("PolynomialCachePath is incompatible with NonPolynomial\n");
+  if (staticModelOptions.splitsPerIteration < 1)
+    fault ("SplitsPerIteration requires a number greater than 0\n");
+  if (staticModelOptions.splitsPerIteration > 1 && ! staticModelOptions.integration)
+    fault ("SplitsPerIteration is incompatible with FixedModels\n");
+  if (staticModelOptions.warmStart < 0)
+    fault ("WarmStart requires a number greater than 0\n");
+  if (staticModelOptions.warmStart && ! staticModelOptions.integration)
+    fault ("WarmStart is incompatible with FixedModels\n");
     
   if (staticModelOptions.markerAnalysis) {
     /* MarkerToMarker is a special case. It only supports TP, LD, fixed grid thetas
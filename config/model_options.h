@@ -90,6 +90,8 @@ typedef struct ModelOptions
   int polynomialScale;	///< Optional scaling factor for polynomial construction storage
   int integration;      ///< Flag to indicate if dynamic grid (integration) is being performed.
   int maxIterations;    ///< Optional upper limit the number of per-BR dynamic grid iterations
+  int splitsPerIteration; ///< Number of dynamic grid subregions split at a time, 1 by default
+  int warmStart;        ///< Optional number of subregions from the last dynamic grid integration to start each from
   int sexLinked;   /**< Flag to indicate that analysis focuses on non-pseudoautosomal region of
 		      the X chromosome. Should not be specified for X chromosome analyses that
 		   focus on the pseudoautosomal regions because they behave like autosomes. */
@@ -158,6 +160,7 @@ typedef struct ModelOptions
   char intermediatefile[PATH_MAX];       ///< Intermediate Result file
   char dkelvinoutfile[PATH_MAX];         ///< DCHURE detail file
   char resultsprefix[PATH_MAX]; ///< Path for SR directive result storage
+  char polynomialCachePath[PATH_MAX];    ///< Directory of cached likelihood polynomials, empty if none
   
 } ModelOptions;
 
@@ -676,6 +676,7 @@ create_person (Pedigree * pPed, char *sID)
   CALCHOKE(pPerson->pNumGenotype, (size_t) 1, sizeof (int) * originalLocusList.numLocus, int *);
   CALCHOKE(pPerson->ppSavedGenotypeList, (size_t) 1, sizeof (Genotype *) * originalLocusList.numLocus, Genotype **);
   CALCHOKE(pPerson->pSavedNumGenotype, (size_t) 1, sizeof (int) * originalLocusList.numLocus, int *);
+  CALCHOKE(pPerson->ppGenotypeBlock, (size_t) 1, sizeof (Genotype *) * originalLocusList.numLocus, Genotype **);
   CALCHOKE(pPerson->ppProbandGenotypeList, (size_t) 1, sizeof (Genotype *) * originalLocusList.numLocus, Genotype **);
   CALCHOKE(pPerson->pProbandNumGenotype, (size_t) 1, sizeof (int) * originalLocusList.numLocus, int *);
   CALCHOKE(pPerson->ppShadowGenotypeList, (size_t) 1, sizeof (Genotype *) * originalLocusList.numLocus, Genotype **);
@@ -40,6 +40,7 @@
    ./test
 ***********************************************************************/
 
+#include <string.h>
 #include "dcuhre.h"
 #include "utils/utils.h"
 #include "config/model.h" // for LINKAGE_DISEQUILIBRIUM
@@ -58,8 +59,6 @@ extern double traitPos;
 
 #define checkpt() fprintf (stderr, "Checkpoint at line %d of file \"%s\"\n",__LINE__,__FILE__)
 
-dcuhre_state *held_dcuhre_state;
-
 int
 dcuhre_ (dcuhre_state * s)
 {
@@ -109,9 +108,15 @@ dcuhre_ (dcuhre_state * s)
 
   /* Step1.2 Creating Pointers for subregions */
   MALCHOKE(s->sbrg_heap, sizeof (sub_region *) * s->maxsub, sub_region **);
+  MALCHOKE(s->sbrg_queue, sizeof (int) * s->maxsub, int *);
+  MALCHOKE(s->sbrg_queue_pos, sizeof (int) * s->maxsub, int *);
   for (i = 0; i < s->maxsub; i++) {
     s->sbrg_heap[i] = NULL;
+    s->sbrg_queue_pos[i] = -1;
   }
+  s->queue_len = 0;
+  s->sbrg_pool = NULL;
+  s->sbrg_pool_free = 0;
 
 
   /* Step2. The adaptive integration routine which calls DTRHRE, DINHRE and DRLHRE */
@@ -127,10 +132,15 @@ dcuhre_ (dcuhre_state * s)
   //  checkpt();
   //   printf("maxsub is %d  in \n", s->maxsub);
   /* Step 3. free all memory */
+  /* keep a partition to start the next integration from */
+  if (s->warm_start > 0)
+    sbrg_seed_keep (s);
   /* free the array of subregions */
-  sbrg_free (s->sbrg_heap, s->maxsub);
+  sbrg_free (s);
   //   checkpt();
   free (s->sbrg_heap);
+  free (s->sbrg_queue);
+  free (s->sbrg_queue_pos);
   //    checkpt(); 
   /* free global variables */
   for (i = 0; i < s->ndim; i++) {
@@ -147,6 +157,8 @@ dcuhre_ (dcuhre_state * s)
   free (s->g); 
   free (s->w);
   free (s->rulpts);
+  free (s->rule_pts);
+  free (s->rule_pts_start);
   free (s->scales);
   free (s->norms);
   free (s->errcof);
@@ -156,15 +168,382 @@ dcuhre_ (dcuhre_state * s)
 }
 
 
+/* Number of subregions allocated at a time, along with their centers and
+   half widths, by sbrg_alloc */
+#define SBRG_POOL_BLOCK 256
+
+/* Give out the next subregion from the current block, starting a new
+   block when it is used up. Each block starts with a pointer to the
+   previous one, for sbrg_free. */
+static sub_region *
+sbrg_alloc (dcuhre_state * s)
+{
+  sub_region *cw_sbrg;
+  void **block;
+  double *pts;
+
+  if (s->sbrg_pool_free == 0) {
+    MALCHOKE(block, sizeof (void *) + SBRG_POOL_BLOCK * (sizeof (sub_region) + sizeof (double) * 2 * s->ndim), void **);
+    block[0] = s->sbrg_pool;
+    s->sbrg_pool = block;
+    s->sbrg_pool_free = SBRG_POOL_BLOCK;
+  }
+  block = (void **) s->sbrg_pool;
+  cw_sbrg = (sub_region *) (block + 1) + (SBRG_POOL_BLOCK - s->sbrg_pool_free);
+  pts = (double *) ((sub_region *) (block + 1) + SBRG_POOL_BLOCK) + (SBRG_POOL_BLOCK - s->sbrg_pool_free) * 2 * s->ndim;
+  cw_sbrg->center = pts;
+  cw_sbrg->hwidth = pts + s->ndim;
+  s->sbrg_pool_free--;
+  return cw_sbrg;
+}
+
+
+/* Whether subregion a comes before b in the queue: greater error first,
+   and on ties the smaller id, as the first found by a scan in id order */
+static int
+sbrg_before (dcuhre_state * s, int a, int b)
+{
+  double ea = s->sbrg_heap[a]->local_error, eb = s->sbrg_heap[b]->local_error;
+
+  return ea > eb || (ea == eb && a < b);
+}
+
+/* Move the subregion at position pos of the queue up or down to its place */
+static void
+sbrg_queue_fix (dcuhre_state * s, int pos)
+{
+  int *q = s->sbrg_queue;
+  int id = q[pos], child;
+
+  while (pos > 0 && sbrg_before (s, id, q[(pos - 1) / 2])) {
+    q[pos] = q[(pos - 1) / 2];
+    s->sbrg_queue_pos[q[pos]] = pos;
+    pos = (pos - 1) / 2;
+  }
+  while ((child = 2 * pos + 1) < s->queue_len) {
+    if (child + 1 < s->queue_len && sbrg_before (s, q[child + 1], q[child]))
+      child++;
+    if (!sbrg_before (s, q[child], id))
+      break;
+    q[pos] = q[child];
+    s->sbrg_queue_pos[q[pos]] = pos;
+    pos = child;
+  }
+  q[pos] = id;
+  s->sbrg_queue_pos[id] = pos;
+}
+
+/* Queue a newly evaluated leaf subregion. Only those with positive errors
+   are ever chosen to be split, so the others are left out. */
+static void
+sbrg_queue_push (dcuhre_state * s, int id)
+{
+  if (!(s->sbrg_heap[id]->local_error > 0.0))
+    return;
+  s->sbrg_queue[s->queue_len] = id;
+  s->sbrg_queue_pos[id] = s->queue_len++;
+  sbrg_queue_fix (s, s->queue_len - 1);
+}
+
+/* Take a subregion that is about to be split out of the queue */
+static void
+sbrg_queue_remove (dcuhre_state * s, int id)
+{
+  int pos = s->sbrg_queue_pos[id];
+
+  if (pos < 0)
+    return;
+  s->sbrg_queue_pos[id] = -1;
+  if (pos == --s->queue_len)
+    return;
+  s->sbrg_queue[pos] = s->sbrg_queue[s->queue_len];
+  s->sbrg_queue_pos[s->sbrg_queue[pos]] = pos;
+  sbrg_queue_fix (s, pos);
+}
+
+
+/* Number of points of the basic rule: the center, four on each axis and
+   those of the fully symmetric sums */
+#define RULE_POINTS(s) (1 + 4 * (s)->ndim + (s)->rule_pts_start[(s)->wtleng])
+
+/* Write the points of the basic rule over cw_sbrg to x, NDIM to a point,
+   in the order their values are taken by apply_rule: the center, the
+   points on each axis at -G(1,2), G(1,2), -G(1,3) and G(1,3) half widths,
+   and then those of the fully symmetric sums. */
+static void
+rule_points (dcuhre_state * s, sub_region * cw_sbrg, double *x)
+{
+  int i, k, n;
+  double *pt;
+
+  memcpy (x, cw_sbrg->center, sizeof (double) * s->ndim);
+  n = 1;
+  for (i = 0; i < s->ndim; i++) {
+    for (k = 0; k < 4; k++) {
+      memcpy (&x[(n + k) * s->ndim], cw_sbrg->center, sizeof (double) * s->ndim);
+    }
+    x[n++ * s->ndim + i] = cw_sbrg->center[i] - cw_sbrg->hwidth[i] * s->g[0][1];
+    x[n++ * s->ndim + i] = cw_sbrg->center[i] + cw_sbrg->hwidth[i] * s->g[0][1];
+    x[n++ * s->ndim + i] = cw_sbrg->center[i] - cw_sbrg->hwidth[i] * s->g[0][2];
+    x[n++ * s->ndim + i] = cw_sbrg->center[i] + cw_sbrg->hwidth[i] * s->g[0][2];
+  }
+  for (k = 0; k < s->rule_pts_start[s->wtleng]; k++, n++) {
+    pt = &s->rule_pts[k * s->ndim];
+    for (i = 0; i < s->ndim; i++) {
+      x[n * s->ndim + i] = cw_sbrg->center[i] + pt[i] * cw_sbrg->hwidth[i];
+    }
+  }
+}
+
+/* The basic rule weight of point k of rule_points, kept with each sample */
+static double
+rule_point_weight (dcuhre_state * s, int k)
+{
+  int i;
+
+  if (k == 0)
+    return s->w[0][0];
+  if (k <= 4 * s->ndim)
+    return s->w[0][(k - 1) % 4 < 2 ? 1 : 2];
+  k -= 1 + 4 * s->ndim;
+  for (i = 3; k >= s->rule_pts_start[i + 1]; i++);
+  return s->w[0][i];
+}
+
+/* Compute the basic rule result and error estimate over cw_sbrg, and the
+   direction to split it in, from the values f of the integrand at the
+   points given by rule_points. */
+static void
+apply_rule (dcuhre_state * s, sub_region * cw_sbrg, double *f)
+{
+  int i, k, n, divaxn;
+  double rgnvol, difsum, difmax, frthdf, ratio, search;
+  double d__1, d__2, d__3;
+  double null[4];
+
+  rgnvol = 1.0;
+  divaxn = 0;
+  for (i = 0; i < s->ndim; i++) {
+    rgnvol *= cw_sbrg->hwidth[i];
+    if (cw_sbrg->hwidth[i] > cw_sbrg->hwidth[divaxn]) {
+      divaxn = i;
+    }
+  }
+
+  if(isnan(s->w[0][0])){
+    fprintf(stderr,"sw00 is nan \n");
+    exit(1);
+  }
+
+  cw_sbrg->local_error = f[0];
+  cw_sbrg->local_result = s->w[0][0] * cw_sbrg->local_error;	//rgnerr[j];
+
+  for (k = 0; k < 4; ++k) {
+    null[k] = s->w[k + 1][0] * cw_sbrg->local_error;	//  rgnerr[j];
+  }
+
+  difmax = 0.;
+  d__1 = s->g[0][2] / s->g[0][1];
+  ratio = d__1 * d__1;
+  for (i = 0, n = 1; i < s->ndim; i++, n += 4) {
+    difsum = 0.;
+
+    frthdf = (1 - ratio) * 2 * cw_sbrg->local_error - (f[n + 2] +
+						       f[n + 3]) +
+      ratio * (f[n] + f[n + 1]);
+
+    /* Ignore differences below roundoff */
+    if (cw_sbrg->local_error + frthdf / 4 != cw_sbrg->local_error) {
+      difsum += fabs (frthdf);
+    }
+    for (k = 0; k < 4; k++) {
+      null[k] += s->w[k + 1][1] * (f[n] + f[n + 1])
+	+ s->w[k + 1][2] * (f[n + 2] + f[n + 3]);
+    }
+
+    cw_sbrg->local_result +=
+      s->w[0][1] * (f[n] + f[n + 1]) + s->w[0][2] * (f[n + 2] + f[n + 3]);
+
+    if (difsum > difmax) {
+      difmax = difsum;
+      divaxn = i;
+    }
+  }
+  cw_sbrg->dir = divaxn;
+
+  /* Finish computing the rule values with the fully symmetric sums. */
+  for (i = 3; i < s->wtleng; i++) {
+    cw_sbrg->local_error = 0.;
+    for (k = s->rule_pts_start[i]; k < s->rule_pts_start[i + 1]; k++) {
+      cw_sbrg->local_error += f[n++];
+    }
+    cw_sbrg->local_result += s->w[0][i] * cw_sbrg->local_error;
+
+    for (k = 0; k < 4; k++) {
+      null[k] += s->w[k + 1][i] * cw_sbrg->local_error;
+    }
+
+  }
+
+  if (s->verbose > 0) {
+
+    fprintf (stderr, "local result =%10.8f  and local error =%10.8f\n", cw_sbrg->local_result,cw_sbrg->local_error);
+  }
+  if(isnan(cw_sbrg->local_result)){
+    fprintf(stderr,"local result is nan \n");
+    exit(1);
+  }
+
+  /*    Compute errors. */
+  /*    We search for the null rule, in the linear space spanned by two */
+  /*    successive null rules in our sequence, which gives the greatest */
+  /*    error estimate among all normalized (1-norm) null rules in this */
+  /*    space. */
+  for (i = 0; i < 3; i++) {
+    search = 0.;
+
+    for (k = 0; k < s->wtleng; k++) {
+      /* Computing MAX */
+      d__2 = search, d__3 = (d__1 = null[i + 1] + s->scales[i][k] * null[i],
+			     fabs (d__1)) * s->norms[i][k];
+      search = max (d__2, d__3);
+    }
+    null[i] = search;
+  }
+  if (s->errcof[0] * null[0] <= null[1] && s->errcof[1] * null[1] <= null[2]) {
+    cw_sbrg->local_error = s->errcof[2] * null[0];
+  } else {
+    /* Computing MAX */
+    d__1 = null[0], d__2 = null[1], d__1 = max (d__1, d__2), d__2 = null[2];
+    cw_sbrg->local_error = s->errcof[3] * max (d__1, d__2);
+  }
+  cw_sbrg->local_error *= rgnvol;
+  cw_sbrg->local_result *= rgnvol;
+
+  if ((modelOptions->equilibrium != LINKAGE_DISEQUILIBRIUM) && // PPLs of 1 are not unusual for LD runs
+      ((cw_sbrg->local_result > 1e+15) || (cw_sbrg->local_result < -1e+15))) {
+#ifdef STUDYDB
+    if (cw_sbrg->bogusLikelihoods == 0) {
+      fprintf (stderr, "FATAL - DUMPING (%s:%d), extreme local_result of %g (w/error %g) encountered with %d global bogus likelihoods and %d local bogus likelihoods!\n",
+	       (__FILE__), (__LINE__), cw_sbrg->local_result, cw_sbrg->local_error, studyDB.bogusLikelihoods, cw_sbrg->bogusLikelihoods);
+      print_sbrg (cw_sbrg, s->ndim);
+      signal (SIGQUIT, SIG_DFL); // Restore the default handler
+      raise (SIGQUIT); // Make a core dump
+    }
+#else
+    fprintf (stderr, "FATAL - DUMPING (%s:%d), extreme local_result of %g (w/error %g) encountered!\n", (__FILE__), (__LINE__), cw_sbrg->local_result, cw_sbrg->local_error);
+    print_sbrg (cw_sbrg, s->ndim);
+    signal (SIGQUIT, SIG_DFL); // Restore the default handler
+    raise (SIGQUIT); // Make a core dump
+#endif
+  }
+}
+
+/* Apply the basic rule over the n new subregions sbrgs, one after
+   another, each starting from the greatest scale so far. Without
+   sampling, the integrand is given the points of all of them in one
+   call of funbatch, in the order drlhre_ would evaluate them and with
+   the scale carried from point to point in the same way, so the results
+   are the same. Each subregion is then left with the scale reached after
+   the last of them. */
+static void
+apply_basic_rule (dcuhre_state * s, sub_region ** sbrgs, int n)
+{
+  int j, num;
+  double *x, *f;
+
+#ifndef STUDYDB
+  /* likelihood server runs look up the results of each subregion */
+  if (s->funbatch != NULL && s->sampling_mode == 0) {
+    num = RULE_POINTS (s);
+    MALCHOKE(x, sizeof (double) * s->ndim * num * n, double *);
+    MALCHOKE(f, sizeof (double) * num * n, double *);
+    for (j = 0; j < n; j++) {
+      rule_points (s, sbrgs[j], &x[j * num * s->ndim]);
+    }
+    (s->funbatch) (num * n, x, f, &(s->scale), s->fun_ctx);
+    for (j = 0; j < n; j++) {
+      sbrgs[j]->cur_scale = s->scale;
+      apply_rule (s, sbrgs[j], &f[j * num]);
+    }
+    free (x);
+    free (f);
+    return;
+  }
+#endif
+  for (j = 0; j < n; j++) {
+    sbrgs[j]->cur_scale = s->scale;
+    drlhre_ (s, sbrgs[j]);
+    if (sbrgs[j]->cur_scale > s->scale) {
+      s->scale = sbrgs[j]->cur_scale;
+    }
+  }
+}
+
+/* Add the results of the new subregion cw_sbrg to the totals and queue it */
+static void
+add_sbrg (dcuhre_state * s, sub_region * cw_sbrg)
+{
+  s->total_neval += s->num;
+  s->result += cw_sbrg->local_result;
+  s->error += cw_sbrg->local_error;
+  sbrg_queue_push (s, cw_sbrg->region_id);
+}
+
+/* Create one half of parent_sbrg, split in its direction dir, the upper
+   half when side is 1 (the left child) and the lower when it is -1 (the
+   right child), as the next subregion s->sbrg_heap[s->sbrgns]. The basic
+   rule is applied over it later, with the other new subregions of the
+   round (see apply_basic_rule). */
+static void
+split_sbrg_half (dcuhre_state * s, sub_region * parent_sbrg, int side)
+{
+  int i, direct;
+  sub_region *cw_sbrg;
+
+  s->sbrg_heap[s->sbrgns] = sbrg_alloc (s);
+  cw_sbrg = s->sbrg_heap[s->sbrgns];
+
+  cw_sbrg->parent_id = parent_sbrg->region_id;
+  cw_sbrg->region_id = s->sbrgns;
+  if (side > 0)
+    parent_sbrg->lchild_id = cw_sbrg->region_id;
+  else
+    parent_sbrg->rchild_id = cw_sbrg->region_id;
+  cw_sbrg->bogusLikelihoods = 0;
+  cw_sbrg->region_level = parent_sbrg->region_level + 1;
+  for (i = 0; i < s->ndim; i++) {
+    cw_sbrg->center[i] = parent_sbrg->center[i];
+    cw_sbrg->hwidth[i] = parent_sbrg->hwidth[i];
+  }
+  direct = parent_sbrg->dir;
+  cw_sbrg->hwidth[direct] = parent_sbrg->hwidth[direct] / 2;
+  if (side > 0)
+    cw_sbrg->center[direct] += cw_sbrg->hwidth[direct];
+  else
+    cw_sbrg->center[direct] -= cw_sbrg->hwidth[direct];
+  cw_sbrg->lchild_id = 0;
+
+  if (s->verbose > 1) {
+    print_sbrg (cw_sbrg, s->ndim);
+  }
+  s->sbrgns++;
+}
+
+
 int
 dadhre_ (dcuhre_state * s)
 {
   /*The adaptive integration routine which calls DTRHRE, DINHRE and DRLHRE */
-  int i, j, direct;
+  int i, j, k, ndiv, nstart, first;
   int intsgn;			//, pointr;
+  int *split_sbrg;		/* the subregions split in a round */
   sub_region *cw_sbrg, *parent_sbrg;	/* currently working subregion */
   double tmp_result;		/*store the just previous error to calculate the difference in error from the previous one to currrent one */
   double real_result, real_error;
+#ifdef STUDYDB
+  dcuhre_state *held_dcuhre_state;	/* the state before a split, to restore after bogus likelihoods */
+#endif
 
   intsgn = 1;
   i = s->ndim;
@@ -193,48 +572,90 @@ dadhre_ (dcuhre_state * s)
   }
 
 
-  /*Step2.2 initialize the first subregion */
-  MALCHOKE(s->sbrg_heap[0], sizeof (sub_region), sub_region *);
-  cw_sbrg = s->sbrg_heap[0];
+  /*Step2.2 initialize the first subregion, or with a warm start, the leaf
+    subregions the previous integration ended with */
+  nstart = 1;
+#ifndef STUDYDB
+  /* likelihood server runs keep their results by subregion id */
+  if (s->warm_start && s->sampling_mode == 0 && s->seed_ndim == s->ndim &&
+      s->num_seed > 1 && s->num_seed <= s->maxsub / 2 &&
+      memcmp (s->seed_bounds, s->xl, sizeof (double) * s->ndim) == 0 &&
+      memcmp (&s->seed_bounds[s->ndim], s->xu, sizeof (double) * s->ndim) == 0)
+    nstart = s->num_seed;
+#endif
+  if (nstart > 1) {
+    for (j = 0; j < nstart; j++) {
+      s->sbrg_heap[j] = sbrg_alloc (s);
+      cw_sbrg = s->sbrg_heap[j];
 
-  cw_sbrg->region_id = 0;
-  cw_sbrg->region_level = 0;
-  cw_sbrg->bogusLikelihoods = 0;
-  cw_sbrg->parent_id = 0;
-  MALCHOKE(cw_sbrg->center, sizeof (double) * s->ndim, double *);
-  MALCHOKE(cw_sbrg->hwidth, sizeof (double) * s->ndim, double *);
-  cw_sbrg->cur_scale = s->scale;
-  for (i = 0; i < s->ndim; i++) {
-    cw_sbrg->center[i] = (s->xl[i] + s->xu[i]) / 2;
-    cw_sbrg->hwidth[i] = fabs ((s->xu[i] - s->xl[i]) / 2);
-  }
-  if (s->verbose > 1) {
-    fprintf (stderr, "A");
-    print_sbrg (cw_sbrg, s->ndim);
-  }
+      cw_sbrg->region_id = j;
+      cw_sbrg->region_level = 0;
+      cw_sbrg->bogusLikelihoods = 0;
+      cw_sbrg->parent_id = 0;
+      cw_sbrg->lchild_id = 0;
+      memcpy (cw_sbrg->center, &s->seed_sbrg[2 * s->ndim * j], sizeof (double) * s->ndim);
+      memcpy (cw_sbrg->hwidth, &s->seed_sbrg[2 * s->ndim * j + s->ndim], sizeof (double) * s->ndim);
+      if (s->verbose > 1) {
+	print_sbrg (cw_sbrg, s->ndim);
+      }
+    }
+    apply_basic_rule (s, s->sbrg_heap, nstart);
+    for (j = 0; j < nstart; j++) {
+      add_sbrg (s, s->sbrg_heap[j]);
+      s->sbrgns++;
+    }
+    tmp_result = s->result /s->vol_rate;
 
-  /*Step2.3   Apply DRLHRE over the whole region. */
-  if (s->verbose > 1) {
-    fprintf (stderr, "Apply DRLHRE over the whole region\n");
-  }
-  drlhre_ (s, cw_sbrg);
+    if (s->verbose > 1) {
+      fprintf (stderr, "After first %d sub regions result=%20.18f error=%20.18f\n",
+	       s->sbrgns, s->result, s->error);
+    }
 
-  if( cw_sbrg->cur_scale > s->scale){
-    s->scale=cw_sbrg->cur_scale;
-  }
-  s->total_neval += s->num;
-  s->result += cw_sbrg->local_result;
-  s->error += cw_sbrg->local_error;
-  tmp_result = s->result /s->vol_rate;
+    s->greate = 0.0;
+    s->next_sbrg = 0;
+    if (s->queue_len > 0) {
+      s->next_sbrg = s->sbrg_queue[0];
+      s->greate = s->sbrg_heap[s->next_sbrg]->local_error;
+    }
+  } else {
+    s->sbrg_heap[0] = sbrg_alloc (s);
+    cw_sbrg = s->sbrg_heap[0];
+
+    cw_sbrg->region_id = 0;
+    cw_sbrg->region_level = 0;
+    cw_sbrg->bogusLikelihoods = 0;
+    cw_sbrg->parent_id = 0;
+    cw_sbrg->lchild_id = 0;
+    for (i = 0; i < s->ndim; i++) {
+      cw_sbrg->center[i] = (s->xl[i] + s->xu[i]) / 2;
+      cw_sbrg->hwidth[i] = fabs ((s->xu[i] - s->xl[i]) / 2);
+    }
+    if (s->verbose > 1) {
+      fprintf (stderr, "A");
+      print_sbrg (cw_sbrg, s->ndim);
+    }
 
-  if (s->verbose > 1) {
-    fprintf (stderr, "After first %d sub regions result=%20.18f error=%20.18f\n",
+    /*Step2.3   Apply DRLHRE over the whole region. */
+    if (s->verbose > 1) {
+      fprintf (stderr, "Apply DRLHRE over the whole region\n");
+    }
+    apply_basic_rule (s, s->sbrg_heap, 1);
+
+    s->total_neval += s->num;
+    s->result += cw_sbrg->local_result;
+    s->error += cw_sbrg->local_error;
+    tmp_result = s->result /s->vol_rate;
+
+    if (s->verbose > 1) {
+      fprintf (stderr, "After first %d sub regions result=%20.18f error=%20.18f\n",
 	     s->sbrgns, s->result, s->error);
-  }
+    }
 
-  s->greate = cw_sbrg->local_error;
-  s->sbrgns++;
-  s->next_sbrg = 0;
+    s->greate = cw_sbrg->local_error;
+    s->sbrgns++;
+    s->next_sbrg = 0;
+    sbrg_queue_push (s, 0);
+  }
   /*Some action which DRTHRE_ does should be here */
 
   /* ***End initialisation. */
@@ -245,6 +666,7 @@ dadhre_ (dcuhre_state * s)
   }
 
   /*Step3 Loop for main integration */
+  MALCHOKE(split_sbrg, sizeof (int) * s->split_round, int *);
   while (s->sbrgns < s->maxsub) {
 
     /*This is for setting absolute error */
@@ -276,8 +698,8 @@ dadhre_ (dcuhre_state * s)
 
 
     //s->epsrel = s->epsabs / (s->result);
-    if (s->sbrgns == 1) {
-      s->diff_result[0] = s->epsabs * 2;	/*Dummy number for the main while loop */
+    if (s->sbrgns == nstart) {
+      s->diff_result[nstart - 1] = s->epsabs * 2;	/*Dummy number for the main while loop */
     }
     if (s->verbose > 0) 
       fprintf (stderr, "%d regions Setting absolute error %12.8f  diff = %f  real error = %f real result= %f dir= %d \n",
@@ -330,115 +752,80 @@ dadhre_ (dcuhre_state * s)
       /*   prepare to apply basic rule over each half of the */
       /*   NDIV subregions with greatest errors. */
       /*   If MAXSUB is great enough, NDIV = MDIV */
-      if (s->verbose > 1) {
-	fprintf (stderr,
-		 "Select %d subregion with %f error and direction = %d\n",
-		 s->next_sbrg, s->greate, s->sbrg_heap[s->next_sbrg]->dir);
+      /*   MDIV is s->split_round, and the first is s->next_sbrg */
+      ndiv = min (s->split_round, (s->maxsub - s->sbrgns) / 2);
+#ifdef STUDYDB
+      /* the held state only covers one split */
+      ndiv = 1;
+#endif
+      split_sbrg[0] = s->next_sbrg;
+      sbrg_queue_remove (s, s->next_sbrg);
+      for (k = 1; k < ndiv && s->queue_len > 0; k++) {
+	split_sbrg[k] = s->sbrg_queue[0];
+	sbrg_queue_remove (s, split_sbrg[k]);
       }
-      /*Step 3.1   Adjust RESULT and ABSERR. and prepare for adding children */
-      parent_sbrg = s->sbrg_heap[s->next_sbrg];	/* parent_sbrg is the sbrg to be split */
+      ndiv = k;
+
+      first = s->sbrgns;
+      for (k = 0; k < ndiv; k++) {
+	if (s->verbose > 1) {
+	  fprintf (stderr,
+		   "Select %d subregion with %f error and direction = %d\n",
+		   split_sbrg[k], s->sbrg_heap[split_sbrg[k]]->local_error, s->sbrg_heap[split_sbrg[k]]->dir);
+	}
+	parent_sbrg = s->sbrg_heap[split_sbrg[k]];	/* parent_sbrg is the sbrg to be split */
 
-      s->result -= parent_sbrg->local_result;
-      s->error -= parent_sbrg->local_error;
+	/*Step 3.1   Create first half region (left child) and second half region (right child) */
+	split_sbrg_half (s, parent_sbrg, 1);
+	split_sbrg_half (s, parent_sbrg, -1);
+      }
 
-      /*Step 3.2   Compute first half region (left child) */
-      MALCHOKE(s->sbrg_heap[s->sbrgns], sizeof (sub_region), sub_region *);
-      cw_sbrg = s->sbrg_heap[s->sbrgns];
+      /*Step 3.2   Compute all of the children of the round at once */
+      apply_basic_rule (s, &s->sbrg_heap[first], 2 * ndiv);
 
-      cw_sbrg->parent_id = parent_sbrg->region_id;
-      cw_sbrg->region_id = s->sbrgns;
-      parent_sbrg->lchild_id = cw_sbrg->region_id;
-      cw_sbrg->bogusLikelihoods = 0;
-      cw_sbrg->region_level = parent_sbrg->region_level + 1;
-      MALCHOKE(cw_sbrg->center, sizeof (double) * s->ndim, double *);
-      MALCHOKE(cw_sbrg->hwidth, sizeof (double) * s->ndim, double *);
-      cw_sbrg->cur_scale = s->scale;
-      for (i = 0; i < s->ndim; i++) {
-	cw_sbrg->center[i] = parent_sbrg->center[i];
-	cw_sbrg->hwidth[i] = parent_sbrg->hwidth[i];
-      }
-      direct = parent_sbrg->dir;
-      cw_sbrg->hwidth[direct] = parent_sbrg->hwidth[direct] / 2;
-      cw_sbrg->center[direct] += cw_sbrg->hwidth[direct];
-      cw_sbrg->lchild_id = 0;
+      for (k = 0; k < ndiv; k++) {
+	/*Step 3.3   Adjust RESULT and ABSERR for each split */
+	parent_sbrg = s->sbrg_heap[split_sbrg[k]];
 
-      if (s->verbose > 1) {
-	print_sbrg (cw_sbrg, s->ndim);
-      }
-      drlhre_ (s, cw_sbrg);
-      if( cw_sbrg->cur_scale > s->scale){
-        s->scale=cw_sbrg->cur_scale;
-      }
-      s->total_neval += s->num;
+	s->result -= parent_sbrg->local_result;
+	s->error -= parent_sbrg->local_error;
 
-      s->result += cw_sbrg->local_result;
-      s->error += cw_sbrg->local_error;
-      if (s->verbose > 1) {
-	fprintf (stderr, "After %d sub regions result=%10.8f error=%10.8f\n",
-		 s->sbrgns, s->result, s->error);
-      }
+	add_sbrg (s, s->sbrg_heap[first + 2 * k]);
+	if (s->verbose > 1) {
+	  fprintf (stderr, "After %d sub regions result=%10.8f error=%10.8f\n",
+		   first + 2 * k, s->result, s->error);
+	}
 #ifdef STUDYDB
-      // This is purely informative.
+	// This is purely informative.
 
-      fprintf (stderr, "DCUHRE split performed from parent %d, direction %d!\n", cw_sbrg->parent_id, parent_sbrg->dir);
-      fprintf(stderr, "Left half region %d w/%d bogus evaluation results\n", 
-	      s->sbrgns, 
-	      s->sbrg_heap[s->sbrgns]->bogusLikelihoods);
+	fprintf (stderr, "DCUHRE split performed from parent %d, direction %d!\n", parent_sbrg->region_id, parent_sbrg->dir);
+	fprintf(stderr, "Left half region %d w/%d bogus evaluation results\n", 
+		first + 2 * k, 
+		s->sbrg_heap[first + 2 * k]->bogusLikelihoods);
 #endif
-      s->sbrgns++;
-
-      /*Step 3.3 Compute second half region.(right child) */
-      MALCHOKE(s->sbrg_heap[s->sbrgns], sizeof (sub_region), sub_region *);
-      cw_sbrg = s->sbrg_heap[s->sbrgns];
-
-      cw_sbrg->parent_id = parent_sbrg->region_id;
-      cw_sbrg->region_id = s->sbrgns;
-      parent_sbrg->rchild_id = cw_sbrg->region_id;
-      cw_sbrg->bogusLikelihoods = 0;
-      cw_sbrg->region_level = parent_sbrg->region_level + 1;
-      MALCHOKE(cw_sbrg->center, sizeof (double) * s->ndim, double *);
-      MALCHOKE(cw_sbrg->hwidth, sizeof (double) * s->ndim, double *);
-      cw_sbrg->cur_scale = s->scale;
-      for (i = 0; i < s->ndim; i++) {
-	cw_sbrg->center[i] = parent_sbrg->center[i];
-	cw_sbrg->hwidth[i] = parent_sbrg->hwidth[i];
-      }
 
-      cw_sbrg->hwidth[direct] = parent_sbrg->hwidth[direct] / 2;
-      cw_sbrg->center[direct] -= cw_sbrg->hwidth[direct];
-      cw_sbrg->lchild_id = 0;
+	add_sbrg (s, s->sbrg_heap[first + 2 * k + 1]);
+#ifdef STUDYDB
+	// This is purely informative.
 
-      if (s->verbose > 1) {
-	print_sbrg (cw_sbrg, s->ndim);
-      }
-      drlhre_ (s, cw_sbrg);
-      if( cw_sbrg->cur_scale > s->scale){
-        s->scale=cw_sbrg->cur_scale;
+	fprintf(stderr, "Right half region %d w/%d bogus evaluation results\n", 
+		first + 2 * k + 1, 
+		s->sbrg_heap[first + 2 * k + 1]->bogusLikelihoods);
+#endif
       }
-      s->total_neval += s->num;
 
-      s->result += cw_sbrg->local_result;
-      s->error += cw_sbrg->local_error;
+      /* The stopping criteria are applied to the round as a whole */
       real_result = s->result / s->vol_rate;
       real_error = s->error / s->vol_rate;
 
-      s->diff_result[s->sbrgns] = fabs (real_result  - tmp_result);
+      s->diff_result[s->sbrgns - 1] = fabs (real_result  - tmp_result);
       tmp_result = real_result;
       if (s->verbose > 0) {
 	fprintf (stderr,
 		 "After %d sub regions result=%10.8f error=%10.8f and difference=%10.8f\n",
-		 s->sbrgns, real_result, real_error, s->diff_result[s->sbrgns]);
+		 s->sbrgns - 1, real_result, real_error, s->diff_result[s->sbrgns - 1]);
       }
 
-#ifdef STUDYDB
-      // This is purely informative.
-
-      fprintf(stderr, "Right half region %d w/%d bogus evaluation results\n", 
-	      s->sbrgns, 
-	      s->sbrg_heap[s->sbrgns]->bogusLikelihoods);
-#endif
-      s->sbrgns++;
-
 #ifdef STUDYDB
       if (studyDB.bogusLikelihoods > 0) {
 	// Did a split, but with bogus results we need to PRETEND that we didn't by
@@ -458,14 +845,9 @@ dadhre_ (dcuhre_state * s)
 
       /*find the next subregion with greatest error among leaves to split */
       s->greate = 0.0;
-      for (i = 0; i < s->sbrgns; i++) {
-	cw_sbrg = s->sbrg_heap[i];
-	if (cw_sbrg->lchild_id == 0) {	/*That is this sbrg is a leaf */
-	  if (cw_sbrg->local_error > s->greate) {
-	    s->next_sbrg = cw_sbrg->region_id;
-	    s->greate = cw_sbrg->local_error;
-	  }
-	}
+      if (s->queue_len > 0) {
+	s->next_sbrg = s->sbrg_queue[0];
+	s->greate = s->sbrg_heap[s->next_sbrg]->local_error;
       }
       s->ifail = 1;
     } else {
@@ -479,13 +861,16 @@ dadhre_ (dcuhre_state * s)
       break;
     }
     
-    if((s->sbrgns  == s->maxsub) && (s->result / s->vol_rate <0)){   
+    if((s->sbrgns  >= s->maxsub) && (s->result / s->vol_rate <0)){   
                   /* in case of a negative result, double the current maxsub*/
       s->maxsub = 2* s->maxsub+1;
       REALCHOKE(s->diff_result, sizeof(double) * s->maxsub, double *);
       REALCHOKE(s->sbrg_heap, sizeof (sub_region *) * s->maxsub, sub_region **);
+      REALCHOKE(s->sbrg_queue, sizeof (int) * s->maxsub, int *);
+      REALCHOKE(s->sbrg_queue_pos, sizeof (int) * s->maxsub, int *);
       for (i = s->maxsub/2; i < s->maxsub; i++) {
         s->sbrg_heap[i] = NULL;
+        s->sbrg_queue_pos[i] = -1;
       }
       //      printf("maxsub is doubled to %d \n",s->maxsub );
     } 
@@ -493,6 +878,7 @@ dadhre_ (dcuhre_state * s)
   }
   //  checkpt();
   //  printf("maxsub is %d in dadddd\n", s->maxsub);
+  free (split_sbrg);
 
   return 0;
 
@@ -503,14 +889,8 @@ int
 drlhre_ (dcuhre_state * s, sub_region * cw_sbrg)
 {
 
-  int i, k, divaxn;
-  double rgnvol, difsum, difmax, frthdf, ratio, search;
-  double d__1, d__2, d__3;
-  double *x, *null;
-  int g_work_col;
-
-  rgnvol = 1.0;
-  divaxn = 0;
+  int k, num;
+  double *x, *f;
 
 #ifdef STUDYDB
   // Attempt to retrieve a subregion cache file and return it's contents instead of calculating one
@@ -560,187 +940,25 @@ drlhre_ (dcuhre_state * s, sub_region * cw_sbrg)
   fprintf (stderr, "not found (maybe had bogus likelihoods), calculating.\n");
 #endif
 
-  MALCHOKE(x, sizeof (double) * s->ndim, double *);
-  MALCHOKE(null, sizeof (double) * 8, double *);
-  for (i = 0; i < s->ndim; i++) {
-    rgnvol *= cw_sbrg->hwidth[i];
-    x[i] = cw_sbrg->center[i];
-    if (cw_sbrg->hwidth[i] > cw_sbrg->hwidth[divaxn]) {
-      divaxn = i;
-    }
-  }
-
-  if(s->sampling_mode>0)
-    (s->funsub) ( x, &(cw_sbrg->local_error),s);
-  else{
-    (s->funsub) ( x, &(cw_sbrg->local_error), &(cw_sbrg->cur_scale));
-  }
-  if(s->sampling_mode==1)
-    s->sample_pts[s->cur_sample*(s->ndim+1)] = s->w[0][0];
-
-  //fprintf (stderr, "1 local result =%10.8f  and local error =%10.8f\n", cw_sbrg->local_result,cw_sbrg->local_error);
-  //fprintf(stderr," sw00 is %G   %p %p\n", s->w[0][0], s->w, s->w[0]);
-
-  if(isnan(s->w[0][0])){
-    fprintf(stderr,"sw00 is nan \n");
-    exit(1);
-  }
-
-  cw_sbrg->local_result = s->w[0][0] * cw_sbrg->local_error;	//rgnerr[j];
-
-  for (k = 0; k < 4; ++k) {
-    null[k] = s->w[k + 1][0] * cw_sbrg->local_error;	//  rgnerr[j];
-  }
-
-  difmax = 0.;
-  d__1 = s->g[0][2] / s->g[0][1];
-  ratio = d__1 * d__1;
-  for (i = 0; i < s->ndim; i++) {
-    x[i] = cw_sbrg->center[i] - cw_sbrg->hwidth[i] * s->g[0][1];
-
+  num = RULE_POINTS (s);
+  MALCHOKE(x, sizeof (double) * s->ndim * num, double *);
+  MALCHOKE(f, sizeof (double) * num, double *);
+  rule_points (s, cw_sbrg, x);
+  for (k = 0; k < num; k++) {
     if(s->sampling_mode>0)
-      (s->funsub) ( x, &null[4],s);
+      (s->funsub) ( &x[k * s->ndim], &f[k],s, s->fun_ctx);
     else{
-      (s->funsub) ( x, &null[4], &(cw_sbrg->cur_scale));
+      (s->funsub) ( &x[k * s->ndim], &f[k], &(cw_sbrg->cur_scale), s->fun_ctx);
     }
-    if(s->sampling_mode==1)
-      s->sample_pts[s->cur_sample*(s->ndim+1)] = s->w[0][1];
-
-    x[i] = cw_sbrg->center[i] + cw_sbrg->hwidth[i] * s->g[0][1];
-
-    if(s->sampling_mode>0)
-      (s->funsub) ( x, &null[5],s);
-    else{
-      (s->funsub) ( x, &null[5], &(cw_sbrg->cur_scale));
-    }
-    if(s->sampling_mode==1)
-      s->sample_pts[s->cur_sample*(s->ndim+1)] =  s->w[0][1];
-
-    x[i] = cw_sbrg->center[i] - cw_sbrg->hwidth[i] * s->g[0][2];
-    if(s->sampling_mode>0)
-      (s->funsub) ( x, &null[6],s);
-    else{
-      (s->funsub) ( x, &null[6], &(cw_sbrg->cur_scale));
-    }
-    if(s->sampling_mode==1)
-      s->sample_pts[s->cur_sample*(s->ndim+1)] = s->w[0][2];
-
-    x[i] = cw_sbrg->center[i] + cw_sbrg->hwidth[i] * s->g[0][2];
-    if(s->sampling_mode>0)
-      (s->funsub) (x, &null[7],s);
-    else{
-      (s->funsub) ( x, &null[7], &(cw_sbrg->cur_scale));
-    }
-    if(s->sampling_mode==1)
-      s->sample_pts[s->cur_sample*(s->ndim+1)] = s->w[0][2];
-
-    x[i] = cw_sbrg->center[i];
-    difsum = 0.;
-
-    frthdf = (1 - ratio) * 2 * cw_sbrg->local_error - (null[6] +
-						       null[7]) +
-      ratio * (null[4] + null[5]);
-
-    //fprintf (stderr, "printing null 4 %f %f %f %f %f\n", null[4],null[5],null[6],null[7],frthdf);
-    /* Ignore differences below roundoff */
-    if (cw_sbrg->local_error + frthdf / 4 != cw_sbrg->local_error) {
-      difsum += fabs (frthdf);
-    }
-    for (k = 0; k < 4; k++) {
-      null[k] += s->w[k + 1][1] * (null[4] + null[5])
-	+ s->w[k + 1][2] * (null[6] + null[7]);
-    }
-
-    cw_sbrg->local_result +=
-      s->w[0][1] * (null[4] + null[5]) + s->w[0][2] * (null[6] + null[7]);
-
-    if (difsum > difmax) {
-      difmax = difsum;
-      divaxn = i;
-    }
-  }
-  cw_sbrg->dir = divaxn;
-
-  //fprintf (stderr, "null is %10.8f  %10.8f  %10.8f \n", null[0], null[1], null[2]);
-  /* Finish computing the rule values. */
-  for (i = 3; i < s->wtleng; i++) {
-    //dfshre_(s->ndim, cw_sbrg->center, cw_sbrg->hwidth, x, s->g[0][i], 
-    //                s->numfun, (S_fp)s->funsub, &(cw_sbrg->local_error), &null[4]);
-    g_work_col = i;
-    //fprintf (stderr, "i=%d calling dfshre\n",i);
-    //fprintf (stderr, "g is %f %f %f %f %f\n",s->g[0][g_work_col],s->g[1][g_work_col],s->g[2][g_work_col],s->g[3][g_work_col],s->g[4][g_work_col]);
-
     if(s->sampling_mode==1){
-      s->cur_weight = s->w[0][i];
-    }
-
-
-    dfshre_ (s, cw_sbrg, x, g_work_col, &(cw_sbrg->local_error), &null[4]);
-    cw_sbrg->local_result += s->w[0][i] * cw_sbrg->local_error;
-
-    for (k = 0; k < 4; k++) {
-      null[k] += s->w[k + 1][i] * cw_sbrg->local_error;
+      s->cur_weight = rule_point_weight (s, k);
+      s->sample_pts[s->cur_sample*(s->ndim+1)] = s->cur_weight;
     }
-
   }
-
-  if (s->verbose > 0) {
-
-    fprintf (stderr, "local result =%10.8f  and local error =%10.8f\n", cw_sbrg->local_result,cw_sbrg->local_error);
-  }
-  if(isnan(cw_sbrg->local_result)){
-    fprintf(stderr,"local result is nan \n");
-    exit(1);
-  }
-
-  /*    Compute errors. */
-  /*    We search for the null rule, in the linear space spanned by two */
-  /*    successive null rules in our sequence, which gives the greatest */
-  /*    error estimate among all normalized (1-norm) null rules in this */
-  /*    space. */
-  //fprintf (stderr, "null is %10.8f  %10.8f  %10.8f \n", null[0], null[1], null[2]);
-  for (i = 0; i < 3; i++) {
-    search = 0.;
-
-    for (k = 0; k < s->wtleng; k++) {
-      /* Computing MAX */
-      d__2 = search, d__3 = (d__1 = null[i + 1] + s->scales[i][k] * null[i],
-			     fabs (d__1)) * s->norms[i][k];
-      search = max (d__2, d__3);
-    }
-    null[i] = search;
-  }
-  //fprintf (stderr, "null is %10.8f  %10.8f  %10.8f \n", null[0], null[1], null[2]);
-  if (s->errcof[0] * null[0] <= null[1] && s->errcof[1] * null[1] <= null[2]) {
-    cw_sbrg->local_error = s->errcof[2] * null[0];
-  } else {
-    /* Computing MAX */
-    d__1 = null[0], d__2 = null[1], d__1 = max (d__1, d__2), d__2 = null[2];
-    cw_sbrg->local_error = s->errcof[3] * max (d__1, d__2);
-  }
-  cw_sbrg->local_error *= rgnvol;
-  cw_sbrg->local_result *= rgnvol;
+  apply_rule (s, cw_sbrg, f);
 
   free (x);
-  free (null);
-
-  if ((modelOptions->equilibrium != LINKAGE_DISEQUILIBRIUM) && // PPLs of 1 are not unusual for LD runs
-      ((cw_sbrg->local_result > 1e+15) || (cw_sbrg->local_result < -1e+15))) {
-#ifdef STUDYDB
-    if (cw_sbrg->bogusLikelihoods == 0) {
-      fprintf (stderr, "FATAL - DUMPING (%s:%d), extreme local_result of %g (w/error %g) encountered with %d global bogus likelihoods and %d local bogus likelihoods!\n",
-	       (__FILE__), (__LINE__), cw_sbrg->local_result, cw_sbrg->local_error, studyDB.bogusLikelihoods, cw_sbrg->bogusLikelihoods);
-      print_sbrg (cw_sbrg, s->ndim);
-      signal (SIGQUIT, SIG_DFL); // Restore the default handler
-      raise (SIGQUIT); // Make a core dump
-    }
-#else
-    fprintf (stderr, "FATAL - DUMPING (%s:%d), extreme local_result of %g (w/error %g) encountered!\n", (__FILE__), (__LINE__), cw_sbrg->local_result, cw_sbrg->local_error);
-    print_sbrg (cw_sbrg, s->ndim);
-    signal (SIGQUIT, SIG_DFL); // Restore the default handler
-    raise (SIGQUIT); // Make a core dump
-#endif
-  }
+  free (f);
 
 #ifdef STUDYDB
   /* We cannot tolerate ANY bogus likelihoods when we write a cache since the marker set likelihood, which is not a part of any region,
@@ -776,90 +994,72 @@ drlhre_ (dcuhre_state * s, sub_region * cw_sbrg)
 }
 
 
-int dfshre_ (dcuhre_state * s, sub_region * cw_sbrg, double *x, int g_work_col,double *fulsms, double *funvls)
+/* Enumerate the points of the fully symmetric sum for generator column
+   g_work_col: every distinct permutation of the generator, in reverse
+   lexicographic order, with every combination of signs of its nonzero
+   entries. The points are written to pts, NDIM to a point, unless pts is
+   NULL, and their number is returned. This was done anew for every
+   subregion, it is now done once per rule. */
+static int
+enumerate_rule_points (dcuhre_state * s, int g_work_col, double *pts)
 {
-
-  /* Local variables */
-  int i, l, i__1, i__2;
-  double gi, gl;
+  int i, l, i__2, numpts = 0;
+  double gi, gl, *g, *x;
   int ixchng = 0, lxchng = 0;
 
-  *fulsms = 0.;
+  MALCHOKE(g, sizeof (double) * s->ndim * 2, double *);
+  x = g + s->ndim;
+  for (i = 0; i < s->ndim; i++) {
+    g[i] = s->g[i][g_work_col];
+  }
 
-  // fprintf(stderr," sw00 is %G   %p %p\n", s->w[0][0], s->w, s->w[0]);
-  /* Compute centrally symmetric sum for permutation of G */
 L20:
-
   for (i = 0; i < s->ndim; i++) {
-    x[i] = cw_sbrg->center[i] + s->g[i][g_work_col] * cw_sbrg->hwidth[i];
+    x[i] = g[i];
   }
 
 L40:
-  if(s->sampling_mode>0)  
-    (s->funsub) ( x, funvls,s);
-  else
-    (s->funsub) ( x, funvls, &(cw_sbrg->cur_scale));
-
-  if(s->sampling_mode==1)
-    s->sample_pts[s->cur_sample*(s->ndim+1)] = s->cur_weight;
-
-  *fulsms += *funvls;
+  if (pts != NULL)
+    memcpy (&pts[numpts * s->ndim], x, sizeof (double) * s->ndim);
+  numpts++;
 
   for (i = 0; i < s->ndim; i++) {
-    if (fabs (s->g[i][g_work_col]) > 0.000000000001)
-      s->g[i][g_work_col] = -s->g[i][g_work_col];
-    x[i] = cw_sbrg->center[i] + s->g[i][g_work_col] * cw_sbrg->hwidth[i];
-    if (s->g[i][g_work_col] < 0.) {
+    if (fabs (g[i]) > 0.000000000001)
+      g[i] = -g[i];
+    x[i] = g[i];
+    if (g[i] < 0.) {
       goto L40;
     }
   }
-  //fprintf (stderr, "go %f %f %f %f %f\n",s->g[0][g_work_col],s->g[1][g_work_col],s->g[2][g_work_col],s->g[3][g_work_col],s->g[4][g_work_col]);
   /*   Find next distinct permutation of G and loop back for next sum. */
   /*   Permutations are generated in reverse lexicographic order. */
   for (i = 2; i <= s->ndim; i++) {
-    //fprintf (stderr, "i=%d g= %f   g=%f\n",i,s->g[i - 2][g_work_col] , s->g[i-1][g_work_col]);
-    if (s->g[i - 2][g_work_col] > s->g[i - 1][g_work_col]) {
-      gi = s->g[i - 1][g_work_col];
+    if (g[i - 2] > g[i - 1]) {
+      gi = g[i - 1];
       ixchng = i - 1;
       i__2 = (i - 1) / 2;
       for (l = 1; l <= i__2; l++) {
-	gl = s->g[l - 1][g_work_col];
-	s->g[l - 1][g_work_col] = s->g[i - l - 1][g_work_col];
-	s->g[i - l - 1][g_work_col] = gl;
+	gl = g[l - 1];
+	g[l - 1] = g[i - l - 1];
+	g[i - l - 1] = gl;
 	if (gl <= gi) {
 	  --ixchng;
 	}
-	if (s->g[l - 1][g_work_col] > gi) {
-	  //fprintf (stderr, "lxchng =%d is changing to l=%d\n",lxchng,l);
+	if (g[l - 1] > gi) {
 	  lxchng = l;
 	}
-	// fprintf (stderr, "     i=%d  l=%d  IXCHNG =%d, lxchng =%d\n", i, l, ixchng, lxchng);
       }
-      if (s->g[ixchng - 1][g_work_col] <= gi) {
+      if (g[ixchng - 1] <= gi) {
 	ixchng = lxchng;
       }
-      s->g[i - 1][g_work_col] = s->g[ixchng - 1][g_work_col];
-      s->g[ixchng - 1][g_work_col] = gi;
-      //fprintf (stderr, "gf %f %f %f %f %f IXCHNG =%d, lxchng =%d\n",s->g[0][g_work_col],s->g[1][g_work_col],s->g[2][g_work_col],s->g[3][g_work_col],s->g[4][g_work_col], ixchng, lxchng);
+      g[i - 1] = g[ixchng - 1];
+      g[ixchng - 1] = gi;
       goto L20;
     }
-
-/* L80: */
   }
-
-/*     Restore original order to generators */
-  //checkpt();
-  i__1 = s->ndim / 2;
-  for (i = 1; i <= i__1; i++) {
-    gi = s->g[i - 1][g_work_col];
-    s->g[i - 1][g_work_col] = s->g[s->ndim - i][g_work_col];
-    s->g[s->ndim - i][g_work_col] = gi;
-  }
-
-  return 0;
-}				/* End of dfshre_ */
-
-
+  free (g);
+  return numpts;
+}
 
 
 int
@@ -899,6 +1099,19 @@ dinhre_ (dcuhre_state * s)
     }
   }
 
+  /*   Enumerate the points of the fully symmetric sums. */
+  MALCHOKE(s->rule_pts_start, sizeof (int) * (s->wtleng + 1), int *);
+  for (i = 0; i <= 3 && i <= s->wtleng; i++) {
+    s->rule_pts_start[i] = 0;
+  }
+  for (i = 3; i < s->wtleng; i++) {
+    s->rule_pts_start[i + 1] = s->rule_pts_start[i] + enumerate_rule_points (s, i, NULL);
+  }
+  MALCHOKE(s->rule_pts, sizeof (double) * s->ndim * (s->rule_pts_start[s->wtleng] + 1), double *);
+  for (i = 3; i < s->wtleng; i++) {
+    enumerate_rule_points (s, i, &s->rule_pts[s->rule_pts_start[i] * s->ndim]);
+  }
+
   return 0;
 
 }
@@ -1672,6 +1885,8 @@ initialize_state (dcuhre_state * s, double *a, double *b, int dim)
   s->ndim = dim;
   s->xl = a;
   s->xu = b;
+  s->fun_ctx = NULL;
+  s->funbatch = NULL;
 
 
   /* default */
@@ -1706,6 +1921,69 @@ initialize_state (dcuhre_state * s, double *a, double *b, int dim)
   s->vol_rate =1.0;
 
   s->scale=0;
+  s->split_round = 1;
+  s->warm_start = 0;
+
+  return 0;
+}
+
+
+/* Keep a partition of the region for the next integration to start from,
+   of at most s->warm_start subregions. Starting from the subregions this
+   integration started with, the one with the greatest error that was split
+   is replaced by its halves, until there are enough. The splits are thus
+   mostly redone in the order they were made. */
+void
+sbrg_seed_keep (dcuhre_state * s)
+{
+  int *part, numpart, i, k, best;
+  sub_region *cw_sbrg;
+
+  MALCHOKE(part, sizeof (int) * (s->sbrgns + 1), int *);
+  numpart = 0;
+  for (i = 0; i < s->sbrgns; i++) {
+    if (s->sbrg_heap[i]->region_level == 0)
+      part[numpart++] = i;
+  }
+  while (numpart < s->warm_start) {
+    best = -1;
+    for (k = 0; k < numpart; k++) {
+      cw_sbrg = s->sbrg_heap[part[k]];
+      if (cw_sbrg->lchild_id != 0 &&
+	  (best < 0 || cw_sbrg->local_error > s->sbrg_heap[part[best]]->local_error))
+	best = k;
+    }
+    if (best < 0)
+      break;
+    cw_sbrg = s->sbrg_heap[part[best]];
+    part[best] = cw_sbrg->lchild_id;
+    part[numpart++] = cw_sbrg->rchild_id;
+  }
+
+  REALCHOKE(s->seed_sbrg, sizeof (double) * 2 * s->ndim * numpart, double *);
+  for (k = 0; k < numpart; k++) {
+    cw_sbrg = s->sbrg_heap[part[k]];
+    memcpy (&s->seed_sbrg[2 * s->ndim * k], cw_sbrg->center, sizeof (double) * s->ndim);
+    memcpy (&s->seed_sbrg[2 * s->ndim * k + s->ndim], cw_sbrg->hwidth, sizeof (double) * s->ndim);
+  }
+  s->num_seed = numpart;
+  s->seed_ndim = s->ndim;
+  REALCHOKE(s->seed_bounds, sizeof (double) * 2 * s->ndim, double *);
+  memcpy (s->seed_bounds, s->xl, sizeof (double) * s->ndim);
+  memcpy (&s->seed_bounds[s->ndim], s->xu, sizeof (double) * s->ndim);
+  free (part);
+}
+
+
+/* release the partition kept for a warm start */
+int
+sbrg_seed_free (dcuhre_state * s)
+{
+  free (s->seed_sbrg);
+  free (s->seed_bounds);
+  s->seed_sbrg = NULL;
+  s->seed_bounds = NULL;
+  s->num_seed = 0;
 
   return 0;
 }
@@ -1727,18 +2005,17 @@ pow_i (int base, int expo)
 
 
 int
-sbrg_free (sub_region ** sbrg_heap, int maxsub)
+sbrg_free (dcuhre_state * s)
 {
 
-  int i = 0;
-  sub_region *cw_sbrg;
+  void **block;
 
-  while (sbrg_heap[i] != NULL && i < maxsub) {
-    cw_sbrg = sbrg_heap[i];
-    free (cw_sbrg->center);
-    free (cw_sbrg->hwidth);
-    free (sbrg_heap[i++]);
+  while (s->sbrg_pool != NULL) {
+    block = (void **) s->sbrg_pool;
+    s->sbrg_pool = block[0];
+    free (block);
   }
+  s->sbrg_pool_free = 0;
 
   return 0;
 }
@@ -124,6 +124,11 @@ typedef struct{
   int key;                  /* Key to selected local integration rule. */
   double epsabs, epsrel;    /* Requested absolute and relative errors.*/
   U_fp funsub;              /* function subroutin, which is the integrand */
+  void *fun_ctx;            /* passed to funsub as its last argument, so that the integrand
+                               keeps its working data there rather than in globals */
+  U_fp funbatch;            /* the integrand at several points at once, given their number,
+                               their coordinates NDIM to a point, where their values go,
+                               the scale and fun_ctx, or NULL if it can't do that */
   int numfun;               /* number of function which is now 1
                                , which should be changed for integrating vector functions*/ 
 
@@ -148,8 +153,26 @@ typedef struct{
   int maxsub;               /* number of max subregions */
   int minsub;               /* number of min subregions  currently this is not used*/
   int sbrgns;               /* number of current subregeions. Use this for assigning subregion ids*/
+  int split_round;          /* number of subregions with greatest errors split in each
+                               round of the main loop, 1 by default */
+  int warm_start;           /* if positive, start from a partition into at most this many
+                               subregions kept from the previous integration with this
+                               state (see sbrg_seed_keep), 0 by default */
+  double *seed_sbrg;        /* the centers and half widths of that partition, 2*NDIM to
+                               a subregion. Kept across calls, initialize_state leaves them */
+  int num_seed;             /* number of subregions in seed_sbrg */
+  int seed_ndim;            /* NDIM of the integration that left them */
+  double *seed_bounds;      /* and its xl followed by its xu, since a partition is
+                               only reused for the same region */
 
   sub_region **sbrg_heap;   /*array of pointers for subregions*/
+  int *sbrg_queue;          /* max-heap of the ids of the leaf subregions with positive
+                               errors, by greatest local_error then smallest id */
+  int *sbrg_queue_pos;      /* position of each subregion in sbrg_queue, -1 if not there */
+  int queue_len;            /* number of subregions in sbrg_queue */
+  void *sbrg_pool;          /* current block of subregions with their centers and widths,
+                               linked to the previous blocks */
+  int sbrg_pool_free;       /* number of subregions left in the current block */
 
   /* global variables controling the list of subregions*/
   double greate;             /* Greatest error in the current heap*/
@@ -166,6 +189,12 @@ typedef struct{
                                W(I,1), ...,W(I,WTLENG), for I > 1 are null rule weights.*/
   int *rulpts;              /* the number of points produced by 
                                 each generator of the selected rule. */
+  double *rule_pts;         /* every point of the fully symmetric sums of generators
+                               3,...,WTLENG, enumerated once by dinhre_ in the order
+                               drlhre_ evaluates them, as offsets from the center
+                               in half widths, NDIM to a point */
+  int *rule_pts_start;      /* index of the first point of generator J in rule_pts,
+                               with rule_pts_start[WTLENG] the total*/
   double **scales;           /* Scaling factors used to construct new null rules, */
   double **norms;            /* 2**NDIM/(1-norm of the null rule constructed by each of 
                                the scaling factors.) */
@@ -229,11 +258,12 @@ int d09hre_(dcuhre_state *s);
 int d07hre_(dcuhre_state *s);
 int dchhre_(dcuhre_state *s);
 int drlhre_(dcuhre_state *s, sub_region *cw_sbrg);
-int dfshre_(dcuhre_state *s, sub_region *cw_sbrg, double *x, int,double *fulsms, double *funvls);
 
 int print_rule(dcuhre_state *s);
 int pow_i(int,int);     /*  integer pow function */
-int sbrg_free(sub_region ** sr_control, int);
+int sbrg_free(dcuhre_state *s);
+void sbrg_seed_keep(dcuhre_state *s);
+int sbrg_seed_free(dcuhre_state *s);
 int print_sbrg(sub_region *cw_sbrg, int dim);
 
 
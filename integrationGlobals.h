@@ -40,7 +40,12 @@ double alpha[5][2] = { //{0.8, 1.0},  //This is for LOD not for HLOD
 
 int num_alpha=5; 
 
-dcuhre_state *s,init_state;
+dcuhre_state init_state;
+dcuhre_state *s = &init_state;  /* for the likelihood server client, which reports on the integration in progress */
+#ifdef _OPENMP
+#pragma omp threadprivate (s)   /* on this thread, see integrate_2p_dt_concurrently */
+#endif
+integration_context integration_ctx;
 double *xl;   //xl[17] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,0,0 };
 double *xu;   //xu[17] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,1,1 };
 
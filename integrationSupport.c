@@ -45,13 +45,17 @@
 #include "trackProgress.h"
 #include "ppl.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // This will go into a 'client include' for likelihood in the future.
 #define compute_likelihood(pPedigreeList) compute_likelihood(__FILE__, __LINE__, pPedigreeList)
 #define populate_xmission_matrix(pMatrix, totalLoci, prob, prob2, hetProb, cellIndex, lastHetLoc, prevPattern, loc) populate_xmission_matrix(__FILE__, __LINE__, pMatrix, totalLoci, prob, prob2, hetProb, cellIndex, lastHetLoc, prevPattern, loc)
 
 #include "dcuhre.h"
-#include "integrationGlobals.h"
 #include "integrationSupport.h"
+#include "integrationGlobals.h"
 #include "integrationLocals.h"
 
 // Application globals - globals that transcend the current file (module)
@@ -97,10 +101,12 @@ int compare_doubles (const void *a, const void *b) {
   @retval 0 firstArg was zero
 
 */
-int kelvin_dcuhre_integrate (double *integralParam, double *abserrParam, double vol_region, int *scale)
+int kelvin_dcuhre_integrate (dcuhre_state *s, integration_context *ic, double *integralParam, double *abserrParam, double vol_region, int *scale)
 {
 
   /* INPUT
+   * s  : the integrator state, whose warm start partition (if any) is kept across calls
+   * ic : where the integrand finds the bounds and keeps its maximum, see integrationSupport.h
    * vol_region : the volume of the rectangular region
    * (( s->vol_rate is the rate to convert DCUHRE's output into the average))
    * 
@@ -111,10 +117,8 @@ int kelvin_dcuhre_integrate (double *integralParam, double *abserrParam, double
    * 
    * VARIABLE
    * dim : number of variables in the middle layer of the 3-layer approach, which is dim of DCUHRE
-   * s   : sturcture to hold all global information in using DCUHRE
-   * and the only variable to change with different analysis
-   * localMOD : maximum in each BR  
-   * maximization information is in localmax_x[]
+   * ic->localMOD : maximum in each BR  
+   * maximization information is in ic->localmax_x[]
    * boost_rate : BR boosting BR^boost_rate
    * 
    */
@@ -129,7 +133,7 @@ int kelvin_dcuhre_integrate (double *integralParam, double *abserrParam, double
     boost_rate = 1.0;
   //extern /* Subroutine */ int ftest_();  
 
-  localMOD = DBL_MIN_10_EXP;
+  *ic->localMOD = DBL_MIN_10_EXP;
 
   if (modelType->trait == DICHOTOMOUS) {
 
@@ -137,14 +141,15 @@ int kelvin_dcuhre_integrate (double *integralParam, double *abserrParam, double
     if (modelOptions->imprintingFlag)
       dim += modelRange->nlclass;       //dD
 
-    s = &init_state;
-    initialize_state (s, xl, xu, dim);
+    initialize_state (s, ic->xl, ic->xu, dim);
 
     if (modelType->type == TP) {
       s->funsub = (U_fp) compute_hlod_2p_dt;
+      s->funbatch = (U_fp) compute_hlod_2p_dt_batch;
       s->mType = TP_DT;
     } else {
       s->funsub = (U_fp) compute_hlod_mp_dt;
+      s->funbatch = (U_fp) compute_hlod_mp_batch;
       s->mType = MP_DT;
     }
   } else {      /*  QT or combined */
@@ -161,14 +166,15 @@ int kelvin_dcuhre_integrate (double *integralParam, double *abserrParam, double
       }
     }
 
-    s = &init_state;
-    initialize_state (s, xl, xu, dim);
+    initialize_state (s, ic->xl, ic->xu, dim);
 
     if (modelType->type == TP) {
       s->funsub = (U_fp) compute_hlod_2p_qt;
+      s->funbatch = (U_fp) compute_hlod_2p_qt_batch;
       s->mType = TP_DT;
     } else {
       s->funsub = (U_fp) compute_hlod_mp_qt;
+      s->funbatch = (U_fp) compute_hlod_mp_batch;
       s->mType = MP_DT;
     }
   }
@@ -179,6 +185,10 @@ int kelvin_dcuhre_integrate (double *integralParam, double *abserrParam, double
   else
     s->maxcls = 100000 * (int) pow (2.0, dim);
 
+  s->fun_ctx = ic;
+  ic->ndim = dim;
+  s->split_round = modelOptions->splitsPerIteration;
+  s->warm_start = modelOptions->warmStart;
   s->nlclass = modelRange->nlclass;
   s->aim_diff_suc = 3 * s->nlclass;
   s->aim_num_smallBR = 5 * s->nlclass;
@@ -238,20 +248,38 @@ int kelvin_dcuhre_integrate (double *integralParam, double *abserrParam, double
 }
 
 
-void compute_hlod_mp_qt (double x[], double *f, int *scale)
+/*
+  Count the liability classes of the current QT trait model, as set up
+  in pTrait, that are outside the hard coded constraint.
+*/
+static void check_qt_constraint (double gfreq)
 {
+  int liabIdxLocal;
+  double constraint;
 
-  int k, j;
-  int pedIdx, liabIdxLocal = 0, statusLocal, pen_size = 3;
-  double constraint = 0.0;
-  double mean_DD = 0.0, mean_Dd = 0.0, mean_dD = 0.0, mean_dd = 0.0;
-  double SD_DD = 0.0, SD_Dd = 0.0, SD_dD = 0.0, SD_dd = 0.0;
-  double gfreq;
-  double alphaV;
-  double threshold = 0.0;
-  double log10_likelihood_null, log10_likelihood_alternative, log10_likelihood_ratio, likelihood_ratio;
-  double hetLR, log10HetLR, homoLR, alphaV2,tmp;
-  double alpha_integral = 0.0, avg_hetLR;
+  if (modelType->distrib == QT_FUNCTION_CHI_SQUARE)
+    return;
+  for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
+    constraint = (1.0 - gfreq) * (1.0 - gfreq) * pTrait->means[liabIdxLocal][1][1] * pTrait->stddev[liabIdxLocal][1][1] +
+        2 * gfreq * (1.0 - gfreq) * pTrait->means[liabIdxLocal][0][1] * pTrait->stddev[liabIdxLocal][0][1] +
+        gfreq * gfreq * pTrait->means[liabIdxLocal][0][0] * pTrait->stddev[liabIdxLocal][0][0];
+    if (constraint >= 3.0 || constraint <= -3.0) {
+      // fprintf(stderr,"Constraint is %f \n", constraint);
+      num_out_constraint++;
+    }
+  }
+}
+
+/*
+  Compute the null likelihood of a multipoint point, that of the trait
+  alone, from each pedigree's trait likelihood polynomial (or by
+  peeling), keeping them in pedigreeSet.nullLikelihood and the log10 of
+  their product in log10_likelihood_null. Returns FALSE if a pedigree's
+  likelihood is zero in a QT analysis, in which case f is 1.
+*/
+static int compute_mp_null (double *f, double *log10_likelihood_null)
+{
+  int pedIdx, statusLocal;
   double log10Likelihood;
 
   /* for null likelihood calculation */
@@ -260,23 +288,112 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
 
   Pedigree *pPedigreeLocal;
 
-  int newscale, oldscale;       /* scaling related variables */
-  double newLog10HetLR;
-  double oldsum;
-  double oldsum_log10;
-  double newsum_log10;
-
-  if (modelOptions->imprintingFlag)
-    pen_size = 4;
-
   int origLocus = analysisLocusList->pLocusIndex[0];
 
   if (analysisLocusList->numLocus > 1)
     origLocus = analysisLocusList->pLocusIndex[1];
 
+  /* for trait likelihood */
+  analysisLocusList = &traitLocusList;
+  xmissionMatrix = traitMatrix;
+
+  /* compute the null likelihood with   */
+  pedigreeSet.likelihood = 1;
+  pedigreeSet.log10Likelihood = 0;
+
+  for (pedIdx = 0; pedIdx < pedigreeSet.numPedigree; pedIdx++) {
+    /* save the likelihood at null */
+    pPedigreeLocal = pedigreeSet.ppPedigreeSet[pedIdx];
+
+    if (modelOptions->polynomial == TRUE) {
+      ASSERT (pPedigreeLocal->traitLikelihoodPolynomial != NULL, "Pedigree trait likelihood is NULL");
+      /* evaluate likelihood */
+      evaluatePoly (pPedigreeLocal->traitLikelihoodPolynomial, pPedigreeLocal->traitLikelihoodPolyList, &pPedigreeLocal->likelihood);
+
+      if (modelType->trait == DT && isnan (pPedigreeLocal->likelihood))
+        ERROR ("Null hypothesis likelihood is not a number");
+
+    } else {
+      initialize_multi_locus_genotype (pPedigreeLocal);
+      statusLocal = compute_pedigree_likelihood (pPedigreeLocal);
+    }
+
+    /*pPedigreeLocal->likelihood is now computed and now check it */
+    if (pPedigreeLocal->likelihood == 0.0) {
+      if (modelType->trait == DT) {
+        WARNING ("Pedigree %s has likelihood of zero or nearly zero", pPedigreeLocal->sPedigreeID);
+        product_likelihood = 0.0;
+        sum_log_likelihood = -9999.99;
+        break;
+      }
+      if (modelRange->atypicalQtTrait)
+        WARNING ("Pedigree %s has likelihood of zero or nearly zero", pPedigreeLocal->sPedigreeID);
+      else
+        ERROR ("Pedigree %s has likelihood of zero or nearly zero", pPedigreeLocal->sPedigreeID);
+
+      f[0] = 1.0;
+      return FALSE;
+    } else if (pPedigreeLocal->likelihood < 0.0) {
+      ASSERT (pPedigreeLocal->likelihood >= 0.0, "Pedigree %s has negative likelihood", pPedigreeLocal->sPedigreeID);
+      product_likelihood = 0.0;
+      sum_log_likelihood = -9999.99;
+      break;
+    } else {
+      if (pPedigreeLocal->pCount[origLocus] == 1) {
+        product_likelihood *= pPedigreeLocal->likelihood;
+        log10Likelihood = log10 (pPedigreeLocal->likelihood);
+      } else {
+        product_likelihood *= pow (pPedigreeLocal->likelihood, pPedigreeLocal->pCount[origLocus]);
+        log10Likelihood = log10 (pPedigreeLocal->likelihood) * pPedigreeLocal->pCount[origLocus];
+      }
+      sum_log_likelihood += log10Likelihood;
+    }
+    pedigreeSet.nullLikelihood[pedIdx] = pPedigreeLocal->likelihood;
+  }
+
+  pedigreeSet.likelihood = product_likelihood;
+  pedigreeSet.log10Likelihood = sum_log_likelihood;
+  *log10_likelihood_null = pedigreeSet.log10Likelihood;
+  DIAG (OVERALL, 1, {
+        fprintf (stderr, "Sum of log Likelihood is: %e\n", sum_log_likelihood);
+      }
+  );
+  return TRUE;
+}
+
+/* Set up the alternative hypothesis of a multipoint point, the trait locus among the markers */
+static void set_mp_alternative ()
+{
+  analysisLocusList = &savedLocusList;
+  xmissionMatrix = altMatrix;
+  if (modelType->trait == DT || modelOptions->polynomial == TRUE);
+  else
+    /*statusLocal = */populate_xmission_matrix (xmissionMatrix, totalLoci, initialProbAddr, /* probability */
+        initialProbAddr2,       /* probability */
+        initialHetProbAddr, 0,  /* cell index */
+        -1, -1, /* last het locus & last het pattern (P-1 or M-2) */
+        0);     /* current locus - start with 0 */
+}
+
+/*
+  Set up the trait model of a compute_hlod_mp_qt point: gene frequency,
+  means, standard deviations and threshold, both where the likelihood
+  code looks for them and in ic->curModel.
+*/
+static void set_mp_qt_model (double x[], integration_context *ic)
+{
+  int j, liabIdxLocal = 0, pen_size = 3;
+  double mean_DD = 0.0, mean_Dd = 0.0, mean_dD = 0.0, mean_dd = 0.0;
+  double SD_DD = 0.0, SD_Dd = 0.0, SD_dD = 0.0, SD_dd = 0.0;
+  double gfreq;
+  double threshold = 0.0;
+
+  if (modelOptions->imprintingFlag)
+    pen_size = 4;
+
   gfreq = x[0];
   //if (fpIR != NULL)
-    dk_curModel.dgf = gfreq;
+    ic->curModel->dgf = gfreq;
 
   pLocus->pAlleleFrequency[0] = gfreq;
   pLocus->pAlleleFrequency[1] = 1 - gfreq;
@@ -291,31 +408,31 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
     //if (modelRange->tthresh[0][0]>=modelRange->tthresh[0][1]-1.0e-10){
       threshold = modelRange->tthresh[0][0];
     }else{
-      threshold = x[s->ndim - 1];
+      threshold = x[ic->ndim - 1];
     }
   }
   for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
     /*mean_DD = x[j];
-    mean_Dd = (x[j + 1] - xl[j + 1]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 1];
+    mean_Dd = (x[j + 1] - ic->xl[j + 1]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 1];
 
     if (modelOptions->imprintingFlag) {
-      mean_dD = (x[j + 2] - xl[j + 2]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 2];
-      mean_dd = (x[j + 3] - xl[j + 3]) * (x[j + 2] - xl[j + 2]) / (xu[j + 2] - xl[j + 2]) * (x[j + 1] - xl[j + 1]) / (xu[j + 1] - xl[j + 1]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 3];
+      mean_dD = (x[j + 2] - ic->xl[j + 2]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 2];
+      mean_dd = (x[j + 3] - ic->xl[j + 3]) * (x[j + 2] - ic->xl[j + 2]) / (ic->xu[j + 2] - ic->xl[j + 2]) * (x[j + 1] - ic->xl[j + 1]) / (ic->xu[j + 1] - ic->xl[j + 1]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 3];
     } else {
-      mean_dd = (x[j + 2] - xl[j + 2]) * (x[j + 1] - xl[j + 1]) / (xu[j + 1] - xl[j + 1]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 2];
+      mean_dd = (x[j + 2] - ic->xl[j + 2]) * (x[j + 1] - ic->xl[j + 1]) / (ic->xu[j + 1] - ic->xl[j + 1]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 2];
       mean_dD = mean_Dd;
     }
     j += pen_size;*/
 
     if ((modelOptions->qtMeanMode==PARAM_MODE_VARY)||(modelType->distrib == QT_FUNCTION_CHI_SQUARE)) {
       mean_DD = x[j];
-      mean_Dd = (x[j + 1] - xl[j + 1]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 1];
+      mean_Dd = (x[j + 1] - ic->xl[j + 1]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 1];
 
       if (modelOptions->imprintingFlag) {
-        mean_dD = (x[j + 2] - xl[j + 2]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 2];
-        mean_dd = (x[j + 3] - xl[j + 3]) * (x[j + 2] - xl[j + 2]) / (xu[j + 2] - xl[j + 2]) * (x[j + 1] - xl[j + 1]) / (xu[j + 1] - xl[j + 1]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 3];
+        mean_dD = (x[j + 2] - ic->xl[j + 2]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 2];
+        mean_dd = (x[j + 3] - ic->xl[j + 3]) * (x[j + 2] - ic->xl[j + 2]) / (ic->xu[j + 2] - ic->xl[j + 2]) * (x[j + 1] - ic->xl[j + 1]) / (ic->xu[j + 1] - ic->xl[j + 1]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 3];
       } else {
-        mean_dd = (x[j + 2] - xl[j + 2]) * (x[j + 1] - xl[j + 1]) / (xu[j + 1] - xl[j + 1]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 2];
+        mean_dd = (x[j + 2] - ic->xl[j + 2]) * (x[j + 1] - ic->xl[j + 1]) / (ic->xu[j + 1] - ic->xl[j + 1]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 2];
         mean_dD = mean_Dd;
       }
       j += pen_size;
@@ -327,10 +444,10 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
     }
 
     //if (fpIR != NULL) {
-      dk_curModel.pen[liabIdxLocal].DD = deNormalizeMean (modelType, mean_DD);
-      dk_curModel.pen[liabIdxLocal].Dd = deNormalizeMean (modelType, mean_Dd);
-      dk_curModel.pen[liabIdxLocal].dD = deNormalizeMean (modelType, mean_dD);
-      dk_curModel.pen[liabIdxLocal].dd = deNormalizeMean (modelType, mean_dd);
+      ic->curModel->pen[liabIdxLocal].DD = deNormalizeMean (modelType, mean_DD);
+      ic->curModel->pen[liabIdxLocal].Dd = deNormalizeMean (modelType, mean_Dd);
+      ic->curModel->pen[liabIdxLocal].dD = deNormalizeMean (modelType, mean_dD);
+      ic->curModel->pen[liabIdxLocal].dd = deNormalizeMean (modelType, mean_dd);
       //}
 
 
@@ -366,17 +483,17 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
       //SD_DD = SD_Dd = SD_dD = SD_dd = x[j++];
 
       //if (fpIR != NULL) {
-        dk_curModel.pen[liabIdxLocal].DDSD = deNormalizeStdev (modelType, SD_DD);
-        dk_curModel.pen[liabIdxLocal].DdSD = deNormalizeStdev (modelType, SD_Dd);
-        dk_curModel.pen[liabIdxLocal].dDSD = deNormalizeStdev (modelType, SD_dD);
-        dk_curModel.pen[liabIdxLocal].ddSD = deNormalizeStdev (modelType, SD_dd);
+        ic->curModel->pen[liabIdxLocal].DDSD = deNormalizeStdev (modelType, SD_DD);
+        ic->curModel->pen[liabIdxLocal].DdSD = deNormalizeStdev (modelType, SD_Dd);
+        ic->curModel->pen[liabIdxLocal].dDSD = deNormalizeStdev (modelType, SD_dD);
+        ic->curModel->pen[liabIdxLocal].ddSD = deNormalizeStdev (modelType, SD_dd);
 	//}
 
     }
     
     //if (fpIR != NULL) {
       if (modelType->trait == CT)
-        dk_curModel.pen[liabIdxLocal].threshold = deNormalizeMean (modelType, threshold);
+        ic->curModel->pen[liabIdxLocal].threshold = deNormalizeMean (modelType, threshold);
     //}
 
     /* threshold for QT *
@@ -385,19 +502,6 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
      * j++;
      * } */
 
-    /* check against the hard coded constraint */
-    if (modelType->distrib != QT_FUNCTION_CHI_SQUARE) {
-      constraint = (1.0 - gfreq) * (1.0 - gfreq) * mean_dd * SD_dd + 2 * gfreq * (1.0 - gfreq)
-          * mean_Dd * SD_Dd + gfreq * gfreq * mean_DD * SD_DD;
-      /* fprintf(stderr, "constraint: %f gfreq:%f DD (%f,%f) Dd(%f,%f) dd(%f,%f)\n",
-       * constraint, gfreq, mean_DD, SD_DD, mean_Dd, SD_DD, mean_dd, SD_dd);
-       */
-      if (constraint >= 3.0 || constraint <= -3.0) {
-        // fprintf(stderr,"Constraint is %f \n", constraint);
-        num_out_constraint++;
-      }
-    }
-
     pTrait->means[liabIdxLocal][0][0] = mean_DD;
     pTrait->means[liabIdxLocal][0][1] = mean_Dd;
     pTrait->means[liabIdxLocal][1][0] = mean_dD;
@@ -418,98 +522,29 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
     /* only need to update trait locus */
     update_penetrance (&pedigreeSet, traitLocus);
 #endif
+}
 
-  /* for trait likelihood */
-  analysisLocusList = &traitLocusList;
-  xmissionMatrix = traitMatrix;
-
-  /* compute the null likelihood with   */
-  pedigreeSet.likelihood = 1;
-  pedigreeSet.log10Likelihood = 0;
-
-  for (pedIdx = 0; pedIdx < pedigreeSet.numPedigree; pedIdx++) {
-    /* save the likelihood at null */
-    pPedigreeLocal = pedigreeSet.ppPedigreeSet[pedIdx];
-
-    if (modelOptions->polynomial == TRUE) {
-      ASSERT (pPedigreeLocal->traitLikelihoodPolynomial != NULL, "Trait likelihood polynomial is NULL");
-      /* evaluate likelihood */
-      evaluatePoly (pPedigreeLocal->traitLikelihoodPolynomial, pPedigreeLocal->traitLikelihoodPolyList, &pPedigreeLocal->likelihood);
-    } else {
-      initialize_multi_locus_genotype (pPedigreeLocal);
-      statusLocal = compute_pedigree_likelihood (pPedigreeLocal);
-    }
-
-    /*pPedigreeLocal->likelihood is now computed and now check it */
-    if (pPedigreeLocal->likelihood == 0.0) {
-      if (modelRange->atypicalQtTrait)
-        WARNING ("Pedigree %s has likelihood of zero or nearly zero", pPedigreeLocal->sPedigreeID);
-      else
-        ERROR ("Pedigree %s has likelihood of zero or nearly zero", pPedigreeLocal->sPedigreeID);
-      product_likelihood = 0.0;
-      sum_log_likelihood = -9999.99;
-
-      f[0] = 1.0;
-      return;
-      //       break;
-    } else if (pPedigreeLocal->likelihood < 0.0) {
-      ASSERT (pPedigreeLocal->likelihood >= 0.0, "Pedigree %s has negative likelihood", pPedigreeLocal->sPedigreeID);
-      product_likelihood = 0.0;
-      sum_log_likelihood = -9999.99;
-      break;
-    } else {
-      if (pPedigreeLocal->pCount[origLocus] == 1) {
-        product_likelihood *= pPedigreeLocal->likelihood;
-        log10Likelihood = log10 (pPedigreeLocal->likelihood);
-      } else {
-        product_likelihood *= pow (pPedigreeLocal->likelihood, pPedigreeLocal->pCount[origLocus]);
-        log10Likelihood = log10 (pPedigreeLocal->likelihood) * pPedigreeLocal->pCount[origLocus];
-      }
-      sum_log_likelihood += log10Likelihood;
-    }
-    pedigreeSet.nullLikelihood[pedIdx] = pPedigreeLocal->likelihood;
-  }
-
-  pedigreeSet.likelihood = product_likelihood;
-  pedigreeSet.log10Likelihood = sum_log_likelihood;
-  log10_likelihood_null = pedigreeSet.log10Likelihood;
-  DIAG (OVERALL, 1, {
-        fprintf (stderr, "Sum of log Likelihood is: %e\n", sum_log_likelihood);
-      }
-  );
-
-  /* This is for alternative likelihood */
-  analysisLocusList = &savedLocusList;
-  xmissionMatrix = altMatrix;
-  if (modelOptions->polynomial == TRUE);
-  else
-    statusLocal = populate_xmission_matrix (xmissionMatrix, totalLoci, initialProbAddr, /* probability */
-        initialProbAddr2,       /* probability */
-        initialHetProbAddr, 0,  /* cell index */
-        -1, -1, /* last het locus & last het pattern (P-1 or M-2) */
-        0);     /* current locus - start with 0 */
-
+/* Compute the HLOD of a compute_hlod_mp_qt point from the pedigree likelihoods
+   under the alternative hypothesis and those kept by compute_mp_null */
+static void finish_mp_qt (double x[], double *f, int *scale, integration_context *ic, double log10_likelihood_null)
+{
+  int j, k;
+  int pedIdx, liabIdxLocal = 0, pen_size = 3;
+  double alphaV;
+  double log10_likelihood_alternative, log10_likelihood_ratio, likelihood_ratio;
+  double hetLR, log10HetLR, homoLR, alphaV2, tmp;
+  double alpha_integral = 0.0, avg_hetLR;
 
-  char markerNo[8];
-  sprintf (partialPolynomialFunctionName, "MQA_LC%d_C%d_P%%sM", modelRange->nlclass, (originalLocusList.ppLocusList[1])->pMapUnit->chromosome);
-  for (k = 0; k < modelType->numMarkers; k++) {
-    if (traitPos <= *get_map_position (markerLocusList.pLocusIndex[k]) && (strstr (partialPolynomialFunctionName, "_T") == NULL))
-      strcat (partialPolynomialFunctionName, "_T");
-    sprintf (markerNo, "_%d", markerLocusList.pLocusIndex[k]);
-    strcat (partialPolynomialFunctionName, markerNo);
-  }
-  if (strstr (partialPolynomialFunctionName, "_T") == NULL)
-    strcat (partialPolynomialFunctionName, "_T");
+  Pedigree *pPedigreeLocal;
 
-  //fprintf(stderr," Calling compute_likelihood in comput_mp_qt function \n ");
-  compute_likelihood (&pedigreeSet);
-   
-  cL[3]++; // MP QT alternative likelihood
-#ifdef STUDYDB
-    if (toupper(*studyDB.role) == 'S') 
-      return;
-#endif
+  int newscale, oldscale;       /* scaling related variables */
+  double newLog10HetLR;
+  double oldsum;
+  double oldsum_log10;
+  double newsum_log10;
 
+  if (modelOptions->imprintingFlag)
+    pen_size = 4;
 
   log10_likelihood_alternative = pedigreeSet.log10Likelihood;
   if (isnan (log10_likelihood_alternative))
@@ -574,26 +609,26 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
 
       }
 
-      dk_curModel.alpha = alphaV;
+      ic->curModel->alpha = alphaV;
       if (fpIR != NULL) {
         fprintf (fpIR, "%6.3f", log10HetLR);
 
-        fprintf (fpIR, " %4.3f %4.3f", dk_curModel.alpha, dk_curModel.dgf);
+        fprintf (fpIR, " %4.3f %4.3f", ic->curModel->alpha, ic->curModel->dgf);
         for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
-          fprintf (fpIR, " %4.3f %4.3f", dk_curModel.pen[liabIdxLocal].DD, dk_curModel.pen[liabIdxLocal].Dd);
+          fprintf (fpIR, " %4.3f %4.3f", ic->curModel->pen[liabIdxLocal].DD, ic->curModel->pen[liabIdxLocal].Dd);
           if (modelOptions->imprintingFlag) {
-            fprintf (fpIR, " %4.3f %4.3f", dk_curModel.pen[liabIdxLocal].dD, dk_curModel.pen[liabIdxLocal].dd);
+            fprintf (fpIR, " %4.3f %4.3f", ic->curModel->pen[liabIdxLocal].dD, ic->curModel->pen[liabIdxLocal].dd);
           } else {
-            fprintf (fpIR, " %4.3f", dk_curModel.pen[liabIdxLocal].dd);
+            fprintf (fpIR, " %4.3f", ic->curModel->pen[liabIdxLocal].dd);
           }
           if (modelType->distrib != QT_FUNCTION_CHI_SQUARE) {
-            fprintf (fpIR, " %4.3f %4.3f %4.3f", dk_curModel.pen[liabIdxLocal].DDSD,dk_curModel.pen[liabIdxLocal].DdSD,dk_curModel.pen[liabIdxLocal].ddSD);
+            fprintf (fpIR, " %4.3f %4.3f %4.3f", ic->curModel->pen[liabIdxLocal].DDSD,ic->curModel->pen[liabIdxLocal].DdSD,ic->curModel->pen[liabIdxLocal].ddSD);
           }
         }
         if (modelType->trait == CT) {
-          fprintf (fpIR, " %4.3f", dk_curModel.pen[0].threshold);
+          fprintf (fpIR, " %4.3f", ic->curModel->pen[0].threshold);
         }
-        fprintf (fpIR, " %d\n", dk_curModel.posIdx);
+        fprintf (fpIR, " %d\n", ic->curModel->posIdx);
       }
 
       oldsum = alpha_integral;
@@ -636,46 +671,46 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
 
 
       /*Update local maximum as necessary */
-      if (log10HetLR > localMOD) {
-        localMOD = log10HetLR;
+      if (log10HetLR > *ic->localMOD) {
+        *ic->localMOD = log10HetLR;
 
-        dk_copyMaxModel2(&dk_localmax, &dk_curModel);  // copy localmax to globalmax 7/26/2018        
+        dk_copyMaxModel2(ic->localmax, ic->curModel);  // copy localmax to globalmax 7/26/2018        
         /*
-        localmax_x[0] = gfreq;
-        localmax_x[1] = alphaV;
+        ic->localmax_x[0] = gfreq;
+        ic->localmax_x[1] = alphaV;
         k = 2;
         for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
 
           if (modelOptions->qtMeanMode==PARAM_MODE_VARY){
-	    localmax_x[k] = x[k - 1];
-	    localmax_x[k + 1] = (x[k] - xl[k]) * (x[k - 1] - xl[k - 1]) / (xu[k - 1] - xl[k - 1]) + xl[k];
+	    ic->localmax_x[k] = x[k - 1];
+	    ic->localmax_x[k + 1] = (x[k] - ic->xl[k]) * (x[k - 1] - ic->xl[k - 1]) / (ic->xu[k - 1] - ic->xl[k - 1]) + ic->xl[k];
 
 	    if (modelOptions->imprintingFlag) {
-	      localmax_x[k + 2] = (x[k + 1] - xl[k + 1]) * (x[k - 1] - xl[k - 1]) / (xu[k - 1] - xl[k - 1]) + xl[k + 1];
-	      localmax_x[k + 3] = (x[k + 2] - xl[k + 2]) * (x[k + 1] - xl[k + 1]) / (xu[k + 1] - xl[k + 1]) * (x[k] - xl[k]) / (xu[k] - xl[k]) * (x[k - 1] - xl[k - 1]) / (xu[k - 1] - xl[k - 1]) + xl[k + 2];
+	      ic->localmax_x[k + 2] = (x[k + 1] - ic->xl[k + 1]) * (x[k - 1] - ic->xl[k - 1]) / (ic->xu[k - 1] - ic->xl[k - 1]) + ic->xl[k + 1];
+	      ic->localmax_x[k + 3] = (x[k + 2] - ic->xl[k + 2]) * (x[k + 1] - ic->xl[k + 1]) / (ic->xu[k + 1] - ic->xl[k + 1]) * (x[k] - ic->xl[k]) / (ic->xu[k] - ic->xl[k]) * (x[k - 1] - ic->xl[k - 1]) / (ic->xu[k - 1] - ic->xl[k - 1]) + ic->xl[k + 2];
 	    } else {
-	      localmax_x[k + 2] = (x[k + 1] - xl[k + 1]) * (x[k] - xl[k]) / (xu[k] - xl[k]) * (x[k - 1] - xl[k - 1]) / (xu[k - 1] - xl[k - 1]) + xl[k + 1];
+	      ic->localmax_x[k + 2] = (x[k + 1] - ic->xl[k + 1]) * (x[k] - ic->xl[k]) / (ic->xu[k] - ic->xl[k]) * (x[k - 1] - ic->xl[k - 1]) / (ic->xu[k - 1] - ic->xl[k - 1]) + ic->xl[k + 1];
 	    }
 	    k += pen_size;
           }else if(modelOptions->qtMeanMode==PARAM_MODE_SAME){
-	    localmax_x[k] = x[k - 1];  // mean_DD, mean_Dd, mean_dD, mean_dd
+	    ic->localmax_x[k] = x[k - 1];  // mean_DD, mean_Dd, mean_dD, mean_dd
 	    k++;
 	  } // PARAM_MODE_FIXED must be taken care directly.
 
 	  if (modelType->distrib != QT_FUNCTION_CHI_SQUARE) {
             if (modelOptions->qtStandardDevMode==PARAM_MODE_SAME){
 	      
-	      localmax_x[k] = x[k - 1];
+	      ic->localmax_x[k] = x[k - 1];
 	      k++;
 	    }else if(modelOptions->qtStandardDevMode==PARAM_MODE_VARY){
-	      localmax_x[k ] = x[k-1]; // SD_DD 
+	      ic->localmax_x[k ] = x[k-1]; // SD_DD 
 	      if (modelOptions->imprintingFlag) {
-		localmax_x[k + 1] = x[k]; //SD_Dd;
-		localmax_x[k + 2] = x[k + 1]; //SD_dD
-		localmax_x[k + 3] = x[k + 2]; //SD_dd
+		ic->localmax_x[k + 1] = x[k]; //SD_Dd;
+		ic->localmax_x[k + 2] = x[k + 1]; //SD_dD
+		ic->localmax_x[k + 3] = x[k + 2]; //SD_dd
 	      } else {
-		localmax_x[k + 1] = x[k]; // SD_Dd;
-		localmax_x[k + 2] = x[k + 1]; // SD_Dd;
+		ic->localmax_x[k + 1] = x[k]; // SD_Dd;
+		ic->localmax_x[k + 2] = x[k + 1]; // SD_Dd;
 	      }
 	      k += pen_size;
 	    }
@@ -684,7 +719,7 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
         }// end of for
         if (modelType->trait == CT) {
 	  if (modelRange->tthresh[0][0]<=modelRange->tthresh[0][1]+1.0e-10){	  
-	    localmax_x[k] = x[k - 1];
+	    ic->localmax_x[k] = x[k - 1];
 	    k++;
 	  }
         }
@@ -702,13 +737,13 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
     if ((modelOptions->qtMeanMode==PARAM_MODE_VARY)||(modelType->distrib == QT_FUNCTION_CHI_SQUARE) ){  
       k = 1; // starting index of penetrance
       for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
-	avg_hetLR *= (x[k] - xl[k]) / (xu[k] - xl[k]);
-	avg_hetLR *= (x[k] - xl[k]) / (xu[k] - xl[k]);
-	avg_hetLR *= (x[k + 1] - xl[k + 1]) / (xu[k + 1] - xl[k + 1]);
+	avg_hetLR *= (x[k] - ic->xl[k]) / (ic->xu[k] - ic->xl[k]);
+	avg_hetLR *= (x[k] - ic->xl[k]) / (ic->xu[k] - ic->xl[k]);
+	avg_hetLR *= (x[k + 1] - ic->xl[k + 1]) / (ic->xu[k + 1] - ic->xl[k + 1]);
 
 	if (modelOptions->imprintingFlag) {
-	  avg_hetLR *= (x[k] - xl[k]) / (xu[k] - xl[k]);
-	  avg_hetLR *= (x[k + 2] - xl[k + 2]) / (xu[k + 2] - xl[k + 2]);
+	  avg_hetLR *= (x[k] - ic->xl[k]) / (ic->xu[k] - ic->xl[k]);
+	  avg_hetLR *= (x[k + 2] - ic->xl[k + 2]) / (ic->xu[k + 2] - ic->xl[k + 2]);
 	}
 
 	k += pen_size;
@@ -725,45 +760,61 @@ void compute_hlod_mp_qt (double x[], double *f, int *scale)
   f[0] = avg_hetLR;
 }
 
-
-void compute_hlod_mp_dt (double x[], double *f, int *scale)
+void compute_hlod_mp_qt (double x[], double *f, int *scale, void *ctx)
 {
 
-  int j;
-  int pedIdx, liabIdxLocal, statusLocal, pen_size = 3, ret;
+  integration_context *ic = (integration_context *) ctx;
+  int k;
+  double log10_likelihood_null;
+  char markerNo[8];
 
-  double pen_DD, pen_Dd, pen_dD, pen_dd, gfreq, alphaV;
-  double log10_likelihood_null, log10_likelihood_alternative, log10_likelihood_ratio, likelihood_ratio;
-  double hetLR, log10HetLR, homoLR, alphaV2, tmp;
-  double alpha_integral = 0.0, avg_hetLR;
-  double log10Likelihood;
+  set_mp_qt_model (x, ic);
+  check_qt_constraint (x[0]);
+  if (!compute_mp_null (f, &log10_likelihood_null))
+    return;
 
-  /* for null likelihood calculation */
-  double product_likelihood = 1;        /* product of the likelihoods for all the pedigrees */
-  double sum_log_likelihood = 0;        /* sum of the log10(likelihood) for all the pedigrees */
+  /* This is for alternative likelihood */
+  set_mp_alternative ();
 
-  Pedigree *pPedigreeLocal;
+  sprintf (partialPolynomialFunctionName, "MQA_LC%d_C%d_P%%sM", modelRange->nlclass, (originalLocusList.ppLocusList[1])->pMapUnit->chromosome);
+  for (k = 0; k < modelType->numMarkers; k++) {
+    if (traitPos <= *get_map_position (markerLocusList.pLocusIndex[k]) && (strstr (partialPolynomialFunctionName, "_T") == NULL))
+      strcat (partialPolynomialFunctionName, "_T");
+    sprintf (markerNo, "_%d", markerLocusList.pLocusIndex[k]);
+    strcat (partialPolynomialFunctionName, markerNo);
+  }
+  if (strstr (partialPolynomialFunctionName, "_T") == NULL)
+    strcat (partialPolynomialFunctionName, "_T");
 
-  int newscale, oldscale;       /* scaling related variables */
-  double newLog10HetLR;
-  double oldsum;
-  double oldsum_log10;
-  double newsum_log10;
+  //fprintf(stderr," Calling compute_likelihood in comput_mp_qt function \n ");
+  compute_likelihood (&pedigreeSet);
+   
+  cL[3]++; // MP QT alternative likelihood
+#ifdef STUDYDB
+    if (toupper(*studyDB.role) == 'S') 
+      return;
+#endif
 
-  //    fprintf(stderr, "        Before avg hetLR calculation mp dt\n");
+  finish_mp_qt (x, f, scale, ic, log10_likelihood_null);
+}
 
-  int origLocus = analysisLocusList->pLocusIndex[0];
+
+/*
+  Set up the trait model of a compute_hlod_mp_dt point: gene frequency
+  and penetrances, both where the likelihood code looks for them and in
+  ic->curModel.
+*/
+static void set_mp_dt_model (double x[], integration_context *ic)
+{
+  int liabIdxLocal, pen_size = 3;
+  double pen_DD, pen_Dd, pen_dD, pen_dd, gfreq;
 
   if (modelOptions->imprintingFlag)
     pen_size = 4;
 
-  if (analysisLocusList->numLocus > 1)
-    origLocus = analysisLocusList->pLocusIndex[1];
-
-  //fprintf(stderr,"in compute hlod x %G %G %G %G\n", x[0],x[1],x[2],x[3]);
   gfreq = x[0];
   //  if (fpIR != NULL)
-    dk_curModel.dgf = gfreq;
+    ic->curModel->dgf = gfreq;
 
   for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
     pen_DD = x[pen_size * liabIdxLocal + 1];
@@ -777,10 +828,10 @@ void compute_hlod_mp_dt (double x[], double *f, int *scale)
       pen_dD = pen_Dd;
     }
     //if (fpIR != NULL) {
-      dk_curModel.pen[liabIdxLocal].DD = pen_DD;
-      dk_curModel.pen[liabIdxLocal].Dd = pen_Dd;
-      dk_curModel.pen[liabIdxLocal].dD = pen_dD;
-      dk_curModel.pen[liabIdxLocal].dd = pen_dd;
+      ic->curModel->pen[liabIdxLocal].DD = pen_DD;
+      ic->curModel->pen[liabIdxLocal].Dd = pen_Dd;
+      ic->curModel->pen[liabIdxLocal].dD = pen_dD;
+      ic->curModel->pen[liabIdxLocal].dd = pen_dd;
       //}
 
     pTrait->penetrance[2][liabIdxLocal][0][0] = pen_DD;
@@ -807,94 +858,29 @@ void compute_hlod_mp_dt (double x[], double *f, int *scale)
   if (modelOptions->polynomial != TRUE)
     update_locus (&pedigreeSet, traitLocus);
 #endif
-  /* for trait likelihood */
-  analysisLocusList = &traitLocusList;
-  xmissionMatrix = traitMatrix;
-
-  // fprintf(stderr, "Null likelihood computation is starting for %d pedigrees \n",pedigreeSet.numPedigree);
-
-  /* compute the null likelihood with   */
-  pedigreeSet.likelihood = 1;
-  pedigreeSet.log10Likelihood = 0;
-
-
-  for (pedIdx = 0; pedIdx < pedigreeSet.numPedigree; pedIdx++) {
-    /* save the likelihood at null */
-    pPedigreeLocal = pedigreeSet.ppPedigreeSet[pedIdx];
-
-
-    if (modelOptions->polynomial == TRUE) {
-      ASSERT (pPedigreeLocal->traitLikelihoodPolynomial != NULL, "Pedigree trait likelihood is NULL");
-      /* evaluate likelihood */
-      evaluatePoly (pPedigreeLocal->traitLikelihoodPolynomial, pPedigreeLocal->traitLikelihoodPolyList, &pPedigreeLocal->likelihood);
-      //fprintf(stderr, " is done %f with %d pedigrees\n",pPedigreeLocal->likelihood, pedigreeSet.numPedigree);
-
-      if (isnan (pPedigreeLocal->likelihood))
-        ERROR ("Null hypothesis likelihood is not a number");
-
-    } else {
-      initialize_multi_locus_genotype (pPedigreeLocal);
-      statusLocal = compute_pedigree_likelihood (pPedigreeLocal);
-    }
+}
 
-    /*pPedigreeLocal->likelihood is now computed and now check it */
-    if (pPedigreeLocal->likelihood == 0.0) {
-      WARNING ("Pedigree %s has likelihood of zero or nearly zero", pPedigreeLocal->sPedigreeID);
-      ret = -1;
-      product_likelihood = 0.0;
-      sum_log_likelihood = -9999.99;
-      break;
-    } else if (pPedigreeLocal->likelihood < 0.0) {
-      ASSERT (pPedigreeLocal->likelihood >= 0.0, "Pedigree %s has negative likelihood", pPedigreeLocal->sPedigreeID);
-      product_likelihood = 0.0;
-      sum_log_likelihood = -9999.99;
-      ret = -2;
-      break;
-    } else {
-      if (pPedigreeLocal->pCount[origLocus] == 1) {
-        product_likelihood *= pPedigreeLocal->likelihood;
-        log10Likelihood = log10 (pPedigreeLocal->likelihood);
-      } else {
-        product_likelihood *= pow (pPedigreeLocal->likelihood, pPedigreeLocal->pCount[origLocus]);
-        log10Likelihood = log10 (pPedigreeLocal->likelihood) * pPedigreeLocal->pCount[origLocus];
-      }
-      sum_log_likelihood += log10Likelihood;
-    }
-    pedigreeSet.nullLikelihood[pedIdx] = pPedigreeLocal->likelihood;
-    //fprintf(stderr,"null likelihood pedIdx=%d is done %20.18f with product =%20.16f\n",pedIdx,pPedigreeLocal->likelihood,product_likelihood );
-  }
+/* Compute the HLOD of a compute_hlod_mp_dt point from the pedigree likelihoods
+   under the alternative hypothesis and those kept by compute_mp_null */
+static void finish_mp_dt (double x[], double *f, int *scale, integration_context *ic, double log10_likelihood_null)
+{
+  int j;
+  int pedIdx, liabIdxLocal = 0, pen_size = 3;
+  double alphaV;
+  double log10_likelihood_alternative, log10_likelihood_ratio, likelihood_ratio;
+  double hetLR, log10HetLR, homoLR, alphaV2, tmp;
+  double alpha_integral = 0.0, avg_hetLR;
 
+  Pedigree *pPedigreeLocal;
 
-  pedigreeSet.likelihood = product_likelihood;
-  pedigreeSet.log10Likelihood = sum_log_likelihood;
-  log10_likelihood_null = pedigreeSet.log10Likelihood;
-  DIAG (OVERALL, 1, {
-        fprintf (stderr, "Sum of log Likelihood is: %e\n", sum_log_likelihood);
-      }
-  );
+  int newscale, oldscale;       /* scaling related variables */
+  double newLog10HetLR;
+  double oldsum;
+  double oldsum_log10;
+  double newsum_log10;
 
-  /* This is for alternative likelihood */
-  analysisLocusList = &savedLocusList;
-  xmissionMatrix = altMatrix;
-  int k;
-  char markerNo[8];
-  sprintf (partialPolynomialFunctionName, "MDA_LC%d_C%d_P%%sM", modelRange->nlclass, (originalLocusList.ppLocusList[1])->pMapUnit->chromosome);
-  for (k = 0; k < modelType->numMarkers; k++) {
-    if (*get_map_position (traitLocus) <= *get_map_position (markerLocusList.pLocusIndex[k]) && (strstr (partialPolynomialFunctionName, "_T") == NULL))
-      strcat (partialPolynomialFunctionName, "_T");
-    sprintf (markerNo, "_%d", markerLocusList.pLocusIndex[k]);
-    strcat (partialPolynomialFunctionName, markerNo);
-  }
-  if (strstr (partialPolynomialFunctionName, "_T") == NULL)
-    strcat (partialPolynomialFunctionName, "_T");
-  ret = compute_likelihood (&pedigreeSet);
-  cL[4]++; // MP DT alternative likelihood
-  if (ret == -2)
-    ERROR ("Negative likelihood for trait");
-#ifdef STUDYDB
-    if (toupper(*studyDB.role) == 'S') 
-      return;
-#endif
+  if (modelOptions->imprintingFlag)
+    pen_size = 4;
 
   log10_likelihood_alternative = pedigreeSet.log10Likelihood;
   if (pedigreeSet.likelihood == 0.0 && pedigreeSet.log10Likelihood == -9999.99) {
@@ -952,21 +938,21 @@ void compute_hlod_mp_dt (double x[], double *f, int *scale)
 
       }
 
-      dk_curModel.alpha = alphaV;
+      ic->curModel->alpha = alphaV;
       if (fpIR != NULL) {
 
         fprintf (fpIR, "%6.3f", log10HetLR);
 
-        fprintf (fpIR, " %4.3f %4.3f", dk_curModel.alpha, dk_curModel.dgf);
+        fprintf (fpIR, " %4.3f %4.3f", ic->curModel->alpha, ic->curModel->dgf);
         for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
-          fprintf (fpIR, " %4.3f %4.3f", dk_curModel.pen[liabIdxLocal].DD, dk_curModel.pen[liabIdxLocal].Dd);
+          fprintf (fpIR, " %4.3f %4.3f", ic->curModel->pen[liabIdxLocal].DD, ic->curModel->pen[liabIdxLocal].Dd);
           if (modelOptions->imprintingFlag) {
-            fprintf (fpIR, " %4.3f %4.3f", dk_curModel.pen[liabIdxLocal].dD, dk_curModel.pen[liabIdxLocal].dd);
+            fprintf (fpIR, " %4.3f %4.3f", ic->curModel->pen[liabIdxLocal].dD, ic->curModel->pen[liabIdxLocal].dd);
           } else {
-            fprintf (fpIR, " %4.3f", dk_curModel.pen[liabIdxLocal].dd);
+            fprintf (fpIR, " %4.3f", ic->curModel->pen[liabIdxLocal].dd);
           }
         }
-        fprintf (fpIR, " %d\n", dk_curModel.posIdx);
+        fprintf (fpIR, " %d\n", ic->curModel->posIdx);
       }
 
       oldsum = alpha_integral;
@@ -1007,22 +993,22 @@ void compute_hlod_mp_dt (double x[], double *f, int *scale)
       else
         alpha_integral += hetLR * alpha[j][1];
  
-      if (log10HetLR > localMOD) {
-        localMOD = log10HetLR;
+      if (log10HetLR > *ic->localMOD) {
+        *ic->localMOD = log10HetLR;
 
-        dk_copyMaxModel2(&dk_localmax, &dk_curModel);  // copy localmax to globalmax 7/26/2018
+        dk_copyMaxModel2(ic->localmax, ic->curModel);  // copy localmax to globalmax 7/26/2018
         /*
-        localmax_x[0] = gfreq;
-        localmax_x[1] = alphaV;
+        ic->localmax_x[0] = gfreq;
+        ic->localmax_x[1] = alphaV;
 
         for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
-          localmax_x[pen_size * liabIdxLocal + 2] = x[pen_size * liabIdxLocal + 1];
-          localmax_x[pen_size * liabIdxLocal + 3] = x[pen_size * liabIdxLocal + 2] * x[pen_size * liabIdxLocal + 1];
-          localmax_x[pen_size * liabIdxLocal + 4] = x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1] * x[pen_size * liabIdxLocal + 2];
+          ic->localmax_x[pen_size * liabIdxLocal + 2] = x[pen_size * liabIdxLocal + 1];
+          ic->localmax_x[pen_size * liabIdxLocal + 3] = x[pen_size * liabIdxLocal + 2] * x[pen_size * liabIdxLocal + 1];
+          ic->localmax_x[pen_size * liabIdxLocal + 4] = x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1] * x[pen_size * liabIdxLocal + 2];
 
           if (modelOptions->imprintingFlag) {
-            localmax_x[pen_size * liabIdxLocal + 4] = x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1];
-            localmax_x[pen_size * liabIdxLocal + 5] = x[pen_size * liabIdxLocal + 4] * x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1] * x[pen_size * liabIdxLocal + 2];
+            ic->localmax_x[pen_size * liabIdxLocal + 4] = x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1];
+            ic->localmax_x[pen_size * liabIdxLocal + 5] = x[pen_size * liabIdxLocal + 4] * x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1] * x[pen_size * liabIdxLocal + 2];
           }
         }
 	*/
@@ -1044,36 +1030,159 @@ void compute_hlod_mp_dt (double x[], double *f, int *scale)
   *f = avg_hetLR;
 }
 
-void compute_hlod_2p_qt (double x[], double *f, int *scale)
+void compute_hlod_mp_dt (double x[], double *f, int *scale, void *ctx)
 {
 
-  int k, j, ret;  
-  int pedIdx, liabIdxLocal = 0, statusLocal, pen_size = 3;
-  double constraint = 0.0;
-  double mean_DD = 0.0, mean_Dd = 0.0, mean_dD = 0.0, mean_dd = 0.0;
-  double SD_DD = 0.0, SD_Dd = 0.0, SD_dD = 0.0, SD_dd = 0.0;
-  double gfreq;
-  double alphaV;
-  double thetaM, thetaF;
-  double threshold = 0.0;
-  double log10_likelihood_null, log10_likelihood_alternative, log10_likelihood_ratio, likelihood_ratio;
-  double hetLR, log10HetLR, homoLR, alphaV2, tmp;
-  double alpha_integral = 0.0, avg_hetLR;
+  integration_context *ic = (integration_context *) ctx;
+  int k, ret;
+  double log10_likelihood_null;
+  char markerNo[8];
 
-  Pedigree *pPedigreeLocal;
+  set_mp_dt_model (x, ic);
+  compute_mp_null (f, &log10_likelihood_null);
 
-  int newscale, oldscale;       /* scaling related variables */
-  double newLog10HetLR;
-  double oldsum;
-  double oldsum_log10;
-  double newsum_log10;
+  /* This is for alternative likelihood */
+  set_mp_alternative ();
+  sprintf (partialPolynomialFunctionName, "MDA_LC%d_C%d_P%%sM", modelRange->nlclass, (originalLocusList.ppLocusList[1])->pMapUnit->chromosome);
+  for (k = 0; k < modelType->numMarkers; k++) {
+    if (*get_map_position (traitLocus) <= *get_map_position (markerLocusList.pLocusIndex[k]) && (strstr (partialPolynomialFunctionName, "_T") == NULL))
+      strcat (partialPolynomialFunctionName, "_T");
+    sprintf (markerNo, "_%d", markerLocusList.pLocusIndex[k]);
+    strcat (partialPolynomialFunctionName, markerNo);
+  }
+  if (strstr (partialPolynomialFunctionName, "_T") == NULL)
+    strcat (partialPolynomialFunctionName, "_T");
+  ret = compute_likelihood (&pedigreeSet);
+  cL[4]++; // MP DT alternative likelihood
+  if (ret == -2)
+    ERROR ("Negative likelihood for trait");
+#ifdef STUDYDB
+    if (toupper(*studyDB.role) == 'S') 
+      return;
+#endif
 
-  if (modelOptions->imprintingFlag)
-    pen_size = 4;
+  finish_mp_dt (x, f, scale, ic, log10_likelihood_null);
+}
 
-  gfreq = x[0];
-  //if (fpIR != NULL)
-    dk_curModel.dgf = gfreq;
+/*
+  Evaluate compute_hlod_mp_dt or compute_hlod_mp_qt, whichever suits the
+  trait, at count points at once, ic->ndim values to a point in x, their
+  values going to f. The null likelihoods, of the trait alone, are
+  computed point by point as before. The trait model of each point is
+  then captured as a row of the polynomial variable values of the
+  alternative, and the alternative likelihoods of all of the points are
+  evaluated together from the merged tape of the pedigrees' likelihood
+  polynomials (see pedigree_set_batch_tape). Each point is finished in
+  turn just as the integrand would, so the results are the same. Until
+  the likelihood polynomials have been built at this trait position, or
+  when they can't be evaluated in batches, the points are just handed to
+  the integrand one at a time.
+*/
+void compute_hlod_mp_batch (int count, double *x, double *f, int *scale, void *ctx)
+{
+  integration_context *ic = (integration_context *) ctx;
+  struct polyTape *t;
+  st_DKMaxModelPenVector *pen;
+  double *rows, *likelihoods, *nullLikelihoods, *log10_likelihood_null, *dgf;
+  int *keep;
+  int k, width, numPedigree = pedigreeSet.numPedigree, nlclass = modelRange->nlclass;
+
+  if ((t = pedigree_set_batch_tape (&pedigreeSet)) == NULL) {
+    for (k = 0; k < count; k++) {
+      if (modelType->trait == DT)
+        compute_hlod_mp_dt (&x[k * ic->ndim], &f[k], scale, ctx);
+      else
+        compute_hlod_mp_qt (&x[k * ic->ndim], &f[k], scale, ctx);
+    }
+    return;
+  }
+
+  width = mergedPolyTapeVariableCount (t);
+  MALCHOKE (rows, sizeof (double) * (count * width + 1), double *);
+  MALCHOKE (likelihoods, sizeof (double) * count * numPedigree, double *);
+  MALCHOKE (nullLikelihoods, sizeof (double) * count * numPedigree, double *);
+  MALCHOKE (log10_likelihood_null, sizeof (double) * count, double *);
+  MALCHOKE (dgf, sizeof (double) * count, double *);
+  MALCHOKE (pen, sizeof (st_DKMaxModelPenVector) * count * nlclass, st_DKMaxModelPenVector *);
+  MALCHOKE (keep, sizeof (int) * count, int *);
+  for (k = 0; k < count; k++) {
+    if (modelType->trait == DT) {
+      set_mp_dt_model (&x[k * ic->ndim], ic);
+    } else {
+      set_mp_qt_model (&x[k * ic->ndim], ic);
+      check_qt_constraint (x[k * ic->ndim]);
+    }
+    /* Finishing the point only needs the model as kept in ic->curModel,
+       so keep it rather than set the point up again */
+    dgf[k] = ic->curModel->dgf;
+    memcpy (&pen[k * nlclass], ic->curModel->pen, sizeof (st_DKMaxModelPenVector) * nlclass);
+    keep[k] = compute_mp_null (&f[k], &log10_likelihood_null[k]);
+    memcpy (&nullLikelihoods[k * numPedigree], pedigreeSet.nullLikelihood, sizeof (double) * numPedigree);
+    set_mp_alternative ();
+    if (keep[k])
+      cL[modelType->trait == DT ? 4 : 3]++; // MP alternative likelihood
+    captureMergedPolyTapeVariables (t, &rows[k * width]);
+  }
+
+  evaluateMergedPolyTapeBatch (t, count, rows, likelihoods);
+
+  for (k = 0; k < count; k++) {
+    ic->curModel->dgf = dgf[k];
+    memcpy (ic->curModel->pen, &pen[k * nlclass], sizeof (st_DKMaxModelPenVector) * nlclass);
+    if (!keep[k])
+      continue;
+    memcpy (pedigreeSet.nullLikelihood, &nullLikelihoods[k * numPedigree], sizeof (double) * numPedigree);
+    take_batch_likelihoods (&pedigreeSet, &likelihoods[k * numPedigree]);
+    if (modelType->trait == DT)
+      finish_mp_dt (&x[k * ic->ndim], &f[k], scale, ic, log10_likelihood_null[k]);
+    else
+      finish_mp_qt (&x[k * ic->ndim], &f[k], scale, ic, log10_likelihood_null[k]);
+  }
+  free (rows);
+  free (likelihoods);
+  free (nullLikelihoods);
+  free (log10_likelihood_null);
+  free (dgf);
+  free (pen);
+  free (keep);
+}
+
+
+/* Set up the null hypothesis of a two-point point, a theta of 0.5 and LD of 0 */
+static void set_2p_null ()
+{
+  int k, statusLocal;
+
+  /* get the likelihood at 0.5 first and LD=0 */
+  if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {
+    statusLocal = setup_LD_haplotype_freq (pLDLoci, pLambdaCell, dprime0Idx);
+    if (statusLocal < 0)
+      ASSERT (1, "Haplotype frequency combination impossible. Exiting!\n");
+
+    set_null_dprime (pLDLoci);
+    copy_haploFreq (pLDLoci, pLambdaCell->haploFreq[dprime0Idx]);
+    copy_DValue (pLDLoci, pLambdaCell->DValue[dprime0Idx]);
+    ASSERT (pLambdaCell->impossibleFlag[dprime0Idx] == 0, "Haplotype frequency combination impossible at LE. Exiting!\n");
+  }
+  for (k = 0; k < 3; k++) {
+    analysisLocusList->pNextLocusDistance[k][0] = 0.5;
+    analysisLocusList->pPrevLocusDistance[k][1] = 0.5;
+  }
+  if (modelOptions->polynomial == TRUE);
+  else
+    /* populate the matrix */
+    statusLocal = populate_xmission_matrix (xmissionMatrix, totalLoci, initialProbAddr, /* probability */
+        initialProbAddr2,       /* probability */
+        initialHetProbAddr, 0,  /* cell index */
+        -1, -1, /* last het locus & last het pattern (P-1 or M-2) */
+        0);     /* current locus - start with 0 */
+}
+
+/* Set up the alternative hypothesis of a two-point point, the LD and theta being integrated over */
+static void set_2p_alternative ()
+{
+  int k;
+  double thetaM, thetaF;
 
   if (modelOptions->mapFlag == SS) {
     thetaM = fixed_thetaM;
@@ -1082,7 +1191,61 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
     thetaM = fixed_theta;
     thetaF = fixed_theta;
   }
-  //thetaM = thetaF =0.0;
+
+  if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {
+    copy_dprime (pLDLoci, pLambdaCell->lambda[dprimeIdx]);
+
+    copy_haploFreq (pLDLoci, pLambdaCell->haploFreq[dprimeIdx]);
+    copy_DValue (pLDLoci, pLambdaCell->DValue[dprimeIdx]);
+
+    /* calculate R square if the marker is a SNP */
+    if (R_square_flag == TRUE)
+      R_square = calculate_R_square (pLocus1->pAlleleFrequency[0], pLocus2->pAlleleFrequency[0], pLDLoci->ppDValue[0][0]);
+    else
+      R_square = -1;
+  }
+
+
+  if (modelOptions->mapFlag == SA) {
+    for (k = 0; k < 3; k++) {
+      analysisLocusList->pNextLocusDistance[k][0] = thetaM;
+      analysisLocusList->pPrevLocusDistance[k][1] = thetaF;
+    }
+  } else {
+    analysisLocusList->pNextLocusDistance[MAP_POS_MALE][0] = analysisLocusList->pPrevLocusDistance[MAP_POS_MALE][1] = thetaM;
+    analysisLocusList->pNextLocusDistance[MAP_POS_FEMALE][0] = analysisLocusList->pPrevLocusDistance[MAP_POS_FEMALE][1] = thetaF;
+  }
+
+  if (modelOptions->polynomial == TRUE);
+  else
+    /* populate the matrix */
+    /*statusLocal = */populate_xmission_matrix (xmissionMatrix, totalLoci, initialProbAddr, /* probability */
+        initialProbAddr2,       /* probability */
+        initialHetProbAddr, 0,  /* cell index */
+        -1, -1, /* last het locus & last het pattern (P-1 or M-2) */
+        0);     /* current locus - start with 0 */
+}
+
+/*
+  Set up the trait model of a compute_hlod_2p_qt point: gene frequency,
+  LD, means, standard deviations and threshold, both where the
+  likelihood code looks for them and in ic->curModel.
+*/
+static void set_2p_qt_model (double x[], integration_context *ic)
+{
+  int j, liabIdxLocal = 0, statusLocal, pen_size = 3;
+  double mean_DD = 0.0, mean_Dd = 0.0, mean_dD = 0.0, mean_dd = 0.0;
+  double SD_DD = 0.0, SD_Dd = 0.0, SD_dD = 0.0, SD_dd = 0.0;
+  double gfreq;
+  double threshold = 0.0;
+
+  if (modelOptions->imprintingFlag)
+    pen_size = 4;
+
+  gfreq = x[0];
+  //if (fpIR != NULL)
+    ic->curModel->dgf = gfreq;
+
   //fprintf(stderr, "          Before avg hetLR calculation 2p qt\n");
   if (1 && modelOptions->markerAnalysis == FALSE) {
     pLocus->pAlleleFrequency[0] = gfreq;
@@ -1108,7 +1271,7 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
       //if(modelRange->tthresh[0][0] >= modelRange->tthresh[0][1]-1.0e-10){
       threshold = modelRange->tthresh[0][0];
     }else{
-      threshold = x[s->ndim - 1];
+      threshold = x[ic->ndim - 1];
     }
   }
   if (modelOptions->markerAnalysis == FALSE) {
@@ -1116,13 +1279,13 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
 
       if ((modelOptions->qtMeanMode==PARAM_MODE_VARY) ||(modelType->distrib == QT_FUNCTION_CHI_SQUARE)) {
         mean_DD = x[j];
-        mean_Dd = (x[j + 1] - xl[j + 1]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 1];
+        mean_Dd = (x[j + 1] - ic->xl[j + 1]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 1];
 
         if (modelOptions->imprintingFlag) {
-          mean_dD = (x[j + 2] - xl[j + 2]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 2];
-          mean_dd = (x[j + 3] - xl[j + 3]) * (x[j + 2] - xl[j + 2]) / (xu[j + 2] - xl[j + 2]) * (x[j + 1] - xl[j + 1]) / (xu[j + 1] - xl[j + 1]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 3];
+          mean_dD = (x[j + 2] - ic->xl[j + 2]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 2];
+          mean_dd = (x[j + 3] - ic->xl[j + 3]) * (x[j + 2] - ic->xl[j + 2]) / (ic->xu[j + 2] - ic->xl[j + 2]) * (x[j + 1] - ic->xl[j + 1]) / (ic->xu[j + 1] - ic->xl[j + 1]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 3];
         } else {
-          mean_dd = (x[j + 2] - xl[j + 2]) * (x[j + 1] - xl[j + 1]) / (xu[j + 1] - xl[j + 1]) * (x[j] - xl[j]) / (xu[j] - xl[j]) + xl[j + 2];
+          mean_dd = (x[j + 2] - ic->xl[j + 2]) * (x[j + 1] - ic->xl[j + 1]) / (ic->xu[j + 1] - ic->xl[j + 1]) * (x[j] - ic->xl[j]) / (ic->xu[j] - ic->xl[j]) + ic->xl[j + 2];
           mean_dD = mean_Dd;
         }
         j += pen_size;
@@ -1135,10 +1298,10 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
       }
 
       //if (fpIR != NULL) {
-        dk_curModel.pen[liabIdxLocal].DD = deNormalizeMean (modelType, mean_DD);
-        dk_curModel.pen[liabIdxLocal].Dd = deNormalizeMean (modelType, mean_Dd);
-        dk_curModel.pen[liabIdxLocal].dD = deNormalizeMean (modelType, mean_dD);
-        dk_curModel.pen[liabIdxLocal].dd = deNormalizeMean (modelType, mean_dd);
+        ic->curModel->pen[liabIdxLocal].DD = deNormalizeMean (modelType, mean_DD);
+        ic->curModel->pen[liabIdxLocal].Dd = deNormalizeMean (modelType, mean_Dd);
+        ic->curModel->pen[liabIdxLocal].dD = deNormalizeMean (modelType, mean_dD);
+        ic->curModel->pen[liabIdxLocal].dd = deNormalizeMean (modelType, mean_dd);
 	//}
 
       if (modelType->distrib != QT_FUNCTION_CHI_SQUARE) {
@@ -1175,16 +1338,16 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
         //SD_dd=1.0;
 
         //if (fpIR != NULL) {
-          dk_curModel.pen[liabIdxLocal].DDSD = deNormalizeStdev (modelType, SD_DD);
-          dk_curModel.pen[liabIdxLocal].DdSD = deNormalizeStdev (modelType, SD_Dd);
-          dk_curModel.pen[liabIdxLocal].dDSD = deNormalizeStdev (modelType, SD_dD);
-          dk_curModel.pen[liabIdxLocal].ddSD = deNormalizeStdev (modelType, SD_dd);
+          ic->curModel->pen[liabIdxLocal].DDSD = deNormalizeStdev (modelType, SD_DD);
+          ic->curModel->pen[liabIdxLocal].DdSD = deNormalizeStdev (modelType, SD_Dd);
+          ic->curModel->pen[liabIdxLocal].dDSD = deNormalizeStdev (modelType, SD_dD);
+          ic->curModel->pen[liabIdxLocal].ddSD = deNormalizeStdev (modelType, SD_dd);
 	  //}
 
       }
       //if (fpIR != NULL) {
         if (modelType->trait == CT)
-          dk_curModel.pen[liabIdxLocal].threshold = deNormalizeMean (modelType, threshold);
+          ic->curModel->pen[liabIdxLocal].threshold = deNormalizeMean (modelType, threshold);
 	//}
 
       /* threshold for QT *
@@ -1194,18 +1357,6 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
        * } */
 
 
-      /* check against the hard coded constraint */
-      if (modelType->distrib != QT_FUNCTION_CHI_SQUARE) {
-        constraint = (1.0 - gfreq) * (1.0 - gfreq) * mean_dd * SD_dd + 2 * gfreq * (1 - gfreq) * mean_Dd * SD_Dd + gfreq * gfreq * mean_DD * SD_DD;
-        /* fprintf(stderr, "constraint: %f gfreq:%f DD (%f,%f) Dd(%f,%f) dd(%f,%f)\n",
-         * constraint, gfreq, mean_DD, SD_DD, mean_Dd, SD_DD, mean_dd, SD_dd);
-         */
-        if (constraint >= 3.0 || constraint <= -3.0) {
-          // fprintf(stderr,"Constraint is %f \n", constraint);
-          num_out_constraint++;
-        }
-      }
-
       pTrait->means[liabIdxLocal][0][0] = mean_DD;
       pTrait->means[liabIdxLocal][0][1] = mean_Dd;
       pTrait->means[liabIdxLocal][1][0] = mean_dD;
@@ -1225,43 +1376,14 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
       update_penetrance (&pedigreeSet, traitLocus);
 
   }
+}
 
-
-
-  /* marker to marker analysis */
-
-  /* get the likelihood at 0.5 first and LD=0 */
-  if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {
-
-    statusLocal = setup_LD_haplotype_freq (pLDLoci, pLambdaCell, dprime0Idx);
-    if (statusLocal < 0)
-      ASSERT (1, "Haplotype frequency combination impossible. Exiting!\n");
-
-    set_null_dprime (pLDLoci);
-    copy_haploFreq (pLDLoci, pLambdaCell->haploFreq[dprime0Idx]);
-    copy_DValue (pLDLoci, pLambdaCell->DValue[dprime0Idx]);
-
-    ASSERT (pLambdaCell->impossibleFlag[dprime0Idx] == 0, "Haplotype frequency combination impossible at LE. Exiting!\n");
-  }
-
-  for (k = 0; k < 3; k++) {
-    analysisLocusList->pNextLocusDistance[k][0] = 0.5;
-    analysisLocusList->pPrevLocusDistance[k][1] = 0.5;
-  }
-
-  if (modelOptions->polynomial == TRUE);
-  else
-    /* populate the matrix */
-    statusLocal = populate_xmission_matrix (xmissionMatrix, totalLoci, initialProbAddr, /* probability */
-        initialProbAddr2,       /* probability */
-        initialHetProbAddr, 0,  /* cell index */
-        -1, -1, /* last het locus & last het pattern (P-1 or M-2) */
-        0);     /* current locus - start with 0 */
-
-
-  sprintf (partialPolynomialFunctionName, "TQ_LC%d_C%d_P%%s_%s_%s", modelRange->nlclass, pLocus2->pMapUnit->chromosome, pLocus1->sName, pLocus2->sName);
-  ret = compute_likelihood (&pedigreeSet);
-  cL[5]++; // TP QT
+/* Save the pedigree likelihoods under the null hypothesis of a compute_hlod_2p_qt
+   point, returning FALSE if they're zero, in which case f is 1 */
+static int keep_2p_qt_null (double *f)
+{
+  int pedIdx;
+  Pedigree *pPedigreeLocal;
 
   if (pedigreeSet.likelihood == 0.0 && pedigreeSet.log10Likelihood == -9999.99) {
     if (modelRange->atypicalQtTrait)
@@ -1270,7 +1392,7 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
       ERROR ("Pedigree set has likelihood of zero or nearly zero");
     
     f[0] = 1.0;
-    return;
+    return FALSE;
   }
 
   for (pedIdx = 0; pedIdx < pedigreeSet.numPedigree; pedIdx++) {
@@ -1278,51 +1400,45 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
     pPedigreeLocal = pedigreeSet.ppPedigreeSet[pedIdx];
     pedigreeSet.nullLikelihood[pedIdx] = pPedigreeLocal->likelihood;
   }
+  return TRUE;
+}
 
-  log10_likelihood_null = pedigreeSet.log10Likelihood;
-
-  if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {
-    copy_dprime (pLDLoci, pLambdaCell->lambda[dprimeIdx]);
-    copy_haploFreq (pLDLoci, pLambdaCell->haploFreq[dprimeIdx]);
-    copy_DValue (pLDLoci, pLambdaCell->DValue[dprimeIdx]);
-  }
+/* Compute the HLOD of a compute_hlod_2p_qt point from the pedigree likelihoods
+   under the alternative hypothesis and those kept by keep_2p_qt_null */
+static void finish_2p_qt (double x[], double *f, int *scale, integration_context *ic, double log10_likelihood_null)
+{
+  int k, j;
+  int pedIdx, liabIdxLocal = 0, pen_size = 3;
+  double alphaV;
+  double log10_likelihood_alternative, log10_likelihood_ratio, likelihood_ratio;
+  double hetLR, log10HetLR, homoLR, alphaV2, tmp;
+  double alpha_integral = 0.0, avg_hetLR;
 
-  if (modelOptions->mapFlag == SA) {
-    for (k = 0; k < 3; k++) {
-      analysisLocusList->pNextLocusDistance[k][0] = thetaM;
-      analysisLocusList->pPrevLocusDistance[k][1] = thetaF;
-    }
-  } else {
-    analysisLocusList->pNextLocusDistance[MAP_POS_MALE][0] = analysisLocusList->pPrevLocusDistance[MAP_POS_MALE][1] = thetaM;
-    analysisLocusList->pNextLocusDistance[MAP_POS_FEMALE][0] = analysisLocusList->pPrevLocusDistance[MAP_POS_FEMALE][1] = thetaF;
-  }
+  Pedigree *pPedigreeLocal;
 
-  if (modelOptions->polynomial == TRUE);
-  else
-    /* populate the matrix */
-    statusLocal = populate_xmission_matrix (xmissionMatrix, totalLoci, initialProbAddr, /* probability */
-        initialProbAddr2,       /* probability */
-        initialHetProbAddr, 0,  /* cell index */
-        -1, -1, /* last het locus & last het pattern (P-1 or M-2) */
-        0);     /* current locus - start with 0 */
+  int newscale, oldscale;       /* scaling related variables */
+  double newLog10HetLR;
+  double oldsum;
+  double oldsum_log10;
+  double newsum_log10;
 
-  // No new name for a polynomial here because we're reusing the existing one
-  ret = compute_likelihood (&pedigreeSet);
-  cL[6]++; // TP QT
-  if (ret == -2)
-    ERROR ("Negative likelihood for markers");
+  if (modelOptions->imprintingFlag)
+    pen_size = 4;
 
   log10_likelihood_alternative = pedigreeSet.log10Likelihood;
   if (pedigreeSet.likelihood == 0.0 && pedigreeSet.log10Likelihood == -9999.99) {
     log10_likelihood_ratio = 0;
     avg_hetLR = 0.0;
 
-    fprintf (stderr, "Theta %f has likelihood 0 \n", thetaM);
-    fprintf (stderr, "dgf=%f\n", gfreq);
-    for (j = 1; j < s->ndim; j++) {
+    fprintf (stderr, "Theta %f has likelihood 0 \n", modelOptions->mapFlag == SS ? fixed_thetaM : fixed_theta);
+    fprintf (stderr, "dgf=%f\n", x[0]);
+    for (j = 1; j < ic->ndim; j++) {
       fprintf (stderr, " %f", x[j]);
     }
-    fprintf (stderr, "mean %f %f %f %f SD %f %f %f %f\n", mean_DD, mean_Dd, mean_dD, mean_dd, SD_DD, SD_Dd, SD_dD, SD_dd);
+    liabIdxLocal = modelRange->nlclass - 1;
+    fprintf (stderr, "mean %f %f %f %f SD %f %f %f %f\n",
+             pTrait->means[liabIdxLocal][0][0], pTrait->means[liabIdxLocal][0][1], pTrait->means[liabIdxLocal][1][0], pTrait->means[liabIdxLocal][1][1],
+             pTrait->stddev[liabIdxLocal][0][0], pTrait->stddev[liabIdxLocal][0][1], pTrait->stddev[liabIdxLocal][1][0], pTrait->stddev[liabIdxLocal][1][1]);
     fprintf (stderr, "\n");
 
   } else {
@@ -1377,33 +1493,33 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
         }
       }
 
-      dk_curModel.alpha = alphaV;
+      ic->curModel->alpha = alphaV;
       if (fpIR != NULL) {
         fprintf (fpIR, "%6.3f", log10HetLR);
         if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {
-          fprintf (fpIR, " %4.3f", dk_curModel.dprime[0]);
+          fprintf (fpIR, " %4.3f", ic->curModel->dprime[0]);
         }
         if (modelOptions->mapFlag == SA) {
-          fprintf (fpIR, " %4.3f", dk_curModel.theta[0]);
+          fprintf (fpIR, " %4.3f", ic->curModel->theta[0]);
         } else {
-          fprintf (fpIR, " %4.3f %4.3f", dk_curModel.theta[0], dk_curModel.theta[1]);
+          fprintf (fpIR, " %4.3f %4.3f", ic->curModel->theta[0], ic->curModel->theta[1]);
         }
-        fprintf (fpIR, " %4.3f %4.3f", dk_curModel.alpha, dk_curModel.dgf);
+        fprintf (fpIR, " %4.3f %4.3f", ic->curModel->alpha, ic->curModel->dgf);
         for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
-          fprintf (fpIR, " %4.3f %4.3f", dk_curModel.pen[liabIdxLocal].DD, dk_curModel.pen[liabIdxLocal].Dd);
+          fprintf (fpIR, " %4.3f %4.3f", ic->curModel->pen[liabIdxLocal].DD, ic->curModel->pen[liabIdxLocal].Dd);
           if (modelOptions->imprintingFlag) {
-            fprintf (fpIR, " %4.3f %4.3f", dk_curModel.pen[liabIdxLocal].dD, dk_curModel.pen[liabIdxLocal].dd);
+            fprintf (fpIR, " %4.3f %4.3f", ic->curModel->pen[liabIdxLocal].dD, ic->curModel->pen[liabIdxLocal].dd);
           } else {
-            fprintf (fpIR, " %4.3f", dk_curModel.pen[liabIdxLocal].dd);
+            fprintf (fpIR, " %4.3f", ic->curModel->pen[liabIdxLocal].dd);
           }
           if (modelType->distrib != QT_FUNCTION_CHI_SQUARE) {
-            fprintf (fpIR, " %4.3f %4.3f %4.3f", dk_curModel.pen[liabIdxLocal].DDSD,dk_curModel.pen[liabIdxLocal].DdSD,dk_curModel.pen[liabIdxLocal].ddSD);
+            fprintf (fpIR, " %4.3f %4.3f %4.3f", ic->curModel->pen[liabIdxLocal].DDSD,ic->curModel->pen[liabIdxLocal].DdSD,ic->curModel->pen[liabIdxLocal].ddSD);
           }
         }
         if (modelType->trait == CT) {
-          fprintf (fpIR, " %4.3f", dk_curModel.pen[0].threshold);
+          fprintf (fpIR, " %4.3f", ic->curModel->pen[0].threshold);
         }
-        fprintf (fpIR, " %d\n", dk_curModel.posIdx);
+        fprintf (fpIR, " %d\n", ic->curModel->posIdx);
       }
 
       oldsum = alpha_integral;
@@ -1446,45 +1562,45 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
 
 
       /*Update local maximum as necessary */
-      if (log10HetLR > localMOD) {
-        localMOD = log10HetLR;
+      if (log10HetLR > *ic->localMOD) {
+        *ic->localMOD = log10HetLR;
         
-        dk_copyMaxModel2(&dk_localmax, &dk_curModel);  // copy localmax to globalmax 7/26/2018
+        dk_copyMaxModel2(ic->localmax, ic->curModel);  // copy localmax to globalmax 7/26/2018
 
         /*
-        localmax_x[0] = gfreq;
-        localmax_x[1] = alphaV;
+        ic->localmax_x[0] = gfreq;
+        ic->localmax_x[1] = alphaV;
         k = 2;
         for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
 
           if (modelOptions->qtMeanMode==PARAM_MODE_VARY){
-	    localmax_x[k] = x[k - 1];
-	    localmax_x[k + 1] = (x[k] - xl[k]) * (x[k - 1] - xl[k - 1]) / (xu[k - 1] - xl[k - 1]) + xl[k];
+	    ic->localmax_x[k] = x[k - 1];
+	    ic->localmax_x[k + 1] = (x[k] - ic->xl[k]) * (x[k - 1] - ic->xl[k - 1]) / (ic->xu[k - 1] - ic->xl[k - 1]) + ic->xl[k];
 
 	    if (modelOptions->imprintingFlag) {
-	      localmax_x[k + 2] = (x[k + 1] - xl[k + 1]) * (x[k - 1] - xl[k - 1]) / (xu[k - 1] - xl[k - 1]) + xl[k + 1];
-	      localmax_x[k + 3] = (x[k + 2] - xl[k + 2]) * (x[k + 1] - xl[k + 1]) / (xu[k + 1] - xl[k + 1]) * (x[k] - xl[k]) / (xu[k] - xl[k]) * (x[k - 1] - xl[k - 1]) / (xu[k - 1] - xl[k - 1]) + xl[k + 2];
+	      ic->localmax_x[k + 2] = (x[k + 1] - ic->xl[k + 1]) * (x[k - 1] - ic->xl[k - 1]) / (ic->xu[k - 1] - ic->xl[k - 1]) + ic->xl[k + 1];
+	      ic->localmax_x[k + 3] = (x[k + 2] - ic->xl[k + 2]) * (x[k + 1] - ic->xl[k + 1]) / (ic->xu[k + 1] - ic->xl[k + 1]) * (x[k] - ic->xl[k]) / (ic->xu[k] - ic->xl[k]) * (x[k - 1] - ic->xl[k - 1]) / (ic->xu[k - 1] - ic->xl[k - 1]) + ic->xl[k + 2];
 	    } else {
-	      localmax_x[k + 2] = (x[k + 1] - xl[k + 1]) * (x[k] - xl[k]) / (xu[k] - xl[k]) * (x[k - 1] - xl[k - 1]) / (xu[k - 1] - xl[k - 1]) + xl[k + 1];
+	      ic->localmax_x[k + 2] = (x[k + 1] - ic->xl[k + 1]) * (x[k] - ic->xl[k]) / (ic->xu[k] - ic->xl[k]) * (x[k - 1] - ic->xl[k - 1]) / (ic->xu[k - 1] - ic->xl[k - 1]) + ic->xl[k + 1];
 	    }
 	    k += pen_size;
           }else if(modelOptions->qtMeanMode==PARAM_MODE_SAME){
-	    localmax_x[k] = x[k - 1];  // mean_DD, mean_Dd, mean_dD, mean_dd
+	    ic->localmax_x[k] = x[k - 1];  // mean_DD, mean_Dd, mean_dD, mean_dd
 	    k++;
 	  } // PARAM_MODE_FIXED must be taken separately
 	  if (modelType->distrib != QT_FUNCTION_CHI_SQUARE) {
             if (modelOptions->qtStandardDevMode==PARAM_MODE_SAME){
-	      localmax_x[k] = x[k - 1];
+	      ic->localmax_x[k] = x[k - 1];
 	      k++;
 	    }else if(modelOptions->qtStandardDevMode==PARAM_MODE_VARY){
-	      localmax_x[k ] = x[k-1]; // SD_DD 
+	      ic->localmax_x[k ] = x[k-1]; // SD_DD 
 	      if (modelOptions->imprintingFlag) {
-		localmax_x[k + 1] = x[k]; //SD_Dd;
-		localmax_x[k + 2] = x[k + 1]; //SD_dD
-		localmax_x[k + 3] = x[k + 2]; //SD_dd
+		ic->localmax_x[k + 1] = x[k]; //SD_Dd;
+		ic->localmax_x[k + 2] = x[k + 1]; //SD_dD
+		ic->localmax_x[k + 3] = x[k + 2]; //SD_dd
 	      } else {
-		localmax_x[k + 1] = x[k]; // SD_Dd;
-		localmax_x[k + 2] = x[k + 1]; // SD_Dd;
+		ic->localmax_x[k + 1] = x[k]; // SD_Dd;
+		ic->localmax_x[k + 2] = x[k + 1]; // SD_Dd;
 	      }
 	      k += pen_size;
 	    }
@@ -1493,7 +1609,7 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
         } // end of for
         if (modelType->trait == CT) {
 	  if (modelRange->tthresh[0][0]<= modelRange->tthresh[0][1] + 1.0e-10){
-	    localmax_x[k] = x[k - 1];
+	    ic->localmax_x[k] = x[k - 1];
 	    k++;
 	  }
         }
@@ -1512,13 +1628,13 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
     if ((modelOptions->qtMeanMode==PARAM_MODE_VARY)|| (modelType->distrib == QT_FUNCTION_CHI_SQUARE) ){
       k = 1;
       for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
-	avg_hetLR *= (x[k] - xl[k]) / (xu[k] - xl[k]);
-	avg_hetLR *= (x[k] - xl[k]) / (xu[k] - xl[k]);
-	avg_hetLR *= (x[k + 1] - xl[k + 1]) / (xu[k + 1] - xl[k + 1]);
+	avg_hetLR *= (x[k] - ic->xl[k]) / (ic->xu[k] - ic->xl[k]);
+	avg_hetLR *= (x[k] - ic->xl[k]) / (ic->xu[k] - ic->xl[k]);
+	avg_hetLR *= (x[k + 1] - ic->xl[k + 1]) / (ic->xu[k + 1] - ic->xl[k + 1]);
 
 	if (modelOptions->imprintingFlag) {
-	  avg_hetLR *= (x[k] - xl[k]) / (xu[k] - xl[k]);
-	  avg_hetLR *= (x[k + 2] - xl[k + 2]) / (xu[k + 2] - xl[k + 2]);
+	  avg_hetLR *= (x[k] - ic->xl[k]) / (ic->xu[k] - ic->xl[k]);
+	  avg_hetLR *= (x[k + 2] - ic->xl[k + 2]) / (ic->xu[k + 2] - ic->xl[k + 2]);
 	}
 
 	k += pen_size;
@@ -1532,8 +1648,8 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
     }  //end fo jacobian
 
     /*This is a temporary checking. *
-     * if (k != s->ndim) {
-     * printf ("k=%d  while dim for BR is %d\n", k, s->ndim);
+     * if (k != ic->ndim) {
+     * printf ("k=%d  while dim for BR is %d\n", k, ic->ndim);
      * exit (EXIT_FAILURE);
      * } */
 
@@ -1541,38 +1657,97 @@ void compute_hlod_2p_qt (double x[], double *f, int *scale)
   *f = avg_hetLR;
 }
 
-void compute_hlod_2p_dt (double x[], double *f, int *scale)
+void compute_hlod_2p_qt (double x[], double *f, int *scale, void *ctx)
 {
 
-//double compute_hlod(PedigreeSet *pedigreeSet,double x[], int loc1, int loc2, Locus *pLocus, Trait *pTrait, int traitLocus, int totalLoci, double * initialProbAddr[3], Locus *pLocus1){
+  integration_context *ic = (integration_context *) ctx;
+  int ret;
+  double log10_likelihood_null;
 
-/*  Limit of this function
+  set_2p_qt_model (x, ic);
+  if (modelOptions->markerAnalysis == FALSE)
+    check_qt_constraint (x[0]);
+  set_2p_null ();
 
-   modelOptions->type := TP  (Two points)
-   modelOptions->trait := DT (DICHOTOMOUS);
-   modelOptions->equilibrium :=LINKAGE_EQUILIBRIUM
-   modelOptions->polynomial := TRUE
-   modelOptions->markerAnalysis := FALSE;
-   modelOptions->mapFlag := SA 
-   modelRange->nafreq :=1
-   
-*/
+  sprintf (partialPolynomialFunctionName, "TQ_LC%d_C%d_P%%s_%s_%s", modelRange->nlclass, pLocus2->pMapUnit->chromosome, pLocus1->sName, pLocus2->sName);
+  ret = compute_likelihood (&pedigreeSet);
+  cL[5]++; // TP QT
 
-  int k, j;
-  int pedIdx, liabIdxLocal = 0, statusLocal, pen_size = 3, ret;
+  if (!keep_2p_qt_null (f))
+    return;
+  log10_likelihood_null = pedigreeSet.log10Likelihood;
 
-  double pen_DD, pen_Dd, pen_dD, pen_dd, gfreq, alphaV, thetaM, thetaF;
-  double log10_likelihood_null, log10_likelihood_alternative, log10_likelihood_ratio, likelihood_ratio;
-  double log10HetLR, homoLR, alphaV2;
-  double hetLR, avg_hetLR, alpha_integral = 0.0, tmp;
-  Pedigree *pPedigreeLocal;
+  set_2p_alternative ();
 
-  int newscale, oldscale;       /* scaling related variables */
-  double newLog10HetLR;
-  double oldsum;
-  double oldsum_log10;
-  double newsum_log10;
+  // No new name for a polynomial here because we're reusing the existing one
+  ret = compute_likelihood (&pedigreeSet);
+  cL[6]++; // TP QT
+  if (ret == -2)
+    ERROR ("Negative likelihood for markers");
+
+  finish_2p_qt (x, f, scale, ic, log10_likelihood_null);
+}
+
+/*
+  compute_hlod_2p_qt at count points at once, ic->ndim values to a point
+  in x, returning each point's value in f, as compute_hlod_2p_dt_batch
+  does for compute_hlod_2p_dt.
+*/
+void compute_hlod_2p_qt_batch (int count, double *x, double *f, int *scale, void *ctx)
+{
+  integration_context *ic = (integration_context *) ctx;
+  struct polyTape *t;
+  double *rows, *likelihoods, log10_likelihood_null;
+  int k, width, numPedigree = pedigreeSet.numPedigree;
+
+  if ((t = pedigree_set_batch_tape (&pedigreeSet)) == NULL) {
+    for (k = 0; k < count; k++)
+      compute_hlod_2p_qt (&x[k * ic->ndim], &f[k], scale, ctx);
+    return;
+  }
 
+  /* Each point has a row for the null hypothesis, then one for the alternative */
+  width = mergedPolyTapeVariableCount (t);
+  MALCHOKE (rows, sizeof (double) * (2 * count * width + 1), double *);
+  MALCHOKE (likelihoods, sizeof (double) * 2 * count * numPedigree, double *);
+  for (k = 0; k < count; k++) {
+    set_2p_qt_model (&x[k * ic->ndim], ic);
+    if (modelOptions->markerAnalysis == FALSE)
+      check_qt_constraint (x[k * ic->ndim]);
+    set_2p_null ();
+    cL[5]++; // TP QT
+    captureMergedPolyTapeVariables (t, &rows[2 * k * width]);
+    set_2p_alternative ();
+    cL[6]++; // TP QT
+    captureMergedPolyTapeVariables (t, &rows[(2 * k + 1) * width]);
+  }
+
+  evaluateMergedPolyTapeBatch (t, 2 * count, rows, likelihoods);
+
+  /* Leave everything as it would be after the last point, as well */
+  for (k = 0; k < count; k++) {
+    set_2p_qt_model (&x[k * ic->ndim], ic);
+    take_batch_likelihoods (&pedigreeSet, &likelihoods[2 * k * numPedigree]);
+    if (!keep_2p_qt_null (&f[k]))
+      continue;
+    log10_likelihood_null = pedigreeSet.log10Likelihood;
+    set_2p_alternative ();
+    take_batch_likelihoods (&pedigreeSet, &likelihoods[(2 * k + 1) * numPedigree]);
+    finish_2p_qt (&x[k * ic->ndim], &f[k], scale, ic, log10_likelihood_null);
+  }
+  free (rows);
+  free (likelihoods);
+}
+
+/*
+  Set up the trait model of a compute_hlod_2p_dt point: gene frequency,
+  LD and penetrances, both where the likelihood code looks for them and
+  in ic->curModel.
+*/
+static void set_2p_dt_model (double x[], integration_context *ic)
+{
+  int liabIdxLocal = 0, statusLocal, pen_size = 3;
+  double pen_DD, pen_Dd, pen_dD, pen_dd, gfreq;
 
   if (modelOptions->imprintingFlag)
     pen_size = 4;
@@ -1580,15 +1755,7 @@ void compute_hlod_2p_dt (double x[], double *f, int *scale)
   gfreq = x[0];
   // printf("Calculating hetLR with gf=%f  theta=%f\n", gfreq,fixed_theta);
   //if (fpIR != NULL)
-    dk_curModel.dgf = gfreq;
-
-  if (modelOptions->mapFlag == SS) {
-    thetaM = fixed_thetaM;
-    thetaF = fixed_thetaF;
-  } else {
-    thetaM = fixed_theta;
-    thetaF = fixed_theta;
-  }
+    ic->curModel->dgf = gfreq;
 
   //fprintf(stderr, "    Before avg hetLR calculation 2p  dt\n");
 
@@ -1621,10 +1788,10 @@ void compute_hlod_2p_dt (double x[], double *f, int *scale)
         pen_dD = pen_Dd;
       }
       //if (fpIR != NULL) {
-        dk_curModel.pen[liabIdxLocal].DD = pen_DD;
-        dk_curModel.pen[liabIdxLocal].Dd = pen_Dd;
-        dk_curModel.pen[liabIdxLocal].dD = pen_dD;
-        dk_curModel.pen[liabIdxLocal].dd = pen_dd;
+        ic->curModel->pen[liabIdxLocal].DD = pen_DD;
+        ic->curModel->pen[liabIdxLocal].Dd = pen_Dd;
+        ic->curModel->pen[liabIdxLocal].dD = pen_dD;
+        ic->curModel->pen[liabIdxLocal].dd = pen_dd;
 	//}
 
       pTrait->penetrance[2][liabIdxLocal][0][0] = pen_DD;
@@ -1640,44 +1807,23 @@ void compute_hlod_2p_dt (double x[], double *f, int *scale)
   if (modelOptions->polynomial == TRUE);
   else
     update_penetrance (&pedigreeSet, traitLocus);
+}
 
-  /* get the likelihood at 0.5 first and LD=0 */
-  if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {
-    statusLocal = setup_LD_haplotype_freq (pLDLoci, pLambdaCell, dprime0Idx);
-    if (statusLocal < 0)
-      ASSERT (1, "Haplotype frequency combination impossible. Exiting!\n");
-
-    set_null_dprime (pLDLoci);
-    copy_haploFreq (pLDLoci, pLambdaCell->haploFreq[dprime0Idx]);
-    copy_DValue (pLDLoci, pLambdaCell->DValue[dprime0Idx]);
-    ASSERT (pLambdaCell->impossibleFlag[dprime0Idx] == 0, "Haplotype frequency combination impossible at LE. Exiting!\n");
-  }
-  for (k = 0; k < 3; k++) {
-    analysisLocusList->pNextLocusDistance[k][0] = 0.5;
-    analysisLocusList->pPrevLocusDistance[k][1] = 0.5;
-  }
-  if (modelOptions->polynomial == TRUE);
-  else
-    /* populate the matrix */
-    statusLocal = populate_xmission_matrix (xmissionMatrix, totalLoci, initialProbAddr, /* probability */
-        initialProbAddr2,       /* probability */
-        initialHetProbAddr, 0,  /* cell index */
-        -1, -1, /* last het locus & last het pattern (P-1 or M-2) */
-        0);     /* current locus - start with 0 */
-
-
-  sprintf (partialPolynomialFunctionName, "TD_LC%d_C%d_P%%s_%s_%s", modelRange->nlclass, pLocus2->pMapUnit->chromosome, pLocus1->sName, pLocus2->sName);
-  cL[7]++; // TP DT
-  ret = compute_likelihood (&pedigreeSet);
+/* Save the pedigree likelihoods under the null hypothesis of a compute_hlod_2p_dt
+   point, returning FALSE if they're zero, in which case f is 1 */
+static int keep_2p_dt_null (double x[], double *f)
+{
+  int pedIdx;
+  Pedigree *pPedigreeLocal;
 
   //printf("likelihood =%15.13f with theta 0.5 with %d pedigrees\n", pedigreeSet.likelihood, pedigreeSet.numPedigree);
 
   if (pedigreeSet.likelihood == 0.0 && pedigreeSet.log10Likelihood == -9999.99) {
     fprintf (stderr, "Theta 0.5 has likelihood 0\n");
-    fprintf (stderr, "dgf=%f\n", gfreq);
+    fprintf (stderr, "dgf=%f\n", x[0]);
     //exit (EXIT_FAILURE);
     f[0] = 1.0;
-    return;
+    return FALSE;
   }
 
   /* save the results for NULL */
@@ -1686,48 +1832,32 @@ void compute_hlod_2p_dt (double x[], double *f, int *scale)
     pPedigreeLocal = pedigreeSet.ppPedigreeSet[pedIdx];
     pedigreeSet.nullLikelihood[pedIdx] = pPedigreeLocal->likelihood;
   }
+  return TRUE;
+}
 
-  log10_likelihood_null = pedigreeSet.log10Likelihood;
-
-
-  if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {
-    copy_dprime (pLDLoci, pLambdaCell->lambda[dprimeIdx]);
-
-    copy_haploFreq (pLDLoci, pLambdaCell->haploFreq[dprimeIdx]);
-    copy_DValue (pLDLoci, pLambdaCell->DValue[dprimeIdx]);
+/* Compute the HLOD of a compute_hlod_2p_dt point from the pedigree likelihoods
+   under the alternative hypothesis and those kept by keep_2p_dt_null */
+static void finish_2p_dt (double x[], double *f, int *scale, integration_context *ic, double log10_likelihood_null)
+{
+  int j;
+  int pedIdx, liabIdxLocal = 0, pen_size = 3;
 
-    /* calculate R square if the marker is a SNP */
-    if (R_square_flag == TRUE)
-      R_square = calculate_R_square (pLocus1->pAlleleFrequency[0], pLocus2->pAlleleFrequency[0], pLDLoci->ppDValue[0][0]);
-    else
-      R_square = -1;
-  }
+  double alphaV;
+  double log10_likelihood_alternative, log10_likelihood_ratio, likelihood_ratio;
+  double log10HetLR, homoLR, alphaV2;
+  double hetLR, avg_hetLR, alpha_integral = 0.0, tmp;
+  Pedigree *pPedigreeLocal;
 
+  int newscale, oldscale;       /* scaling related variables */
+  double newLog10HetLR;
+  double oldsum;
+  double oldsum_log10;
+  double newsum_log10;
 
-  if (modelOptions->mapFlag == SA) {
-    for (k = 0; k < 3; k++) {
-      analysisLocusList->pNextLocusDistance[k][0] = thetaM;
-      analysisLocusList->pPrevLocusDistance[k][1] = thetaF;
-    }
-  } else {
-    analysisLocusList->pNextLocusDistance[MAP_POS_MALE][0] = analysisLocusList->pPrevLocusDistance[MAP_POS_MALE][1] = thetaM;
-    analysisLocusList->pNextLocusDistance[MAP_POS_FEMALE][0] = analysisLocusList->pPrevLocusDistance[MAP_POS_FEMALE][1] = thetaF;
-  }
 
-  if (modelOptions->polynomial == TRUE);
-  else
-    /* populate the matrix */
-    statusLocal = populate_xmission_matrix (xmissionMatrix, totalLoci, initialProbAddr, /* probability */
-        initialProbAddr2,       /* probability */
-        initialHetProbAddr, 0,  /* cell index */
-        -1, -1, /* last het locus & last het pattern (P-1 or M-2) */
-        0);     /* current locus - start with 0 */
+  if (modelOptions->imprintingFlag)
+    pen_size = 4;
 
-  // No new name for a polynomial here because we're reusing the existing one
-  cL[8]++; // TP DT
-  ret = compute_likelihood (&pedigreeSet);
-  if (ret == -2)
-    ERROR ("Negative alternative likelihood");
   log10_likelihood_alternative = pedigreeSet.log10Likelihood;
 
   if (pedigreeSet.likelihood == 0.0 && pedigreeSet.log10Likelihood == -9999.99) {
@@ -1780,28 +1910,28 @@ void compute_hlod_2p_dt (double x[], double *f, int *scale)
         // log10HetLR += tmp * sqrt(pPedigreeLocal->pCount[loc2] );  //kelvin log10 exponential for case-control
       }
 
-      dk_curModel.alpha = alphaV;
+      ic->curModel->alpha = alphaV;
       if (fpIR != NULL) {
 
         fprintf (fpIR, "%6.3f", log10HetLR);
         if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {
-          fprintf (fpIR, " %4.3f", dk_curModel.dprime[0]);
+          fprintf (fpIR, " %4.3f", ic->curModel->dprime[0]);
         }
         if (modelOptions->mapFlag == SA) {
-          fprintf (fpIR, " %4.3f", dk_curModel.theta[0]);
+          fprintf (fpIR, " %4.3f", ic->curModel->theta[0]);
         } else {
-          fprintf (fpIR, " %4.3f %4.3f", dk_curModel.theta[0], dk_curModel.theta[1]);
+          fprintf (fpIR, " %4.3f %4.3f", ic->curModel->theta[0], ic->curModel->theta[1]);
         }
-        fprintf (fpIR, " %4.3f %4.3f", dk_curModel.alpha, dk_curModel.dgf);
+        fprintf (fpIR, " %4.3f %4.3f", ic->curModel->alpha, ic->curModel->dgf);
         for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
-          fprintf (fpIR, " %4.3f %4.3f", dk_curModel.pen[liabIdxLocal].DD, dk_curModel.pen[liabIdxLocal].Dd);
+          fprintf (fpIR, " %4.3f %4.3f", ic->curModel->pen[liabIdxLocal].DD, ic->curModel->pen[liabIdxLocal].Dd);
           if (modelOptions->imprintingFlag) {
-            fprintf (fpIR, " %4.3f %4.3f", dk_curModel.pen[liabIdxLocal].dD, dk_curModel.pen[liabIdxLocal].dd);
+            fprintf (fpIR, " %4.3f %4.3f", ic->curModel->pen[liabIdxLocal].dD, ic->curModel->pen[liabIdxLocal].dd);
           } else {
-            fprintf (fpIR, " %4.3f", dk_curModel.pen[liabIdxLocal].dd);
+            fprintf (fpIR, " %4.3f", ic->curModel->pen[liabIdxLocal].dd);
           }
         }
-        fprintf (fpIR, " %d\n", dk_curModel.posIdx);
+        fprintf (fpIR, " %d\n", ic->curModel->posIdx);
       }
 
 
@@ -1844,22 +1974,22 @@ void compute_hlod_2p_dt (double x[], double *f, int *scale)
       else
         alpha_integral += hetLR * alpha[j][1];
 
-      if (log10HetLR > localMOD) {
-        localMOD = log10HetLR;
+      if (log10HetLR > *ic->localMOD) {
+        *ic->localMOD = log10HetLR;
 
-        dk_copyMaxModel2(&dk_localmax, &dk_curModel);  // copy localmax to globalmax 7/26/2018
+        dk_copyMaxModel2(ic->localmax, ic->curModel);  // copy localmax to globalmax 7/26/2018
 	/*
-        localmax_x[0] = gfreq;
-        localmax_x[1] = alphaV;
+        ic->localmax_x[0] = gfreq;
+        ic->localmax_x[1] = alphaV;
 
         for (liabIdxLocal = 0; liabIdxLocal < modelRange->nlclass; liabIdxLocal++) {
-          localmax_x[pen_size * liabIdxLocal + 2] = x[pen_size * liabIdxLocal + 1];
-          localmax_x[pen_size * liabIdxLocal + 3] = x[pen_size * liabIdxLocal + 2] * x[pen_size * liabIdxLocal + 1];
-          localmax_x[pen_size * liabIdxLocal + 4] = x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1] * x[pen_size * liabIdxLocal + 2];
+          ic->localmax_x[pen_size * liabIdxLocal + 2] = x[pen_size * liabIdxLocal + 1];
+          ic->localmax_x[pen_size * liabIdxLocal + 3] = x[pen_size * liabIdxLocal + 2] * x[pen_size * liabIdxLocal + 1];
+          ic->localmax_x[pen_size * liabIdxLocal + 4] = x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1] * x[pen_size * liabIdxLocal + 2];
 
           if (modelOptions->imprintingFlag) {
-            localmax_x[pen_size * liabIdxLocal + 4] = x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1];
-            localmax_x[pen_size * liabIdxLocal + 5] = x[pen_size * liabIdxLocal + 4] * x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1] * x[pen_size * liabIdxLocal + 2];
+            ic->localmax_x[pen_size * liabIdxLocal + 4] = x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1];
+            ic->localmax_x[pen_size * liabIdxLocal + 5] = x[pen_size * liabIdxLocal + 4] * x[pen_size * liabIdxLocal + 3] * x[pen_size * liabIdxLocal + 1] * x[pen_size * liabIdxLocal + 2];
           }
         }
         */
@@ -1890,7 +2020,285 @@ void compute_hlod_2p_dt (double x[], double *f, int *scale)
 
 }
 
+void compute_hlod_2p_dt (double x[], double *f, int *scale, void *ctx)
+{
+
+//double compute_hlod(PedigreeSet *pedigreeSet,double x[], int loc1, int loc2, Locus *pLocus, Trait *pTrait, int traitLocus, int totalLoci, double * initialProbAddr[3], Locus *pLocus1){
+
+/*  Limit of this function
+
+   modelOptions->type := TP  (Two points)
+   modelOptions->trait := DT (DICHOTOMOUS);
+   modelOptions->equilibrium :=LINKAGE_EQUILIBRIUM
+   modelOptions->polynomial := TRUE
+   modelOptions->markerAnalysis := FALSE;
+   modelOptions->mapFlag := SA 
+   modelRange->nafreq :=1
+   
+*/
+
+  integration_context *ic = (integration_context *) ctx;
+  int ret;
+  double log10_likelihood_null;
+
+  if (ic->concurrent) {
+    compute_hlod_2p_dt_batch (1, x, f, scale, ctx);
+    return;
+  }
+
+  set_2p_dt_model (x, ic);
+  set_2p_null ();
+
+  sprintf (partialPolynomialFunctionName, "TD_LC%d_C%d_P%%s_%s_%s", modelRange->nlclass, pLocus2->pMapUnit->chromosome, pLocus1->sName, pLocus2->sName);
+  cL[7]++; // TP DT
+  ret = compute_likelihood (&pedigreeSet);
+
+  if (!keep_2p_dt_null (x, f))
+    return;
+  log10_likelihood_null = pedigreeSet.log10Likelihood;
+
+  set_2p_alternative ();
+
+  // No new name for a polynomial here because we're reusing the existing one
+  cL[8]++; // TP DT
+  ret = compute_likelihood (&pedigreeSet);
+  if (ret == -2)
+    ERROR ("Negative alternative likelihood");
+
+  finish_2p_dt (x, f, scale, ic, log10_likelihood_null);
+}
+
+/*
+  Put the BR point of a concurrent integration where set_2p_dt_model and
+  set_2p_alternative look for it. Other integrations move it, so this
+  is done at the start of each critical section.
+*/
+static void stage_2p_dt_integration (integration_context *ic)
+{
+  if (!ic->concurrent)
+    return;
+  if (modelOptions->mapFlag == SA) {
+    if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM)
+      fixed_dprime = ic->curModel->dprime[0];
+    fixed_theta = ic->curModel->theta[0];
+  } else {
+    fixed_thetaM = ic->curModel->theta[0];
+    fixed_thetaF = ic->curModel->theta[1];
+  }
+  dprimeIdx = ic->dprimeIdx;
+}
+
+/*
+  compute_hlod_2p_dt at count points at once, ic->ndim values to a point
+  in x, returning each point's value in f. The likelihoods of all of the
+  points, under both hypotheses, are evaluated in one batch, and then
+  each point is finished in turn just as compute_hlod_2p_dt would, so
+  the results are the same. Until the likelihood polynomials have been
+  built, or when they can't be evaluated in batches, the points are
+  just handed to compute_hlod_2p_dt one at a time.
+
+  The trait model of each point is set up in pTrait, pLocus and the
+  other globals the likelihood code reads, and captured from there as a
+  row of polynomial variable values, in the trait_model critical
+  section, as is finishing the points. The evaluation in between, which
+  is nearly all of the work, only reads the tape and this batch's own
+  rows, so concurrent integrations (see integrate_2p_dt_concurrently)
+  do it alongside one another.
+*/
+void compute_hlod_2p_dt_batch (int count, double *x, double *f, int *scale, void *ctx)
+{
+  integration_context *ic = (integration_context *) ctx;
+  struct polyTape *t;
+  double *rows = NULL, *likelihoods = NULL, log10_likelihood_null;
+  int k, width, numPedigree = pedigreeSet.numPedigree;
+
+#ifdef _OPENMP
+#pragma omp critical (trait_model)
+#endif
+  {
+    stage_2p_dt_integration (ic);
+    if ((t = pedigree_set_batch_tape (&pedigreeSet)) != NULL) {
+      /* Each point has a row for the null hypothesis, then one for the alternative */
+      width = mergedPolyTapeVariableCount (t);
+      MALCHOKE (rows, sizeof (double) * (2 * count * width + 1), double *);
+      MALCHOKE (likelihoods, sizeof (double) * 2 * count * numPedigree, double *);
+      for (k = 0; k < count; k++) {
+        set_2p_dt_model (&x[k * ic->ndim], ic);
+        set_2p_null ();
+        cL[7]++; // TP DT
+        captureMergedPolyTapeVariables (t, &rows[2 * k * width]);
+        set_2p_alternative ();
+        cL[8]++; // TP DT
+        captureMergedPolyTapeVariables (t, &rows[(2 * k + 1) * width]);
+      }
+    }
+  }
+  if (t == NULL) {
+    /* Never so for a concurrent integration, which would come straight back */
+    for (k = 0; k < count; k++)
+      compute_hlod_2p_dt (&x[k * ic->ndim], &f[k], scale, ctx);
+    return;
+  }
+
+  evaluateMergedPolyTapeBatch (t, 2 * count, rows, likelihoods);
+
+  /* Leave everything as it would be after the last point, as well */
+#ifdef _OPENMP
+#pragma omp critical (trait_model)
+#endif
+  {
+    stage_2p_dt_integration (ic);
+    for (k = 0; k < count; k++) {
+      set_2p_dt_model (&x[k * ic->ndim], ic);
+      take_batch_likelihoods (&pedigreeSet, &likelihoods[2 * k * numPedigree]);
+      if (!keep_2p_dt_null (&x[k * ic->ndim], &f[k]))
+        continue;
+      log10_likelihood_null = pedigreeSet.log10Likelihood;
+      set_2p_alternative ();
+      take_batch_likelihoods (&pedigreeSet, &likelihoods[(2 * k + 1) * numPedigree]);
+      finish_2p_dt (&x[k * ic->ndim], &f[k], scale, ic, log10_likelihood_null);
+    }
+  }
+  free (rows);
+  free (likelihoods);
+}
+
+/*
+  Set up BR point i of a two-point analysis, a D' and theta or a male
+  and female theta, in the globals and dk_curModel.
+*/
+static void set_2p_br_point (int i)
+{
+  if (modelOptions->mapFlag == SA) {
+    fixed_dprime = dcuhre2[i][0];
+    fixed_theta = dcuhre2[i][1];
+
+    //if (fpIR != NULL) {
+      if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM)
+        dk_curModel.dprime[0] = fixed_dprime;
+      dk_curModel.theta[0] = dk_curModel.theta[1] = fixed_theta;
+    //}
+  } else {
+    fixed_thetaM = thetaSS[i][0];
+    fixed_thetaF = thetaSS[i][1];
+
+    //if (fpIR != NULL) {
+      if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM)
+        dk_curModel.dprime[0] = 0.0;
+      dk_curModel.theta[0] = fixed_thetaM;
+      dk_curModel.theta[1] = fixed_thetaF;
+    //}
+    //fprintf (stderr, "i=%d Dprime=%f theta=%f   loc1=%d  loc2=%d\n", i, fixed_thetaM, fixed_thetaF,loc1,loc2);
+  }
+
+  if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {     // checking Dprime
+    for (dprimeIdx = 0; dprimeIdx < pLambdaCell->ndprime; dprimeIdx++) {
+      if (fabs (pLambdaCell->lambda[dprimeIdx][0][0] - fixed_dprime) < 0.0001) {
+        // fprintf(stderr,"dprimeIdx =%d with %15.13f which is matching wit fixed_dprime\n",dprimeIdx,pLambdaCell->lambda[dprimeIdx][0][0]);
+        break;
+      }
+    }
+    if (dprimeIdx == pLambdaCell->ndprime) {
+      // &&& This needs fixin'
+      ERROR ( "dprimeIdx is %d for dprime=%f theta=%f\n", dprimeIdx,fixed_dprime, fixed_theta);
+    }
+  }
+}
+
+/* A BR integration run by integrate_2p_dt_concurrently, and its results */
+typedef struct
+{
+  integration_context ic;
+  st_DKMaxModel curModel, localmax;
+  double localMOD, localmax_x[20];
+  double integral, abserr;
+  int scale, neval, ifail;
+} br_integration;
+
+/*
+  Run the BR integrations first to last - 1 of a two-point dichotomous
+  trait analysis concurrently, returning their results indexed by BR
+  point, or NULL if they have to be run one at a time. The first BR
+  integration must have been run already, so the likelihood polynomials
+  are built and the rest only evaluate them.
+
+  Each integration has its own dcuhre_state and integration_context,
+  with its own current and maximizing models. They take turns to set up
+  their trait models in the globals the likelihood code reads, and
+  evaluate the likelihoods alongside one another (see
+  compute_hlod_2p_dt_batch). The integrations don't depend upon one
+  another without a warm start, so the results are the same as running
+  them in turn. Not done with an intermediate results file, whose lines
+  would be interleaved, and only built with CONCURRENT_INTEGRATION (see
+  Makefile.main).
+*/
+static br_integration *integrate_2p_dt_concurrently (int first, int last, double vol_region)
+{
+#if defined (_OPENMP) && defined (CONCURRENT_INTEGRATION)
+  br_integration *br;
+  dcuhre_state state;
+  int i, threads;
+
+  // More threads than processors would only wait on each other
+  if ((threads = omp_get_max_threads ()) > omp_get_num_procs ())
+    threads = omp_get_num_procs ();
+  if (threads > last - first)
+    threads = last - first;
+  if (threads < 2 || modelType->trait != DT || modelOptions->polynomial != TRUE ||
+      modelOptions->warmStart > 0 || fpIR != NULL || pedigree_set_batch_tape (&pedigreeSet) == NULL)
+    return NULL;
+
+  CALCHOKE (br, (size_t) last, sizeof (br_integration), br_integration *);
+  for (i = first; i < last; i++) {
+    set_2p_br_point (i);
+    if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {
+      CALCHOKE (br[i].curModel.dprime, (size_t) 1, sizeof (double), double *);
+      CALCHOKE (br[i].localmax.dprime, (size_t) 1, sizeof (double), double *);
+      br[i].curModel.dprime[0] = dk_curModel.dprime[0];
+    }
+    CALCHOKE (br[i].curModel.pen, (size_t) modelRange->nlclass, sizeof (st_DKMaxModelPenVector), void *);
+    CALCHOKE (br[i].localmax.pen, (size_t) modelRange->nlclass, sizeof (st_DKMaxModelPenVector), void *);
+    br[i].curModel.posIdx = dk_curModel.posIdx;
+    br[i].curModel.theta[0] = dk_curModel.theta[0];
+    br[i].curModel.theta[1] = dk_curModel.theta[1];
+
+    br[i].ic = integration_ctx;
+    br[i].ic.localMOD = &br[i].localMOD;
+    br[i].ic.localmax_x = br[i].localmax_x;
+    br[i].ic.curModel = &br[i].curModel;
+    br[i].ic.localmax = &br[i].localmax;
+    br[i].ic.concurrent = TRUE;
+    br[i].ic.dprimeIdx = dprimeIdx;
+  }
+
+  DETAIL (0, "Running %d BR integrations with %d threads", last - first, threads);
+#pragma omp parallel for schedule(dynamic, 1) private(state) num_threads(threads)
+  for (i = first; i < last; i++) {
+    memset (&state, 0, sizeof (dcuhre_state));
+    s = &state;
+    kelvin_dcuhre_integrate (&state, &br[i].ic, &br[i].integral, &br[i].abserr, vol_region, &br[i].scale);
+    br[i].neval = state.total_neval;
+    br[i].ifail = state.ifail;
+    s = &init_state;    /* state goes with this iteration */
+  }
+  return br;
+#else
+  return NULL;
+#endif
+}
+
+static void free_br_integrations (br_integration *br, int first, int last)
+{
+  int i;
 
+  for (i = first; i < last; i++) {
+    free (br[i].curModel.dprime);
+    free (br[i].localmax.dprime);
+    free (br[i].curModel.pen);
+    free (br[i].localmax.pen);
+  }
+  free (br);
+}
 
 /**
 
@@ -1911,6 +2319,8 @@ void integrateMain ()
   int i, j, k;
   int liabIdxLocal, pedIdx/*, statusLocal*/;
   Pedigree *pPedigreeLocal;
+  br_integration *concurrentBR; /* BR integrations already run together, if any */
+  int lastBR;
 #ifdef STUDYDB
   int *pMarkers;
 #endif
@@ -1994,6 +2404,13 @@ void integrateMain ()
     xl[i] = 0;
     xu[i] = 1;
   }
+  integration_ctx.xl = xl;
+  integration_ctx.xu = xu;
+  integration_ctx.localMOD = &localMOD;
+  integration_ctx.localmax_x = localmax_x;
+  integration_ctx.curModel = &dk_curModel;
+  integration_ctx.localmax = &dk_localmax;
+  integration_ctx.concurrent = FALSE;
 
   memset (&dk_globalmax, 0, sizeof (st_DKMaxModel));
   memset (&dk_dprime0max, 0, sizeof (st_DKMaxModel));
@@ -2374,52 +2791,39 @@ void integrateMain ()
           }
           max_scale = 0;
           CALCHOKE (BRscale, (size_t) num_BR, sizeof (int), int *);
+          /* Only the first ten, at D' of 0, under linkage equilibrium */
+          if (modelOptions->mapFlag == SA && modelOptions->equilibrium == LINKAGE_EQUILIBRIUM)
+            lastBR = 10;
+          else
+            lastBR = num_BR;
+          concurrentBR = NULL;
           /*The main loop to Calculate BR(theta, dprime) or BR(thetaM, thetaF) */
           for (i = 0; i < num_BR; i++) {        /* num_BR = 271 for Sex-Average Analysis
                                                  * = 260 for Sex-Specific Analysis */
 
-            if (modelOptions->mapFlag == SA) {
-              fixed_dprime = dcuhre2[i][0];
-              fixed_theta = dcuhre2[i][1];
-
-              //if (fpIR != NULL) {
-                if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM)
-                  dk_curModel.dprime[0] = fixed_dprime;
-                dk_curModel.theta[0] = dk_curModel.theta[1] = fixed_theta;
-		//}
-            } else {
-              fixed_thetaM = thetaSS[i][0];
-              fixed_thetaF = thetaSS[i][1];
-
-              //if (fpIR != NULL) {
-                if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM)
-                  dk_curModel.dprime[0] = 0.0;
-                dk_curModel.theta[0] = fixed_thetaM;
-                dk_curModel.theta[1] = fixed_thetaF;
-		//}
-              //fprintf (stderr, "i=%d Dprime=%f theta=%f   loc1=%d  loc2=%d\n", i, fixed_thetaM, fixed_thetaF,loc1,loc2);
-            }
-
+            /* The first has built the likelihood polynomials, so the rest may run together */
+            if (i == 1)
+              concurrentBR = integrate_2p_dt_concurrently (1, lastBR, volume_region);
+            set_2p_br_point (i);
             integral = 0.0;
             abserr = 0.0;
-
-            if (modelOptions->equilibrium != LINKAGE_EQUILIBRIUM) {     // checking Dprime
-              for (dprimeIdx = 0; dprimeIdx < pLambdaCell->ndprime; dprimeIdx++) {
-                if (fabs (pLambdaCell->lambda[dprimeIdx][0][0] - fixed_dprime) < 0.0001) {
-                  // fprintf(stderr,"dprimeIdx =%d with %15.13f which is matching wit fixed_dprime\n",dprimeIdx,pLambdaCell->lambda[dprimeIdx][0][0]);
-                  break;
-                }
-              }
-              if (dprimeIdx == pLambdaCell->ndprime) {
-                // &&& This needs fixin'
-                ERROR ( "dprimeIdx is %d for dprime=%f theta=%f\n", dprimeIdx,fixed_dprime, fixed_theta);
-              }
-            }
             num_out_constraint = 0;
 
-            /* Call DCUHRE  Domain information is stored in global variables,  xl an xu */
-            kelvin_dcuhre_integrate (&integral, &abserr, volume_region, &(BRscale[i]));
-            ASSERT ((s->ifail == 0), "Dynamic integration failed with ifail of %d. Please increase the maxcls parameter in integrationSupport.c if ifail is 1. Others, check dchhre function in dcuhre.c", s->ifail);
+            if (concurrentBR != NULL) {
+              /* Already integrated by integrate_2p_dt_concurrently */
+              integral = concurrentBR[i].integral;
+              abserr = concurrentBR[i].abserr;
+              BRscale[i] = concurrentBR[i].scale;
+              num_eval = concurrentBR[i].neval;
+              localMOD = concurrentBR[i].localMOD;
+              dk_copyMaxModel2 (&dk_localmax, &concurrentBR[i].localmax);
+              ASSERT ((concurrentBR[i].ifail == 0), "Dynamic integration failed with ifail of %d. Please increase the maxcls parameter in integrationSupport.c if ifail is 1. Others, check dchhre function in dcuhre.c", concurrentBR[i].ifail);
+            } else {
+              /* Call DCUHRE  Domain information is in integration_ctx */
+              kelvin_dcuhre_integrate (&init_state, &integration_ctx, &integral, &abserr, volume_region, &(BRscale[i]));
+              ASSERT ((init_state.ifail == 0), "Dynamic integration failed with ifail of %d. Please increase the maxcls parameter in integrationSupport.c if ifail is 1. Others, check dchhre function in dcuhre.c", init_state.ifail);
+              num_eval = init_state.total_neval;
+            }
 
             if (modelOptions->mapFlag == SA) {
               dcuhre2[i][3] = integral;
@@ -2433,9 +2837,9 @@ void integrateMain ()
             /* Dk specific results */
             if (fpDK != NULL) {
               if (modelOptions->mapFlag == SA) {
-                fprintf (fpDK, "%d %6.4f %6.4f %6d %8.4f %8.4f %5d %8.4f\n", i, fixed_dprime, fixed_theta, s->total_neval, integral, abserr, BRscale[i], localMOD);
+                fprintf (fpDK, "%d %6.4f %6.4f %6d %8.4f %8.4f %5d %8.4f\n", i, fixed_dprime, fixed_theta, num_eval, integral, abserr, BRscale[i], localMOD);
               } else {
-                fprintf (fpDK, "%d %6.4f %6.4f %6d %8.4f %8.4f %5d %8.4f\n", i, fixed_thetaM, fixed_thetaF, s->total_neval, integral, abserr, BRscale[i], localMOD);
+                fprintf (fpDK, "%d %6.4f %6.4f %6d %8.4f %8.4f %5d %8.4f\n", i, fixed_thetaM, fixed_thetaF, num_eval, integral, abserr, BRscale[i], localMOD);
               }
               fflush (fpDK);
             }
@@ -2597,6 +3001,8 @@ void integrateMain ()
             }
           }     /* end of for to calculate BR(theta, dprime) or BR(thetaM, thetaF) */
           free (BRscale);
+          if (concurrentBR != NULL)
+            free_br_integrations (concurrentBR, 1, lastBR);
 
           dk_write2ptMODHeader ();
 	  if (overallMOD == 0 && overallMin == 0)
@@ -3143,11 +3549,11 @@ void integrateMain ()
       integral = 0.0;
       abserr = 0.0;
       num_out_constraint = 0;
-      kelvin_dcuhre_integrate (&integral, &abserr, volume_region, &max_scale);
+      kelvin_dcuhre_integrate (&init_state, &integration_ctx, &integral, &abserr, volume_region, &max_scale);
       // Would it kill us to actually use parameters and not seemingly-unrelated single-character globals?
-      ASSERT ((s->ifail == 0), "Dynamic integration failed with ifail of %d. Please increase the maxcls parameter in integrationSupport.c if ifail is 1. Others, check dchhre function in dcuhre.c", s->ifail);
+      ASSERT ((init_state.ifail == 0), "Dynamic integration failed with ifail of %d. Please increase the maxcls parameter in integrationSupport.c if ifail is 1. Others, check dchhre function in dcuhre.c", init_state.ifail);
 
-      num_eval = s->total_neval;
+      num_eval = init_state.total_neval;
 
       /* calculate imputed PPL and print the results */
       if (integral > 0.214) {
@@ -3226,4 +3632,5 @@ void integrateMain ()
   free (dk_curModel.pen);
   free (xl);
   //free (xu);
+  sbrg_seed_free (&init_state);
 }
@@ -8,13 +8,37 @@
  * You should have received a copy of the GNU General Public License along
  * with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#include "dcuhre.h"
+
 #define SCALE_RESERVE 50
 #define checkpt() fprintf (stderr, "Checkpoint at line %d of file \"%s\"\n",__LINE__,__FILE__)
-void compute_hlod_2p_dt (double x[], double *f, int *scale);
-int kelvin_dcuhre_integrate (double *integral, double *abserr, double, int *);
-void compute_hlod_mp_dt (double x[], double *f, int *scale);
-void compute_hlod_2p_qt (double x[], double *f, int *scale);
-void compute_hlod_mp_qt (double x[], double *f, int *scale);
+
+/* What an integrand works with besides its arguments, passed to it by DCUHRE
+   (see fun_ctx in dcuhre.h). An integration with its own dcuhre_state and
+   integration_context shares nothing with another in the integrator or here.
+   The likelihood code still takes its trait model from pTrait, pLocus and
+   friends, so concurrent integrations only set it up there in turn (see
+   compute_hlod_2p_dt_batch). */
+typedef struct
+{
+  double *xl, *xu;              /* bounds of the BR dimensions */
+  int ndim;                     /* number of BR dimensions being integrated */
+  double *localMOD;             /* maximum log10 HLOD seen in this integration */
+  double *localmax_x;           /* and the trait parameters where it was seen */
+  st_DKMaxModel *curModel;      /* the model being evaluated */
+  st_DKMaxModel *localmax;      /* and the one where localMOD was seen */
+  int concurrent;               /* TRUE if run alongside others, in which case the */
+  int dprimeIdx;                /* BR point is curModel's theta and D', and this */
+} integration_context;
+
+void compute_hlod_2p_dt (double x[], double *f, int *scale, void *ctx);
+void compute_hlod_2p_dt_batch (int count, double *x, double *f, int *scale, void *ctx);
+int kelvin_dcuhre_integrate (dcuhre_state *s, integration_context *ic, double *integral, double *abserr, double, int *);
+void compute_hlod_mp_dt (double x[], double *f, int *scale, void *ctx);
+void compute_hlod_2p_qt (double x[], double *f, int *scale, void *ctx);
+void compute_hlod_2p_qt_batch (int count, double *x, double *f, int *scale, void *ctx);
+void compute_hlod_mp_qt (double x[], double *f, int *scale, void *ctx);
+void compute_hlod_mp_batch (int count, double *x, double *f, int *scale, void *ctx);
 void integrateMain();
 
 
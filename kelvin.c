@@ -60,20 +60,13 @@
   - _OPENMP - this conditional is not defined by the user, but rather
   set by the compiler when the -fopenmp flag is specified to enable
   OpenMP multithreading. Aspects of polynomial build and evaluation
-  are currently setup to handle multithreading.  As a caveat --
-  polynomial evaluation performance is only improved with
-  multi-threading if the analysis has more unique pedigrees than
-  threads. Performance will actually degrade when there are only a few
-  unique pedigrees because term optimization will cause their
-  polynomials to share most of their terms, and then per-pedigree
-  evaluation threads will get into extensive synchronization conflicts
-  traversing those polynomials. You can monitor this by watching the
-  System CPU time as opposed to User CPU time. System CPU time is
-  almost exclusively wasted time due to thread synchronization
-  conflicts. Note that it is not, however, necessary to disable
-  multi-threading by rebuilding kelvin for these situations. Simply
-  set the OMP_NUM_THREADS environment variable to 1, and no locking
-  conflicts will occur.
+  are currently setup to handle multithreading. Pedigree likelihood
+  polynomials are merged into a single tape and evaluated level by
+  level, with the terms of each level divided amongst the threads, so
+  threads don't contend for the terms pedigrees share. Since threads
+  synchronize between levels, polynomials that are small or deep
+  won't benefit much, and OMP_NUM_THREADS can be set to 1 for them
+  without rebuilding kelvin.
 
   COMPILE-TIME CONDITIONALS for diagnostic and test purposes...
 
@@ -51,6 +51,7 @@ void kelvinTerm () {
   /* free transmission probability matrix */
   free (altMatrix);
   free (nullMatrix);
+  free_xmission_cache ();
 
   if (modelType->type == TP)
     free_LD_loci (pLDLoci);
@@ -79,6 +79,7 @@ our %KnownDirectives = (
 			"ExtraMODs" => \&NoAction,
 
 			"PolynomialScale" => \&NoAction,
+			"PolynomialCachePath" => \&NoAction,
 			"LiabilityClasses" => \&NoAction,
 			"DiseaseAlleles" => \&NoAction,
 
@@ -22,6 +22,7 @@
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
+#include <stdint.h>
 
 #include "pedlib.h"
 #include "pedigree.h"
@@ -43,6 +44,48 @@ int child_children_parents_genotype_elimination (int locus,
 						 NuclearFamily * pNucFam,
 						 int child);
 
+#ifndef NO_BITSET_GENOTYPE_ELIMINATION
+static int bitset_pedigree_genotype_elimination (int locus, Pedigree * pPedigree);
+
+/* Bit-parallel elimination keeps each person's candidate genotypes for the
+ * locus as a bit vector, in genotype list order, and every nuclear family
+ * has a row for each of a parent's genotypes marking the compatible ones
+ * of each child. One pass over the alive parental pairs of a family then
+ * does what the four pairwise elimination rules do, a word at a time. */
+#define ELIM_WORD_BITS 64
+#define ELIM_WORDS(n) (((n) + ELIM_WORD_BITS - 1) / ELIM_WORD_BITS)
+
+typedef struct ElimPerson
+{
+  /* index of the person whose genotype list this person uses - its own
+   * unless it is a duplicated loop breaker */
+  int owner;
+  int numGeno;
+  int numWords;
+  /* first of its genotypes in elimGeno */
+  int genoOffset;
+  /* its alive genotypes, and those kept by the current family, in elimBits */
+  size_t alive, kept;
+} ElimPerson;
+
+/* work space, only ever grown, and per thread since pedigrees and loci
+ * are eliminated concurrently */
+static uint64_t *elimBits = NULL;
+static size_t maxElimBits = 0;
+static Genotype **elimGeno = NULL;
+static int maxElimGeno = 0;
+static ElimPerson *elimPerson = NULL;
+static int maxElimPerson = 0;
+/* offsets of the compatibility rows in elimBits, two per child (one for
+ * each parent) for each nuclear family in turn */
+static size_t *elimCompat = NULL;
+static int maxElimCompat = 0;
+#ifdef _OPENMP
+#pragma omp threadprivate (elimBits, maxElimBits, elimGeno, maxElimGeno, elimPerson, maxElimPerson, \
+			   elimCompat, maxElimCompat)
+#endif
+#endif
+
 
 /* This function go through the nuclear families in the pedigree
  * to eliminate any genotype that is against Mendel's law 
@@ -56,6 +99,9 @@ int child_children_parents_genotype_elimination (int locus,
 int
 pedigree_genotype_elimination (int locus, Pedigree * pPedigree)
 {
+#ifndef NO_BITSET_GENOTYPE_ELIMINATION
+  return bitset_pedigree_genotype_elimination (locus, pPedigree);
+#else
   NuclearFamily *pNucFam;
   int i;
   int doneFlag;
@@ -89,6 +135,7 @@ pedigree_genotype_elimination (int locus, Pedigree * pPedigree)
 
 
   return 0;
+#endif
 }
 
 /* genotype elimination is done through the unit of nuclear family */
@@ -601,6 +648,292 @@ child_children_parents_genotype_elimination (int locus,
   return ret;
 }
 
+#ifndef NO_BITSET_GENOTYPE_ELIMINATION
+/* the same test as is_parent_child_genotype_compatible, without recording
+ * the inheritance in the child's genotype */
+static int
+elim_compatible (int parent, int childSex, Genotype * pParentGeno, Genotype * pChildGeno)
+{
+  int alleleSetLen = originalLocusList.alleleSetLen;
+  unsigned int *pParentAlleleSet1 = pParentGeno->pAlleleBits[DAD];
+  unsigned int *pParentAlleleSet2 = pParentGeno->pAlleleBits[MOM];
+  unsigned int *pChildAlleleSet = pChildGeno->pAlleleBits[parent];
+  int compatible[2];
+  int i;
+
+  if ((modelOptions->sexLinked != 0) && (parent == DAD) && (childSex + 1 == MALE))
+    return TRUE;
+  compatible[DAD] = compatible[MOM] = TRUE;
+  for (i = 0; i < alleleSetLen; i++) {
+    if ((pChildAlleleSet[i] & pParentAlleleSet1[i]) != pParentAlleleSet1[i])
+      compatible[DAD] = FALSE;
+    if ((pChildAlleleSet[i] & pParentAlleleSet2[i]) != pParentAlleleSet2[i])
+      compatible[MOM] = FALSE;
+    if (compatible[DAD] == FALSE && compatible[MOM] == FALSE)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+#endif
+
+/* release this thread's bit-parallel elimination work space */
+void
+free_genotype_elimination_space ()
+{
+#ifndef NO_BITSET_GENOTYPE_ELIMINATION
+  free (elimBits);
+  elimBits = NULL;
+  maxElimBits = 0;
+  free (elimGeno);
+  elimGeno = NULL;
+  maxElimGeno = 0;
+  free (elimPerson);
+  elimPerson = NULL;
+  maxElimPerson = 0;
+  free (elimCompat);
+  elimCompat = NULL;
+  maxElimCompat = 0;
+#endif
+}
+
+#ifndef NO_BITSET_GENOTYPE_ELIMINATION
+
+/* Eliminate genotypes the way the rules above do, until nothing changes.
+ * A parent's genotype survives when it pairs with some genotype of the
+ * other parent such that every child has a compatible genotype, and a
+ * child's genotype survives when it is compatible with such a pair. Those
+ * two rules imply the other two, and since elimination only ever shrinks
+ * the lists, the result doesn't depend on the order it is done in. The
+ * lists are only updated at the end. */
+static int
+bitset_pedigree_genotype_elimination (int locus, Pedigree * pPedigree)
+{
+  NuclearFamily *pNucFam;
+  Person *pPerson, *pChild;
+  Genotype *pGeno, *pPrev;
+  ElimPerson *pEP, *pParent[2], *pEC;
+  Locus *pLocus = originalLocusList.ppLocusList[locus];
+  uint64_t *pRow[2], *pChildBits, *pScratch, word, unionBits;
+  size_t numBits, scratch, offset;
+  int numPerson = pPedigree->numPerson;
+  int numCompat, numGeno, maxChildWords, childWords;
+  int i, j, k, f, c, p, g[2], w, pairOK, changed, failed;
+  int passNo;
+
+  /* per person: whose list, and how many genotypes are on it */
+  if (numPerson > maxElimPerson) {
+    maxElimPerson = numPerson;
+    REALCHOKE(elimPerson, sizeof (ElimPerson) * maxElimPerson, ElimPerson *);
+  }
+  numGeno = 0;
+  numBits = 0;
+  for (i = 0; i < numPerson; i++) {
+    pPerson = pPedigree->ppPersonList[i];
+    pEP = &elimPerson[i];
+    if (pPerson->loopBreaker >= 1 && pPerson->pParents[DAD] == NULL) {
+      /* a duplicated loop breaker, use the original's genotype list */
+      pEP->owner = pPerson->pOriginalPerson->personIndex;
+      continue;
+    }
+    pEP->owner = i;
+    pEP->numGeno = 0;
+    for (pGeno = pPerson->ppGenotypeList[locus]; pGeno != NULL; pGeno = pGeno->pNext)
+      pEP->numGeno++;
+    pEP->numWords = ELIM_WORDS (pEP->numGeno);
+    pEP->genoOffset = numGeno;
+    numGeno += pEP->numGeno;
+    pEP->alive = numBits;
+    pEP->kept = numBits + pEP->numWords;
+    numBits += 2 * pEP->numWords;
+  }
+
+  /* per nuclear family child and parent: a row of the child's compatible
+   * genotypes for each of the parent's */
+  numCompat = 0;
+  maxChildWords = 0;
+  for (f = 0; f < pPedigree->numNuclearFamily; f++) {
+    pNucFam = pPedigree->ppNuclearFamilyList[f];
+    numCompat += 2 * pNucFam->numChildren;
+    childWords = 0;
+    for (c = 0; c < pNucFam->numChildren; c++)
+      childWords += elimPerson[pNucFam->ppChildrenList[c]->personIndex].numWords;
+    if (childWords > maxChildWords)
+      maxChildWords = childWords;
+  }
+  if (numCompat > maxElimCompat) {
+    maxElimCompat = numCompat;
+    REALCHOKE(elimCompat, sizeof (size_t) * maxElimCompat, size_t *);
+  }
+  k = 0;
+  for (f = 0; f < pPedigree->numNuclearFamily; f++) {
+    pNucFam = pPedigree->ppNuclearFamilyList[f];
+    for (c = 0; c < pNucFam->numChildren; c++) {
+      pEC = &elimPerson[pNucFam->ppChildrenList[c]->personIndex];
+      for (p = DAD; p <= MOM; p++) {
+	pEP = &elimPerson[elimPerson[pNucFam->pParents[p]->personIndex].owner];
+	elimCompat[k++] = numBits;
+	numBits += (size_t) pEP->numGeno * pEC->numWords;
+      }
+    }
+  }
+  /* the children's surviving genotypes under the current parental pair */
+  scratch = numBits;
+  numBits += maxChildWords;
+
+  if (numGeno > maxElimGeno) {
+    maxElimGeno = numGeno;
+    REALCHOKE(elimGeno, sizeof (Genotype *) * maxElimGeno, Genotype **);
+  }
+  if (numBits > maxElimBits) {
+    maxElimBits = numBits;
+    REALCHOKE(elimBits, sizeof (uint64_t) * maxElimBits, uint64_t *);
+  }
+  memset (elimBits, 0, sizeof (uint64_t) * numBits);
+
+  /* everyone's genotypes start out alive */
+  for (i = 0; i < numPerson; i++) {
+    pEP = &elimPerson[i];
+    if (pEP->owner != i)
+      continue;
+    k = pEP->genoOffset;
+    for (pGeno = pPedigree->ppPersonList[i]->ppGenotypeList[locus]; pGeno != NULL; pGeno = pGeno->pNext)
+      elimGeno[k++] = pGeno;
+    for (j = 0; j < pEP->numGeno; j++)
+      elimBits[pEP->alive + j / ELIM_WORD_BITS] |= (uint64_t) 1 << (j % ELIM_WORD_BITS);
+  }
+  k = 0;
+  for (f = 0; f < pPedigree->numNuclearFamily; f++) {
+    pNucFam = pPedigree->ppNuclearFamilyList[f];
+    for (c = 0; c < pNucFam->numChildren; c++) {
+      pChild = pNucFam->ppChildrenList[c];
+      pEC = &elimPerson[pChild->personIndex];
+      for (p = DAD; p <= MOM; p++) {
+	pEP = &elimPerson[elimPerson[pNucFam->pParents[p]->personIndex].owner];
+	for (i = 0; i < pEP->numGeno; i++) {
+	  pChildBits = &elimBits[elimCompat[k] + (size_t) i * pEC->numWords];
+	  for (j = 0; j < pEC->numGeno; j++)
+	    if (elim_compatible (p, pChild->sex, elimGeno[pEP->genoOffset + i], elimGeno[pEC->genoOffset + j]) == TRUE)
+	      pChildBits[j / ELIM_WORD_BITS] |= (uint64_t) 1 << (j % ELIM_WORD_BITS);
+	}
+	k++;
+      }
+    }
+  }
+
+  failed = FALSE;
+  passNo = 0;
+  do {
+    changed = FALSE;
+    passNo++;
+    k = 0;
+    for (f = 0; f < pPedigree->numNuclearFamily && failed == FALSE; f++) {
+      pNucFam = pPedigree->ppNuclearFamilyList[f];
+      for (p = DAD; p <= MOM; p++) {
+	pParent[p] = &elimPerson[elimPerson[pNucFam->pParents[p]->personIndex].owner];
+	memset (&elimBits[pParent[p]->kept], 0, sizeof (uint64_t) * pParent[p]->numWords);
+      }
+      for (c = 0; c < pNucFam->numChildren; c++) {
+	pEC = &elimPerson[pNucFam->ppChildrenList[c]->personIndex];
+	memset (&elimBits[pEC->kept], 0, sizeof (uint64_t) * pEC->numWords);
+      }
+
+      /* every alive parental pair */
+      for (g[DAD] = 0; g[DAD] < pParent[DAD]->numGeno; g[DAD]++) {
+	if (!(elimBits[pParent[DAD]->alive + g[DAD] / ELIM_WORD_BITS] & ((uint64_t) 1 << (g[DAD] % ELIM_WORD_BITS))))
+	  continue;
+	for (g[MOM] = 0; g[MOM] < pParent[MOM]->numGeno; g[MOM]++) {
+	  if (!(elimBits[pParent[MOM]->alive + g[MOM] / ELIM_WORD_BITS] & ((uint64_t) 1 << (g[MOM] % ELIM_WORD_BITS))))
+	    continue;
+	  /* each child needs a genotype that goes with the pair */
+	  pairOK = TRUE;
+	  pScratch = &elimBits[scratch];
+	  for (c = 0; c < pNucFam->numChildren && pairOK == TRUE; c++) {
+	    pEC = &elimPerson[pNucFam->ppChildrenList[c]->personIndex];
+	    for (p = DAD; p <= MOM; p++)
+	      pRow[p] = &elimBits[elimCompat[k + 2 * c + p] + (size_t) g[p] * pEC->numWords];
+	    pChildBits = &elimBits[pEC->alive];
+	    unionBits = 0;
+	    for (w = 0; w < pEC->numWords; w++) {
+	      word = pRow[DAD][w] & pRow[MOM][w] & pChildBits[w];
+	      pScratch[w] = word;
+	      unionBits |= word;
+	    }
+	    if (unionBits == 0)
+	      pairOK = FALSE;
+	    pScratch += pEC->numWords;
+	  }
+	  if (pairOK == FALSE)
+	    continue;
+	  /* the pair stands, and so does all that goes with it */
+	  for (p = DAD; p <= MOM; p++)
+	    elimBits[pParent[p]->kept + g[p] / ELIM_WORD_BITS] |= (uint64_t) 1 << (g[p] % ELIM_WORD_BITS);
+	  pScratch = &elimBits[scratch];
+	  for (c = 0; c < pNucFam->numChildren; c++) {
+	    pEC = &elimPerson[pNucFam->ppChildrenList[c]->personIndex];
+	    for (w = 0; w < pEC->numWords; w++)
+	      elimBits[pEC->kept + w] |= pScratch[w];
+	    pScratch += pEC->numWords;
+	  }
+	}
+      }
+
+      /* whatever isn't kept is eliminated */
+      for (i = -2; i < pNucFam->numChildren; i++) {
+	if (i < 0) {
+	  pPerson = pNucFam->pParents[i + 2];
+	  pEP = pParent[i + 2];
+	} else {
+	  pPerson = pNucFam->ppChildrenList[i];
+	  pEP = &elimPerson[pPerson->personIndex];
+	}
+	unionBits = 0;
+	for (w = 0; w < pEP->numWords; w++) {
+	  if (elimBits[pEP->alive + w] != elimBits[pEP->kept + w]) {
+	    elimBits[pEP->alive + w] = elimBits[pEP->kept + w];
+	    changed = TRUE;
+	  }
+	  unionBits |= elimBits[pEP->alive + w];
+	}
+	if (genoElimState == 0 && unionBits == 0 && failed == FALSE) {
+	  WARNING ("Pedigree %s(%s) Person %s(%s) is not compatible at locus %s",
+		   pPerson->pPedigree->sPedigreeID, pPerson->pPedigree->sOriginalID, pPerson->sID, pPerson->sOriginalID, pLocus->sName);
+	  failed = TRUE;
+	}
+      }
+      k += 2 * pNucFam->numChildren;
+    }
+  } while (changed == TRUE && failed == FALSE);
+
+  /* take the eliminated genotypes off the lists */
+  for (i = 0; i < numPerson; i++) {
+    pEP = &elimPerson[i];
+    if (pEP->owner != i)
+      continue;
+    pPerson = pPedigree->ppPersonList[i];
+    pPrev = NULL;
+    for (j = 0; j < pEP->numGeno; j++) {
+      pGeno = elimGeno[pEP->genoOffset + j];
+      offset = pEP->alive + j / ELIM_WORD_BITS;
+      if (elimBits[offset] & ((uint64_t) 1 << (j % ELIM_WORD_BITS))) {
+	pPrev = pGeno;
+	continue;
+      }
+      DIAG (GENOTYPE_ELIMINATION, 1, {fprintf (stderr, "Remove person %s genotype (%d, %d).\n",
+					       pPerson->sID, pGeno->allele[DAD], pGeno->allele[MOM]);});
+      remove_genotype (pPrev == NULL ? &pPerson->ppGenotypeList[locus] : &pPrev->pNext, pGeno,
+		       &pPerson->pNumGenotype[locus]);
+    }
+  }
+  DIAG (GENOTYPE_ELIMINATION, 1, {
+      fprintf (stderr, "After %d passes:\n", passNo);
+      print_pedigree_locus_genotype_list(pPedigree, locus);
+    });
+
+  return (failed == TRUE) ? -1 : 0;
+}
+#endif
+
 /* return TRUE if the parent's genotype is compatible with 
  * the child's. 
  * For example if the parent is DAD, then the paternal allele 
@@ -20,3 +20,4 @@
 					      int parent, int childSex,
 					      Genotype * pChildGenotype);
 /*inline */int isHet (Genotype * pGeno);
+void free_genotype_elimination_space ();
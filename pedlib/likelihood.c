@@ -37,6 +37,9 @@ char *likelihoodVersion = "$Id$";
 #ifdef STUDYDB
 #include "../dcuhre.h"
 extern dcuhre_state *s;
+#ifdef _OPENMP
+#pragma omp threadprivate (s)
+#endif
 #endif
 
 #ifdef _OPENMP
@@ -166,6 +169,15 @@ int maxChildren;
 
 int multCount;
 
+/* Without polynomials, the children's multilocus genotypes are laid out
+ * as dense arrays of xmission indices and factors instead, one child after
+ * another, so that all of their terms can be valued by childTermValues at
+ * once (see child_terms_product) */
+int *childTermXmission[2];
+double *childTermFactor;
+double *childTermValue;
+int maxChildTerms;
+
 typedef struct probandCondL
 {
   char *pPedigreeID;
@@ -181,6 +193,16 @@ typedef struct probandCondL
 probandCondL *pCondSet = NULL;
 int numCond;
 
+#ifndef NO_CONCURRENT_PEELING
+/* Pedigrees are peeled concurrently, each thread in its own work space */
+#pragma omp threadprivate (pTempGenoVector, ppairMatrix, ppairMatrixRowSize, ppairMatrixNumLocus, bitMask, \
+			   pChild, pProband, pHaplo, child, childSum, pGenotype, traitGenoIndex, \
+			   pTraitParentalPair, parent, newProbPolynomial, newChromosome, numLocus, pNucFam, \
+			   calcFlag, likelihoodChildElements, maxChildElements, likelihoodChildCount, \
+			   maxChildren, multCount, childTermXmission, childTermFactor, childTermValue, maxChildTerms, \
+			   pCondSet, numCond)
+#endif
+
 /* function prototypes */
 void recalculate_child_likelihood (int[], void *);
 int peel_graph (NuclearFamily *, Person *, int);
@@ -199,9 +221,71 @@ inline void initialize_proband_tmpLikelihood (Person *);
 void populate_pedigree_loopbreaker_genotype_vector (Pedigree *);
 void populate_loopbreaker_genotype_vector (Person *, int);
 int set_next_loopbreaker_genotype_vector (Pedigree *, int);
+#ifndef NO_CONCURRENT_PEELING
+static void leave_peeling_thread ();
+#endif
 
 #include "../kelvinGlobals.h"
 
+#if defined (__GNUC__) && defined (__x86_64__) && !defined (NO_PEELING_SIMD)
+  #define PEELING_SIMD
+  #include <immintrin.h>
+#endif
+
+/* fewer children's terms than this aren't worth valuing all at once */
+#define MIN_VALUED_CHILD_TERMS 16
+
+/* doubles between consecutive xmission matrix entries */
+#define XMISSION_STRIDE (sizeof (XMission) / sizeof (double))
+
+/*
+ * values of the children's terms: paternal times maternal transmission
+ * probabilities times the factor, with the xmission indices flipped
+ * for a related parental pair
+ */
+static void childTermValuesScalar (int num, const int *dadIndex, const int *momIndex, const double *factor, int flipMask[2], double *value)
+{
+  int k;
+
+  for (k = 0; k < num; k++)
+    value[k] = xmissionMatrix[dadIndex[k] ^ flipMask[DAD]].slot.prob[1] * xmissionMatrix[momIndex[k] ^ flipMask[MOM]].slot.prob[2] * factor[k];
+}
+
+#ifdef PEELING_SIMD
+__attribute__ ((target ("avx2")))
+static void childTermValuesAVX2 (int num, const int *dadIndex, const int *momIndex, const double *factor, int flipMask[2], double *value)
+{
+  const double *dadProb = &xmissionMatrix[0].slot.prob[1], *momProb = &xmissionMatrix[0].slot.prob[2];
+  const __m128i dadFlip = _mm_set1_epi32 (flipMask[DAD]), momFlip = _mm_set1_epi32 (flipMask[MOM]);
+  const __m128i stride = _mm_set1_epi32 (XMISSION_STRIDE);
+  __m128i dad, mom;
+  int k;
+
+  for (k = 0; k + 4 <= num; k += 4) {
+    dad = _mm_mullo_epi32 (_mm_xor_si128 (_mm_loadu_si128 ((const __m128i *) &dadIndex[k]), dadFlip), stride);
+    mom = _mm_mullo_epi32 (_mm_xor_si128 (_mm_loadu_si128 ((const __m128i *) &momIndex[k]), momFlip), stride);
+    _mm256_storeu_pd (&value[k], _mm256_mul_pd (_mm256_mul_pd (_mm256_i32gather_pd (dadProb, dad, 8), _mm256_i32gather_pd (momProb, mom, 8)),
+						_mm256_loadu_pd (&factor[k])));
+  }
+  _mm256_zeroupper ();
+  childTermValuesScalar (num - k, &dadIndex[k], &momIndex[k], &factor[k], flipMask, &value[k]);
+}
+#endif
+
+void (*childTermValues) (int, const int *, const int *, const double *, int[2], double *) = childTermValuesScalar;
+
+/* pick the widest children's terms kernel the processor can run */
+static void select_peeling_kernels ()
+{
+#ifdef PEELING_SIMD
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2")) {
+    childTermValues = childTermValuesAVX2;
+    DIAG (LIKELIHOOD, 1, {fprintf (stderr, "Using AVX2 kernel for non-polynomial peeling\n");});
+  }
+#endif
+}
+
 /*
  * before likelihood calculation, pre-allocate space to store conditional
  * likelihoods 
@@ -211,11 +295,6 @@ int allocate_likelihood_space (PedigreeSet * pPedigreeList, int numLocus1)
 {
   Pedigree *pPedigree;
   int i;
-  int size;
-
-  numLocus = numLocus1;
-  /* this is for loop breaker multilocus genotypes */
-  MALCHOKE (pTempGenoVector, sizeof (Genotype *) * numLocus, Genotype **);
 
   for (i = 0; i < pPedigreeList->numPedigree; i++) {
     pPedigree = pPedigreeList->ppPedigreeSet[i];
@@ -223,8 +302,26 @@ int allocate_likelihood_space (PedigreeSet * pPedigreeList, int numLocus1)
      * allocate conditional likelihood storage for each
      * person/pedigree
      */
-    allocate_multi_locus_genotype_storage (pPedigree, numLocus);
+    allocate_multi_locus_genotype_storage (pPedigree, numLocus1);
   }
+  allocate_peeling_work_space (numLocus1);
+  select_peeling_kernels ();
+
+  return 0;
+}
+
+/*
+ * allocate the work space for peeling, which each thread building
+ * polynomials concurrently has its own of
+ */
+void allocate_peeling_work_space (int numLocus1)
+{
+  int i;
+  int size;
+
+  numLocus = numLocus1;
+  /* this is for loop breaker multilocus genotypes */
+  MALCHOKE (pTempGenoVector, sizeof (Genotype *) * numLocus, Genotype **);
 
   /*
    * allocate storage for temporarily stored likelihood for similar
@@ -256,12 +353,16 @@ int allocate_likelihood_space (PedigreeSet * pPedigreeList, int numLocus1)
   maxChildren = 20;
   CALCHOKE (likelihoodChildCount, sizeof (int), (size_t) maxChildren, int *);
 
+  maxChildTerms = 1024;
+  MALCHOKE (childTermXmission[DAD], sizeof (int) * maxChildTerms, int *);
+  MALCHOKE (childTermXmission[MOM], sizeof (int) * maxChildTerms, int *);
+  MALCHOKE (childTermFactor, sizeof (double) * maxChildTerms, double *);
+  MALCHOKE (childTermValue, sizeof (double) * maxChildTerms, double *);
+
   if (pCondSet == NULL) {
     MALCHOKE (pCondSet, sizeof (probandCondL) * 4, probandCondL *);
     numCond = 4;
   }
-
-  return 0;
 }
 
 /* free the storage space for conditionals */
@@ -274,9 +375,24 @@ void free_likelihood_space (PedigreeSet * pPedigreeList)
     pPedigree = pPedigreeList->ppPedigreeSet[i];
     free_multi_locus_genotype_storage (pPedigree);
   }
+#ifndef NO_CONCURRENT_PEELING
+#pragma omp parallel
+  {
+    leave_peeling_thread ();
+    free_genotype_elimination_space ();
+  }
+#endif
+  free_peeling_work_space ();
+  free_genotype_elimination_space ();
+}
+
+/* free the work space for peeling, except for pCondSet, which is kept */
+void free_peeling_work_space ()
+{
+  int i;
 
   /* free storage for temporary likelihood for similar parental pairs */
-  for (i = 0; i < pow (2, analysisLocusList->numLocus); i++) {
+  for (i = 0; i < pow (2, ppairMatrixNumLocus); i++) {
     free (ppairMatrix[i]);
   }
   free (ppairMatrix);
@@ -289,6 +405,131 @@ void free_likelihood_space (PedigreeSet * pPedigreeList)
   free (likelihoodChildCount);
   likelihoodChildElements = NULL;
   likelihoodChildCount = NULL;
+  free (childTermXmission[DAD]);
+  free (childTermXmission[MOM]);
+  free (childTermFactor);
+  free (childTermValue);
+  childTermXmission[DAD] = childTermXmission[MOM] = NULL;
+  childTermFactor = childTermValue = NULL;
+}
+
+/// Fold some bytes into a polynomial cache key (64-bit FNV-1a)
+static void add_to_polynomial_key (uint64_t *key, const void *data, int length)
+{
+  const unsigned char *bytes = (const unsigned char *) data;
+  int i;
+
+  for (i = 0; i < length; i++) {
+    *key ^= bytes[i];
+    *key *= UINT64_C (0x100000001B3);
+  }
+}
+
+/**
+
+  Compute the polynomial cache key for a pedigree's likelihood
+  polynomial. This must cover everything the structure of the
+  polynomial depends upon, and any values that end up in it as
+  constants rather than variables. The polynomial name already covers
+  the analysis type, liability classes, chromosome and loci. Beyond
+  that we need the analysis options that change how likelihoods are
+  built, the marker allele frequencies and allele sets, and for each
+  person their place in the pedigree, their phenotypes and their
+  genotypes after elimination.
+
+*/
+static uint64_t pedigree_polynomial_key (Pedigree * pPedigree, char *polynomialFunctionName)
+{
+  uint64_t key = UINT64_C (0xCBF29CE484222325);
+  Person *pPerson;
+  Locus *pLocus;
+  Genotype *pGenotype;
+  int i, j, locus, origLocus, parent;
+
+  add_to_polynomial_key (&key, polynomialFunctionName, strlen (polynomialFunctionName));
+  add_to_polynomial_key (&key, &modelType->trait, sizeof (modelType->trait));
+  add_to_polynomial_key (&key, &modelOptions->equilibrium, sizeof (modelOptions->equilibrium));
+  add_to_polynomial_key (&key, &modelOptions->sexLinked, sizeof (modelOptions->sexLinked));
+  add_to_polynomial_key (&key, &modelOptions->imprintingFlag, sizeof (modelOptions->imprintingFlag));
+  add_to_polynomial_key (&key, &modelOptions->mapFlag, sizeof (modelOptions->mapFlag));
+  add_to_polynomial_key (&key, &analysisLocusList->numLocus, sizeof (analysisLocusList->numLocus));
+  for (locus = 0; locus < analysisLocusList->numLocus; locus++) {
+    origLocus = analysisLocusList->pLocusIndex[locus];
+    pLocus = originalLocusList.ppLocusList[origLocus];
+    add_to_polynomial_key (&key, &origLocus, sizeof (origLocus));
+    add_to_polynomial_key (&key, &pLocus->locusType, sizeof (pLocus->locusType));
+    add_to_polynomial_key (&key, &pLocus->numAllele, sizeof (pLocus->numAllele));
+    if (pLocus->locusType == LOCUS_TYPE_MARKER)
+      add_to_polynomial_key (&key, pLocus->pAlleleFrequency, sizeof (double) * pLocus->numOriginalAllele);
+    add_to_polynomial_key (&key, &pLocus->numAlleleSet, sizeof (pLocus->numAlleleSet));
+    for (i = 0; i < pLocus->numAlleleSet; i++)
+      add_to_polynomial_key (&key, pLocus->ppAlleleSetList[i]->pAlleleBits, sizeof (unsigned int) * pLocus->alleleSetLen);
+  }
+
+  add_to_polynomial_key (&key, &pPedigree->numPerson, sizeof (pPedigree->numPerson));
+  for (i = 0; i < pPedigree->numPerson; i++) {
+    pPerson = pPedigree->ppPersonList[i];
+    add_to_polynomial_key (&key, &pPerson->sex, sizeof (pPerson->sex));
+    add_to_polynomial_key (&key, &pPerson->founderFlag, sizeof (pPerson->founderFlag));
+    add_to_polynomial_key (&key, &pPerson->loopBreaker, sizeof (pPerson->loopBreaker));
+    for (j = DAD; j <= MOM; j++) {
+      parent = (pPerson->pParents[j] == NULL) ? -1 : pPerson->pParents[j]->personIndex;
+      add_to_polynomial_key (&key, &parent, sizeof (parent));
+    }
+    for (locus = 0; locus < analysisLocusList->numLocus; locus++) {
+      origLocus = analysisLocusList->pLocusIndex[locus];
+      pLocus = originalLocusList.ppLocusList[origLocus];
+      if (pLocus->locusType == LOCUS_TYPE_TRAIT) {
+	for (j = 0; j < pLocus->pTraitLocus->numTrait; j++) {
+	  add_to_polynomial_key (&key, &pPerson->ppOrigTraitValue[origLocus][j], sizeof (double));
+	  add_to_polynomial_key (&key, &pPerson->ppTraitKnown[origLocus][j], sizeof (int));
+	  add_to_polynomial_key (&key, &pPerson->ppLiabilityClass[origLocus][j], sizeof (int));
+	}
+      }
+      add_to_polynomial_key (&key, &pPerson->pSavedNumGenotype[origLocus], sizeof (int));
+      for (pGenotype = pPerson->ppSavedGenotypeList[origLocus]; pGenotype != NULL; pGenotype = pGenotype->pSavedNext)
+	add_to_polynomial_key (&key, pGenotype->allele, sizeof (pGenotype->allele));
+    }
+  }
+  return key;
+}
+
+/* Restore a pedigree's likelihood polynomial from the cache, if there's one and it's in there */
+static int restore_cached_likelihood_polynomial (Pedigree * pPedigree, char *polynomialFunctionName)
+{
+  char cacheFileName[PATH_MAX];
+
+  if (modelOptions->polynomialCachePath[0] == '\0')
+    return FALSE;
+  if (snprintf (cacheFileName, PATH_MAX, "%s/%s.poly", modelOptions->polynomialCachePath,
+		polynomialFunctionName) >= PATH_MAX) {
+    DETAIL (0, "Polynomial cache file name for %s is too long, not using the cache", polynomialFunctionName);
+    return FALSE;
+  }
+  if ((pPedigree->likelihoodPolynomial =
+       restorePolyCache (cacheFileName, pedigree_polynomial_key (pPedigree, polynomialFunctionName))) == NULL)
+    return FALSE;
+  holdPoly (pPedigree->likelihoodPolynomial);
+  freeKeptPolys ();
+  pPedigree->likelihoodPolyList = buildPolyList ();
+  polyListSorting (pPedigree->likelihoodPolynomial, pPedigree->likelihoodPolyList);
+  return TRUE;
+}
+
+/* Save a newly-built and sorted pedigree likelihood polynomial to the cache, if there is one */
+static void save_cached_likelihood_polynomial (Pedigree * pPedigree, char *polynomialFunctionName)
+{
+  char cacheFileName[PATH_MAX];
+
+  if (modelOptions->polynomialCachePath[0] == '\0')
+    return;
+  if (snprintf (cacheFileName, PATH_MAX, "%s/%s.poly", modelOptions->polynomialCachePath,
+		polynomialFunctionName) >= PATH_MAX) {
+    DETAIL (0, "Polynomial cache file name for %s is too long, not saving to the cache", polynomialFunctionName);
+    return;
+  }
+  savePolyCache (pPedigree->likelihoodPolynomial, pPedigree->likelihoodPolyList, cacheFileName,
+		 pedigree_polynomial_key (pPedigree, polynomialFunctionName));
 }
 
 int build_likelihood_polynomial (Pedigree * pPedigree)
@@ -306,6 +547,10 @@ int build_likelihood_polynomial (Pedigree * pPedigree)
 #endif
     // Construct polynomialFunctionName for attempted load and maybe compilation
     sprintf (polynomialFunctionName, partialPolynomialFunctionName, pPedigree->sPedigreeID);
+
+    // Try the cache first, if there is one
+    if (restore_cached_likelihood_polynomial (pPedigree, polynomialFunctionName))
+      return EXIT_SUCCESS;
 #ifdef POLYUSE_DL
     if ((pPedigree->likelihoodPolynomial = restoreExternalPoly (polynomialFunctionName)) == NULL) {
 #endif
@@ -347,10 +592,247 @@ int build_likelihood_polynomial (Pedigree * pPedigree)
     // We still need to build a list even if there's only the external for the DL.
     pPedigree->likelihoodPolyList = buildPolyList ();
     polyListSorting (pPedigree->likelihoodPolynomial, pPedigree->likelihoodPolyList);
+    save_cached_likelihood_polynomial (pPedigree, polynomialFunctionName);
   }
   return EXIT_SUCCESS;
 }
 
+#ifndef NO_CONCURRENT_PEELING
+/* loci of the peeling work space of a thread other than the master, 0 if none */
+int peelingThreadLoci = 0;
+#pragma omp threadprivate (peelingThreadLoci)
+
+/* release the peeling work space given by enter_peeling_thread */
+static void leave_peeling_thread ()
+{
+  if (peelingThreadLoci == 0)
+    return;
+  free_peeling_work_space ();
+  free (pCondSet);
+  pCondSet = NULL;
+  free_parental_pair_workspace (&parentalPairSpace, peelingThreadLoci);
+  peelingThreadLoci = 0;
+}
+
+/*
+ * give a thread other than the master its own peeling work space, sized
+ * like the master's, for peeling pedigrees concurrently with it. The
+ * work space is kept for the thread's next time, since the same team
+ * of threads is used throughout, and only released by free_likelihood_space
+ */
+static void enter_peeling_thread (ParentalPairSpace * pMasterSpace, int workLoci, int masterNumLocus)
+{
+  if (omp_get_thread_num () == 0)
+    return;
+  if (peelingThreadLoci != workLoci ||
+      parentalPairSpace.maxNumParentalPair != pMasterSpace->maxNumParentalPair ||
+      parentalPairSpace.maxNumChildren != pMasterSpace->maxNumChildren ||
+      parentalPairSpace.maxNumChildGenotype != pMasterSpace->maxNumChildGenotype) {
+    leave_peeling_thread ();
+    initialize_parental_pair_workspace (&parentalPairSpace, originalLocusList.numLocus);
+    parentalPairSpace.maxNumParentalPair = pMasterSpace->maxNumParentalPair;
+    parentalPairSpace.maxNumChildren = pMasterSpace->maxNumChildren;
+    parentalPairSpace.maxNumChildGenotype = pMasterSpace->maxNumChildGenotype;
+    allocate_parental_pair_workspace (&parentalPairSpace, workLoci);
+    allocate_peeling_work_space (workLoci);
+    peelingThreadLoci = workLoci;
+  }
+  numLocus = masterNumLocus;
+}
+
+/*
+ * Work, as measured by pedigree_peeling_work, below which it doesn't
+ * pay to share pedigrees out amongst threads. Peeling without
+ * polynomials costs about 15ns per unit, so a set of pedigrees must
+ * come to a few hundred microseconds before it covers starting and
+ * joining the threads. Building a polynomial costs about 1us per unit,
+ * but every term built concurrently takes locks, so only pedigrees
+ * taking a millisecond or more are built concurrently
+ */
+#define MIN_CONCURRENT_PEELING_WORK 16384
+#define MIN_CONCURRENT_BUILD_WORK 1024
+
+/*
+ * threads to peel with, no more than there are processors to run
+ * them, since threads waiting on each other for a processor spend
+ * longer than the peeling itself
+ */
+static int peeling_threads ()
+{
+  return MIN (omp_get_max_threads (), omp_get_num_procs ());
+}
+
+/*
+ * a rough measure of the work in peeling a pedigree: the number of
+ * multi-locus genotype combinations of each child with its parents,
+ * and of each founder alone
+ */
+static double pedigree_peeling_work (Pedigree * pPedigree)
+{
+  Person *pPerson;
+  double work = 0, combinations;
+  int i, j, locus, origLocus;
+
+  for (i = 0; i < pPedigree->numPerson; i++) {
+    pPerson = pPedigree->ppPersonList[i];
+    combinations = 1;
+    for (locus = 0; locus < analysisLocusList->numLocus; locus++) {
+      origLocus = analysisLocusList->pLocusIndex[locus];
+      combinations *= pPerson->pSavedNumGenotype[origLocus];
+      for (j = DAD; j <= MOM; j++)
+	if (pPerson->pParents[j] != NULL)
+	  combinations *= pPerson->pParents[j]->pSavedNumGenotype[origLocus];
+    }
+    work += combinations;
+  }
+  return work;
+}
+#endif
+
+/*
+
+  Make sure every pedigree in the set has its likelihood polynomial.
+
+  With several OpenMP threads and processors, the pedigrees that are
+  neither built nor cached, and are big enough to be worth it, are
+  constructed concurrently, a round of up to one per thread at a time.
+  Smaller ones are built serially as they come. Each thread peels in
+  its own work space (the
+  peeling globals are threadprivate), and polynomial construction
+  is safe to share while between beginConcurrentPolyBuild and
+  endConcurrentPolyBuild. Nothing can be freed during a round, so
+  the results are held and everything else freed between rounds,
+  which is also when the serial steps of sorting and caching happen.
+
+*/
+void build_likelihood_polynomials (PedigreeSet * pPedigreeList)
+{
+  Pedigree *pPedigree;
+  int i;
+
+#ifndef NO_POLY_CONCURRENT_BUILD
+  Pedigree **ppRound;
+  ParentalPairSpace *pMasterSpace;
+  char polynomialFunctionName[MAX_PFN_LEN + 1];
+  int threads, roundCount, j, workLoci, masterNumLocus;
+
+  threads = peeling_threads ();
+  if (modelOptions->polynomial == TRUE && threads > 1) {
+    MALCHOKE (ppRound, sizeof (Pedigree *) * threads, Pedigree **);
+    i = 0;
+    while (i < pPedigreeList->numPedigree) {
+      /* Gather the next round of pedigrees that need to be constructed */
+      for (roundCount = 0; i < pPedigreeList->numPedigree && roundCount < threads; i++) {
+	pPedigree = pPedigreeList->ppPedigreeSet[i];
+	if (pPedigree->likelihoodPolynomial != NULL)
+	  continue;
+	if (pedigree_peeling_work (pPedigree) < MIN_CONCURRENT_BUILD_WORK) {
+	  build_likelihood_polynomial (pPedigree);
+	  continue;
+	}
+	sprintf (polynomialFunctionName, partialPolynomialFunctionName, pPedigree->sPedigreeID);
+	if (!restore_cached_likelihood_polynomial (pPedigree, polynomialFunctionName))
+	  ppRound[roundCount++] = pPedigree;
+      }
+      if (roundCount == 1) {
+	build_likelihood_polynomial (ppRound[0]);
+	continue;
+      }
+      if (roundCount == 0)
+	continue;
+
+      pMasterSpace = &parentalPairSpace;
+      workLoci = ppairMatrixNumLocus;
+      masterNumLocus = numLocus;
+      beginConcurrentPolyBuild ();
+#pragma omp parallel private(j) num_threads(threads)
+      {
+	enter_peeling_thread (pMasterSpace, workLoci, masterNumLocus);
+#pragma omp for schedule(dynamic, 1)
+	for (j = 0; j < roundCount; j++) {
+	  initialize_multi_locus_genotype (ppRound[j]);
+	  compute_pedigree_likelihood (ppRound[j]);
+	}
+      }
+      endConcurrentPolyBuild ();
+
+      /* Keep only the round's results, then sort and cache them */
+      for (j = 0; j < roundCount; j++)
+	holdPoly (ppRound[j]->likelihoodPolynomial);
+      freeKeptPolys ();
+      for (j = 0; j < roundCount; j++) {
+	pPedigree = ppRound[j];
+	pPedigree->likelihoodPolyList = buildPolyList ();
+	polyListSorting (pPedigree->likelihoodPolynomial, pPedigree->likelihoodPolyList);
+	sprintf (polynomialFunctionName, partialPolynomialFunctionName, pPedigree->sPedigreeID);
+	save_cached_likelihood_polynomial (pPedigree, polynomialFunctionName);
+      }
+    }
+    free (ppRound);
+    return;
+  }
+#endif
+
+  for (i = 0; i < pPedigreeList->numPedigree; i++) {
+    pPedigree = pPedigreeList->ppPedigreeSet[i];
+    if (pPedigree->likelihoodPolynomial == NULL)  // There's no polynomial, so come up with one
+      build_likelihood_polynomial (pPedigree);
+  }
+}
+
+/*
+
+  Compute the likelihood of every pedigree in the set without
+  polynomials.
+
+  With several OpenMP threads and processors, and enough work between
+  them, the pedigrees are peeled concurrently, each thread in its own
+  work space as for build_likelihood_polynomials.
+  Peeling only reads the shared transmission matrix and penetrances,
+  and otherwise writes to the pedigree being peeled, so nothing needs
+  to be serialized. The likelihoods are combined by the caller in
+  pedigree order, so results don't depend upon the number of threads.
+
+*/
+void compute_pedigree_likelihoods (PedigreeSet * pPedigreeList)
+{
+  Pedigree *pPedigree;
+  int i;
+
+#ifndef NO_CONCURRENT_PEELING
+  ParentalPairSpace *pMasterSpace;
+  int workLoci, masterNumLocus, threads;
+  double work = 0;
+
+  threads = peeling_threads ();
+  if (threads > 1 && pPedigreeList->numPedigree > 1)
+    for (i = 0; i < pPedigreeList->numPedigree && work < MIN_CONCURRENT_PEELING_WORK; i++)
+      work += pedigree_peeling_work (pPedigreeList->ppPedigreeSet[i]);
+  if (work >= MIN_CONCURRENT_PEELING_WORK) {
+    pMasterSpace = &parentalPairSpace;
+    workLoci = ppairMatrixNumLocus;
+    masterNumLocus = numLocus;
+#pragma omp parallel private(i, pPedigree) num_threads(threads)
+    {
+      enter_peeling_thread (pMasterSpace, workLoci, masterNumLocus);
+#pragma omp for schedule(dynamic, 1)
+      for (i = 0; i < pPedigreeList->numPedigree; i++) {
+	pPedigree = pPedigreeList->ppPedigreeSet[i];
+	initialize_multi_locus_genotype (pPedigree);
+	compute_pedigree_likelihood (pPedigree);
+      }
+    }
+    return;
+  }
+#endif
+
+  for (i = 0; i < pPedigreeList->numPedigree; i++) {
+    pPedigree = pPedigreeList->ppPedigreeSet[i];
+    initialize_multi_locus_genotype (pPedigree);
+    compute_pedigree_likelihood (pPedigree);
+  }
+}
+
 #ifdef STUDYDB
 
 void compute_server_pedigree_likelihood (PedigreeSet *pPedigreeList, Pedigree *pPedigree, int updateFlag) {
@@ -1084,13 +1566,12 @@ int compute_likelihood (char *fileName, int lineNo, PedigreeSet * pPedigreeList)
 
     /* Make sure they exist. Need to check until the day we have all builds separate, and
      * then we pull this to improve evaulation performance. */
-    for (i = 0; i < pPedigreeList->numPedigree; i++) {
-      pPedigree = pPedigreeList->ppPedigreeSet[i];
-      if (pPedigree->likelihoodPolynomial == NULL)  // There's no polynomial, so come up with one
-	build_likelihood_polynomial (pPedigree);
-    }
+    build_likelihood_polynomials (pPedigreeList);
 
     /* Now evaluate them all */
+#if !defined (NO_POLY_TAPE) && !defined (FAKEEVALUATE) && !defined (MANYSMALLEVALUATE) && !defined (POLYCHECK_DL)
+    evaluate_pedigree_set_polynomials (pPedigreeList);
+#else
 #ifdef _OPENMP
 #pragma omp parallel for private(pPedigree)
 #endif
@@ -1114,16 +1595,14 @@ int compute_likelihood (char *fileName, int lineNo, PedigreeSet * pPedigreeList)
 #endif
 #endif
     }
-  }
-  /* Now (optional non-poly) and incorporate results */
+#endif
+  } else
+    compute_pedigree_likelihoods (pPedigreeList);
+
+  /* Now incorporate (non-poly) results */
   for (i = 0; i < pPedigreeList->numPedigree; i++) {
     pPedigree = pPedigreeList->ppPedigreeSet[i];
     if (modelOptions->polynomial == FALSE) {
-      initialize_multi_locus_genotype (pPedigree);
-
-      //fprintf(stderr," %d th ped calling for compute_pedigree_likelihood which seems for both trait and marker or combined \n",i);
-      compute_pedigree_likelihood (pPedigree);
-
 #ifdef STUDYDB
       DIAG (ALTLSERVER, 1, { \
       fprintf (stderr, "Ped: %s, Pos: %.8g, DGF: %.8g, LC1DD: %.8g, LC1Dd: %.8g, LC1dd: %.8g => Likelihood %.8g (normal)\n", \
@@ -1188,6 +1667,96 @@ int compute_likelihood (char *fileName, int lineNo, PedigreeSet * pPedigreeList)
   return ret;
 }
 
+/* Get the merged tape of the likelihood polynomials of all pedigrees,
+ * rebuilding it whenever any pedigree's polynomial has been rebuilt
+ * since */
+static struct polyTape *pedigree_set_polynomial_tape (PedigreeSet * pPedigreeList)
+{
+  struct polyList **ppLists;
+  Polynomial **ppRoots;
+  int i;
+
+  MALCHOKE (ppLists, sizeof (struct polyList *) * pPedigreeList->numPedigree, struct polyList **);
+  for (i = 0; i < pPedigreeList->numPedigree; i++)
+    ppLists[i] = pPedigreeList->ppPedigreeSet[i]->likelihoodPolyList;
+
+  if (pPedigreeList->likelihoodPolyTape != NULL &&
+      !mergedPolyTapeIsCurrent (pPedigreeList->likelihoodPolyTape, pPedigreeList->numPedigree, ppLists)) {
+    freeMergedPolyTape (pPedigreeList->likelihoodPolyTape);
+    pPedigreeList->likelihoodPolyTape = NULL;
+  }
+  if (pPedigreeList->likelihoodPolyTape == NULL) {
+    MALCHOKE (ppRoots, sizeof (Polynomial *) * pPedigreeList->numPedigree, Polynomial **);
+    for (i = 0; i < pPedigreeList->numPedigree; i++)
+      ppRoots[i] = pPedigreeList->ppPedigreeSet[i]->likelihoodPolynomial;
+    pPedigreeList->likelihoodPolyTape = buildMergedPolyTape (pPedigreeList->numPedigree, ppRoots, ppLists);
+    free (ppRoots);
+  }
+  free (ppLists);
+  return pPedigreeList->likelihoodPolyTape;
+}
+
+/* Evaluate the likelihood polynomials of all pedigrees together from a
+ * merged tape, so terms shared between pedigrees are evaluated once and
+ * the work can be shared-out amongst threads without them contending
+ * for the polynomials. */
+void evaluate_pedigree_set_polynomials (PedigreeSet * pPedigreeList)
+{
+  double *pLikelihoods;
+  int i;
+
+  MALCHOKE (pLikelihoods, sizeof (double) * pPedigreeList->numPedigree, double *);
+  evaluateMergedPolyTape (pedigree_set_polynomial_tape (pPedigreeList), pLikelihoods);
+  for (i = 0; i < pPedigreeList->numPedigree; i++)
+    pPedigreeList->ppPedigreeSet[i]->likelihood = pLikelihoods[i];
+  free (pLikelihoods);
+}
+
+/*
+
+  Batched evaluation of the pedigrees' likelihoods at many points, for
+  an integrand that knows all of its points up front. The polynomials
+  must have been built by an earlier compute_likelihood. Get their
+  merged tape from pedigree_set_batch_tape, then for each point set up
+  the model the usual way and capture it with
+  captureMergedPolyTapeVariables. Evaluate them all with
+  evaluateMergedPolyTapeBatch, and finally take_batch_likelihoods for
+  each point in turn, which leaves things just as compute_likelihood
+  would have. pedigree_set_batch_tape returns NULL when likelihoods
+  can't be evaluated this way, in which case compute_likelihood must be
+  used.
+
+*/
+struct polyTape *pedigree_set_batch_tape (PedigreeSet * pPedigreeList)
+{
+#if !defined (NO_POLY_TAPE) && !defined (FAKEEVALUATE) && !defined (MANYSMALLEVALUATE) && !defined (POLYCHECK_DL) && !defined (STUDYDB)
+  int i;
+
+  if (modelOptions->polynomial != TRUE)
+    return NULL;
+  for (i = 0; i < pPedigreeList->numPedigree; i++)
+    if (pPedigreeList->ppPedigreeSet[i]->likelihoodPolynomial == NULL ||
+	pPedigreeList->ppPedigreeSet[i]->likelihoodPolynomial->eType == T_EXTERNAL)
+      return NULL;
+  return pedigree_set_polynomial_tape (pPedigreeList);
+#else
+  return NULL;
+#endif
+}
+
+/* Take the likelihoods of one point of a batch, as compute_likelihood
+ * would have left them */
+int take_batch_likelihoods (PedigreeSet * pPedigreeList, double *likelihoods)
+{
+  int i;
+
+  for (i = 0; i < pPedigreeList->numPedigree; i++)
+    pPedigreeList->ppPedigreeSet[i]->likelihood = likelihoods[i];
+  pPedigreeList->likelihood = 1;
+  pPedigreeList->log10Likelihood = 0;
+  return 0;
+}
+
 /* release polynomial for all pedigrees */
 void pedigreeSetPolynomialClearance (PedigreeSet * pPedigreeList)
 {
@@ -1196,6 +1765,8 @@ void pedigreeSetPolynomialClearance (PedigreeSet * pPedigreeList)
   int i;
 
   if (modelOptions->polynomial == TRUE) {
+    freeMergedPolyTape (pPedigreeList->likelihoodPolyTape);
+    pPedigreeList->likelihoodPolyTape = NULL;
     for (i = 0; i < pPedigreeList->numPedigree; i++) {
       pPedigree = pPedigreeList->ppPedigreeSet[i];
       if (pPedigree->likelihoodPolynomial != NULL) {
@@ -1203,8 +1774,7 @@ void pedigreeSetPolynomialClearance (PedigreeSet * pPedigreeList)
         if (pPedigree->likelihoodPolynomial->eType == T_EXTERNAL)
           releaseExternalPoly (pPedigree->likelihoodPolynomial);
         pPedigree->likelihoodPolynomial = NULL;
-        free (pPedigree->likelihoodPolyList->pList);
-        free (pPedigree->likelihoodPolyList);
+        freePolyList (pPedigree->likelihoodPolyList);
         pPedigree->likelihoodPolyList = NULL;
       }
     }
@@ -2416,7 +2986,6 @@ void loop_phases (int locus, int multiLocusIndex[2], int multiLocusPhase[2], int
           calcFlag = 0;
         } else {
           if (multiLocusPhase2[DAD] == 0 && multiLocusPhase2[MOM] == 0) {
-            memset (likelihoodChildCount, 0, sizeof (int) * maxChildren);
             calcFlag = 1;
           } else {
             calcFlag = 2;
@@ -2438,42 +3007,65 @@ void loop_phases (int locus, int multiLocusIndex[2], int multiLocusPhase[2], int
 }       /* end of loop_phases() */
 
 
+/*
+ * product over the nuclear family's children of the sums of their terms,
+ * as laid out by loop_child_multi_locus_genotype without polynomials.
+ * Sex-linked male children get only their mother's chromosome unless
+ * the terms are being reused for a related parental pair.
+ */
+static double child_terms_product (int flipMask[2], int fresh)
+{
+  double product = 1, sum;
+  int i, j, k = 0;
+  int valued = (multCount >= MIN_VALUED_CHILD_TERMS);
+
+  if (valued)
+    childTermValues (multCount, childTermXmission[DAD], childTermXmission[MOM], childTermFactor, flipMask, childTermValue);
+  for (i = 0; i < pNucFam->numChildren; i++) {
+    sum = 0;
+    if (fresh && modelOptions->sexLinked != 0 && pNucFam->ppChildrenList[i]->sex + 1 == MALE)
+      for (j = 0; j < likelihoodChildCount[i]; j++, k++)
+        sum += xmissionMatrix[childTermXmission[MOM][k]].slot.prob[2] * childTermFactor[k];
+    else if (valued)
+      for (j = 0; j < likelihoodChildCount[i]; j++)
+        sum += childTermValue[k++];
+    else
+      for (j = 0; j < likelihoodChildCount[i]; j++, k++)
+        sum += xmissionMatrix[childTermXmission[DAD][k] ^ flipMask[DAD]].slot.prob[1] *
+          xmissionMatrix[childTermXmission[MOM][k] ^ flipMask[MOM]].slot.prob[2] * childTermFactor[k];
+    DIAG (LIKELIHOOD, 1, {fprintf (stderr, "\t child sum %e \n", sum);});
+    product *= sum;
+  }
+  return product;
+}
+
 /* calculating childProduct base on previous pattern */
 void recalculate_child_likelihood (int flipMask[2], void *childProduct)
 {
   int i, j;
-  double myChildSum = 0;
   Polynomial *childSumPoly = NULL;
   ChildElement *pElement;
   int xmissionIndex[2];
 
   multCount = 0;
-  if (modelOptions->polynomial == TRUE)
-    *(Polynomial **) childProduct = constant1Poly;
-  else
-    *(double *) childProduct = 1;
+  if (modelOptions->polynomial != TRUE) {
+    for (i = 0; i < pNucFam->numChildren; i++)
+      multCount += likelihoodChildCount[i];
+    *(double *) childProduct = child_terms_product (flipMask, FALSE);
+    return;
+  }
+  *(Polynomial **) childProduct = constant1Poly;
 
   for (i = 0; i < pNucFam->numChildren; i++) {
-    if (modelOptions->polynomial == TRUE)
-      childSumPoly = constant0Poly;
-    else
-      myChildSum = 0;
+    childSumPoly = constant0Poly;
     for (j = 0; j < likelihoodChildCount[i]; j++) {
       pElement = &likelihoodChildElements[multCount + j];
       for (parent = DAD; parent <= MOM; parent++) {
         xmissionIndex[parent] = pElement->xmissionIndex[parent] ^ flipMask[parent];
       }
-
-      if (modelOptions->polynomial == TRUE) {
-        childSumPoly = plusExp (2, 1.0, childSumPoly, 1.0, timesExp (3, xmissionMatrix[xmissionIndex[DAD]].slot.probPoly[1], 1, xmissionMatrix[xmissionIndex[MOM]].slot.probPoly[2], 1, pElement->fslot.factorPolynomial, 1, 0), 1);
-      } else {
-        myChildSum += xmissionMatrix[xmissionIndex[DAD]].slot.prob[1] * xmissionMatrix[xmissionIndex[MOM]].slot.prob[2] * pElement->fslot.factor;
-      }
+      childSumPoly = plusExp (2, 1.0, childSumPoly, 1.0, timesExp (3, xmissionMatrix[xmissionIndex[DAD]].slot.probPoly[1], 1, xmissionMatrix[xmissionIndex[MOM]].slot.probPoly[2], 1, pElement->fslot.factorPolynomial, 1, 0), 1);
     }
-    if (modelOptions->polynomial == TRUE)
-      *(Polynomial **) childProduct = timesExp (2, *(Polynomial **) childProduct, 1, childSumPoly, 1, 1);
-    else
-      *(double *) childProduct *= myChildSum;
+    *(Polynomial **) childProduct = timesExp (2, *(Polynomial **) childProduct, 1, childSumPoly, 1, 1);
     multCount += likelihoodChildCount[i];
 
   }
@@ -2520,6 +3112,8 @@ int calculate_likelihood (int multiLocusIndex[2],       ///< Input, index into p
   int traitLocus;
   int genoIndex;
   double sum;
+  int firstTerm;
+  int noFlip[2] = { 0, 0 };
 
   Polynomial *newWeightPolynomial[2] = { NULL, NULL };
   Polynomial *penetrancePolynomial[2] = { NULL, NULL };
@@ -2625,6 +3219,12 @@ int calculate_likelihood (int multiLocusIndex[2],       ///< Input, index into p
     /* now work on the children conditional on this parental pair */
     childProduct = 1;
     multCount = 0;
+    if (pNucFam->numChildren > maxChildren) {
+      maxChildren = pNucFam->numChildren;
+      REALCHOKE (likelihoodChildCount, sizeof (int) * maxChildren, int *);
+    }
+    if (modelOptions->polynomial == TRUE)
+      memset (likelihoodChildCount, 0, sizeof (int) * pNucFam->numChildren);
     if (modelOptions->polynomial == TRUE)
       childProductPolynomial = constant1Poly;   // Non-destructive assignment
     for (child = 0; child < pNucFam->numChildren; child++) {
@@ -2638,11 +3238,14 @@ int calculate_likelihood (int multiLocusIndex[2],       ///< Input, index into p
         loop_child_multi_locus_genotype (0, 0, xmissionIndex);
         childProductPolynomial = timesExp (2, childProductPolynomial, 1, (Polynomial *) sumPolynomial, 1, 1);
       } else {
-        sum = 0;
+        /* just lay out the child's multilocus genotypes */
+        firstTerm = multCount;
         loop_child_multi_locus_genotype (0, 0, xmissionIndex);
-        childProduct *= sum;
+        likelihoodChildCount[child] = multCount - firstTerm;
       }
     }   /* looping over all children */
+    if (modelOptions->polynomial != TRUE)
+      childProduct = child_terms_product (noFlip, TRUE);
   }
 
   /* results processing */
@@ -2779,7 +3382,6 @@ void get_haplotype_freq (int locus, int myParent, void *freqPtr)
  */
 int loop_child_multi_locus_genotype (int locus, int multiLocusIndex, int xmissionIndex[2])
 {
-  double newProb = 1;
   int i;
   int newMultiLocusIndex;
   int newXmissionIndex[2];
@@ -2814,33 +3416,50 @@ int loop_child_multi_locus_genotype (int locus, int multiLocusIndex, int xmissio
     if (locus < analysisLocusList->numLocus - 1) {
       loop_child_multi_locus_genotype (locus + 1, newMultiLocusIndex, newXmissionIndex);
     } else {
-
-      /* get the transmission probability from the matrix */
-      if (modelOptions->polynomial == TRUE) {
-        if ((modelOptions->sexLinked != 0) && pChild->sex + 1 == MALE) {
-          newProbPolynomial = xmissionMatrix[newXmissionIndex[MOM]].slot.probPoly[2];
-        } else {
-          newProbPolynomial = timesExp (2, xmissionMatrix[newXmissionIndex[DAD]].slot.probPoly[1], 1, xmissionMatrix[newXmissionIndex[MOM]].slot.probPoly[2], 1, 0);
+      if (modelOptions->polynomial != TRUE) {
+        /* lay it out for calculate_likelihood to sum */
+        if (multCount >= maxChildTerms) {
+          maxChildTerms += 1024;
+          REALCHOKE (childTermXmission[DAD], sizeof (int) * maxChildTerms, int *);
+          REALCHOKE (childTermXmission[MOM], sizeof (int) * maxChildTerms, int *);
+          REALCHOKE (childTermFactor, sizeof (double) * maxChildTerms, double *);
+          REALCHOKE (childTermValue, sizeof (double) * maxChildTerms, double *);
         }
+        childTermXmission[DAD][multCount] = newXmissionIndex[DAD];
+        childTermXmission[MOM][multCount] = newXmissionIndex[MOM];
+        if (pChild != pProband && pChild->touchedFlag == 1)
+          /* some likelihood calculation has been done for this child */
+          childTermFactor[multCount] = pChild->pLikelihood[newMultiLocusIndex].lkslot.likelihood;
+        else if (pChild != pProband && analysisLocusList->traitLocusIndex >= 0) {
+          /*
+           * first time working on this child's current multilocus
+           * genotype and we need to consider penetrance
+           */
+          traitGenoIndex = pHaplo->pChildGenoInd[analysisLocusList->traitLocusIndex];
+          pTraitParentalPair = &pHaplo->ppParentalPair[analysisLocusList->traitLocusIndex][pHaplo->pParentalPairInd[analysisLocusList->traitLocusIndex]];
+          childTermFactor[multCount] = pTraitParentalPair->pppChildGenoList[child][traitGenoIndex]->penslot.penetrance;
+        } else
+          /* no trait locus and new to this child, or the proband, whose penetrance is figured in later */
+          childTermFactor[multCount] = 1;
         DIAG (LIKELIHOOD, 1, {
-            fprintf (stderr, "\t xmission prob: %f = %f * %f\n", evaluateValue (newProbPolynomial),
-		     evaluateValue (xmissionMatrix[newXmissionIndex[DAD]].slot.probPoly[1]), evaluateValue (xmissionMatrix[newXmissionIndex[MOM]].slot.probPoly[2]));
-	  });
+              fprintf (stderr, "\t xmission prob: %f * %f, child factor %e\n", xmissionMatrix[newXmissionIndex[DAD]].slot.prob[1],
+		       xmissionMatrix[newXmissionIndex[MOM]].slot.prob[2], childTermFactor[multCount]);
+            }
+        );
+        multCount++;
+        continue;
+      }
+
+      /* get the transmission probability from the matrix */
+      if ((modelOptions->sexLinked != 0) && pChild->sex + 1 == MALE) {
+        newProbPolynomial = xmissionMatrix[newXmissionIndex[MOM]].slot.probPoly[2];
       } else {
-        if ((modelOptions->sexLinked != 0) && pChild->sex + 1 == MALE) {
-          newProb = xmissionMatrix[newXmissionIndex[MOM]].slot.prob[2];
-          DIAG (LIKELIHOOD, 1, {
-                fprintf (stderr, "\t xmission prob: %f = %f\n", newProb, xmissionMatrix[newXmissionIndex[MOM]].slot.prob[2]);
-              }
-          );
-        } else {
-          newProb = xmissionMatrix[newXmissionIndex[DAD]].slot.prob[1] * xmissionMatrix[newXmissionIndex[MOM]].slot.prob[2];
-          DIAG (LIKELIHOOD, 1, {
-                fprintf (stderr, "\t xmission prob: %f = %f * %f\n", newProb, xmissionMatrix[newXmissionIndex[DAD]].slot.prob[1], xmissionMatrix[newXmissionIndex[MOM]].slot.prob[2]);
-              }
-          );
-        }
+        newProbPolynomial = timesExp (2, xmissionMatrix[newXmissionIndex[DAD]].slot.probPoly[1], 1, xmissionMatrix[newXmissionIndex[MOM]].slot.probPoly[2], 1, 0);
       }
+      DIAG (LIKELIHOOD, 1, {
+          fprintf (stderr, "\t xmission prob: %f = %f * %f\n", evaluateValue (newProbPolynomial),
+		     evaluateValue (xmissionMatrix[newXmissionIndex[DAD]].slot.probPoly[1]), evaluateValue (xmissionMatrix[newXmissionIndex[MOM]].slot.probPoly[2]));
+	  });
 
       /* we have completed one multilocus genotype for this child */
       /*
@@ -2848,114 +3467,60 @@ int loop_child_multi_locus_genotype (int locus, int multiLocusIndex, int xmissio
        * kid we should have if this kid is a connector to another
        * nuclear family we have processed before
        */
+
       if (calcFlag == 1 && multCount >= maxChildElements) {
         /* resizing likelihoodchildElements array */
         maxChildElements += 1024;
         REALCHOKE (likelihoodChildElements, sizeof (ChildElement) * maxChildElements, ChildElement *);
       }
-      if (modelOptions->polynomial == TRUE) {
-        if (pChild != pProband) {
-          /* the child is not a proband */
-          if (pChild->touchedFlag == 1) {
-            /*
-             * some likelihood calculation has
-             * been calculated for this child
-             */
-            *(Polynomial **) childSum = plusExp (2, 1.0, *(Polynomial **) childSum, 1.0, timesExp (2, newProbPolynomial, 1, pChild->pLikelihood[newMultiLocusIndex].lkslot.likelihoodPolynomial, 1, 1), //end of timesExp
-                1);
-            if (calcFlag == 1) {
-              likelihoodChildElements[multCount].fslot.factorPolynomial = pChild->pLikelihood[newMultiLocusIndex].lkslot.likelihoodPolynomial;
-            }
-            //end of plusExp
-            DIAG (LIKELIHOOD, 1, { fprintf (stderr, "\t use already calculated child prob %e \n", evaluateValue (pChild->pLikelihood[newMultiLocusIndex].lkslot.likelihoodPolynomial)); });
-          } else if (analysisLocusList->traitLocusIndex >= 0)
-            /*
-             * first time working on this child's
-             * current multilocus genotype and we
-             * need to consider penetrance
-             */
-          {
-            traitGenoIndex = pHaplo->pChildGenoInd[analysisLocusList->traitLocusIndex];
-            pTraitParentalPair = &pHaplo->ppParentalPair[analysisLocusList->traitLocusIndex][pHaplo->pParentalPairInd[analysisLocusList->traitLocusIndex]];
-            *(Polynomial **) childSum = plusExp (2, 1.0, *(Polynomial **) childSum, 1.0, timesExp (2, newProbPolynomial, 1, pTraitParentalPair->pppChildGenoList[child]
-                    [traitGenoIndex]->penslot.penetrancePolynomial, 1, 1),      //end of timesExp
-                1);
-
-            if (calcFlag == 1) {
-              likelihoodChildElements[multCount].fslot.factorPolynomial = pTraitParentalPair->pppChildGenoList[child]
-                  [traitGenoIndex]->penslot.penetrancePolynomial;
-            }
-          } else {
-            /*
-             * no trait locus and new to this
-             * child
-             */
-            *(Polynomial **) childSum = plusExp (2, 1.0, *(Polynomial **) childSum, 1.0, newProbPolynomial, 1);
-            if (calcFlag == 1) {
-              likelihoodChildElements[multCount].fslot.factorPolynomial = constant1Poly;
-            }
-          }
-        } else {        /* this child is proband */
-          *(Polynomial **) childSum = plusExp (2, 1.0, *(Polynomial **) childSum, 1.0, newProbPolynomial, 1);
+      if (pChild != pProband) {
+        /* the child is not a proband */
+        if (pChild->touchedFlag == 1) {
+          /*
+           * some likelihood calculation has
+           * been calculated for this child
+           */
+          *(Polynomial **) childSum = plusExp (2, 1.0, *(Polynomial **) childSum, 1.0, timesExp (2, newProbPolynomial, 1, pChild->pLikelihood[newMultiLocusIndex].lkslot.likelihoodPolynomial, 1, 1), //end of timesExp
+              1);
           if (calcFlag == 1) {
-            likelihoodChildElements[multCount].fslot.factorPolynomial = constant1Poly;
+            likelihoodChildElements[multCount].fslot.factorPolynomial = pChild->pLikelihood[newMultiLocusIndex].lkslot.likelihoodPolynomial;
           }
-        }
-        DIAG (LIKELIHOOD, 1, { fprintf (stderr, "\t child sum %e \n", evaluateValue (*(Polynomial **) childSum)); });
-      } else {  /* PE is not turned on */
-        if (pChild != pProband) {
-          /* the child is not a proband */
-          if (pChild->touchedFlag == 1) {
-            /*
-             * some likelihood calculation has
-             * been done for this child
-             */
-            *(double *) childSum += newProb * pChild->pLikelihood[newMultiLocusIndex].lkslot.likelihood;
-            DIAG (LIKELIHOOD, 1, {
-                  fprintf (stderr, "\t use already calculated child prob %e \n", pChild->pLikelihood[newMultiLocusIndex].lkslot.likelihood);
-                });
-            if (calcFlag == 1) {
-              likelihoodChildElements[multCount].fslot.factor = pChild->pLikelihood[newMultiLocusIndex].lkslot.likelihood;
-            }
-          } else if (analysisLocusList->traitLocusIndex >= 0)
-            /*
-             * first time working on this child's
-             * current multilocus genotype and we
-             * need to consider penetrance
-             */
-          {
-            traitGenoIndex = pHaplo->pChildGenoInd[analysisLocusList->traitLocusIndex];
-            pTraitParentalPair = &pHaplo->ppParentalPair[analysisLocusList->traitLocusIndex][pHaplo->pParentalPairInd[analysisLocusList->traitLocusIndex]];
-            *(double *) childSum += newProb * pTraitParentalPair->pppChildGenoList[child][traitGenoIndex]->penslot.penetrance;
-            if (calcFlag == 1) {
-              likelihoodChildElements[multCount].fslot.factor = pTraitParentalPair->pppChildGenoList[child][traitGenoIndex]->penslot.penetrance;
-            }
-            DIAG (LIKELIHOOD, 1, {
-                  fprintf (stderr, "child penetrance %e\n", pTraitParentalPair->pppChildGenoList[child][traitGenoIndex]->penslot.penetrance);
-                }
-            );
+          //end of plusExp
+          DIAG (LIKELIHOOD, 1, { fprintf (stderr, "\t use already calculated child prob %e \n", evaluateValue (pChild->pLikelihood[newMultiLocusIndex].lkslot.likelihoodPolynomial)); });
+        } else if (analysisLocusList->traitLocusIndex >= 0)
+          /*
+           * first time working on this child's
+           * current multilocus genotype and we
+           * need to consider penetrance
+           */
+        {
+          traitGenoIndex = pHaplo->pChildGenoInd[analysisLocusList->traitLocusIndex];
+          pTraitParentalPair = &pHaplo->ppParentalPair[analysisLocusList->traitLocusIndex][pHaplo->pParentalPairInd[analysisLocusList->traitLocusIndex]];
+          *(Polynomial **) childSum = plusExp (2, 1.0, *(Polynomial **) childSum, 1.0, timesExp (2, newProbPolynomial, 1, pTraitParentalPair->pppChildGenoList[child]
+                  [traitGenoIndex]->penslot.penetrancePolynomial, 1, 1),      //end of timesExp
+              1);
 
-          } else {
-            *(double *) childSum += newProb;
-            if (calcFlag == 1) {
-              likelihoodChildElements[multCount].fslot.factor = 1;
-            }
+          if (calcFlag == 1) {
+            likelihoodChildElements[multCount].fslot.factorPolynomial = pTraitParentalPair->pppChildGenoList[child]
+                [traitGenoIndex]->penslot.penetrancePolynomial;
           }
-        } else {        /* this child is proband */
+        } else {
           /*
-           * penetrance if applicable will be figured
-           * into later
+           * no trait locus and new to this
+           * child
            */
-          *(double *) childSum += newProb;
+          *(Polynomial **) childSum = plusExp (2, 1.0, *(Polynomial **) childSum, 1.0, newProbPolynomial, 1);
           if (calcFlag == 1) {
-            likelihoodChildElements[multCount].fslot.factor = 1;
+            likelihoodChildElements[multCount].fslot.factorPolynomial = constant1Poly;
           }
         }
-        DIAG (LIKELIHOOD, 1, {
-              fprintf (stderr, "\t child sum %e \n", *(double *) childSum);
-            });
+      } else {        /* this child is proband */
+        *(Polynomial **) childSum = plusExp (2, 1.0, *(Polynomial **) childSum, 1.0, newProbPolynomial, 1);
+        if (calcFlag == 1) {
+          likelihoodChildElements[multCount].fslot.factorPolynomial = constant1Poly;
+        }
       }
-
+      DIAG (LIKELIHOOD, 1, { fprintf (stderr, "\t child sum %e \n", evaluateValue (*(Polynomial **) childSum)); });
 
       if (calcFlag == 1) {
         likelihoodChildElements[multCount].xmissionIndex[DAD] = newXmissionIndex[DAD];
@@ -3329,6 +3894,260 @@ int do_populate_xmission_matrix (XMission * my_pMatrix, int totalLoci, void *pro
   return 0;
 }
 
+#ifndef NO_XMISSION_CACHE
+/*
+ * Cache of populated transmission matrices, non-polynomial only.
+ *
+ * A matrix is entirely determined by the number of loci, the initial
+ * probabilities and the recombination fractions between adjacent loci,
+ * so each entry keeps the matrix for one such key, and populating a
+ * matrix for a key that's cached is just a copy. That happens for every
+ * penetrance and liability class parameter set at the same position.
+ *
+ * Every cell spans every interval, so no cell survives a change to any
+ * of them. What does survive is the partial state of the recursion for
+ * the loci before the first changed interval, so entries also keep that
+ * state level by level, and a miss rebuilds only from the first interval
+ * that differs from the closest cached key. Consecutive multipoint
+ * positions differ only in the intervals next to the trait.
+ *
+ * Only used from the serial analysis loops, so not thread safe.
+ */
+#define XMISSION_CACHE_SIZE 8
+
+/* state of the recursion after one locus, for one inheritance pattern
+ * vector so far (the node's index in its level) */
+typedef struct XMissionNode
+{
+  double prob[3];
+  double prob2[3];
+  double hetProb[3];
+  int lastHetLoc;
+} XMissionNode;
+
+typedef struct XMissionCacheEntry
+{
+  int totalLoci;		/* 0 when the entry is unused */
+  double initialProb[3], initialProb2[3];
+  double *distance;		/* pPrevLocusDistance[i][loc], 3 per locus after the first */
+  XMissionNode **ppLevel;	/* states after each locus but the last */
+  XMission *pMatrix;		/* the populated cells */
+  unsigned long lastUse;
+} XMissionCacheEntry;
+
+static XMissionCacheEntry xmissionCache[XMISSION_CACHE_SIZE];
+static unsigned long xmissionCacheClock = 0;
+
+/* state after locus loc for the given pattern there, from the state
+ * after the previous locus - the non-polynomial arm of
+ * do_populate_xmission_matrix */
+static void xmission_step (XMissionNode * pPrev, int prevPattern, int pattern, int loc, int totalLoci, XMissionNode * pNew)
+{
+  double *theta[3];
+  int sexAveraged = (modelOptions->mapFlag == SEX_AVERAGED);
+  int i;
+
+  *pNew = *pPrev;
+  for (i = 0; i < 3; i++)
+    theta[i] = &analysisLocusList->pPrevLocusDistance[i][loc];
+
+  if (pattern != 3 && pattern != 0) {
+    /* parent is not homozygous */
+    if (pPrev->lastHetLoc != -1) {
+      if (prevPattern != 3 && prevPattern != 0) {
+        if (prevPattern == pattern) {
+          /* no recombination */
+          for (i = 0; i < 3; i++)
+            pNew->prob[i] *= (1 - *theta[i]);
+        } else {
+          /* recombination */
+          for (i = 0; i < 3; i++)
+            if (i > 0 && sexAveraged)
+              pNew->prob[i] = pNew->prob[0];
+            else
+              pNew->prob[i] *= *theta[i];
+        }
+      } else {
+        /* previous locus at parent is homo and current locus is het */
+        for (i = 0; i < 3; i++)
+          if (i > 0 && sexAveraged)
+            pNew->prob[i] = pNew->prob[0];
+          else if (pattern == 1)
+            pNew->prob[i] = pPrev->prob[i] * (1 - *theta[i]) + pPrev->prob2[i] * *theta[i];
+          else
+            pNew->prob[i] = pPrev->prob2[i] * (1 - *theta[i]) + pPrev->prob[i] * *theta[i];
+      }
+    } else {
+      /* we don't have any het locus yet, this locus is the first het */
+      for (i = 0; i < 3; i++)
+        pNew->prob[i] = 0.5;
+    }
+    pNew->lastHetLoc = loc;
+    for (i = 0; i < 3; i++)
+      pNew->hetProb[i] = pNew->prob[i];
+  } else if (pPrev->lastHetLoc != -1) {
+    if (loc == totalLoci - 1) {
+      /* this is the last locus and it's homo, take the previous het locus */
+      for (i = 0; i < 3; i++)
+        pNew->prob[i] = pPrev->hetProb[i];
+    } else if (prevPattern == 3 || prevPattern == 0) {
+      /* previous locus pattern is homo */
+      for (i = 0; i < 3; i++)
+        if (i > 0 && sexAveraged) {
+          pNew->prob[i] = pNew->prob[0];
+          pNew->prob2[i] = pNew->prob2[0];
+        } else {
+          pNew->prob[i] = pPrev->prob[i] * (1 - *theta[i]) + pPrev->prob2[i] * *theta[i];
+          pNew->prob2[i] = pPrev->prob2[i] * (1 - *theta[i]) + pPrev->prob[i] * *theta[i];
+        }
+    } else {
+      /* prev pattern is het */
+      for (i = 0; i < 3; i++)
+        if (i > 0 && sexAveraged) {
+          pNew->prob[i] = pNew->prob[0];
+          pNew->prob2[i] = pNew->prob2[0];
+        } else if (prevPattern == 1) {
+          pNew->prob[i] = pPrev->prob[i] * (1 - *theta[i]);
+          pNew->prob2[i] = pPrev->prob[i] * *theta[i];
+        } else {
+          pNew->prob2[i] = pPrev->prob[i] * (1 - *theta[i]);
+          pNew->prob[i] = pPrev->prob[i] * *theta[i];
+        }
+    }
+  }
+}
+
+static void free_xmission_cache_entry (XMissionCacheEntry * pEntry)
+{
+  int loc;
+
+  if (pEntry->totalLoci == 0)
+    return;
+  for (loc = 0; loc < pEntry->totalLoci - 1; loc++)
+    free (pEntry->ppLevel[loc]);
+  free (pEntry->ppLevel);
+  free (pEntry->distance);
+  free (pEntry->pMatrix);
+  memset (pEntry, 0, sizeof (XMissionCacheEntry));
+}
+
+/* release all cached transmission matrices */
+void free_xmission_cache ()
+{
+  int k;
+
+  for (k = 0; k < XMISSION_CACHE_SIZE; k++)
+    free_xmission_cache_entry (&xmissionCache[k]);
+}
+
+/* populate the matrix for the current inter-locus distances from the
+ * cache, building whatever part of it isn't there */
+static void populate_cached_xmission_matrix (XMission * my_pMatrix, int totalLoci, void *prob[3], void *prob2[3])
+{
+  XMissionCacheEntry *pEntry, *pDonor, *pVictim;
+  XMissionNode initialNode, *pPrev, *pNode;
+  int numDistance = 3 * (totalLoci - 1);
+  int numCells = 1 << (2 * totalLoci);
+  int k, i, loc, same, first, bestFirst, numNodes, node, pattern;
+
+  memset (&initialNode, 0, sizeof (XMissionNode));
+  for (i = 0; i < 3; i++) {
+    initialNode.prob[i] = *(double *) prob[i];
+    initialNode.prob2[i] = *(double *) prob2[i];
+  }
+  initialNode.lastHetLoc = -1;
+
+  /* look for the key, or failing that the longest shared leading loci */
+  xmissionCacheClock++;
+  pDonor = NULL;
+  pVictim = &xmissionCache[0];
+  bestFirst = 0;
+  for (k = 0; k < XMISSION_CACHE_SIZE; k++) {
+    pEntry = &xmissionCache[k];
+    if (pEntry->lastUse < pVictim->lastUse)
+      pVictim = pEntry;
+    if (pEntry->totalLoci != totalLoci)
+      continue;
+    same = TRUE;
+    for (i = 0; i < 3; i++)
+      if (pEntry->initialProb[i] != initialNode.prob[i] || pEntry->initialProb2[i] != initialNode.prob2[i])
+        same = FALSE;
+    if (same == FALSE)
+      continue;
+    /* first locus whose preceding interval differs */
+    for (first = 1; first < totalLoci; first++) {
+      for (i = 0; i < 3; i++)
+        if (pEntry->distance[3 * (first - 1) + i] != analysisLocusList->pPrevLocusDistance[i][first])
+          break;
+      if (i < 3)
+        break;
+    }
+    if (first == totalLoci) {
+      /* a hit */
+      pEntry->lastUse = xmissionCacheClock;
+      memcpy (my_pMatrix, pEntry->pMatrix, sizeof (XMission) * numCells);
+      return;
+    }
+    if (first > bestFirst) {
+      bestFirst = first;
+      pDonor = pEntry;
+    }
+  }
+
+  /* a miss, build it in the least recently used entry, from the loci
+   * the closest one has in common */
+  if (pVictim->totalLoci != totalLoci) {
+    free_xmission_cache_entry (pVictim);
+    pVictim->totalLoci = totalLoci;
+    MALCHOKE (pVictim->distance, sizeof (double) * (numDistance > 0 ? numDistance : 1), double *);
+    CALCHOKE (pVictim->ppLevel, (size_t) totalLoci, sizeof (XMissionNode *), XMissionNode **);
+    for (loc = 0; loc < totalLoci - 1; loc++)
+      MALCHOKE (pVictim->ppLevel[loc], sizeof (XMissionNode) * (1 << (2 * (loc + 1))), XMissionNode *);
+    MALCHOKE (pVictim->pMatrix, sizeof (XMission) * numCells, XMission *);
+    if (pDonor == pVictim)
+      pDonor = NULL;
+  }
+  if (pDonor == NULL)
+    bestFirst = 0;
+  else if (pDonor != pVictim)
+    for (loc = 0; loc < bestFirst && loc < totalLoci - 1; loc++)
+      memcpy (pVictim->ppLevel[loc], pDonor->ppLevel[loc], sizeof (XMissionNode) * (1 << (2 * (loc + 1))));
+  for (i = 0; i < 3; i++) {
+    pVictim->initialProb[i] = initialNode.prob[i];
+    pVictim->initialProb2[i] = initialNode.prob2[i];
+  }
+  for (loc = 1; loc < totalLoci; loc++)
+    for (i = 0; i < 3; i++)
+      pVictim->distance[3 * (loc - 1) + i] = analysisLocusList->pPrevLocusDistance[i][loc];
+  pVictim->lastUse = xmissionCacheClock;
+
+  /* states after locus bestFirst onwards, the last locus into the cells */
+  for (loc = bestFirst; loc < totalLoci; loc++) {
+    numNodes = (loc == 0) ? 1 : 1 << (2 * loc);
+    for (node = 0; node < numNodes; node++) {
+      pPrev = (loc == 0) ? &initialNode : &pVictim->ppLevel[loc - 1][node];
+      for (pattern = 0; pattern <= 3; pattern++) {
+        if (loc == totalLoci - 1) {
+          XMissionNode leaf;
+
+          xmission_step (pPrev, node & 3, pattern, loc, totalLoci, &leaf);
+          for (i = 0; i < 3; i++)
+            pVictim->pMatrix[node * 4 + pattern].slot.prob[i] = leaf.prob[i];
+        } else {
+          pNode = &pVictim->ppLevel[loc][node * 4 + pattern];
+          xmission_step (pPrev, node & 3, pattern, loc, totalLoci, pNode);
+        }
+      }
+    }
+  }
+  memcpy (my_pMatrix, pVictim->pMatrix, sizeof (XMission) * numCells);
+}
+#else
+void free_xmission_cache ()
+{
+}
+#endif
+
 int populate_xmission_matrix (char *fileName, int lineNo, XMission *my_pMatrix, int totalLoci, void *prob[3], void *prob2[3], void *hetProb[3], int cellIndex, int lastHetLoc, int prevPattern, int loc)
 {
 
@@ -3336,6 +4155,13 @@ int populate_xmission_matrix (char *fileName, int lineNo, XMission *my_pMatrix,
       fprintf (stderr, "In populate_xmission_matrix from %s:%d\n", fileName, lineNo);
     });
 
+#ifndef NO_XMISSION_CACHE
+  if (modelOptions->polynomial != TRUE && cellIndex == 0 && lastHetLoc == -1 && loc == 0) {
+    populate_cached_xmission_matrix (my_pMatrix, totalLoci, prob, prob2);
+    return 0;
+  }
+#endif
+
   do_populate_xmission_matrix (my_pMatrix, totalLoci, prob, prob2, hetProb, cellIndex, lastHetLoc, prevPattern, loc);
 
   return 0;
@@ -56,12 +56,38 @@ typedef struct ParentalPairSpace
   short *phase[2];
   int numHaplotypePair;
 
+#ifndef NO_PARENTAL_PAIR_CACHE
+  /* the pairs allocated for each locus. ppParentalPair[locus] points at
+   * a nuclear family's cached pairs instead when they can be reused */
+  ParentalPair **ppWorkParentalPair;
+#endif
+
   /* internal counter for each locus */
   int maxNumParentalPair;
   int maxNumChildren;
   int maxNumChildGenotype;
 } ParentalPairSpace;
 
+/* The parental pairs of a nuclear family at one locus depend only on the
+ * genotype lists of its members, and those only change in pedigrees with
+ * loops. So they are kept, along with what made them, and reused by later
+ * peels at any trait position or set of parameters */
+typedef struct ParentalPairCache
+{
+  /* what the pairs were constructed for */
+  int head;
+  Person *pProband;
+  struct Genotype *pProbandList;
+  int probandNumGenotype;
+
+  int numPair;
+  /* the pairs, with their children's arrays in the same allocation */
+  ParentalPair *pPair;
+  /* bytes of that allocation, counted against the cache ceiling */
+  size_t size;
+  struct ParentalPairCache *pNext;
+} ParentalPairCache;
+
 typedef struct XMission
 {
   /* transmission probability */
@@ -72,14 +98,33 @@ typedef struct XMission
   } slot;
 } XMission;
 
+/* Pedigrees are only peeled concurrently with OpenMP, and not when they
+   are being farmed-out to a study database one at a time. Polynomials
+   are built by peeling, so they can't be built concurrently either. */
+#if !defined (_OPENMP) || defined (STUDYDB)
+  #define NO_CONCURRENT_PEELING
+#endif
+#if defined (NO_CONCURRENT_PEELING) && !defined (NO_POLY_CONCURRENT_BUILD)
+  #define NO_POLY_CONCURRENT_BUILD
+#endif
+
 extern ParentalPairSpace parentalPairSpace;
+#ifndef NO_CONCURRENT_PEELING
+/* Each thread peeling a pedigree concurrently has its own (see enter_peeling_thread) */
+#pragma omp threadprivate (parentalPairSpace)
+#endif
 extern XMission *xmissionMatrix;
 extern double *half_pow;
 extern char partialPolynomialFunctionName[];
 
 
 int build_likelihood_polynomial (Pedigree * pPedigree);
+void build_likelihood_polynomials (PedigreeSet * pPedigreeList);
+void compute_pedigree_likelihoods (PedigreeSet * pPedigreeList);
 int compute_likelihood (char *fileName, int lineNo, PedigreeSet * pPedigreeList);
+void evaluate_pedigree_set_polynomials (PedigreeSet * pPedigreeList);
+struct polyTape *pedigree_set_batch_tape (PedigreeSet * pPedigreeList);
+int take_batch_likelihoods (PedigreeSet * pPedigreeList, double *likelihoods);
 int construct_parental_pair (NuclearFamily * pNucFam, Person * pProband,
 			     int locus);
 int stat_parental_pair_workspace (PedigreeSet *);
@@ -88,9 +133,12 @@ int initialize_parental_pair_workspace (ParentalPairSpace * pSpace,
 int allocate_parental_pair_workspace (ParentalPairSpace * pSpace,
 				      int numLocus);
 int free_parental_pair_workspace (ParentalPairSpace * pSpace, int numLocus);
+void free_parental_pair_cache (NuclearFamily * pNucFam);
 int allocate_likelihood_space (PedigreeSet * pPedigreeList, int numLocus);
 int count_likelihood_space (PedigreeSet * pPedigreeList);
 void free_likelihood_space (PedigreeSet * pPedigreeList);
+void allocate_peeling_work_space (int numLocus);
+void free_peeling_work_space ();
 void allocate_nucfam_het (PedigreeSet * pPedigreeList, int numLocus);
 int build_xmission_matrix (XMission ** ppMatrix, int totalLoci);
 
@@ -99,6 +147,7 @@ int populate_xmission_matrix (char *fileName, int lineNo, XMission * pMatrix, in
 			      void *hetProb[3],
 			      int cellIndex,
 			      int lastHetLoc, int prevPattern, int loc);
+void free_xmission_cache ();
 
 void
 print_xmission_matrix (XMission * pMatrix, int totalLoci, int loc,
@@ -35,10 +35,16 @@ char *locusVersion = "$Id$";
 //#include "gsl/gsl_randist.h"
 //#include "gsl/gsl_cdf.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "../utils/dists.h"
 #include "pedlib.h"
+#include "genotype_elimination.h"
 #include "../utils/utils.h"		/* for logging */
 #include "../utils/polynomial.h"
+#include "likelihood.h"
 
 #define MAP_CHR_COL        1
 #define MAP_NAME_COL       2
@@ -71,6 +77,7 @@ Trait *add_trait (int, TraitLocus *, int);
 void compute_penetrance (Person *, int, int, int, void *);
 void free_allele_set (AlleleSet *);
 void free_person (Person *);
+void pack_genotype_list (Person *, int);
 void free_nuclear_family (NuclearFamily *);
 
 /* hard removal of genotype flag */
@@ -1978,58 +1985,98 @@ initialize_loci (PedigreeSet * pPedigreeSet)
   int ped;
   Pedigree *pPedigree;
   Locus *pLocus;
-  int ret;
+  int i;
+  int batchSize, batchEnd, batchLocus, numElim;
+  int *pElimRet;
 
   set_removeGenotypeFlag (TRUE);
 
+  /* Loci are taken a batch at a time, as many as there are threads, so
+   * that their genotype elimination (which, unlike set recoding, shares
+   * nothing between loci or pedigrees) can be done concurrently. */
+#ifdef _OPENMP
+  batchSize = omp_get_max_threads ();
+#else
+  batchSize = 1;
+#endif
+  MALCHOKE(pElimRet, sizeof (int) * batchSize * pPedigreeSet->numPedigree, int *);
+
   /* go through all loci in the original locus list */
   locus = 0;
   while (locus < originalLocusList.numLocus) {
-    pLocus = originalLocusList.ppLocusList[locus];
-    ped = 0;
-    /* go through all peidgress in this set */
-    while (ped < pPedigreeSet->numPedigree) {
-      pPedigree = pPedigreeSet->ppPedigreeSet[ped];
-      /* depending on the locus type, we call different function */
-
-      if (pLocus->locusType == LOCUS_TYPE_TRAIT)
-	create_baseline_trait_genotypes (locus, pPedigree);
-      else
-	create_baseline_marker_genotypes (locus, pPedigree);
+    batchEnd = locus + batchSize;
+    if (batchEnd > originalLocusList.numLocus)
+      batchEnd = originalLocusList.numLocus;
+
+    for (batchLocus = locus; batchLocus < batchEnd; batchLocus++) {
+      pLocus = originalLocusList.ppLocusList[batchLocus];
+      /* go through all peidgress in this set */
+      for (ped = 0; ped < pPedigreeSet->numPedigree; ped++) {
+	pPedigree = pPedigreeSet->ppPedigreeSet[ped];
+	/* depending on the locus type, we call different function */
+
+	if (pLocus->locusType == LOCUS_TYPE_TRAIT)
+	  create_baseline_trait_genotypes (batchLocus, pPedigree);
+	else
+	  create_baseline_marker_genotypes (batchLocus, pPedigree);
 
-      DIAG (GENOTYPE_ELIMINATION, 1, {
-	  fprintf (stderr, "Baseline Genotype Lists:\n");
-	  print_pedigree_locus_genotype_list (pPedigree, locus);
-	});
+	DIAG (GENOTYPE_ELIMINATION, 1, {
+	    fprintf (stderr, "Baseline Genotype Lists:\n");
+	    print_pedigree_locus_genotype_list (pPedigree, batchLocus);
+	  });
 
-      /* first step is do the set recoding: this should help speed up
-       * genotype elimination process */
+	/* first step is do the set recoding: this should help speed up
+	 * genotype elimination process */
 
-      allele_set_recoding (locus, pPedigree);
+	allele_set_recoding (batchLocus, pPedigree);
+      }
+    }
 
-      /* do genotype elimination next */
-      ret = pedigree_genotype_elimination (locus, pPedigree);
-      ASSERT (ret == 0, "Genotype incompatibility has been detected");
+    /* do genotype elimination next */
+    numElim = (batchEnd - locus) * pPedigreeSet->numPedigree;
+#ifdef _OPENMP
+#pragma omp parallel if (numElim > 1)
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic,1)
+#endif
+      for (i = 0; i < numElim; i++)
+	pElimRet[i] = pedigree_genotype_elimination (locus + i / pPedigreeSet->numPedigree,
+						     pPedigreeSet->ppPedigreeSet[i % pPedigreeSet->numPedigree]);
+    }
+
+    for (i = 0; i < numElim; i++) {
+      batchLocus = locus + i / pPedigreeSet->numPedigree;
+      pPedigree = pPedigreeSet->ppPedigreeSet[i % pPedigreeSet->numPedigree];
+      ASSERT (pElimRet[i] == 0, "Genotype incompatibility has been detected");
       DIAG (GENOTYPE_ELIMINATION, 1, {
 	  fprintf (stderr, "Genotype Lists after genotype elimination :\n");
-	  print_pedigree_locus_genotype_list (pPedigree, locus);
+	  print_pedigree_locus_genotype_list (pPedigree, batchLocus);
 	});
 
       /* do the set recoding again */
-      allele_set_recoding (locus, pPedigree);
+      allele_set_recoding (batchLocus, pPedigree);
 
       /* set genotype weight now to save likelihood calculation time */
-      set_genotype_weight (pPedigree, locus);
-      set_genotype_position (pPedigree, locus);
+      set_genotype_weight (pPedigree, batchLocus);
+      set_genotype_position (pPedigree, batchLocus);
 
       DIAG (GENOTYPE_ELIMINATION, 1, {
 	  fprintf (stderr, "Genotype Lists after set recoding :\n");
-	  print_pedigree_locus_genotype_list (pPedigree, locus);
+	  print_pedigree_locus_genotype_list (pPedigree, batchLocus);
 	});
-      ped++;
     }
-    locus++;
+    locus = batchEnd;
   }
+  free (pElimRet);
+
+  /* Each thread's elimination work space only grows, so it's kept for
+   * every batch and released once they're all done */
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  free_genotype_elimination_space ();
 
   /* If we ever need to loop over marker allele frequencies, 
    * the super allele frequencies, genotype weights should be set out of 
@@ -2076,6 +2123,17 @@ initialize_loci (PedigreeSet * pPedigreeSet)
 
   }				/* loop over pedigrees */
 
+#ifndef NO_GENOTYPE_PACKING
+  /* genotype lists don't change length from here on, so move each into
+   * one contiguous block for the peeling walks */
+  for (ped = 0; ped < pPedigreeSet->numPedigree; ped++) {
+    pPedigree = pPedigreeSet->ppPedigreeSet[ped];
+    for (i = 0; i < pPedigree->numPerson; i++)
+      for (locus = 0; locus < originalLocusList.numLocus; locus++)
+	pack_genotype_list (pPedigree->ppPersonList[i], locus);
+  }
+#endif
+
   /* populate the master genotype list */
   populate_saved_genotype_link (pPedigreeSet);
 
@@ -2760,6 +2818,13 @@ free_person (Person * pPerson)
   if (pPerson->loopBreaker == 0 || pPerson->pParents[DAD] != NULL) {
     /* go through each locus for the genotypes */
     for (i = 0; i < originalLocusList.numLocus; i++) {
+      if (pPerson->ppGenotypeBlock[i] != NULL) {
+	/* packed genotypes go all at once */
+	free (pPerson->ppGenotypeBlock[i]);
+	pPerson->ppSavedGenotypeList[i] = NULL;
+	pPerson->pSavedNumGenotype[i] = 0;
+	continue;
+      }
       /* delete each genotype in the list */
       while (pPerson->ppSavedGenotypeList[i] != NULL) {
 	remove_genotype (&(pPerson->ppSavedGenotypeList[i]),
@@ -2779,6 +2844,7 @@ free_person (Person * pPerson)
   free (pPerson->pNumGenotype);
   free (pPerson->ppSavedGenotypeList);
   free (pPerson->pSavedNumGenotype);
+  free (pPerson->ppGenotypeBlock);
   free (pPerson->ppShadowGenotypeList);
   free (pPerson->pShadowGenotypeListLen);
   free (pPerson->ppProbandGenotypeList);
@@ -2822,6 +2888,7 @@ free_nuclear_family (NuclearFamily * pNucFam)
   free (pNucFam->relatedPPairStart);
   free (pNucFam->numRelatedPPair);
   free (pNucFam->totalRelatedPPair);
+  free_parental_pair_cache (pNucFam);
   free (pNucFam->ppChildrenList);
   free (pNucFam);
 }
@@ -3021,6 +3088,69 @@ populate_pedigree_saved_genotype_link (int locus, Pedigree * pPed)
   }
 }
 
+/* move a person's genotype list for a locus into one allocation, in list
+ * order, with the allele bits of all its genotypes following them.
+ * The peeling walks then step through adjacent memory, and the list goes
+ * away with a single free. Only phase duals still adjacent on the list
+ * are kept - the others were eliminated, so nothing follows them anyway.
+ * locus - index in original locus list */
+void
+pack_genotype_list (Person * pPerson, int locus)
+{
+  Genotype *pBlock, *pGeno, *pPrev, *pNext;
+  unsigned int *pBits;
+  int numGeno, numInts;
+  int k;
+
+  if (pPerson->loopBreaker >= 1 && pPerson->pParents[DAD] == NULL)
+    /* the duplicated loop breaker has no genotypes of its own */
+    return;
+  if (pPerson->ppGenotypeBlock[locus] != NULL || pPerson->ppGenotypeList[locus] == NULL)
+    return;
+
+  numGeno = 0;
+  for (pGeno = pPerson->ppGenotypeList[locus]; pGeno != NULL; pGeno = pGeno->pNext)
+    numGeno++;
+  numInts = originalLocusList.alleleSetLen;
+  MALCHOKE(pBlock, (sizeof (Genotype) + 2 * numInts * sizeof (unsigned int)) * numGeno, Genotype *);
+  pBits = (unsigned int *) (pBlock + numGeno);
+
+  pPrev = NULL;
+  pGeno = pPerson->ppGenotypeList[locus];
+  for (k = 0; k < numGeno; k++) {
+    pBlock[k] = *pGeno;
+    pBlock[k].pNext = (k + 1 < numGeno) ? &pBlock[k + 1] : NULL;
+    pBlock[k].position = k;
+    if (pGeno->pDualGenotype != NULL && pGeno->pDualGenotype == pGeno->pNext)
+      pBlock[k].pDualGenotype = &pBlock[k + 1];
+    else if (pGeno->pDualGenotype != NULL && pGeno->pDualGenotype == pPrev)
+      pBlock[k].pDualGenotype = &pBlock[k - 1];
+    else
+      pBlock[k].pDualGenotype = NULL;
+    pBlock[k].pAlleleBits[DAD] = pBits;
+    memcpy (pBits, pGeno->pAlleleBits[DAD], numInts * sizeof (unsigned int));
+    pBits += numInts;
+    pBlock[k].pAlleleBits[MOM] = pBits;
+    memcpy (pBits, pGeno->pAlleleBits[MOM], numInts * sizeof (unsigned int));
+    pBits += numInts;
+
+    pNext = pGeno->pNext;
+    if (pPrev != NULL) {
+      free (pPrev->pAlleleBits[DAD]);
+      free (pPrev->pAlleleBits[MOM]);
+      free (pPrev);
+    }
+    pPrev = pGeno;
+    pGeno = pNext;
+  }
+  free (pPrev->pAlleleBits[DAD]);
+  free (pPrev->pAlleleBits[MOM]);
+  free (pPrev);
+
+  pPerson->ppGenotypeList[locus] = pBlock;
+  pPerson->ppGenotypeBlock[locus] = pBlock;
+}
+
 /* populate the master list of valid genotype list for all pedigrees */
 void
 populate_saved_genotype_link (PedigreeSet * pSet)
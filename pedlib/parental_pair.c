@@ -39,6 +39,18 @@ void fill_parental_pair (int locus, int *numPair, NuclearFamily * pNucFam,
 			 Genotype * pDad, Genotype * pMom,
 			 int dadAdjust, int momAdjust);
 
+#ifndef NO_PARENTAL_PAIR_CACHE
+/* ceiling on the memory kept by all nuclear families' parental pair caches */
+#define PARENTAL_PAIR_CACHE_BYTES ((size_t) 1 << 28)
+static size_t parentalPairCacheBytes = 0;
+
+static ParentalPairCache *find_parental_pair_cache (NuclearFamily * pNucFam,
+						    Person * pProband,
+						    int origLocus);
+static void cache_parental_pair (NuclearFamily * pNucFam, Person * pProband,
+				 int locus);
+#endif
+
 /* construct the parental pair list for one locus */
 
 /* locus is the index in the sub locusList */
@@ -58,6 +70,19 @@ construct_parental_pair (NuclearFamily * pNucFam, Person * pProband,
   Genotype *initialGeno[2];
   int head, spouse;
   ParentalPair *pPair;
+#ifndef NO_PARENTAL_PAIR_CACHE
+  ParentalPairCache *pCache;
+
+  /* reuse the pairs if this family has had them constructed before */
+  parentalPairSpace.ppParentalPair[locus] =
+    parentalPairSpace.ppWorkParentalPair[locus];
+  pCache = find_parental_pair_cache (pNucFam, pProband, origLocus);
+  if (pCache != NULL) {
+    parentalPairSpace.ppParentalPair[locus] = pCache->pPair;
+    parentalPairSpace.pNumParentalPair[locus] = pCache->numPair;
+    return 0;
+  }
+#endif
 
   /* initialize first */
   parentalPairSpace.pNumParentalPair[locus] = 0;
@@ -149,9 +174,168 @@ construct_parental_pair (NuclearFamily * pNucFam, Person * pProband,
 
   }
 
+#ifndef NO_PARENTAL_PAIR_CACHE
+  cache_parental_pair (pNucFam, pProband, locus);
+#endif
   return 0;
 }
 
+#ifndef NO_PARENTAL_PAIR_CACHE
+/* find the pairs kept for the family at this locus that were constructed 
+ * with the same head and the same genotypes for the proband. Nothing is
+ * kept for pedigrees with loops, where the genotype lists change with the
+ * loop breakers' genotypes */
+static ParentalPairCache *
+find_parental_pair_cache (NuclearFamily * pNucFam, Person * pProband,
+			  int origLocus)
+{
+  ParentalPairCache *pCache;
+
+  if (pNucFam->pPedigree->numLoopBreaker > 0 || pNucFam->ppPairCache == NULL)
+    return NULL;
+  for (pCache = pNucFam->ppPairCache[origLocus]; pCache != NULL;
+       pCache = pCache->pNext) {
+    if (pCache->head == pNucFam->head && pCache->pProband == pProband &&
+	pCache->pProbandList == pProband->ppGenotypeList[origLocus] &&
+	pCache->probandNumGenotype == pProband->pNumGenotype[origLocus])
+      return pCache;
+  }
+  return NULL;
+}
+
+/* keep a copy of the pairs just constructed at this locus, packed into
+ * one allocation sized by what they actually hold */
+static void
+cache_parental_pair (NuclearFamily * pNucFam, Person * pProband, int locus)
+{
+  ParentalPairCache *pCache;
+  ParentalPair *pFrom, *pTo;
+  int origLocus = analysisLocusList->pLocusIndex[locus];
+  int numPair = parentalPairSpace.pNumParentalPair[locus];
+  int numChildren = pNucFam->numChildren;
+  int numGeno = 0;
+  int i, j, len;
+  size_t size, reserved;
+  char *pNext;
+  Genotype ***pppList;
+  Genotype **ppGeno;
+  int **ppInheritance;
+  int *pInt;
+
+  if (pNucFam->pPedigree->numLoopBreaker > 0)
+    return;
+
+  for (i = 0; i < numPair; i++)
+    for (j = 0; j < numChildren; j++)
+      numGeno += parentalPairSpace.ppParentalPair[locus][i].pChildGenoLen[j];
+  /* pointers first, then ints, so everything stays aligned */
+  size = sizeof (ParentalPairCache) + sizeof (ParentalPair) * numPair +
+    (sizeof (Genotype **) + 2 * sizeof (int *)) * numPair * numChildren +
+    sizeof (Genotype *) * numGeno +
+    sizeof (int) * numPair * numChildren + 2 * sizeof (int) * numGeno;
+  /* reserve the bytes before checking, so that threads caching at the
+   * same time can't together go over the limit */
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+  reserved = parentalPairCacheBytes += size;
+  if (reserved > PARENTAL_PAIR_CACHE_BYTES) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    parentalPairCacheBytes -= size;
+    return;
+  }
+
+  if (pNucFam->ppPairCache == NULL)
+    CALCHOKE (pNucFam->ppPairCache, sizeof (ParentalPairCache *),
+	      (size_t) originalLocusList.numLocus, ParentalPairCache **);
+  MALCHOKE (pCache, size, ParentalPairCache *);
+  pCache->head = pNucFam->head;
+  pCache->pProband = pProband;
+  pCache->pProbandList = pProband->ppGenotypeList[origLocus];
+  pCache->probandNumGenotype = pProband->pNumGenotype[origLocus];
+  pCache->numPair = numPair;
+  pCache->pPair = (ParentalPair *) (pCache + 1);
+  pCache->size = size;
+
+  pNext = (char *) (pCache->pPair + numPair);
+  pppList = (Genotype ***) pNext;
+  pNext += sizeof (Genotype **) * numPair * numChildren;
+  ppInheritance = (int **) pNext;
+  pNext += 2 * sizeof (int *) * numPair * numChildren;
+  ppGeno = (Genotype **) pNext;
+  pNext += sizeof (Genotype *) * numGeno;
+  pInt = (int *) pNext;
+
+  for (i = 0; i < numPair; i++) {
+    pFrom = &parentalPairSpace.ppParentalPair[locus][i];
+    pTo = &pCache->pPair[i];
+    pTo->pGenotype[DAD] = pFrom->pGenotype[DAD];
+    pTo->pGenotype[MOM] = pFrom->pGenotype[MOM];
+    pTo->phase[DAD] = pFrom->phase[DAD];
+    pTo->phase[MOM] = pFrom->phase[MOM];
+    pTo->pNext = NULL;
+    pTo->pppChildGenoList = pppList;
+    pppList += numChildren;
+    pTo->ppChildInheritance[DAD] = ppInheritance;
+    ppInheritance += numChildren;
+    pTo->ppChildInheritance[MOM] = ppInheritance;
+    ppInheritance += numChildren;
+    pTo->pChildGenoLen = pInt;
+    pInt += numChildren;
+    for (j = 0; j < numChildren; j++) {
+      len = pFrom->pChildGenoLen[j];
+      pTo->pChildGenoLen[j] = len;
+      pTo->pppChildGenoList[j] = ppGeno;
+      memcpy (ppGeno, pFrom->pppChildGenoList[j], sizeof (Genotype *) * len);
+      ppGeno += len;
+    }
+  }
+  for (i = 0; i < numPair; i++) {
+    pFrom = &parentalPairSpace.ppParentalPair[locus][i];
+    pTo = &pCache->pPair[i];
+    for (j = 0; j < numChildren; j++) {
+      len = pFrom->pChildGenoLen[j];
+      pTo->ppChildInheritance[DAD][j] = pInt;
+      memcpy (pInt, pFrom->ppChildInheritance[DAD][j], sizeof (int) * len);
+      pInt += len;
+      pTo->ppChildInheritance[MOM][j] = pInt;
+      memcpy (pInt, pFrom->ppChildInheritance[MOM][j], sizeof (int) * len);
+      pInt += len;
+    }
+  }
+
+  pCache->pNext = pNucFam->ppPairCache[origLocus];
+  pNucFam->ppPairCache[origLocus] = pCache;
+}
+#endif
+
+/* release the parental pairs kept for a nuclear family */
+void
+free_parental_pair_cache (NuclearFamily * pNucFam)
+{
+  ParentalPairCache *pCache, *pNext;
+  int locus;
+
+  if (pNucFam->ppPairCache == NULL)
+    return;
+  for (locus = 0; locus < originalLocusList.numLocus; locus++) {
+    for (pCache = pNucFam->ppPairCache[locus]; pCache != NULL; pCache = pNext) {
+      pNext = pCache->pNext;
+#ifndef NO_PARENTAL_PAIR_CACHE
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      parentalPairCacheBytes -= pCache->size;
+#endif
+      free (pCache);
+    }
+  }
+  free (pNucFam->ppPairCache);
+  pNucFam->ppPairCache = NULL;
+}
+
 void
 fill_parental_pair (int locus, int *numPair, NuclearFamily * pNucFam,
 		    Genotype * pDad, Genotype * pMom,
@@ -323,6 +507,9 @@ initialize_parental_pair_workspace (ParentalPairSpace * pSpace, int numLocus)
   CALCHOKE(pSpace->phase[DAD], sizeof (short), (size_t) numLocus, short *);
   CALCHOKE(pSpace->phase[MOM], sizeof (short), (size_t) numLocus, short *);
   CALCHOKE(pSpace->ppParentalPair, sizeof (ParentalPair *), (size_t) numLocus, ParentalPair **);
+#ifndef NO_PARENTAL_PAIR_CACHE
+  CALCHOKE(pSpace->ppWorkParentalPair, sizeof (ParentalPair *), (size_t) numLocus, ParentalPair **);
+#endif
   pSpace->maxNumParentalPair = 0;
   pSpace->maxNumChildren = 0;
   pSpace->maxNumChildGenotype = 0;
@@ -344,6 +531,9 @@ allocate_parental_pair_workspace (ParentalPairSpace * pSpace, int numLocus)
   for (locus = 0; locus < numLocus; locus++) {
     /* allocate parental pair space first */
     CALCHOKE(pSpace->ppParentalPair[locus], sizeof (ParentalPair), (size_t) pSpace->maxNumParentalPair, ParentalPair *);
+#ifndef NO_PARENTAL_PAIR_CACHE
+    pSpace->ppWorkParentalPair[locus] = pSpace->ppParentalPair[locus];
+#endif
     /* allocate space for children genotype list */
     for (i = 0; i < pSpace->maxNumParentalPair; i++) {
       CALCHOKE(pSpace->ppParentalPair[locus][i].pChildGenoLen, sizeof (int), (size_t) pSpace->maxNumChildren, int *);
@@ -372,6 +562,10 @@ free_parental_pair_workspace (ParentalPairSpace * pSpace, int numLocus)
   int i, j;
 
   for (locus = 0; locus < numLocus; locus++) {
+#ifndef NO_PARENTAL_PAIR_CACHE
+    /* the locus may be left pointing at a nuclear family's cached pairs */
+    pSpace->ppParentalPair[locus] = pSpace->ppWorkParentalPair[locus];
+#endif
     /* free space for children genotype list */
     for (i = 0; i < pSpace->maxNumParentalPair; i++) {
       /* for each child allocate enough space for genotypes */
@@ -398,6 +592,9 @@ free_parental_pair_workspace (ParentalPairSpace * pSpace, int numLocus)
   free (pSpace->pNumParentalPair);
   free (pSpace->pParentalPairInd);
   free (pSpace->ppParentalPair);
+#ifndef NO_PARENTAL_PAIR_CACHE
+  free (pSpace->ppWorkParentalPair);
+#endif
 
   return 0;
 }
@@ -88,6 +88,8 @@ typedef struct PedigreeSet
 #endif
 
   struct polynomial *likelihoodPolynomial;
+  /* all pedigree likelihood polynomials merged for evaluation together */
+  struct polyTape *likelihoodPolyTape;
 
   /* for internal memory allocation tracking purpose 
    * This is the number of pedigrees we have allocated space for the list */
@@ -322,6 +324,11 @@ typedef struct Person
   struct Genotype **ppSavedGenotypeList;
   int *pSavedNumGenotype;
 
+  /* contiguous storage that the saved genotypes (and their allele bits) are
+   * are packed into after initialization, for each locus. NULL when a
+   * list is still made of individually allocated genotypes */
+  struct Genotype **ppGenotypeBlock;
+
   /* index to the flattened array */
   int *multiLocusAdjust;
   int *numSavedGenotype2;
@@ -457,6 +464,10 @@ typedef struct NuclearFamily
   double likelihood;
   Polynomial *likelihoodPolynomial;
 
+  /* parental pairs already constructed for this family, by original locus
+   * (see construct_parental_pair). NULL until the first are kept */
+  struct ParentalPairCache **ppPairCache;
+
   /* The followings are for the related parental pairs that are only different in phases */
   /* numer of heterozygous loci for each parent */
   int numHetLocus[2];
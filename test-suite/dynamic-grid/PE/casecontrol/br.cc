@@ -0,0 +1,1093 @@
+# Version V2.8.0 edit 
+# Seq: 1 Chr: 40 Trait: Trait Marker: M17 Position: 18.0000
+D11 Theta(M,F) BayesRatio
+0.00 (0.0023,0.0023) 1.000000e+00
+0.00 (0.0115,0.0115) 1.000000e+00
+0.00 (0.0250,0.0250) 1.000000e+00
+0.00 (0.0385,0.0385) 1.000000e+00
+0.00 (0.0477,0.0477) 1.000000e+00
+0.00 (0.0711,0.0711) 1.000000e+00
+0.00 (0.1538,0.1538) 1.000000e+00
+0.00 (0.2750,0.2750) 1.000000e+00
+0.00 (0.3962,0.3962) 1.000000e+00
+0.00 (0.4789,0.4789) 1.000000e+00
+-0.50 (0.0250,0.0250) 7.629003e-01
+-0.63 (0.0250,0.0250) 6.998215e-01
+-0.37 (0.0250,0.0250) 8.352015e-01
+-0.85 (0.0250,0.0250) 6.106157e-01
+-0.15 (0.0250,0.0250) 9.593120e-01
+-0.50 (0.0187,0.0187) 7.611561e-01
+-0.50 (0.0313,0.0313) 7.646510e-01
+-0.50 (0.0075,0.0075) 7.580561e-01
+-0.50 (0.0425,0.0425) 7.677943e-01
+-0.02 (0.0250,0.0250) 9.972098e-01
+-0.98 (0.0250,0.0250) 5.701688e-01
+-0.50 (0.0490,0.0490) 7.696048e-01
+-0.50 (0.0010,0.0010) 7.562889e-01
+-0.00 (0.0250,0.0250) 9.997405e-01
+-1.00 (0.0250,0.0250) 5.649424e-01
+-0.50 (0.0499,0.0499) 7.698618e-01
+-0.50 (0.0001,0.0001) 7.560391e-01
+-0.25 (0.0250,0.0250) 9.086929e-01
+-0.75 (0.0250,0.0250) 6.472364e-01
+-0.50 (0.0375,0.0375) 7.663841e-01
+-0.50 (0.0125,0.0125) 7.594419e-01
+-0.42 (0.0290,0.0290) 8.088822e-01
+-0.58 (0.0290,0.0290) 7.229163e-01
+-0.42 (0.0210,0.0210) 8.068746e-01
+-0.58 (0.0210,0.0210) 7.205921e-01
+-0.31 (0.0345,0.0345) 8.757829e-01
+-0.69 (0.0345,0.0345) 6.742005e-01
+-0.31 (0.0155,0.0155) 8.721742e-01
+-0.69 (0.0155,0.0155) 6.685148e-01
+-0.17 (0.0415,0.0415) 9.510539e-01
+-0.83 (0.0415,0.0415) 6.229932e-01
+-0.17 (0.0085,0.0085) 9.483824e-01
+-0.83 (0.0085,0.0085) 6.132011e-01
+-0.06 (0.0469,0.0469) 9.892016e-01
+-0.94 (0.0469,0.0469) 5.889900e-01
+-0.06 (0.0031,0.0031) 9.885176e-01
+-0.94 (0.0031,0.0031) 5.761490e-01
+-0.00 (0.0500,0.0500) 9.999002e-01
+-1.00 (0.0500,0.0500) 5.719122e-01
+-0.00 (0.0000,0.0000) 9.998949e-01
+-1.00 (0.0000,0.0000) 5.574478e-01
+-0.01 (0.0412,0.0412) 9.986992e-01
+-0.99 (0.0412,0.0412) 5.720608e-01
+-0.01 (0.0088,0.0088) 9.986514e-01
+-0.99 (0.0088,0.0088) 5.626365e-01
+-0.18 (0.0495,0.0495) 9.496687e-01
+-0.82 (0.0495,0.0495) 6.270239e-01
+-0.18 (0.0005,0.0005) 9.455256e-01
+-0.82 (0.0005,0.0005) 6.124529e-01
+-0.06 (0.0340,0.0340) 9.885854e-01
+-0.94 (0.0340,0.0340) 5.856448e-01
+-0.06 (0.0160,0.0160) 9.882937e-01
+-0.94 (0.0160,0.0160) 5.803932e-01
+-0.32 (0.0468,0.0468) 8.715076e-01
+-0.68 (0.0468,0.0468) 6.827294e-01
+-0.32 (0.0032,0.0032) 8.628995e-01
+-0.68 (0.0032,0.0032) 6.697137e-01
+-0.22 (0.0302,0.0302) 9.275366e-01
+-0.78 (0.0302,0.0302) 6.361235e-01
+-0.22 (0.0198,0.0198) 9.263157e-01
+-0.78 (0.0198,0.0198) 6.330217e-01
+-0.40 (0.0392,0.0392) 8.255245e-01
+-0.60 (0.0392,0.0392) 7.142849e-01
+-0.40 (0.0108,0.0108) 8.186976e-01
+-0.60 (0.0108,0.0108) 7.059547e-01
+0.50 (0.0250,0.0250) 9.697712e-01
+0.37 (0.0250,0.0250) 1.006486e+00
+0.63 (0.0250,0.0250) 9.330192e-01
+0.15 (0.0250,0.0250) 1.041512e+00
+0.85 (0.0250,0.0250) 8.700911e-01
+0.50 (0.0187,0.0187) 9.688197e-01
+0.50 (0.0313,0.0313) 9.707229e-01
+0.50 (0.0075,0.0075) 9.671205e-01
+0.50 (0.0425,0.0425) 9.724236e-01
+0.98 (0.0250,0.0250) 8.355041e-01
+0.02 (0.0250,0.0250) 1.008882e+00
+0.50 (0.0490,0.0490) 9.733984e-01
+0.50 (0.0010,0.0010) 9.661471e-01
+1.00 (0.0250,0.0250) 8.306735e-01
+0.00 (0.0250,0.0250) 1.000990e+00
+0.50 (0.0499,0.0499) 9.735365e-01
+0.50 (0.0001,0.0001) 9.660093e-01
+0.75 (0.0250,0.0250) 8.978157e-01
+0.25 (0.0250,0.0250) 1.035868e+00
+0.50 (0.0375,0.0375) 9.716619e-01
+0.50 (0.0125,0.0125) 9.678814e-01
+0.58 (0.0290,0.0290) 9.470757e-01
+0.42 (0.0290,0.0290) 9.937376e-01
+0.58 (0.0210,0.0210) 9.456950e-01
+0.42 (0.0210,0.0210) 9.927350e-01
+0.69 (0.0345,0.0345) 9.164699e-01
+0.31 (0.0345,0.0345) 1.024283e+00
+0.69 (0.0155,0.0155) 9.126478e-01
+0.31 (0.0155,0.0155) 1.022823e+00
+0.83 (0.0415,0.0415) 8.798014e-01
+0.17 (0.0415,0.0415) 1.042366e+00
+0.83 (0.0085,0.0085) 8.721501e-01
+0.17 (0.0085,0.0085) 1.042436e+00
+0.94 (0.0469,0.0469) 8.521837e-01
+0.06 (0.0469,0.0469) 1.023768e+00
+0.94 (0.0031,0.0031) 8.409225e-01
+0.06 (0.0031,0.0031) 1.024659e+00
+1.00 (0.0500,0.0500) 8.370956e-01
+0.00 (0.0500,0.0500) 1.000386e+00
+1.00 (0.0000,0.0000) 8.235863e-01
+0.00 (0.0000,0.0000) 1.000407e+00
+0.99 (0.0412,0.0412) 8.372307e-01
+0.01 (0.0412,0.0412) 1.004573e+00
+0.99 (0.0088,0.0088) 8.285133e-01
+0.01 (0.0088,0.0088) 1.004725e+00
+0.82 (0.0495,0.0495) 8.828856e-01
+0.18 (0.0495,0.0495) 1.042413e+00
+0.82 (0.0005,0.0005) 8.715560e-01
+0.18 (0.0005,0.0005) 1.042414e+00
+0.94 (0.0340,0.0340) 8.492976e-01
+0.06 (0.0340,0.0340) 1.024572e+00
+0.94 (0.0160,0.0160) 8.446998e-01
+0.06 (0.0160,0.0160) 1.024941e+00
+0.68 (0.0468,0.0468) 9.220985e-01
+0.32 (0.0468,0.0468) 1.022550e+00
+0.68 (0.0032,0.0032) 9.134585e-01
+0.32 (0.0032,0.0032) 1.018944e+00
+0.78 (0.0302,0.0302) 8.897148e-01
+0.22 (0.0302,0.0302) 1.040425e+00
+0.78 (0.0198,0.0198) 8.874073e-01
+0.22 (0.0198,0.0198) 1.040195e+00
+0.60 (0.0392,0.0392) 9.419111e-01
+0.40 (0.0392,0.0392) 1.001888e+00
+0.60 (0.0108,0.0108) 9.368273e-01
+0.40 (0.0108,0.0108) 9.985799e-01
+-0.50 (0.2750,0.2750) 8.366082e-01
+-0.63 (0.2750,0.2750) 7.820057e-01
+-0.37 (0.2750,0.2750) 8.924997e-01
+-0.85 (0.2750,0.2750) 6.967430e-01
+-0.15 (0.2750,0.2750) 9.741991e-01
+-0.50 (0.2184,0.2184) 8.193055e-01
+-0.50 (0.3316,0.3316) 8.540600e-01
+-0.50 (0.1172,0.1172) 7.891606e-01
+-0.50 (0.4328,0.4328) 8.850729e-01
+-0.02 (0.2750,0.2750) 9.980066e-01
+-0.98 (0.2750,0.2750) 6.557625e-01
+-0.50 (0.4908,0.4908) 9.023729e-01
+-0.50 (0.0592,0.0592) 7.724919e-01
+-0.00 (0.2750,0.2750) 9.998080e-01
+-1.00 (0.2750,0.2750) 6.503804e-01
+-0.50 (0.4990,0.4990) 9.047763e-01
+-0.50 (0.0510,0.0510) 7.701716e-01
+-0.25 (0.2750,0.2750) 9.425793e-01
+-0.75 (0.2750,0.2750) 7.327138e-01
+-0.50 (0.3875,0.3875) 8.712602e-01
+-0.50 (0.1625,0.1625) 8.025130e-01
+-0.42 (0.3109,0.3109) 8.814181e-01
+-0.58 (0.3109,0.3109) 8.140495e-01
+-0.42 (0.2391,0.2391) 8.629441e-01
+-0.58 (0.2391,0.2391) 7.893389e-01
+-0.31 (0.3607,0.3607) 9.340535e-01
+-0.69 (0.3607,0.3607) 7.891629e-01
+-0.31 (0.1893,0.1893) 9.045088e-01
+-0.69 (0.1893,0.1893) 7.245209e-01
+-0.17 (0.4231,0.4231) 9.775771e-01
+-0.83 (0.4231,0.4231) 7.680260e-01
+-0.17 (0.1269,0.1269) 9.577234e-01
+-0.83 (0.1269,0.1269) 6.501687e-01
+-0.06 (0.4721,0.4721) 9.949735e-01
+-0.94 (0.4721,0.4721) 7.586553e-01
+-0.06 (0.0779,0.0779) 9.896749e-01
+-0.94 (0.0779,0.0779) 5.984819e-01
+-0.00 (0.4996,0.4996) 9.999476e-01
+-1.00 (0.4996,0.4996) 7.560333e-01
+-0.00 (0.0504,0.0504) 9.999002e-01
+-1.00 (0.0504,0.0504) 5.720435e-01
+-0.01 (0.4211,0.4211) 9.992401e-01
+-0.99 (0.4211,0.4211) 7.179417e-01
+-0.01 (0.1289,0.1289) 9.988271e-01
+-0.99 (0.1289,0.1289) 5.995125e-01
+-0.18 (0.4953,0.4953) 9.808650e-01
+-0.82 (0.4953,0.4953) 8.040324e-01
+-0.18 (0.0547,0.0547) 9.501051e-01
+-0.82 (0.0547,0.0547) 6.286325e-01
+-0.06 (0.3556,0.3556) 9.933204e-01
+-0.94 (0.3556,0.3556) 7.030599e-01
+-0.06 (0.1944,0.1944) 9.910660e-01
+-0.94 (0.1944,0.1944) 6.381747e-01
+-0.32 (0.4714,0.4714) 9.482767e-01
+-0.68 (0.4714,0.4714) 8.387534e-01
+-0.32 (0.0786,0.0786) 8.777527e-01
+-0.68 (0.0786,0.0786) 6.925679e-01
+-0.22 (0.3217,0.3217) 9.587062e-01
+-0.78 (0.3217,0.3217) 7.392128e-01
+-0.22 (0.2283,0.2283) 9.494290e-01
+-0.78 (0.2283,0.2283) 7.025126e-01
+-0.40 (0.4025,0.4025) 9.127562e-01
+-0.60 (0.4025,0.4025) 8.376386e-01
+-0.40 (0.1475,0.1475) 8.518987e-01
+-0.60 (0.1475,0.1475) 7.479755e-01
+0.50 (0.2750,0.2750) 1.007144e+00
+0.37 (0.2750,0.2750) 1.030611e+00
+0.63 (0.2750,0.2750) 9.799855e-01
+0.15 (0.2750,0.2750) 1.036637e+00
+0.85 (0.2750,0.2750) 9.310862e-01
+0.50 (0.2184,0.2184) 9.988765e-01
+0.50 (0.3316,0.3316) 1.015096e+00
+0.50 (0.1172,0.1172) 9.837159e-01
+0.50 (0.4328,0.4328) 1.027896e+00
+0.98 (0.2750,0.2750) 9.038621e-01
+0.02 (0.2750,0.2750) 1.006677e+00
+0.50 (0.4908,0.4908) 1.033938e+00
+0.50 (0.0592,0.0592) 9.749459e-01
+1.00 (0.2750,0.2750) 9.000619e-01
+0.00 (0.2750,0.2750) 1.000737e+00
+0.50 (0.4990,0.4990) 1.034692e+00
+0.50 (0.0510,0.0510) 9.737030e-01
+0.75 (0.2750,0.2750) 9.528173e-01
+0.25 (0.2750,0.2750) 1.042296e+00
+0.50 (0.3875,0.3875) 1.022449e+00
+0.50 (0.1625,0.1625) 9.905430e-01
+0.58 (0.3109,0.3109) 9.962992e-01
+0.42 (0.3109,0.3109) 1.026501e+00
+0.58 (0.2391,0.2391) 9.838082e-01
+0.42 (0.2391,0.2391) 1.018963e+00
+0.69 (0.3607,0.3607) 9.837171e-01
+0.31 (0.3607,0.3607) 1.041470e+00
+0.69 (0.1893,0.1893) 9.480246e-01
+0.31 (0.1893,0.1893) 1.034609e+00
+0.83 (0.4231,0.4231) 9.725485e-01
+0.17 (0.4231,0.4231) 1.034675e+00
+0.83 (0.1269,0.1269) 8.999113e-01
+0.17 (0.1269,0.1269) 1.041759e+00
+0.94 (0.4721,0.4721) 9.674497e-01
+0.06 (0.4721,0.4721) 1.014136e+00
+0.94 (0.0779,0.0779) 8.601991e-01
+0.06 (0.0779,0.0779) 1.023127e+00
+1.00 (0.4996,0.4996) 9.660060e-01
+0.00 (0.4996,0.4996) 1.000204e+00
+1.00 (0.0504,0.0504) 8.372150e-01
+0.00 (0.0504,0.0504) 1.000386e+00
+0.99 (0.4211,0.4211) 9.441116e-01
+0.01 (0.4211,0.4211) 1.002783e+00
+0.99 (0.1289,0.1289) 8.610544e-01
+0.01 (0.1289,0.1289) 1.004163e+00
+0.82 (0.4953,0.4953) 9.913087e-01
+0.18 (0.4953,0.4953) 1.032338e+00
+0.82 (0.0547,0.0547) 8.841062e-01
+0.18 (0.0547,0.0547) 1.042401e+00
+0.94 (0.3556,0.3556) 9.350369e-01
+0.06 (0.3556,0.3556) 1.017363e+00
+0.94 (0.1944,0.1944) 8.912294e-01
+0.06 (0.1944,0.1944) 1.021112e+00
+0.68 (0.4714,0.4714) 1.008145e+00
+0.32 (0.4714,0.4714) 1.042437e+00
+0.68 (0.0786,0.0786) 9.284413e-01
+0.32 (0.0786,0.0786) 1.025067e+00
+0.78 (0.3217,0.3217) 9.565583e-01
+0.22 (0.3217,0.3217) 1.041611e+00
+0.78 (0.2283,0.2283) 9.346970e-01
+0.22 (0.2283,0.2283) 1.042419e+00
+0.60 (0.4025,0.4025) 1.007626e+00
+0.40 (0.4025,0.4025) 1.037014e+00
+0.60 (0.1475,0.1475) 9.615211e-01
+0.40 (0.1475,0.1475) 1.014136e+00
+0.00 (0.5000,0.5000) 1.000000e+00
+# Seq: 2 Chr: 40 Trait: Trait Marker: M18 Position: 19.0000
+D11 Theta(M,F) BayesRatio
+0.00 (0.0023,0.0023) 1.000000e+00
+0.00 (0.0115,0.0115) 1.000000e+00
+0.00 (0.0250,0.0250) 1.000000e+00
+0.00 (0.0385,0.0385) 1.000000e+00
+0.00 (0.0477,0.0477) 1.000000e+00
+0.00 (0.0711,0.0711) 10.000000e-01
+0.00 (0.1538,0.1538) 1.000000e+00
+0.00 (0.2750,0.2750) 1.000000e+00
+0.00 (0.3962,0.3962) 1.000000e+00
+0.00 (0.4789,0.4789) 1.000000e+00
+-0.50 (0.0250,0.0250) 1.438719e+00
+-0.63 (0.0250,0.0250) 1.466831e+00
+-0.37 (0.0250,0.0250) 1.377737e+00
+-0.85 (0.0250,0.0250) 1.465544e+00
+-0.15 (0.0250,0.0250) 1.175008e+00
+-0.50 (0.0187,0.0187) 1.439807e+00
+-0.50 (0.0313,0.0313) 1.437608e+00
+-0.50 (0.0075,0.0075) 1.441698e+00
+-0.50 (0.0425,0.0425) 1.435570e+00
+-0.02 (0.0250,0.0250) 1.024273e+00
+-0.98 (0.0250,0.0250) 1.446487e+00
+-0.50 (0.0490,0.0490) 1.434370e+00
+-0.50 (0.0010,0.0010) 1.442751e+00
+-0.00 (0.0250,0.0250) 1.002603e+00
+-1.00 (0.0250,0.0250) 1.442998e+00
+-0.50 (0.0499,0.0499) 1.434198e+00
+-0.50 (0.0001,0.0001) 1.442899e+00
+-0.25 (0.0250,0.0250) 1.279351e+00
+-0.75 (0.0250,0.0250) 1.472233e+00
+-0.50 (0.0375,0.0375) 1.436492e+00
+-0.50 (0.0125,0.0125) 1.440860e+00
+-0.42 (0.0290,0.0290) 1.403586e+00
+-0.58 (0.0290,0.0290) 1.459230e+00
+-0.42 (0.0210,0.0210) 1.405382e+00
+-0.58 (0.0210,0.0210) 1.460137e+00
+-0.31 (0.0345,0.0345) 1.328825e+00
+-0.69 (0.0345,0.0345) 1.471568e+00
+-0.31 (0.0155,0.0155) 1.333665e+00
+-0.69 (0.0155,0.0155) 1.472083e+00
+-0.17 (0.0415,0.0415) 1.195643e+00
+-0.83 (0.0415,0.0415) 1.468839e+00
+-0.17 (0.0085,0.0085) 1.201915e+00
+-0.83 (0.0085,0.0085) 1.466324e+00
+-0.06 (0.0469,0.0469) 1.071997e+00
+-0.94 (0.0469,0.0469) 1.457029e+00
+-0.06 (0.0031,0.0031) 1.075302e+00
+-0.94 (0.0031,0.0031) 1.450173e+00
+-0.00 (0.0500,0.0500) 1.001013e+00
+-1.00 (0.0500,0.0500) 1.447595e+00
+-0.00 (0.0000,0.0000) 1.001066e+00
+-1.00 (0.0000,0.0000) 1.437542e+00
+-0.01 (0.0412,0.0412) 1.012224e+00
+-0.99 (0.0412,0.0412) 1.447688e+00
+-0.01 (0.0088,0.0088) 1.012639e+00
+-0.99 (0.0088,0.0088) 1.441377e+00
+-0.18 (0.0495,0.0495) 1.198918e+00
+-0.82 (0.0495,0.0495) 1.469678e+00
+-0.18 (0.0005,0.0005) 1.208432e+00
+-0.82 (0.0005,0.0005) 1.466103e+00
+-0.06 (0.0340,0.0340) 1.074978e+00
+-0.94 (0.0340,0.0340) 1.455378e+00
+-0.06 (0.0160,0.0160) 1.076366e+00
+-0.94 (0.0160,0.0160) 1.452596e+00
+-0.32 (0.0468,0.0468) 1.334548e+00
+-0.68 (0.0468,0.0468) 1.470428e+00
+-0.32 (0.0032,0.0032) 1.345642e+00
+-0.68 (0.0032,0.0032) 1.471991e+00
+-0.22 (0.0302,0.0302) 1.245694e+00
+-0.78 (0.0302,0.0302) 1.471164e+00
+-0.22 (0.0198,0.0198) 1.248022e+00
+-0.78 (0.0198,0.0198) 1.470720e+00
+-0.40 (0.0392,0.0392) 1.387745e+00
+-0.60 (0.0392,0.0392) 1.462437e+00
+-0.40 (0.0108,0.0108) 1.394450e+00
+-0.60 (0.0108,0.0108) 1.465118e+00
+0.50 (0.0250,0.0250) 5.856018e-01
+0.37 (0.0250,0.0250) 6.539544e-01
+0.63 (0.0250,0.0250) 5.314247e-01
+0.15 (0.0250,0.0250) 8.291294e-01
+0.85 (0.0250,0.0250) 4.592307e-01
+0.50 (0.0187,0.0187) 5.840537e-01
+0.50 (0.0313,0.0313) 5.871592e-01
+0.50 (0.0075,0.0075) 5.813107e-01
+0.50 (0.0425,0.0425) 5.899647e-01
+0.98 (0.0250,0.0250) 4.278503e-01
+0.02 (0.0250,0.0250) 9.738185e-01
+0.50 (0.0490,0.0490) 5.915860e-01
+0.50 (0.0010,0.0010) 5.797518e-01
+1.00 (0.0250,0.0250) 4.238514e-01
+0.00 (0.0250,0.0250) 9.971480e-01
+0.50 (0.0499,0.0499) 5.918165e-01
+0.50 (0.0001,0.0001) 5.795317e-01
+0.75 (0.0250,0.0250) 4.883529e-01
+0.25 (0.0250,0.0250) 7.403251e-01
+0.50 (0.0375,0.0375) 5.887045e-01
+0.50 (0.0125,0.0125) 5.825356e-01
+0.58 (0.0290,0.0290) 5.508799e-01
+0.42 (0.0290,0.0290) 6.279339e-01
+0.58 (0.0210,0.0210) 5.489045e-01
+0.42 (0.0210,0.0210) 6.260124e-01
+0.69 (0.0345,0.0345) 5.102441e-01
+0.31 (0.0345,0.0345) 6.982549e-01
+0.69 (0.0155,0.0155) 5.055954e-01
+0.31 (0.0155,0.0155) 6.940412e-01
+0.83 (0.0415,0.0415) 4.689968e-01
+0.17 (0.0415,0.0415) 8.111612e-01
+0.83 (0.0085,0.0085) 4.612642e-01
+0.17 (0.0085,0.0085) 8.057571e-01
+0.94 (0.0469,0.0469) 4.423536e-01
+0.06 (0.0469,0.0469) 9.249160e-01
+0.94 (0.0031,0.0031) 4.324407e-01
+0.06 (0.0031,0.0031) 9.216483e-01
+1.00 (0.0500,0.0500) 4.291869e-01
+0.00 (0.0500,0.0500) 9.988891e-01
+1.00 (0.0000,0.0000) 4.181368e-01
+0.00 (0.0000,0.0000) 9.988308e-01
+0.99 (0.0412,0.0412) 4.293009e-01
+0.01 (0.0412,0.0412) 9.867000e-01
+0.99 (0.0088,0.0088) 4.220908e-01
+0.01 (0.0088,0.0088) 9.862531e-01
+0.82 (0.0495,0.0495) 4.721940e-01
+0.18 (0.0495,0.0495) 8.083368e-01
+0.82 (0.0005,0.0005) 4.606754e-01
+0.18 (0.0005,0.0005) 8.001675e-01
+0.94 (0.0340,0.0340) 4.397636e-01
+0.06 (0.0340,0.0340) 9.219683e-01
+0.94 (0.0160,0.0160) 4.357084e-01
+0.06 (0.0160,0.0160) 9.205998e-01
+0.68 (0.0468,0.0468) 5.172517e-01
+0.32 (0.0468,0.0468) 6.932698e-01
+0.68 (0.0032,0.0032) 5.065741e-01
+0.32 (0.0032,0.0032) 6.834910e-01
+0.78 (0.0302,0.0302) 4.794425e-01
+0.22 (0.0302,0.0302) 7.685847e-01
+0.78 (0.0198,0.0198) 4.769669e-01
+0.22 (0.0198,0.0198) 7.666267e-01
+0.60 (0.0392,0.0392) 5.435646e-01
+0.40 (0.0392,0.0392) 6.441930e-01
+0.60 (0.0108,0.0108) 5.365554e-01
+0.40 (0.0108,0.0108) 6.374481e-01
+-0.50 (0.2750,0.2750) 1.376232e+00
+-0.63 (0.2750,0.2750) 1.425634e+00
+-0.37 (0.2750,0.2750) 1.304973e+00
+-0.85 (0.2750,0.2750) 1.467607e+00
+-0.15 (0.2750,0.2750) 1.131376e+00
+-0.50 (0.2184,0.2184) 1.393865e+00
+-0.50 (0.3316,0.3316) 1.356463e+00
+-0.50 (0.1172,0.1172) 1.420183e+00
+-0.50 (0.4328,0.4328) 1.315870e+00
+-0.02 (0.2750,0.2750) 1.018037e+00
+-0.98 (0.2750,0.2750) 1.472514e+00
+-0.50 (0.4908,0.4908) 1.289675e+00
+-0.50 (0.0592,0.0592) 1.432416e+00
+-0.00 (0.2750,0.2750) 1.001936e+00
+-1.00 (0.2750,0.2750) 1.472391e+00
+-0.50 (0.4990,0.4990) 1.285800e+00
+-0.50 (0.0510,0.0510) 1.433990e+00
+-0.25 (0.2750,0.2750) 1.214960e+00
+-0.75 (0.2750,0.2750) 1.455064e+00
+-0.50 (0.3875,0.3875) 1.334875e+00
+-0.50 (0.1625,0.1625) 1.409200e+00
+-0.42 (0.3109,0.3109) 1.321054e+00
+-0.58 (0.3109,0.3109) 1.398850e+00
+-0.42 (0.2391,0.2391) 1.345586e+00
+-0.58 (0.2391,0.2391) 1.420043e+00
+-0.31 (0.3607,0.3607) 1.232869e+00
+-0.69 (0.3607,0.3607) 1.420181e+00
+-0.31 (0.1893,0.1893) 1.286235e+00
+-0.69 (0.1893,0.1893) 1.458586e+00
+-0.17 (0.4231,0.4231) 1.119830e+00
+-0.83 (0.4231,0.4231) 1.435417e+00
+-0.17 (0.1269,0.1269) 1.179138e+00
+-0.83 (0.1269,0.1269) 1.472382e+00
+-0.06 (0.4721,0.4721) 1.039842e+00
+-0.94 (0.4721,0.4721) 1.441337e+00
+-0.06 (0.0779,0.0779) 1.069660e+00
+-0.94 (0.0779,0.0779) 1.461217e+00
+-0.00 (0.4996,0.4996) 1.000533e+00
+-1.00 (0.4996,0.4996) 1.442902e+00
+-0.00 (0.0504,0.0504) 1.001012e+00
+-1.00 (0.0504,0.0504) 1.447678e+00
+-0.01 (0.4211,0.4211) 1.007376e+00
+-0.99 (0.4211,0.4211) 1.461132e+00
+-0.01 (0.1289,0.1289) 1.011105e+00
+-0.99 (0.1289,0.1289) 1.461628e+00
+-0.18 (0.4953,0.4953) 1.107765e+00
+-0.82 (0.4953,0.4953) 1.407883e+00
+-0.18 (0.0547,0.0547) 1.197891e+00
+-0.82 (0.0547,0.0547) 1.469981e+00
+-0.06 (0.3556,0.3556) 1.050001e+00
+-0.94 (0.3556,0.3556) 1.465954e+00
+-0.06 (0.1944,0.1944) 1.062530e+00
+-0.94 (0.1944,0.1944) 1.471422e+00
+-0.32 (0.4714,0.4714) 1.202160e+00
+-0.68 (0.4714,0.4714) 1.373912e+00
+-0.32 (0.0786,0.0786) 1.326138e+00
+-0.68 (0.0786,0.0786) 1.468570e+00
+-0.22 (0.3217,0.3217) 1.176592e+00
+-0.78 (0.3217,0.3217) 1.451992e+00
+-0.22 (0.2283,0.2283) 1.199480e+00
+-0.78 (0.2283,0.2283) 1.466106e+00
+-0.40 (0.4025,0.4025) 1.272476e+00
+-0.60 (0.4025,0.4025) 1.375121e+00
+-0.40 (0.1475,0.1475) 1.359024e+00
+-0.60 (0.1475,0.1475) 1.447462e+00
+0.50 (0.2750,0.2750) 6.553946e-01
+0.37 (0.2750,0.2750) 7.187070e-01
+0.63 (0.2750,0.2750) 6.028060e-01
+0.15 (0.2750,0.2750) 8.682989e-01
+0.85 (0.2750,0.2750) 5.288586e-01
+0.50 (0.2184,0.2184) 6.380443e-01
+0.50 (0.3316,0.3316) 6.737719e-01
+0.50 (0.1172,0.1172) 6.093785e-01
+0.50 (0.4328,0.4328) 7.094177e-01
+0.98 (0.2750,0.2750) 4.952328e-01
+0.02 (0.2750,0.2750) 9.804576e-01
+0.50 (0.4908,0.4908) 7.316412e-01
+0.50 (0.0592,0.0592) 5.941799e-01
+1.00 (0.2750,0.2750) 4.908854e-01
+0.00 (0.2750,0.2750) 9.978785e-01
+0.50 (0.4990,0.4990) 7.349035e-01
+0.50 (0.0510,0.0510) 5.920944e-01
+0.75 (0.2750,0.2750) 5.592535e-01
+0.25 (0.2750,0.2750) 7.945913e-01
+0.50 (0.3875,0.3875) 6.929840e-01
+0.50 (0.1625,0.1625) 6.218648e-01
+0.58 (0.3109,0.3109) 6.329170e-01
+0.42 (0.3109,0.3109) 7.049692e-01
+0.58 (0.2391,0.2391) 6.095432e-01
+0.42 (0.2391,0.2391) 6.835409e-01
+0.69 (0.3607,0.3607) 6.093806e-01
+0.31 (0.3607,0.3607) 7.793958e-01
+0.69 (0.1893,0.1893) 5.522460e-01
+0.31 (0.1893,0.1893) 7.345379e-01
+0.83 (0.4231,0.4231) 5.901719e-01
+0.17 (0.4231,0.4231) 8.789806e-01
+0.83 (0.1269,0.1269) 4.907147e-01
+0.17 (0.1269,0.1269) 8.255082e-01
+0.94 (0.4721,0.4721) 5.818400e-01
+0.06 (0.4721,0.4721) 9.575004e-01
+0.94 (0.0779,0.0779) 4.497324e-01
+0.06 (0.0779,0.0779) 9.272358e-01
+1.00 (0.4996,0.4996) 5.795265e-01
+0.00 (0.4996,0.4996) 9.994147e-01
+1.00 (0.0504,0.0504) 4.292876e-01
+0.00 (0.0504,0.0504) 9.988897e-01
+0.99 (0.4211,0.4211) 5.466570e-01
+0.01 (0.4211,0.4211) 9.919464e-01
+0.99 (0.1289,0.1289) 4.505363e-01
+0.01 (0.1289,0.1289) 9.879085e-01
+0.82 (0.4953,0.4953) 6.233056e-01
+0.18 (0.4953,0.4953) 8.903035e-01
+0.82 (0.0547,0.0547) 4.734723e-01
+0.18 (0.0547,0.0547) 8.092214e-01
+0.94 (0.3556,0.3556) 5.341307e-01
+0.06 (0.3556,0.3556) 9.470469e-01
+0.94 (0.1944,0.1944) 4.810823e-01
+0.06 (0.1944,0.1944) 9.343585e-01
+0.68 (0.4714,0.4714) 6.576018e-01
+0.32 (0.4714,0.4714) 8.055468e-01
+0.68 (0.0786,0.0786) 5.253881e-01
+0.32 (0.0786,0.0786) 7.005828e-01
+0.78 (0.3217,0.3217) 5.648524e-01
+0.22 (0.3217,0.3217) 8.277385e-01
+0.78 (0.2283,0.2283) 5.336729e-01
+0.22 (0.2283,0.2283) 8.078529e-01
+0.60 (0.4025,0.4025) 6.564531e-01
+0.40 (0.4025,0.4025) 7.460974e-01
+0.60 (0.1475,0.1475) 5.724622e-01
+0.40 (0.1475,0.1475) 6.714406e-01
+0.00 (0.5000,0.5000) 1.000000e+00
+# Seq: 3 Chr: 40 Trait: Trait Marker: M19 Position: 20.0000
+D11 Theta(M,F) BayesRatio
+0.00 (0.0023,0.0023) 10.000000e-01
+0.00 (0.0115,0.0115) 1.000000e+00
+0.00 (0.0250,0.0250) 1.000000e+00
+0.00 (0.0385,0.0385) 1.000000e+00
+0.00 (0.0477,0.0477) 1.000000e+00
+0.00 (0.0711,0.0711) 1.000000e+00
+0.00 (0.1538,0.1538) 1.000000e+00
+0.00 (0.2750,0.2750) 1.000000e+00
+0.00 (0.3962,0.3962) 1.000000e+00
+0.00 (0.4789,0.4789) 1.000000e+00
+-0.50 (0.0250,0.0250) 1.318069e+00
+-0.63 (0.0250,0.0250) 1.303578e+00
+-0.37 (0.0250,0.0250) 1.300464e+00
+-0.85 (0.0250,0.0250) 1.234643e+00
+-0.15 (0.0250,0.0250) 1.158600e+00
+-0.50 (0.0187,0.0187) 1.318044e+00
+-0.50 (0.0313,0.0313) 1.318072e+00
+-0.50 (0.0075,0.0075) 1.317948e+00
+-0.50 (0.0425,0.0425) 1.318025e+00
+-0.02 (0.0250,0.0250) 1.022849e+00
+-0.98 (0.0250,0.0250) 1.184987e+00
+-0.50 (0.0490,0.0490) 1.317967e+00
+-0.50 (0.0010,0.0010) 1.317864e+00
+-0.00 (0.0250,0.0250) 1.002457e+00
+-1.00 (0.0250,0.0250) 1.177718e+00
+-0.50 (0.0499,0.0499) 1.317956e+00
+-0.50 (0.0001,0.0001) 1.317850e+00
+-0.25 (0.0250,0.0250) 1.240579e+00
+-0.75 (0.0250,0.0250) 1.269746e+00
+-0.50 (0.0375,0.0375) 1.318054e+00
+-0.50 (0.0125,0.0125) 1.317999e+00
+-0.42 (0.0290,0.0290) 1.311123e+00
+-0.58 (0.0290,0.0290) 1.312159e+00
+-0.42 (0.0210,0.0210) 1.311733e+00
+-0.58 (0.0210,0.0210) 1.311468e+00
+-0.31 (0.0345,0.0345) 1.273586e+00
+-0.69 (0.0345,0.0345) 1.289569e+00
+-0.31 (0.0155,0.0155) 1.276541e+00
+-0.69 (0.0155,0.0155) 1.285820e+00
+-0.17 (0.0415,0.0415) 1.175853e+00
+-0.83 (0.0415,0.0415) 1.247550e+00
+-0.17 (0.0085,0.0085) 1.181008e+00
+-0.83 (0.0085,0.0085) 1.237427e+00
+-0.06 (0.0469,0.0469) 1.067213e+00
+-0.94 (0.0469,0.0469) 1.209534e+00
+-0.06 (0.0031,0.0031) 1.070250e+00
+-0.94 (0.0031,0.0031) 1.193063e+00
+-0.00 (0.0500,0.0500) 1.000956e+00
+-1.00 (0.0500,0.0500) 1.187368e+00
+-0.00 (0.0000,0.0000) 1.001006e+00
+-1.00 (0.0000,0.0000) 1.166952e+00
+-0.01 (0.0412,0.0412) 1.011526e+00
+-0.99 (0.0412,0.0412) 1.187570e+00
+-0.01 (0.0088,0.0088) 1.011916e+00
+-0.99 (0.0088,0.0088) 1.174449e+00
+-0.18 (0.0495,0.0495) 1.178549e+00
+-0.82 (0.0495,0.0495) 1.251524e+00
+-0.18 (0.0005,0.0005) 1.186318e+00
+-0.82 (0.0005,0.0005) 1.236626e+00
+-0.06 (0.0340,0.0340) 1.069953e+00
+-0.94 (0.0340,0.0340) 1.205357e+00
+-0.06 (0.0160,0.0160) 1.071227e+00
+-0.94 (0.0160,0.0160) 1.198637e+00
+-0.32 (0.0468,0.0468) 1.277074e+00
+-0.68 (0.0468,0.0468) 1.294757e+00
+-0.32 (0.0032,0.0032) 1.283601e+00
+-0.68 (0.0032,0.0032) 1.286630e+00
+-0.22 (0.0302,0.0302) 1.215695e+00
+-0.78 (0.0302,0.0302) 1.260080e+00
+-0.22 (0.0198,0.0198) 1.217470e+00
+-0.78 (0.0198,0.0198) 1.257228e+00
+-0.40 (0.0392,0.0392) 1.304966e+00
+-0.60 (0.0392,0.0392) 1.309399e+00
+-0.40 (0.0108,0.0108) 1.307732e+00
+-0.60 (0.0108,0.0108) 1.306230e+00
+0.50 (0.0250,0.0250) 5.978836e-01
+0.37 (0.0250,0.0250) 6.701376e-01
+0.63 (0.0250,0.0250) 5.394556e-01
+0.15 (0.0250,0.0250) 8.468260e-01
+0.85 (0.0250,0.0250) 4.598154e-01
+0.50 (0.0187,0.0187) 5.962287e-01
+0.50 (0.0313,0.0313) 5.995475e-01
+0.50 (0.0075,0.0075) 5.932945e-01
+0.50 (0.0425,0.0425) 6.025427e-01
+0.98 (0.0250,0.0250) 4.245250e-01
+0.02 (0.0250,0.0250) 9.780164e-01
+0.50 (0.0490,0.0490) 6.042725e-01
+0.50 (0.0010,0.0010) 5.916258e-01
+1.00 (0.0250,0.0250) 4.200008e-01
+0.00 (0.0250,0.0250) 9.976314e-01
+0.50 (0.0499,0.0499) 6.045183e-01
+0.50 (0.0001,0.0001) 5.913901e-01
+0.75 (0.0250,0.0250) 4.921997e-01
+0.25 (0.0250,0.0250) 7.590839e-01
+0.50 (0.0375,0.0375) 6.011977e-01
+0.50 (0.0125,0.0125) 5.946051e-01
+0.58 (0.0290,0.0290) 5.605619e-01
+0.42 (0.0290,0.0290) 6.428164e-01
+0.58 (0.0210,0.0210) 5.584255e-01
+0.42 (0.0210,0.0210) 6.407899e-01
+0.69 (0.0345,0.0345) 5.163106e-01
+0.31 (0.0345,0.0345) 7.161184e-01
+0.69 (0.0155,0.0155) 5.112068e-01
+0.31 (0.0155,0.0155) 7.117754e-01
+0.83 (0.0415,0.0415) 4.707153e-01
+0.17 (0.0415,0.0415) 8.294544e-01
+0.83 (0.0085,0.0085) 4.620882e-01
+0.17 (0.0085,0.0085) 8.241886e-01
+0.94 (0.0469,0.0469) 4.408844e-01
+0.06 (0.0469,0.0469) 9.354984e-01
+0.94 (0.0031,0.0031) 4.297114e-01
+0.06 (0.0031,0.0031) 9.325896e-01
+1.00 (0.0500,0.0500) 4.260359e-01
+0.00 (0.0500,0.0500) 9.990782e-01
+1.00 (0.0000,0.0000) 4.135267e-01
+0.00 (0.0000,0.0000) 9.990298e-01
+0.99 (0.0412,0.0412) 4.261647e-01
+0.01 (0.0412,0.0412) 9.889000e-01
+0.99 (0.0088,0.0088) 4.180072e-01
+0.01 (0.0088,0.0088) 9.885246e-01
+0.82 (0.0495,0.0495) 4.742749e-01
+0.18 (0.0495,0.0495) 8.267047e-01
+0.82 (0.0005,0.0005) 4.614302e-01
+0.18 (0.0005,0.0005) 8.187228e-01
+0.94 (0.0340,0.0340) 4.379689e-01
+0.06 (0.0340,0.0340) 9.328748e-01
+0.94 (0.0160,0.0160) 4.333987e-01
+0.06 (0.0160,0.0160) 9.316544e-01
+0.68 (0.0468,0.0468) 5.239877e-01
+0.32 (0.0468,0.0468) 7.109796e-01
+0.68 (0.0032,0.0032) 5.122821e-01
+0.32 (0.0032,0.0032) 7.008725e-01
+0.78 (0.0302,0.0302) 4.823291e-01
+0.22 (0.0302,0.0302) 7.874890e-01
+0.78 (0.0198,0.0198) 4.795808e-01
+0.22 (0.0198,0.0198) 7.855341e-01
+0.60 (0.0392,0.0392) 5.526426e-01
+0.40 (0.0392,0.0392) 6.599147e-01
+0.60 (0.0108,0.0108) 5.450357e-01
+0.40 (0.0108,0.0108) 6.528324e-01
+-0.50 (0.2750,0.2750) 1.299751e+00
+-0.63 (0.2750,0.2750) 1.316959e+00
+-0.37 (0.2750,0.2750) 1.258270e+00
+-0.85 (0.2750,0.2750) 1.302144e+00
+-0.15 (0.2750,0.2750) 1.120828e+00
+-0.50 (0.2184,0.2184) 1.307499e+00
+-0.50 (0.3316,0.3316) 1.289648e+00
+-0.50 (0.1172,0.1172) 1.315895e+00
+-0.50 (0.4328,0.4328) 1.265418e+00
+-0.02 (0.2750,0.2750) 1.016993e+00
+-0.98 (0.2750,0.2750) 1.276572e+00
+-0.50 (0.4908,0.4908) 1.247849e+00
+-0.50 (0.0592,0.0592) 1.317827e+00
+-0.00 (0.2750,0.2750) 1.001827e+00
+-1.00 (0.2750,0.2750) 1.272323e+00
+-0.50 (0.4990,0.4990) 1.245142e+00
+-0.50 (0.0510,0.0510) 1.317944e+00
+-0.25 (0.2750,0.2750) 1.191589e+00
+-0.75 (0.2750,0.2750) 1.314648e+00
+-0.50 (0.3875,0.3875) 1.277270e+00
+-0.50 (0.1625,0.1625) 1.312961e+00
+-0.42 (0.3109,0.3109) 1.268730e+00
+-0.58 (0.3109,0.3109) 1.309423e+00
+-0.42 (0.2391,0.2391) 1.283569e+00
+-0.58 (0.2391,0.2391) 1.315864e+00
+-0.31 (0.3607,0.3607) 1.205784e+00
+-0.69 (0.3607,0.3607) 1.315895e+00
+-0.31 (0.1893,0.1893) 1.245446e+00
+-0.69 (0.1893,0.1893) 1.312613e+00
+-0.17 (0.4231,0.4231) 1.110579e+00
+-0.83 (0.4231,0.4231) 1.318019e+00
+-0.17 (0.1269,0.1269) 1.162088e+00
+-0.83 (0.1269,0.1269) 1.272151e+00
+-0.06 (0.4721,0.4721) 1.037416e+00
+-0.94 (0.4721,0.4721) 1.317972e+00
+-0.06 (0.0779,0.0779) 1.065062e+00
+-0.94 (0.0779,0.0779) 1.220958e+00
+-0.00 (0.4996,0.4996) 1.000504e+00
+-1.00 (0.4996,0.4996) 1.317850e+00
+-0.00 (0.0504,0.0504) 1.000956e+00
+-1.00 (0.0504,0.0504) 1.187547e+00
+-0.01 (0.4211,0.4211) 1.006959e+00
+-0.99 (0.4211,0.4211) 1.310633e+00
+-0.01 (0.1289,0.1289) 1.010472e+00
+-0.99 (0.1289,0.1289) 1.222160e+00
+-0.18 (0.4953,0.4953) 1.099770e+00
+-0.82 (0.4953,0.4953) 1.312548e+00
+-0.18 (0.0547,0.0547) 1.177705e+00
+-0.82 (0.0547,0.0547) 1.253078e+00
+-0.06 (0.3556,0.3556) 1.046875e+00
+-0.94 (0.3556,0.3556) 1.305012e+00
+-0.06 (0.1944,0.1944) 1.058485e+00
+-0.94 (0.1944,0.1944) 1.261929e+00
+-0.32 (0.4714,0.4714) 1.181208e+00
+-0.68 (0.4714,0.4714) 1.298636e+00
+-0.32 (0.0786,0.0786) 1.271923e+00
+-0.68 (0.0786,0.0786) 1.300091e+00
+-0.22 (0.3217,0.3217) 1.159940e+00
+-0.78 (0.3217,0.3217) 1.315925e+00
+-0.22 (0.2283,0.2283) 1.179011e+00
+-0.78 (0.2283,0.2283) 1.304775e+00
+-0.40 (0.4025,0.4025) 1.235638e+00
+-0.60 (0.4025,0.4025) 1.299220e+00
+-0.40 (0.1475,0.1475) 1.291029e+00
+-0.60 (0.1475,0.1475) 1.317175e+00
+0.50 (0.2750,0.2750) 6.716432e-01
+0.37 (0.2750,0.2750) 7.370991e-01
+0.63 (0.2750,0.2750) 6.162180e-01
+0.15 (0.2750,0.2750) 8.839185e-01
+0.85 (0.2750,0.2750) 5.366609e-01
+0.50 (0.2184,0.2184) 6.534590e-01
+0.50 (0.3316,0.3316) 6.907927e-01
+0.50 (0.1172,0.1172) 6.231957e-01
+0.50 (0.4328,0.4328) 7.275905e-01
+0.98 (0.2750,0.2750) 4.997984e-01
+0.02 (0.2750,0.2750) 9.836422e-01
+0.50 (0.4908,0.4908) 7.502777e-01
+0.50 (0.0592,0.0592) 6.070380e-01
+1.00 (0.2750,0.2750) 4.949991e-01
+0.00 (0.2750,0.2750) 9.982387e-01
+0.50 (0.4990,0.4990) 7.535900e-01
+0.50 (0.0510,0.0510) 6.048147e-01
+0.75 (0.2750,0.2750) 5.696026e-01
+0.25 (0.2750,0.2750) 8.132507e-01
+0.50 (0.3875,0.3875) 7.106847e-01
+0.50 (0.1625,0.1625) 6.364115e-01
+0.58 (0.3109,0.3109) 6.480661e-01
+0.42 (0.3109,0.3109) 7.230246e-01
+0.58 (0.2391,0.2391) 6.233703e-01
+0.42 (0.2391,0.2391) 7.009241e-01
+0.69 (0.3607,0.3607) 6.231979e-01
+0.31 (0.3607,0.3607) 7.982450e-01
+0.69 (0.1893,0.1893) 5.620386e-01
+0.31 (0.1893,0.1893) 7.532191e-01
+0.83 (0.4231,0.4231) 6.027639e-01
+0.17 (0.4231,0.4231) 8.938388e-01
+0.83 (0.1269,0.1269) 4.948105e-01
+0.17 (0.1269,0.1269) 8.433423e-01
+0.94 (0.4721,0.4721) 5.938610e-01
+0.06 (0.4721,0.4721) 9.640404e-01
+0.94 (0.0779,0.0779) 4.491757e-01
+0.06 (0.0779,0.0779) 9.375584e-01
+1.00 (0.4996,0.4996) 5.913846e-01
+0.00 (0.4996,0.4996) 9.995145e-01
+1.00 (0.0504,0.0504) 4.261497e-01
+0.00 (0.0504,0.0504) 9.990786e-01
+0.99 (0.4211,0.4211) 5.559929e-01
+0.01 (0.4211,0.4211) 9.932952e-01
+0.99 (0.1289,0.1289) 4.500777e-01
+0.01 (0.1289,0.1289) 9.899143e-01
+0.82 (0.4953,0.4953) 6.379331e-01
+0.18 (0.4953,0.4953) 9.042600e-01
+0.82 (0.0547,0.0547) 4.756969e-01
+0.18 (0.0547,0.0547) 8.275664e-01
+0.94 (0.3556,0.3556) 5.423998e-01
+0.06 (0.3556,0.3556) 9.549758e-01
+0.94 (0.1944,0.1944) 4.841482e-01
+0.06 (0.1944,0.1944) 9.438563e-01
+0.68 (0.4714,0.4714) 6.739493e-01
+0.32 (0.4714,0.4714) 8.239834e-01
+0.68 (0.0786,0.0786) 5.328771e-01
+0.32 (0.0786,0.0786) 7.185148e-01
+0.78 (0.3217,0.3217) 5.756330e-01
+0.22 (0.3217,0.3217) 8.454889e-01
+0.78 (0.2283,0.2283) 5.419019e-01
+0.22 (0.2283,0.2283) 8.262330e-01
+0.60 (0.4025,0.4025) 6.727494e-01
+0.40 (0.4025,0.4025) 7.649182e-01
+0.60 (0.1475,0.1475) 5.838112e-01
+0.40 (0.1475,0.1475) 6.883699e-01
+0.00 (0.5000,0.5000) 1.000000e+00
+# Seq: 4 Chr: 40 Trait: Trait Marker: M20 Position: 21.0000
+D11 Theta(M,F) BayesRatio
+0.00 (0.0023,0.0023) 1.000000e+00
+0.00 (0.0115,0.0115) 1.000000e+00
+0.00 (0.0250,0.0250) 1.000000e+00
+0.00 (0.0385,0.0385) 1.000000e+00
+0.00 (0.0477,0.0477) 1.000000e+00
+0.00 (0.0711,0.0711) 1.000000e+00
+0.00 (0.1538,0.1538) 1.000000e+00
+0.00 (0.2750,0.2750) 1.000000e+00
+0.00 (0.3962,0.3962) 1.000000e+00
+0.00 (0.4789,0.4789) 1.000000e+00
+-0.50 (0.0250,0.0250) 1.080753e+00
+-0.63 (0.0250,0.0250) 1.033137e+00
+-0.37 (0.0250,0.0250) 1.113391e+00
+-0.85 (0.0250,0.0250) 9.399595e-01
+-0.15 (0.0250,0.0250) 1.088842e+00
+-0.50 (0.0187,0.0187) 1.079664e+00
+-0.50 (0.0313,0.0313) 1.081832e+00
+-0.50 (0.0075,0.0075) 1.077696e+00
+-0.50 (0.0425,0.0425) 1.083735e+00
+-0.02 (0.0250,0.0250) 1.014609e+00
+-0.98 (0.0250,0.0250) 8.895695e-01
+-0.50 (0.0490,0.0490) 1.084811e+00
+-0.50 (0.0010,0.0010) 1.076555e+00
+-0.00 (0.0250,0.0250) 1.001595e+00
+-1.00 (0.0250,0.0250) 8.827578e-01
+-0.50 (0.0499,0.0499) 1.084962e+00
+-0.50 (0.0001,0.0001) 1.076393e+00
+-0.25 (0.0250,0.0250) 1.116528e+00
+-0.75 (0.0250,0.0250) 9.814878e-01
+-0.50 (0.0375,0.0375) 1.082886e+00
+-0.50 (0.0125,0.0125) 1.078581e+00
+-0.42 (0.0290,0.0290) 1.104441e+00
+-0.58 (0.0290,0.0290) 1.052492e+00
+-0.42 (0.0210,0.0210) 1.103615e+00
+-0.58 (0.0210,0.0210) 1.050642e+00
+-0.31 (0.0345,0.0345) 1.119663e+00
+-0.69 (0.0345,0.0345) 1.009229e+00
+-0.31 (0.0155,0.0155) 1.119518e+00
+-0.69 (0.0155,0.0155) 1.003593e+00
+-0.17 (0.0415,0.0415) 1.096181e+00
+-0.83 (0.0415,0.0415) 9.544631e-01
+-0.17 (0.0085,0.0085) 1.098247e+00
+-0.83 (0.0085,0.0085) 9.430268e-01
+-0.06 (0.0469,0.0469) 1.041475e+00
+-0.94 (0.0469,0.0469) 9.135569e-01
+-0.06 (0.0031,0.0031) 1.043235e+00
+-0.94 (0.0031,0.0031) 8.972860e-01
+-0.00 (0.0500,0.0500) 1.000621e+00
+-1.00 (0.0500,0.0500) 8.918279e-01
+-0.00 (0.0000,0.0000) 1.000654e+00
+-1.00 (0.0000,0.0000) 8.728856e-01
+-0.01 (0.0412,0.0412) 1.007431e+00
+-0.99 (0.0412,0.0412) 8.920200e-01
+-0.01 (0.0088,0.0088) 1.007680e+00
+-0.99 (0.0088,0.0088) 8.797331e-01
+-0.18 (0.0495,0.0495) 1.097270e+00
+-0.82 (0.0495,0.0495) 9.590858e-01
+-0.18 (0.0005,0.0005) 1.100309e+00
+-0.82 (0.0005,0.0005) 9.421411e-01
+-0.06 (0.0340,0.0340) 1.043063e+00
+-0.94 (0.0340,0.0340) 9.093588e-01
+-0.06 (0.0160,0.0160) 1.043798e+00
+-0.94 (0.0160,0.0160) 9.027100e-01
+-0.32 (0.0468,0.0468) 1.119482e+00
+-0.68 (0.0468,0.0468) 1.017463e+00
+-0.32 (0.0032,0.0032) 1.118754e+00
+-0.68 (0.0032,0.0032) 1.004791e+00
+-0.22 (0.0302,0.0302) 1.110334e+00
+-0.78 (0.0302,0.0302) 9.693341e-01
+-0.22 (0.0198,0.0198) 1.110855e+00
+-0.78 (0.0198,0.0198) 9.658703e-01
+-0.40 (0.0392,0.0392) 1.110515e+00
+-0.60 (0.0392,0.0392) 1.045510e+00
+-0.40 (0.0108,0.0108) 1.108192e+00
+-0.60 (0.0108,0.0108) 1.038485e+00
+0.50 (0.0250,0.0250) 6.818596e-01
+0.37 (0.0250,0.0250) 7.525958e-01
+0.63 (0.0250,0.0250) 6.218103e-01
+0.15 (0.0250,0.0250) 9.038075e-01
+0.85 (0.0250,0.0250) 5.362490e-01
+0.50 (0.0187,0.0187) 6.801929e-01
+0.50 (0.0313,0.0313) 6.835335e-01
+0.50 (0.0075,0.0075) 6.772327e-01
+0.50 (0.0425,0.0425) 6.865414e-01
+0.98 (0.0250,0.0250) 4.972038e-01
+0.02 (0.0250,0.0250) 9.884036e-01
+0.50 (0.0490,0.0490) 6.882755e-01
+0.50 (0.0010,0.0010) 6.755463e-01
+1.00 (0.0250,0.0250) 4.921589e-01
+0.00 (0.0250,0.0250) 9.987865e-01
+0.50 (0.0499,0.0499) 6.885217e-01
+0.50 (0.0001,0.0001) 6.753080e-01
+0.75 (0.0250,0.0250) 5.715133e-01
+0.25 (0.0250,0.0250) 8.333099e-01
+0.50 (0.0375,0.0375) 6.851915e-01
+0.50 (0.0125,0.0125) 6.785556e-01
+0.58 (0.0290,0.0290) 6.437846e-01
+0.42 (0.0290,0.0290) 7.263301e-01
+0.58 (0.0210,0.0210) 6.415746e-01
+0.42 (0.0210,0.0210) 7.243578e-01
+0.69 (0.0345,0.0345) 5.973594e-01
+0.31 (0.0345,0.0345) 7.953215e-01
+0.69 (0.0155,0.0155) 5.919194e-01
+0.31 (0.0155,0.0155) 7.913720e-01
+0.83 (0.0415,0.0415) 5.481841e-01
+0.17 (0.0415,0.0415) 8.906808e-01
+0.83 (0.0085,0.0085) 5.387430e-01
+0.17 (0.0085,0.0085) 8.866172e-01
+0.94 (0.0469,0.0469) 5.153755e-01
+0.06 (0.0469,0.0469) 9.638596e-01
+0.94 (0.0031,0.0031) 5.029773e-01
+0.06 (0.0031,0.0031) 9.620787e-01
+1.00 (0.0500,0.0500) 4.988869e-01
+0.00 (0.0500,0.0500) 9.995288e-01
+1.00 (0.0000,0.0000) 4.849258e-01
+0.00 (0.0000,0.0000) 9.995040e-01
+0.99 (0.0412,0.0412) 4.990303e-01
+0.01 (0.0412,0.0412) 9.942381e-01
+0.99 (0.0088,0.0088) 4.899332e-01
+0.01 (0.0088,0.0088) 9.940399e-01
+0.82 (0.0495,0.0495) 5.520677e-01
+0.18 (0.0495,0.0495) 8.885637e-01
+0.82 (0.0005,0.0005) 5.380213e-01
+0.18 (0.0005,0.0005) 8.823583e-01
+0.94 (0.0340,0.0340) 5.121456e-01
+0.06 (0.0340,0.0340) 9.622539e-01
+0.94 (0.0160,0.0160) 5.070750e-01
+0.06 (0.0160,0.0160) 9.615034e-01
+0.68 (0.0468,0.0468) 6.055098e-01
+0.32 (0.0468,0.0468) 7.906463e-01
+0.68 (0.0032,0.0032) 5.930669e-01
+0.32 (0.0032,0.0032) 7.813749e-01
+0.78 (0.0302,0.0302) 5.608286e-01
+0.22 (0.0302,0.0302) 8.572432e-01
+0.78 (0.0198,0.0198) 5.578434e-01
+0.22 (0.0198,0.0198) 8.556285e-01
+0.60 (0.0392,0.0392) 6.355765e-01
+0.40 (0.0392,0.0392) 7.428398e-01
+0.60 (0.0108,0.0108) 6.276503e-01
+0.40 (0.0108,0.0108) 7.360300e-01
+-0.50 (0.2750,0.2750) 1.113768e+00
+-0.63 (0.2750,0.2750) 1.091783e+00
+-0.37 (0.2750,0.2750) 1.119138e+00
+-0.85 (0.2750,0.2750) 1.030397e+00
+-0.15 (0.2750,0.2750) 1.070798e+00
+-0.50 (0.2184,0.2184) 1.108409e+00
+-0.50 (0.3316,0.3316) 1.117526e+00
+-0.50 (0.1172,0.1172) 1.095486e+00
+-0.50 (0.4328,0.4328) 1.119623e+00
+-0.02 (0.2750,0.2750) 1.010912e+00
+-0.98 (0.2750,0.2750) 9.905331e-01
+-0.50 (0.4908,0.4908) 1.117815e+00
+-0.50 (0.0592,0.0592) 1.086496e+00
+-0.00 (0.2750,0.2750) 1.001186e+00
+-1.00 (0.2750,0.2750) 9.848519e-01
+-0.50 (0.4990,0.4990) 1.117368e+00
+-0.50 (0.0510,0.0510) 1.085145e+00
+-0.25 (0.2750,0.2750) 1.102286e+00
+-0.75 (0.2750,0.2750) 1.060046e+00
+-0.50 (0.3875,0.3875) 1.119467e+00
+-0.50 (0.1625,0.1625) 1.101753e+00
+-0.42 (0.3109,0.3109) 1.119712e+00
+-0.58 (0.3109,0.3109) 1.106476e+00
+-0.42 (0.2391,0.2391) 1.118759e+00
+-0.58 (0.2391,0.2391) 1.095575e+00
+-0.31 (0.3607,0.3607) 1.107236e+00
+-0.69 (0.3607,0.3607) 1.095487e+00
+-0.31 (0.1893,0.1893) 1.117420e+00
+-0.69 (0.1893,0.1893) 1.053757e+00
+-0.17 (0.4231,0.4231) 1.065499e+00
+-0.83 (0.4231,0.4231) 1.083873e+00
+-0.17 (0.1269,0.1269) 1.090376e+00
+-0.83 (0.1269,0.1269) 9.846264e-01
+-0.06 (0.4721,0.4721) 1.023659e+00
+-0.94 (0.4721,0.4721) 1.078080e+00
+-0.06 (0.0779,0.0779) 1.040222e+00
+-0.94 (0.0779,0.0779) 9.253060e-01
+-0.00 (0.4996,0.4996) 1.000327e+00
+-1.00 (0.4996,0.4996) 1.076389e+00
+-0.00 (0.0504,0.0504) 1.000621e+00
+-1.00 (0.0504,0.0504) 8.919976e-01
+-0.01 (0.4211,0.4211) 1.004501e+00
+-0.99 (0.4211,0.4211) 1.048505e+00
+-0.01 (0.1289,0.1289) 1.006756e+00
+-0.99 (0.1289,0.1289) 9.265668e-01
+-0.18 (0.4953,0.4953) 1.059744e+00
+-0.82 (0.4953,0.4953) 1.102412e+00
+-0.18 (0.0547,0.0547) 1.096931e+00
+-0.82 (0.0547,0.0547) 9.609165e-01
+-0.06 (0.3556,0.3556) 1.029420e+00
+-0.94 (0.3556,0.3556) 1.035979e+00
+-0.06 (0.1944,0.1944) 1.036358e+00
+-0.94 (0.1944,0.1944) 9.716078e-01
+-0.32 (0.4714,0.4714) 1.098326e+00
+-0.68 (0.4714,0.4714) 1.114321e+00
+-0.32 (0.0786,0.0786) 1.119705e+00
+-0.68 (0.0786,0.0786) 1.026622e+00
+-0.22 (0.3217,0.3217) 1.089434e+00
+-0.78 (0.3217,0.3217) 1.064834e+00
+-0.22 (0.2283,0.2283) 1.097455e+00
+-0.78 (0.2283,0.2283) 1.035502e+00
+-0.40 (0.4025,0.4025) 1.115504e+00
+-0.60 (0.4025,0.4025) 1.114037e+00
+-0.40 (0.1475,0.1475) 1.117155e+00
+-0.60 (0.1475,0.1475) 1.071006e+00
+0.50 (0.2750,0.2750) 7.540251e-01
+0.37 (0.2750,0.2750) 8.141253e-01
+0.63 (0.2750,0.2750) 7.001900e-01
+0.15 (0.2750,0.2750) 9.303654e-01
+0.85 (0.2750,0.2750) 6.188773e-01
+0.50 (0.2184,0.2184) 7.366342e-01
+0.50 (0.3316,0.3316) 7.720312e-01
+0.50 (0.1172,0.1172) 7.070999e-01
+0.50 (0.4328,0.4328) 8.056610e-01
+0.98 (0.2750,0.2750) 5.796986e-01
+0.02 (0.2750,0.2750) 9.914424e-01
+0.50 (0.4908,0.4908) 8.256918e-01
+0.50 (0.0592,0.0592) 6.910433e-01
+1.00 (0.2750,0.2750) 5.745330e-01
+0.00 (0.2750,0.2750) 9.990985e-01
+0.50 (0.4990,0.4990) 8.285678e-01
+0.50 (0.0510,0.0510) 6.888187e-01
+0.75 (0.2750,0.2750) 6.531002e-01
+0.25 (0.2750,0.2750) 8.780532e-01
+0.50 (0.3875,0.3875) 7.903772e-01
+0.50 (0.1625,0.1625) 7.200856e-01
+0.58 (0.3109,0.3109) 7.314241e-01
+0.42 (0.3109,0.3109) 8.015622e-01
+0.58 (0.2391,0.2391) 7.072724e-01
+0.42 (0.2391,0.2391) 7.814225e-01
+0.69 (0.3607,0.3607) 7.071021e-01
+0.31 (0.3607,0.3607) 8.660389e-01
+0.69 (0.1893,0.1893) 6.453102e-01
+0.31 (0.1893,0.1893) 8.282464e-01
+0.83 (0.4231,0.4231) 6.867632e-01
+0.17 (0.4231,0.4231) 9.371210e-01
+0.83 (0.1269,0.1269) 5.743297e-01
+0.17 (0.1269,0.1269) 9.012098e-01
+0.94 (0.4721,0.4721) 6.778046e-01
+0.06 (0.4721,0.4721) 9.806432e-01
+0.94 (0.0779,0.0779) 5.245393e-01
+0.06 (0.0779,0.0779) 9.651128e-01
+1.00 (0.4996,0.4996) 6.753024e-01
+0.00 (0.4996,0.4996) 9.997520e-01
+1.00 (0.0504,0.0504) 4.990137e-01
+0.00 (0.0504,0.0504) 9.995290e-01
+0.99 (0.4211,0.4211) 6.390543e-01
+0.01 (0.4211,0.4211) 9.965424e-01
+0.99 (0.1289,0.1289) 5.255341e-01
+0.01 (0.1289,0.1289) 9.947726e-01
+0.82 (0.4953,0.4953) 7.215719e-01
+0.18 (0.4953,0.4953) 9.440576e-01
+0.82 (0.0547,0.0547) 5.536172e-01
+0.18 (0.0547,0.0547) 8.892283e-01
+0.94 (0.3556,0.3556) 6.248944e-01
+0.06 (0.3556,0.3556) 9.754489e-01
+0.94 (0.1944,0.1944) 5.628020e-01
+0.06 (0.1944,0.1944) 9.689041e-01
+0.68 (0.4714,0.4714) 7.562107e-01
+0.32 (0.4714,0.4714) 8.864581e-01
+0.68 (0.0786,0.0786) 6.148977e-01
+0.32 (0.0786,0.0786) 7.974925e-01
+0.78 (0.3217,0.3217) 6.592814e-01
+0.22 (0.3217,0.3217) 9.028126e-01
+0.78 (0.2283,0.2283) 6.243733e-01
+0.22 (0.2283,0.2283) 8.881995e-01
+0.60 (0.4025,0.4025) 7.550741e-01
+0.40 (0.4025,0.4025) 8.383065e-01
+0.60 (0.1475,0.1475) 6.676220e-01
+0.40 (0.1475,0.1475) 7.697712e-01
+0.00 (0.5000,0.5000) 1.000000e+00
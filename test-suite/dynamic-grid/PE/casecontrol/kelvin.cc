@@ -0,0 +1,31 @@
+26/10/17 12:40:49 @0s, Initializing
+26/10/17 12:40:49 kelvin V2.8.0 edit  built Oct 17 2026 12:23:13 on (null)
+26/10/17 12:40:49 Reference for this version of kelvin:
+
+	Vieland VJ, Huang Y, Seok S-C, Burian J, Catalyurek U, O'Connell J,
+	Segre A, Valentine-Cooper W. Kelvin: A software package for rigorous
+	measurement of statistical evidence in human genetics. Hum Hered
+	72(4):276-288, 2011.
+
+26/10/17 12:40:49 Compiler 12.2.0
+26/10/17 12:40:49 Using internal statistical functions instead of GNU Scientific Library (GSL)
+26/10/17 12:40:49 GCC optimization level 2 enabled
+26/10/17 12:40:49 To check status (at some risk), type CTRL-\ or type "kill -3 16552"
+26/10/17 12:40:49 Using configuration file kelvin.conf
+26/10/17 12:40:49 Computation is done in polynomial mode
+26/10/17 12:40:49 polynomialScale is 1 (1-10, 1 is default)
+26/10/17 12:40:49 Integration is done numerically (dkelvin)
+26/10/17 12:40:49 Trait type is dichotomous
+26/10/17 12:40:49 Further progress will be displayed at 120 second intervals
+26/10/17 12:40:49 67D' cases over a dynamic space (1LC) for 100 pedigree(s)
+26/10/17 12:40:49 Trait-to-marker Two-Point, Dichotomous Trait, Disequilibrium.
+26/10/17 12:40:49 @0s, Performing analysis
+total_dim=7 after theta and/or dprime
+26/10/17 12:40:52 @3s, Analysis complete
+26/10/17 12:40:52 stopwatch overall(1) e:3s u:2s s:0s, vx:1, ivx:1287, sf:141682, hf:0
+26/10/17 12:40:52 @3s, Finished run
+26/10/17 12:40:52 Cleaning-up for exit
+
+real	0m3.156s
+user	0m2.825s
+sys	0m0.274s
@@ -0,0 +1,13 @@
+# Version V2.8.0 edit 
+# Seq: 1 Chr: 40 Trait: Trait Marker: M17 Position: 18.0000
+MOD D11 Theta(M,F) Alpha DGF LC1PV(DD,Dd,dd)
+0.5588 1.00 (0.0000,0.0000) 0.23 0.5000 (0.978,0.956,0.478)
+# Seq: 2 Chr: 40 Trait: Trait Marker: M18 Position: 19.0000
+MOD D11 Theta(M,F) Alpha DGF LC1PV(DD,Dd,dd)
+0.6682 -1.00 (0.0000,0.0000) 0.95 0.5000 (0.500,0.489,0.145)
+# Seq: 3 Chr: 40 Trait: Trait Marker: M19 Position: 20.0000
+MOD D11 Theta(M,F) Alpha DGF LC1PV(DD,Dd,dd)
+0.3885 -1.00 (0.0000,0.0000) 0.50 0.5000 (0.978,0.489,0.478)
+# Seq: 4 Chr: 40 Trait: Trait Marker: M20 Position: 21.0000
+MOD D11 Theta(M,F) Alpha DGF LC1PV(DD,Dd,dd)
+0.2341 -0.37 (0.2750,0.2750) 0.77 0.0220 (0.022,0.011,0.000)
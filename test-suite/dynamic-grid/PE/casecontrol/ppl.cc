@@ -0,0 +1,6 @@
+# Version V2.8.0 edit 
+Chr Trait Marker Position PPL PPL(LD) PPLD|L PPLD(L)
+40 Trait M17 18.0000 0.020 0.0199 0.0174 0.0003
+40 Trait M18 19.0000 0.020 0.0200 0.0199 0.0004
+40 Trait M19 20.0000 0.020 0.0200 0.0188 0.0004
+40 Trait M20 21.0000 0.020 0.0199 0.0175 0.0003
@@ -89,6 +89,11 @@
   the stopwatch has to be turned on and off with each evaluation, and
   there can be millions of evaluations.
 
+  - NO_POLY_INCREMENTAL - evaluate every entry of a tape on every
+  evaluation. Normally tapes note which of their variables each entry
+  depends upon, and only entries depending upon variables whose values
+  have changed since the last evaluation are evaluated again.
+
   - DEPENDENCYFLAGGING - define this to enable pre-evaluatePoly dumps
   of the percentage of polynomial nodes that reference each of the
   variables (up to 64) used. This was the starting point for an idea
@@ -101,6 +106,8 @@
   the more of the tree covered by the variables. It was anywhere from
   85 to 99%, so they payoff just wasn't there. Try turning this on if
   you have a different application and see if it is worth finishing.
+  Tapes now do this for themselves (see NO_POLY_INCREMENTAL), where the
+  test is cheap enough to be worthwhile even with that much coverage.
 
   - USE_GMP - define this to enable validation of polynomial double
   arithmetic. 192-bit mantissa arithmetic will be performed in parallel
@@ -119,7 +126,8 @@
   code until such time as precision questions arise again.
 
   - USE_SSD - use the sSDHandler.c routines to allow data structures to
-  significantly exceed physical memory.
+  significantly exceed physical memory. Large sum term lists move to a
+  memory-mapped file, and are used in place there (see importTermList).
 
   - POLYUSE_DL - look for, load and use dynamic libraries built earlier
   for the named polynomials in this run.
@@ -133,6 +141,32 @@
   - POLYCHECK_DL - internal polynomials will be build whether compiled ones
   exist or not, and internal vs compiled results will be compared.
 
+  - NO_POLY_SIMD - don't use the AVX2/AVX-512 sum and product kernels for
+  tape evaluation even when the processor supports them. They are only
+  built for x86-64 with GCC-compatible compilers in any case.
+
+  - NO_POLY_THREADED - dispatch tape operations with a switch instead
+  of the threaded code runPolyTape normally uses with GCC-compatible
+  compilers. Only useful for comparing the two.
+
+  - NO_POLY_ARENA - malloc every Polynomial, sumPoly, productPoly and
+  term list individually instead of taking them from slab arenas (see
+  polyArenaAlloc). Useful with memory debuggers, which can't tell one
+  structure in a slab from the next. Terms are then referenced by
+  pointer rather than by 32-bit handle (see polyHandle).
+
+  - NO_POLY_CONCURRENT_BUILD - construct pedigrees' likelihood polynomials
+  one at a time even when OpenMP provides several threads (see
+  beginConcurrentPolyBuild). Implied without OpenMP, and by USE_SSD,
+  SOURCEDIGRAPH, POLYSTATISTICS, STUDYDB and the DL conditionals, which
+  all expect only one thread to be building.
+
+  - NO_POLY_TAPE - don't compile sorted evaluation lists into flat tapes
+  (see buildPolyTape), but evaluate them node-by-node as was done
+  originally. Implied by USE_GMP, which needs the per-node mpfValues, and
+  by USE_SSD, since a tape would pull every offline term list back into
+  memory.
+
 
   ENVIRONMENT VARIABLES:
 
@@ -167,6 +201,11 @@
 #include <time.h>
 #include <signal.h>
 #include <float.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 
 #include <dlfcn.h>
 
@@ -204,6 +243,11 @@
 #include "sSDHandler.h"
 #endif
 
+#if defined (__GNUC__) && defined (__x86_64__) && !defined (NO_POLY_SIMD)
+  #define POLY_SIMD
+  #include <immintrin.h>
+#endif
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -351,6 +395,9 @@ long evaluatePolyCount = 0, evaluateValueCount = 0;
 int containerExpansions = 0;    ///< Count of expansions of any term-collection container.
 unsigned long totalSPLLengths = 0, totalSPLCalls = 0, lowSPLCount = 0, highSPLCount = 0;
 unsigned long initialHashSize = 0;      ///< Total initial size of hash table and collision lists
+unsigned int polyEvalEpoch = 1;        ///< Polynomials stamped with this are valid for the current traversal
+unsigned long polyTapeMemory = 0;       ///< Total size of all current evaluation tapes
+int polyListSerial = 0;                 ///< Last serial number given to a sorted evaluation list
 int pendingExplicitDiscards = 0; ///< Number of first-term explicit discards awaiting removal
 /*@}*/
 
@@ -424,6 +471,264 @@ static struct hashStruct *sumHash;     //...for sum polynomials
 static struct hashStruct *productHash; //...for the product polynomials
 static struct hashStruct *functionCallHash;    //...for the functionCall polynomials
 
+// Generations of each type's list (see collectPolyGeneration)
+struct polyGeneration
+{
+  int held;			// list positions before this survived a freeKeptPolys
+  int kept;			// list positions before this survived a freePolys or freeKeptPolys
+};
+static struct polyGeneration constantGeneration, sumGeneration, productGeneration;
+#ifdef VARIABLE_C_MESSES_UP_COMPILED_DL_ARGUMENTS
+static struct polyGeneration variableGeneration;
+#endif
+static int heldPolysReleased = FALSE;	// an unHoldPoly since the last freeKeptPolys
+
+/**
+
+  Concurrent construction. Between beginConcurrentPolyBuild and
+  endConcurrentPolyBuild, any number of threads can construct polynomials
+  at once, e.g. each peeling its own pedigree, and still share identical
+  subterms. The term collection containers above are per-thread, and
+  everything they share is locked:
+
+  - each hash bucket is covered by one of POLY_HASH_STRIPES locks, held
+  from the search for an existing polynomial until a new one has been
+  entered, so the same polynomial is never built twice,
+  - each thread lists its new polynomials in blocks of list positions
+  and nodeIds of its own (see listConcurrentPoly), taking polyListLock
+  only to reserve another block,
+  - each thread carves structures from slabs of its own (see
+  ownPolyArenaAlloc), taking the arena's lock only to get another slab,
+  and
+  - flags of existing polynomials and the statistics counters are
+  changed atomically.
+
+  Lists and slab tables that must grow are copied rather than realloc'd,
+  and the old copies retired until the end of the build, since other
+  threads may still be reading them without a lock. Replacing the first
+  term in-place, explicit discards, keeps and frees are all skipped while
+  building concurrently, as a polynomial that looks unreferenced to one
+  thread may just have been found by another. The caller frees whatever
+  is left over once all threads are done. endConcurrentPolyBuild then
+  merges the blocks into the lists and the slabs back into their arenas.
+
+  Outside of a concurrent build none of the locks are taken.
+
+*/
+#ifndef NO_POLY_CONCURRENT_BUILD
+#pragma omp threadprivate (factor_v1, p_v1, containerLength_v1, counter_v1, factor_p1, p_p1, containerLength_p1, \
+			   counter_p1, factor_f1, p_f1, containerLength_f1, counter_f1, factorSum, pSum, lengthSum, \
+			   exponent_v2, p_v2, containerLength_v2, counter_v2, exponent_s2, p_s2, containerLength_s2, \
+			   counter_s2, exponent_f2, p_f2, containerLength_f2, counter_f2, exponentProd, pProd, lengthProd)
+
+#define POLY_HASH_STRIPES 4096
+static omp_lock_t polyHashStripes[POLY_HASH_STRIPES];
+static omp_lock_t polyListLock;
+static int polyConcurrentBuild = FALSE;	///< TRUE while several threads may be constructing
+static int polyBuildSerial = 0;	///< Distinct for every concurrent build
+static void **retiredPolyTables;	///< Copied lists and slab tables to free after the build
+static int retiredPolyTableCount = 0, retiredPolyTableLength = 0;
+
+#define POLY_CONCURRENT polyConcurrentBuild
+#define POLY_STRIPE(eType, hIndex) (&polyHashStripes[((hIndex) * 8 + (eType)) & (POLY_HASH_STRIPES - 1)])
+#define LOCK_POLY_HASH(eType, hIndex) do { if (polyConcurrentBuild) omp_set_lock (POLY_STRIPE (eType, hIndex)); } while (0)
+#define UNLOCK_POLY_HASH(eType, hIndex) do { if (polyConcurrentBuild) omp_unset_lock (POLY_STRIPE (eType, hIndex)); } while (0)
+#define SET_POLY_VALID(p, flags) do {					\
+    unsigned char *valid_ = &(p)->valid;				\
+    if (polyConcurrentBuild) {						\
+      _Pragma ("omp atomic")						\
+	*valid_ |= (flags);						\
+    } else								\
+      *valid_ |= (flags);						\
+  } while (0)
+#define CLEAR_POLY_VALID(p, flags) do {					\
+    unsigned char *valid_ = &(p)->valid;				\
+    if (polyConcurrentBuild) {						\
+      _Pragma ("omp atomic")						\
+	*valid_ &= ~(flags);						\
+    } else								\
+      *valid_ &= ~(flags);						\
+  } while (0)
+#define ADD_POLY_STAT(counter, n) do {					\
+    if (polyConcurrentBuild) {						\
+      _Pragma ("omp atomic")						\
+	(counter) += (n);						\
+    } else								\
+      (counter) += (n);							\
+  } while (0)
+#else
+#define POLY_CONCURRENT FALSE
+#define LOCK_POLY_HASH(eType, hIndex)
+#define UNLOCK_POLY_HASH(eType, hIndex)
+#define LISTED_POLY(eType, list, index) ((list)[index])
+#define listConcurrentPoly(p)
+#define SET_POLY_VALID(p, flags) ((p)->valid |= (flags))
+#define CLEAR_POLY_VALID(p, flags) ((p)->valid &= ~(flags))
+#define ADD_POLY_STAT(counter, n) ((counter) += (n))
+#endif
+#define COUNT_POLY_STAT(counter) ADD_POLY_STAT (counter, 1)
+
+/// Count a raw term for progress reporting, and return the new count
+static inline long countPolyTerm ()
+{
+  long count;
+
+#ifndef NO_POLY_CONCURRENT_BUILD
+  if (polyConcurrentBuild) {
+#pragma omp atomic capture
+    count = ++termCount;
+    return count;
+  }
+#endif
+  count = ++termCount;
+  return count;
+}
+
+/// Grow a list or table that other threads might be reading, retiring the old copy if they might
+static void *growPolyTable (void *table, size_t oldBytes, size_t newBytes)
+{
+#ifndef NO_POLY_CONCURRENT_BUILD
+  void *newTable;
+
+  if (polyConcurrentBuild) {
+    MALCHOKE(newTable, newBytes, void *);
+    memcpy (newTable, table, oldBytes);
+#pragma omp critical (retirePolyTable)
+    {
+      if (retiredPolyTableCount == retiredPolyTableLength) {
+	retiredPolyTableLength += 64;
+	REALCHOKE(retiredPolyTables, retiredPolyTableLength * sizeof (void *), void **);
+      }
+      retiredPolyTables[retiredPolyTableCount++] = table;
+    }
+    return newTable;
+  }
+#endif
+  REALCHOKE(table, newBytes, void *);
+  return table;
+}
+
+#ifndef NO_POLY_CONCURRENT_BUILD
+/**
+
+  Polynomials listed during a concurrent build. Rather than append every
+  new polynomial to its list under polyListLock, each thread reserves
+  POLY_LIST_BLOCK list positions and nodeIds at a time and fills them in
+  by itself. The lists aren't touched until endConcurrentPolyBuild, so
+  until then polynomials at positions past a list's count are found thru
+  its block table instead (see LISTED_POLY). Positions reserved but never
+  filled are taken up at the end of the build by polynomials moved down
+  from the end of the list.
+
+*/
+#define POLY_LIST_BLOCK 1024
+
+struct polyListBlocks
+{
+  int base;			// list count when the build began
+  int count;			// number of blocks reserved
+  int limit;			// length of the block table
+  Polynomial ***block;		// polynomials of each block, NULL where unfilled
+};
+
+struct ownListBlock
+{
+  int build;			// polyBuildSerial of the build it was reserved in
+  Polynomial **block;		// polynomials of the block
+  int next, end;		// next list position to fill and end of the block
+};
+
+static struct polyListBlocks listBlocks[T_FUNCTIONCALL + 1];
+static struct ownListBlock ownListBlocks[T_FUNCTIONCALL + 1];	///< The thread's block of each list
+static int ownNodeIdBuild;	///< polyBuildSerial of the thread's block of nodeIds
+static long ownNodeId, ownNodeIdEnd;	///< and the next and end of the block
+#pragma omp threadprivate (ownListBlocks, ownNodeIdBuild, ownNodeId, ownNodeIdEnd)
+
+/// The polynomial at a list position, even if only just listed by a concurrent build
+#define LISTED_POLY(eType, list, index)					\
+  (polyConcurrentBuild && (index) >= listBlocks[eType].base ?		\
+   listBlocks[eType].block[((index) - listBlocks[eType].base) / POLY_LIST_BLOCK] \
+   [((index) - listBlocks[eType].base) % POLY_LIST_BLOCK] : (list)[index])
+
+/// Give a polynomial built concurrently a list position and nodeId from the thread's own blocks
+static void listConcurrentPoly (Polynomial *p)
+{
+  struct polyListBlocks *b = &listBlocks[p->eType];
+  struct ownListBlock *o = &ownListBlocks[p->eType];
+
+  if (o->build != polyBuildSerial || o->next == o->end) {
+    CALCHOKE(o->block, sizeof (Polynomial *), POLY_LIST_BLOCK, Polynomial **);
+    omp_set_lock (&polyListLock);
+    if (b->count == b->limit) {
+      b->limit += 64;
+      b->block = growPolyTable (b->block, sizeof (Polynomial **) * b->count, sizeof (Polynomial **) * b->limit);
+    }
+    b->block[b->count] = o->block;
+    o->next = b->base + b->count * POLY_LIST_BLOCK;
+    b->count++;
+    omp_unset_lock (&polyListLock);
+    o->end = o->next + POLY_LIST_BLOCK;
+    o->build = polyBuildSerial;
+  }
+  if (ownNodeIdBuild != polyBuildSerial || ownNodeId == ownNodeIdEnd) {
+#pragma omp atomic capture
+    {
+      ownNodeId = nodeId;
+      nodeId += POLY_LIST_BLOCK;
+    }
+    ownNodeIdEnd = ownNodeId + POLY_LIST_BLOCK;
+    ownNodeIdBuild = polyBuildSerial;
+  }
+  o->block[(o->next - b->base) % POLY_LIST_BLOCK] = p;
+  p->index = o->next++;
+  p->id = ownNodeId++;
+}
+
+/// Copy the blocks of a list into it at the end of a concurrent build, closing up the unfilled positions
+static void mergeListBlocks (int eType, Polynomial ***list, int *count, int *length, int increase,
+			     int *expansions, struct hashStruct *hash, int hashSize)
+{
+  struct polyListBlocks *b = &listBlocks[eType];
+  struct hashStruct *h;
+  Polynomial *p;
+  int i, j, top;
+
+  if (b->count == 0)
+    return;
+  top = b->base + b->count * POLY_LIST_BLOCK;
+  if (top > *length) {
+    while (*length < top)
+      *length += increase;
+    (*expansions)++;
+    REALCHOKE(*list, *length * sizeof (Polynomial *), Polynomial **);
+  }
+  for (i = 0; i < b->count; i++) {
+    memcpy (&(*list)[b->base + i * POLY_LIST_BLOCK], b->block[i], sizeof (Polynomial *) * POLY_LIST_BLOCK);
+    free (b->block[i]);
+  }
+  b->count = 0;
+
+  // Move polynomials down from the end into the gaps, and tell the hash table where they went
+  for (i = b->base;; i++) {
+    while (top > b->base && (*list)[top - 1] == NULL)
+      top--;
+    while (i < top && (*list)[i] != NULL)
+      i++;
+    if (i >= top)
+      break;
+    p = (*list)[--top];
+    h = &hash[(p->key % hashSize + hashSize) % hashSize];
+    for (j = 0; j < h->num && h->index[j] != p->index; j++);
+    if (j == h->num)
+      FATAL ("Polynomial %d is not in the hash table of type %d", p->id, eType);
+    h->index[j] = i;
+    p->index = i;
+    (*list)[i] = p;
+  }
+  *count = top;
+}
+#endif
+
 #ifdef SOURCEDIGRAPH
 struct polySource
 {
@@ -443,19 +748,397 @@ static int originalChildren[MAXPOLYSOURCES];
 #ifdef USE_SSD
 static int importedTerms = 0, exportedDroppedTerms = 0, exportedWrittenTerms = 0, peakInMemoryTerms = 0;
 static long sSDDebt = 0; // When <= 0, we're OK, if not, must pay-off allocation debt with freeSSD calls
-#define MAX_SSD_BUFFER ((MAX_DPC_MASK+1)*2)
 
-#define IMTL_COUNT 32
+/* Term lists on the SSD that are in use (pinned) or were used recently
+   (warm) have an entry here, and their sumPoly's iMTLIndex says which.
+   Warm entries are on an LRU list, and once there are more than
+   WARM_TERM_DPS double pairs of them, the least recently used are
+   cooled (see coolSSD) and forgotten. */
+#define WARM_TERM_DPS (32UL * (MAX_DPC_MASK+1))
 struct inMemoryTermList {
-  unsigned int lastNodeId; // This will enable recycling without retrieval
+  struct sumPoly *sP; // Whose term list this is
   struct chunkTicket cT;
-  double buffer[MAX_SSD_BUFFER];
+  int pinned; // TRUE while imported, otherwise warm
+  int prev, next; // LRU links while warm, next free entry while unused
 };
-static struct inMemoryTermList  iMTL[IMTL_COUNT];
+static struct inMemoryTermList *iMTL = NULL;
+static int iMTLSize = 0, iMTLFree = -1, iMTLWarmest = -1, iMTLCoolest = -1;
+static unsigned long warmTermDPs = 0;
+/* How many cold term lists evaluatePoly keeps being read ahead of it */
+#define PREFETCH_TERM_LISTS 8
+static int prefetchNextTermList (struct polyList *l, int from);
 #endif
 
 
 
+/**
+
+  Slab arenas for polynomial storage. Builds create hundreds of millions
+  of small structures of just a few sizes -- Polynomials, sumPolys,
+  productPolys and their term lists -- and doFreePolys frees most of them
+  again. Individually malloc'd, each carries allocator overhead, and the
+  survivors end up scattered over a fragmented heap. Instead, each kind
+  of structure comes from its own arena of large slabs, and short term
+  lists come from arenas of size classes, with only longer lists left to
+  malloc.
+
+  Slabs are aligned on their own size, so a structure's slab is found
+  from its address. A slab counts the structures it has handed out and
+  keeps a free list of those released, and slabs with room are on their
+  arena's available list. At the end of each doFreePolys pass, every slab
+  that no longer holds anything is given back to the system in one go.
+
+  No arena is shared by polynomials of different types, so the sections
+  of doFreePolys can release their own types in parallel without locking.
+  Concurrent construction (see POLY_CONCURRENT) gives each thread a slab
+  of its own in every arena it allocates from, and only locks the arena
+  to get another.
+  Sum term lists stay with malloc under USE_SSD, which moves them in and
+  out of memory itself.
+
+*/
+struct polySlab
+{
+  struct polySlab *next;	// next slab of the arena
+  struct polySlab *nextAvailable;	// next slab with room, if available
+  void *freeList;		// structures released back to this slab
+  char *unused;			// start of space never yet handed out
+  int inUse;			// structures handed out and not released
+  int available;		// TRUE if on the arena's available list
+  int number;			// index in the arena's slab table, if it has one
+  unsigned int handleBase;	// handle of the slab's first structure, if the arena has handles
+};
+
+struct polyArena
+{
+  size_t size;			// bytes per structure
+  struct polySlab *slabs;	// all slabs of the arena
+  struct polySlab *available;	// slabs with room
+  int slabCount;		// number of slabs
+  unsigned long inUse;		// structures handed out and not released
+  int handles;			// TRUE if structures are referenced by handles
+  unsigned int handleType;	// top bits of handles to structures of this arena
+  struct polySlab **slab;	// slab table for handles, NULL where released
+  int slabLimit;		// length of the slab table
+  int slabHint;			// no released slab table entries before this
+#ifndef NO_POLY_CONCURRENT_BUILD
+  int number;			// index of the thread's own slab in ownPolySlab
+  omp_lock_t lock;		// held while building concurrently
+#endif
+};
+
+/* Term lists of up to this many doubles or pointers come from arenas */
+#define POLY_TERM_CLASSES 16
+#define POLY_TERM_CLASS(bytes) ((bytes) == 0 ? 0 : ((bytes) - 1) / sizeof (double))
+/* Smallest slab, scaled-up by polynomialScale to the next power of 2 */
+#define MIN_POLY_SLAB_SIZE (64 * 1024)
+#define POLY_SLAB_HEADER ((sizeof (struct polySlab) + 15) & ~((size_t) 15))
+#define POLY_SLAB_OF(p) ((struct polySlab *) ((uintptr_t) (p) & ~((uintptr_t) polySlabSize - 1)))
+
+static size_t polySlabSize = MIN_POLY_SLAB_SIZE;
+static struct polyArena constantArena, variableArena, sumArena, sumPolyArena, productArena, productPolyArena,
+  functionCallArena, externalArena;
+static struct polyArena sumTermArena[POLY_TERM_CLASSES], productTermArena[POLY_TERM_CLASSES];
+#ifndef USE_SSD
+#define SUM_TERM_ARENA sumTermArena
+#else
+#define SUM_TERM_ARENA NULL
+#endif
+
+/* A handle is the node arena's eType in the top bits, then slab number
+   and slot in the slab. There are enough slab bits to handle at least
+   16Gb of polynomials of each type. */
+#define POLY_HANDLE_INDEX_BITS 29
+#define POLY_HANDLE_INDEX_MASK ((1U << POLY_HANDLE_INDEX_BITS) - 1)
+static struct polyArena *handleArena[] = {&constantArena, &variableArena, &sumArena, &productArena,
+  &functionCallArena, &externalArena};
+static int polyHandleSlotBits;	// bits of a handle for the slot in a slab
+
+#ifndef NO_POLY_CONCURRENT_BUILD
+/* The node and term arenas */
+#define POLY_ARENAS (8 + 2 * POLY_TERM_CLASSES)
+static struct polyArena *allPolyArenas[POLY_ARENAS];
+static struct polySlab *ownPolySlab[POLY_ARENAS];	///< The thread's slab in each arena
+static int ownPolySlabBuild;	///< polyBuildSerial of the build they're from
+#pragma omp threadprivate (ownPolySlab, ownPolySlabBuild)
+#endif
+
+/// Enter a new slab in its arena's slab table, and work out its handles
+static void numberPolySlab (struct polyArena *a, struct polySlab *s)
+{
+  while (a->slabHint < a->slabLimit && a->slab[a->slabHint] != NULL)
+    a->slabHint++;
+  if (a->slabHint == a->slabLimit) {
+    if ((unsigned int) a->slabLimit << polyHandleSlotBits >= 1U << POLY_HANDLE_INDEX_BITS)
+      FATAL ("Exhausted handles for polynomials of type %d", a->handleType);
+    a->slabLimit += 1024;
+    a->slab = growPolyTable (a->slab, sizeof (struct polySlab *) * a->slabHint, sizeof (struct polySlab *) * a->slabLimit);
+    memset (&a->slab[a->slabHint], 0, sizeof (struct polySlab *) * (a->slabLimit - a->slabHint));
+  }
+  s->number = a->slabHint;
+  s->handleBase = (a->handleType << POLY_HANDLE_INDEX_BITS) | (s->number << polyHandleSlotBits);
+  a->slab[s->number] = s;
+}
+
+/// Add a new slab to an arena's available list
+static struct polySlab *newPolySlab (struct polyArena *a)
+{
+  struct polySlab *s;
+
+  if (posix_memalign ((void **) &s, polySlabSize, polySlabSize) != 0)
+    FATAL ("Allocation of a %lu byte polynomial slab failed!", (unsigned long) polySlabSize);
+  s->next = a->slabs;
+  a->slabs = s;
+  s->nextAvailable = NULL;
+  s->freeList = NULL;
+  s->unused = (char *) s + POLY_SLAB_HEADER;
+  s->inUse = 0;
+  s->available = TRUE;
+  a->available = s;
+  a->slabCount++;
+  if (a->handles)
+    numberPolySlab (a, s);
+  return s;
+}
+
+/// TRUE if a slab can hand out another structure
+#define POLY_SLAB_ROOM(a, s) ((s)->freeList != NULL || (s)->unused + (a)->size <= (char *) (s) + polySlabSize)
+
+#ifndef NO_POLY_CONCURRENT_BUILD
+/**
+
+  Hand out a structure from the thread's own slab of an arena during a
+  concurrent build. The slab is taken off the available list, so no
+  other thread touches it, and nothing is released to it until the build
+  is over, so the arena is only locked to take another once it's full.
+  The arena's inUse count is caught up by settlePolyArena.
+
+*/
+static void *ownPolyArenaAlloc (struct polyArena *a)
+{
+  struct polySlab *s;
+  void *p;
+
+  if (ownPolySlabBuild != polyBuildSerial) {
+    memset (ownPolySlab, 0, sizeof (ownPolySlab));
+    ownPolySlabBuild = polyBuildSerial;
+  }
+  if ((s = ownPolySlab[a->number]) == NULL || !POLY_SLAB_ROOM (a, s)) {
+    omp_set_lock (&a->lock);
+    if ((s = a->available) == NULL)
+      s = newPolySlab (a);
+    a->available = s->nextAvailable;
+    s->available = FALSE;
+    omp_unset_lock (&a->lock);
+    ownPolySlab[a->number] = s;
+  }
+  if ((p = s->freeList) != NULL)
+    s->freeList = *(void **) p;
+  else {
+    p = s->unused;
+    s->unused += a->size;
+  }
+  s->inUse++;
+  return p;
+}
+
+/// Put the slabs threads had to themselves back on their arena's available list, and recount its structures
+static void settlePolyArena (struct polyArena *a)
+{
+  struct polySlab *s;
+
+  a->available = NULL;
+  a->inUse = 0;
+  for (s = a->slabs; s != NULL; s = s->next) {
+    a->inUse += s->inUse;
+    if ((s->available = POLY_SLAB_ROOM (a, s))) {
+      s->nextAvailable = a->available;
+      a->available = s;
+    }
+  }
+}
+#endif
+
+/// Hand out a structure from an arena, starting a new slab if none have room
+static void *polyArenaAlloc (struct polyArena *a)
+{
+  struct polySlab *s;
+  void *p;
+
+#ifdef NO_POLY_ARENA
+  MALCHOKE(p, a->size, void *);
+  return p;
+#endif
+#ifndef NO_POLY_CONCURRENT_BUILD
+  if (polyConcurrentBuild)
+    return ownPolyArenaAlloc (a);
+#endif
+  if ((s = a->available) == NULL)
+    s = newPolySlab (a);
+  if ((p = s->freeList) != NULL)
+    s->freeList = *(void **) p;
+  else {
+    p = s->unused;
+    s->unused += a->size;
+  }
+  s->inUse++;
+  a->inUse++;
+  // Take it off the available list once it is full
+  if (!POLY_SLAB_ROOM (a, s)) {
+    a->available = s->nextAvailable;
+    s->available = FALSE;
+  }
+  return p;
+}
+
+/// Release a structure back to its slab
+static void polyArenaFree (struct polyArena *a, void *p)
+{
+  struct polySlab *s;
+
+#ifdef NO_POLY_ARENA
+  free (p);
+  return;
+#endif
+#ifndef NO_POLY_CONCURRENT_BUILD
+  if (polyConcurrentBuild)
+    omp_set_lock (&a->lock);
+#endif
+  s = POLY_SLAB_OF (p);
+  *(void **) p = s->freeList;
+  s->freeList = p;
+  s->inUse--;
+  a->inUse--;
+  if (!s->available) {
+    s->nextAvailable = a->available;
+    a->available = s;
+    s->available = TRUE;
+  }
+#ifndef NO_POLY_CONCURRENT_BUILD
+  if (polyConcurrentBuild)
+    omp_unset_lock (&a->lock);
+#endif
+}
+
+/// Give the empty slabs of an arena back to the system
+static void releasePolyArenaSlabs (struct polyArena *a)
+{
+  struct polySlab **ps, *s;
+
+  a->available = NULL;
+  ps = &a->slabs;
+  while ((s = *ps) != NULL) {
+    if (s->inUse == 0) {
+      *ps = s->next;
+      if (a->handles) {
+	a->slab[s->number] = NULL;
+	if (s->number < a->slabHint)
+	  a->slabHint = s->number;
+      }
+      free (s);
+      a->slabCount--;
+      continue;
+    }
+    if (s->available) {
+      s->nextAvailable = a->available;
+      a->available = s;
+    }
+    ps = &s->next;
+  }
+}
+
+#ifndef NO_POLY_HANDLES
+/// The polynomial a handle refers to
+static inline Polynomial *handlePoly (polyHandle h)
+{
+  return (Polynomial *) ((char *) handleArena[h >> POLY_HANDLE_INDEX_BITS]->
+			 slab[(h & POLY_HANDLE_INDEX_MASK) >> polyHandleSlotBits] + POLY_SLAB_HEADER) +
+    (h & ((1U << polyHandleSlotBits) - 1));
+}
+
+/// The handle of a polynomial from a node arena
+static inline polyHandle polyHandleOf (Polynomial *p)
+{
+  struct polySlab *s = POLY_SLAB_OF (p);
+
+  return s->handleBase + (unsigned int) (p - (Polynomial *) ((char *) s + POLY_SLAB_HEADER));
+}
+
+#define POLY_TERM(h) handlePoly (h)
+#define POLY_HANDLE(p) polyHandleOf (p)
+#else
+#define POLY_TERM(h) (h)
+#define POLY_HANDLE(p) (p)
+#endif
+
+/// Term i of a sum, product or function call
+static inline Polynomial *polyTerm (Polynomial *p, int i)
+{
+  switch (p->eType) {
+  case T_SUM:
+    return POLY_TERM (p->e.s->sum[i]);
+  case T_PRODUCT:
+    return POLY_TERM (p->e.p->product[i]);
+  default:
+    return p->e.f->para[i];
+  }
+}
+
+/// Allocate a term list from the size class arenas, or with malloc if too long or there are none
+static inline void *polyTermAlloc (struct polyArena *classes, size_t bytes)
+{
+  void *p;
+
+  if (classes == NULL || POLY_TERM_CLASS (bytes) >= POLY_TERM_CLASSES) {
+    MALCHOKE(p, bytes, void *);
+    return p;
+  }
+  return polyArenaAlloc (&classes[POLY_TERM_CLASS (bytes)]);
+}
+
+/// Release a term list allocated by polyTermAlloc with the same classes and size
+static inline void polyTermFree (struct polyArena *classes, void *p, size_t bytes)
+{
+  if (classes == NULL || POLY_TERM_CLASS (bytes) >= POLY_TERM_CLASSES)
+    free (p);
+  else
+    polyArenaFree (&classes[POLY_TERM_CLASS (bytes)], p);
+}
+
+/// Give the empty slabs of the sum arenas back to the system
+static void releaseSumArenaSlabs ()
+{
+  int i;
+
+  releasePolyArenaSlabs (&sumArena);
+  releasePolyArenaSlabs (&sumPolyArena);
+  for (i = 0; i < POLY_TERM_CLASSES; i++)
+    releasePolyArenaSlabs (&sumTermArena[i]);
+}
+
+/// Give the empty slabs of the product arenas back to the system
+static void releaseProductArenaSlabs ()
+{
+  int i;
+
+  releasePolyArenaSlabs (&productArena);
+  releasePolyArenaSlabs (&productPolyArena);
+  for (i = 0; i < POLY_TERM_CLASSES; i++)
+    releasePolyArenaSlabs (&productTermArena[i]);
+}
+
+/// Bytes of slabs held by all arenas
+static double polyArenaMemory ()
+{
+  int i, slabs;
+
+  slabs = constantArena.slabCount + variableArena.slabCount + sumArena.slabCount + sumPolyArena.slabCount +
+    productArena.slabCount + productPolyArena.slabCount + functionCallArena.slabCount + externalArena.slabCount;
+  for (i = 0; i < POLY_TERM_CLASSES; i++)
+    slabs += sumTermArena[i].slabCount + productTermArena[i].slabCount;
+  return (double) slabs * polySlabSize;
+}
+
 /**
 
   This was used for determining polynomial size, but it could not
@@ -476,6 +1159,11 @@ Polynomial *polyReturnWrapper (Polynomial * p)
   Clear the evaluation flag on the entire tree so we can mark where
   we've been and not retrace our steps regardless of redundancy.
 
+  Polynomials are marked by stamping them with the current evaluation
+  epoch (see EVAL_VALID), so clearing is just a matter of starting a
+  new epoch. Only when the epoch counter wraps-around do we have to
+  visit every polynomial.
+
   This code has been adapted for parallel execution by breaking-up
   the iteration over constants, sums and products.
 
@@ -484,33 +1172,60 @@ void clearValidEvalFlag ()
 {
   int i;
 
+  if (++polyEvalEpoch != 0)
+    return;
+
+  /* The epoch has wrapped-around, so some polynomial could still be
+   stamped with the new one. Reset them all to start over. */
+  polyEvalEpoch = 1;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
   for (i = 0; i < constantCount; i++)
-    constantList[i]->valid &= ~VALID_EVAL_FLAG;
+    constantList[i]->evalEpoch = 0;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
   for (i = 0; i < variableCount; i++)
-    variableList[i]->valid &= ~VALID_EVAL_FLAG;
+    variableList[i]->evalEpoch = 0;
   for (i = 0; i < externalCount; i++)
-    externalList[i]->valid &= ~VALID_EVAL_FLAG;
+    externalList[i]->evalEpoch = 0;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
   for (i = 0; i < sumCount; i++)
-    sumList[i]->valid &= ~VALID_EVAL_FLAG;
+    sumList[i]->evalEpoch = 0;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
   for (i = 0; i < productCount; i++)
-    productList[i]->valid &= ~VALID_EVAL_FLAG;
+    productList[i]->evalEpoch = 0;
   for (i = 0; i < functionCallCount; i++)
-    functionCallList[i]->valid &= ~VALID_EVAL_FLAG;
+    functionCallList[i]->evalEpoch = 0;
   return;
 }
 
+/**
+
+  Raise to an integer power by repeated squaring, which is both faster
+  and more accurate than pow for the small exponents we see.
+
+*/
+static inline double integerPower (double x, int n)
+{
+  double result = 1;
+
+  if (n < 0)
+    return 1 / integerPower (x, -n);
+  while (n) {
+    if (n & 1)
+      result *= x;
+    x *= x;
+    n >>= 1;
+  }
+  return result;
+}
+
 /**
 
   Recursively evaluate a polynomial without the benefit of a
@@ -528,7 +1243,7 @@ double doEvaluateValue (Polynomial * p)
   struct functionPoly *fp;
   double value0, value1;
 
-  if (p->valid & VALID_EVAL_FLAG)
+  if (EVAL_VALID (p))
     return p->value;
 
   switch (p->eType) {
@@ -538,11 +1253,11 @@ double doEvaluateValue (Polynomial * p)
 
     // If a sub polynomial is a contant, return the value
   case T_CONSTANT:
-    p->valid |= VALID_EVAL_FLAG;
+    SET_EVAL_VALID (p);
     return p->value;
     // If a sub polynomial is a variable, return the value
   case T_VARIABLE:
-    p->valid |= VALID_EVAL_FLAG;
+    SET_EVAL_VALID (p);
     if (p->e.v->vType == 'D') {
       p->value = *(p->e.v->vAddr.vAddrD);
       return *(p->e.v->vAddr.vAddrD);
@@ -570,13 +1285,13 @@ double doEvaluateValue (Polynomial * p)
     sP = p->e.s;
     for (i = 0; i < sP->num; i++) {
       if (sP->factor[i] == 1)
-        result += doEvaluateValue (sP->sum[i]);
+        result += doEvaluateValue (POLY_TERM (sP->sum[i]));
       else
-        result += doEvaluateValue (sP->sum[i]) * sP->factor[i];
+        result += doEvaluateValue (POLY_TERM (sP->sum[i])) * sP->factor[i];
     }
     exportTermList(p, FALSE);
     p->value = result;
-    p->valid |= VALID_EVAL_FLAG;
+    SET_EVAL_VALID (p);
     return result;
 
     /* If a sub polynomial is a product, evaluate the values of all the terms.
@@ -589,15 +1304,15 @@ double doEvaluateValue (Polynomial * p)
       case 0:
         break;
       case 1:
-        result *= doEvaluateValue (pP->product[i]);
+        result *= doEvaluateValue (POLY_TERM (pP->product[i]));
         break;
       default:
-        result *= pow (doEvaluateValue (pP->product[i]), pP->exponent[i]);
+        result *= integerPower (doEvaluateValue (POLY_TERM (pP->product[i])), pP->exponent[i]);
         break;
       }
     }
     p->value = result;
-    p->valid |= VALID_EVAL_FLAG;
+    SET_EVAL_VALID (p);
     return result;
 
     /* If a sub polynomial is a function call, evaluate the values of all the parameters
@@ -673,7 +1388,7 @@ double doEvaluateValue (Polynomial * p)
     } else
       ERROR ("Unknown function name %s in polynomial\n", fp->name);
     p->value = result;
-    p->valid |= VALID_EVAL_FLAG;
+    SET_EVAL_VALID (p);
     return result;
 
   default:
@@ -704,7 +1419,7 @@ double evaluateValue (Polynomial * p)
   swStart (evaluateValueSW);
 #endif
 
-  /* Clear all of the VALID_EVAL_FLAGs */
+  /* Invalidate all evaluation marks by starting a new epoch */
   clearValidEvalFlag ();
 
   if (p->eType == T_OFFLINE) importPoly (p);
@@ -715,7 +1430,7 @@ double evaluateValue (Polynomial * p)
 #pragma omp parallel for
 #endif
     for (i = 0; i < p->e.s->num; i++) {
-      doEvaluateValue (p->e.s->sum[i]);
+      doEvaluateValue (POLY_TERM (p->e.s->sum[i]));
     }
   }
   returnValue = doEvaluateValue (p);
@@ -891,7 +1606,7 @@ Polynomial *constantExp (char *fileName, int lineNo, double con)
 #endif
 
 #ifdef POLYSTATISTICS
-  if ((termCount++ & 0x7FFFFF) == 0) ///< New term from an external standpoint.
+  if (((countPolyTerm () - 1) & 0x7FFFFF) == 0) ///< New term from an external standpoint.
     polyStatistics ("At 8M raw term multiple");
 #endif
 
@@ -903,6 +1618,7 @@ Polynomial *constantExp (char *fileName, int lineNo, double con)
   hIndex = key % CONSTANT_HASH_SIZE;
   if (hIndex < 0)
     hIndex += CONSTANT_HASH_SIZE;
+  LOCK_POLY_HASH (T_CONSTANT, hIndex);
 
   /* If the hash table item is not empty, determine if the constant is in the
    * constant polynomial list.  If it is not, find a position in the hash table to
@@ -914,21 +1630,26 @@ Polynomial *constantExp (char *fileName, int lineNo, double con)
     if (searchHashTable (&constantHash[hIndex], &first, &last, key)) {
       for (i = first; i <= last; i++) {
         cIndex = constantHash[hIndex].index[i];
-        tempD2 = frexp (constantList[cIndex]->value, &tempI2);
+        p = LISTED_POLY (T_CONSTANT, constantList, cIndex);
+        tempD2 = frexp (p->value, &tempI2);
         // See if the two constants are the same
         if (tempI2 == tempI1 && (int) (tempD2 * 100000000) == (int) (tempD1 * 100000000)) {
           // If the two constants are the same, return the constant in the constant list
 	  // Only set one or the other of VALID_REF_FLAG and VALID_NOTDISC_FLAG
-	  if (constantList[cIndex]->valid & VALID_NOTDISC_FLAG)
+	  if (p->valid & VALID_NOTDISC_FLAG)
 	    // Not a pending discard, so now it's referenced
-	    constantList[cIndex]->valid |= VALID_REF_FLAG;
+	    SET_POLY_VALID (p, VALID_REF_FLAG);
 	  else {
 	    // Pending discard is recycled, so not pending anymore (and not referenced!)
-	    constantList[cIndex]->valid |= VALID_NOTDISC_FLAG;
+	    SET_POLY_VALID (p, VALID_NOTDISC_FLAG);
+#ifndef NO_POLY_CONCURRENT_BUILD
+#pragma omp atomic
+#endif
 	    pendingExplicitDiscards--;
 	  }
-          constantHashHits++;
-          return polyReturnWrapper (constantList[cIndex]);
+          COUNT_POLY_STAT (constantHashHits);
+          UNLOCK_POLY_HASH (T_CONSTANT, hIndex);
+          return polyReturnWrapper (p);
         }
       }
     }
@@ -939,37 +1660,41 @@ Polynomial *constantExp (char *fileName, int lineNo, double con)
   // Next, insert it into the constant list
 
   // Generate a constant polynomial
-  MALCHOKE(p, sizeof (Polynomial), Polynomial *);
+  p = (Polynomial *) polyArenaAlloc (&constantArena);
   p->eType = T_CONSTANT;
   p->value = con;
 #ifdef USE_GMP
   mpf_init_set_d (p->mpfValue, p->value);
 #endif
 
-  // Check if the constant polynomial list is full.
-  if (constantCount >= constantListLength) {
-    constantListLength += CONSTANT_LIST_INCREASE;
-    constantPListExpansions++;
-    REALCHOKE (constantList, constantListLength * sizeof (Polynomial *), void *);
-  }
-  // Save the constant in the constant polynomial list
-  constantList[constantCount] = p;
-  p->index = constantCount;
-  // Give the polynomial a unique ID
-  p->id = nodeId;
-  constantCount++;
-  //  if (constantCount >= 100000)
-  //    printf ("Hit 100K\n");
-  nodeId++;
+  if (POLY_CONCURRENT)
+    listConcurrentPoly (p);
+  else {
+    // Check if the constant polynomial list is full.
+    if (constantCount >= constantListLength) {
+      constantListLength += CONSTANT_LIST_INCREASE;
+      constantPListExpansions++;
+      constantList = growPolyTable (constantList, constantCount * sizeof (Polynomial *), constantListLength * sizeof (Polynomial *));
+    }
+    // Save the constant in the constant polynomial list
+    constantList[constantCount] = p;
+    p->index = constantCount;
+    // Give the polynomial a unique ID
+    p->id = nodeId;
+    constantCount++;
+    nodeId++;
+  }
   p->key = key;
   p->valid = VALID_NOTDISC_FLAG;
+  p->evalEpoch = 0;
   p->count = 0;
 #ifdef SOURCEDIGRAPH
   p->source = findOrAddSource (fileName, lineNo, T_CONSTANT);
 #endif
 
   // Record the constant polynomial in the hash table of constant polynomials
-  insertHashTable (&constantHash[hIndex], location, key, constantCount - 1);
+  insertHashTable (&constantHash[hIndex], location, key, p->index);
+  UNLOCK_POLY_HASH (T_CONSTANT, hIndex);
 
   return polyReturnWrapper (p);
 };
@@ -1016,7 +1741,7 @@ Polynomial *variableExp (double *vD, int *vI, char vType, char name[10])
   int first, last, location;
 
 #ifdef POLYSTATISTICS
-  if ((termCount++ & 0x7FFFFF) == 0) ///< New term from an external standpoint.
+  if (((countPolyTerm () - 1) & 0x7FFFFF) == 0) ///< New term from an external standpoint.
     polyStatistics ("At 8M raw term multiple");
 #endif
 
@@ -1027,6 +1752,7 @@ Polynomial *variableExp (double *vD, int *vI, char vType, char name[10])
   hIndex = key % VARIABLE_HASH_SIZE;
   if (hIndex < 0)
     hIndex += VARIABLE_HASH_SIZE;
+  LOCK_POLY_HASH (T_VARIABLE, hIndex);
   /* If the hash table item is not empty, determine if the variable is already in the
    * variable polynomial list.  If it is not, determine a position in the hash table to
    * save the key and an index in the variable list. Save this variable polynomial in
@@ -1037,13 +1763,15 @@ Polynomial *variableExp (double *vD, int *vI, char vType, char name[10])
     if (searchHashTable (&variableHash[hIndex], &first, &last, key)) {
       for (i = first; i <= last; i++) {
         vIndex = variableHash[hIndex].index[i];
+        p = LISTED_POLY (T_VARIABLE, variableList, vIndex);
         // Compare if the two variables are the same
-        if ((vType == 'D' && variableList[vIndex]->e.v->vAddr.vAddrD == vD)
-            || (vType == 'I' && variableList[vIndex]->e.v->vAddr.vAddrI == vI)) {
+        if ((vType == 'D' && p->e.v->vAddr.vAddrD == vD)
+            || (vType == 'I' && p->e.v->vAddr.vAddrI == vI)) {
           // If the two variables are the same, return the address from the list
-          variableList[vIndex]->valid |= VALID_REF_FLAG;
-          variableHashHits++;
-          return polyReturnWrapper (variableList[vIndex]);
+          SET_POLY_VALID (p, VALID_REF_FLAG);
+          COUNT_POLY_STAT (variableHashHits);
+          UNLOCK_POLY_HASH (T_VARIABLE, hIndex);
+          return polyReturnWrapper (p);
         }
       }
     }
@@ -1052,16 +1780,9 @@ Polynomial *variableExp (double *vD, int *vI, char vType, char name[10])
     location = 0;
 
   // This variable polynomial doesn't exist, so we'll create it.
-  MALCHOKE(p, sizeof (Polynomial), Polynomial *);
-
-  MALCHOKE(p, sizeof (Polynomial), Polynomial *);
+  p = (Polynomial *) polyArenaAlloc (&variableArena);
   MALCHOKE(vPoly, sizeof (struct variablePoly), struct variablePoly *);
   p->eType = T_VARIABLE;
-  // Make sure we always have a name, either provided or based upon arrival order.
-  if (strlen (name) == 0)
-    sprintf (vPoly->vName, "u%d", variableCount);
-  else
-    strcpy (vPoly->vName, name);
   if (vType == 'D')
     vPoly->vAddr.vAddrD = vD;
   else
@@ -1069,29 +1790,40 @@ Polynomial *variableExp (double *vD, int *vI, char vType, char name[10])
   vPoly->vType = vType;
   p->e.v = vPoly;
 
-  // If the polynomial list is full, get  more memory
-  if (variableCount >= variableListLength) {
-    variableListLength += VARIABLE_LIST_INCREASE;
-    variablePListExpansions++;
-    REALCHOKE (variableList, variableListLength * sizeof (Polynomial *), void *);
+  if (POLY_CONCURRENT)
+    listConcurrentPoly (p);
+  else {
+    // If the polynomial list is full, get  more memory
+    if (variableCount >= variableListLength) {
+      variableListLength += VARIABLE_LIST_INCREASE;
+      variablePListExpansions++;
+      variableList = growPolyTable (variableList, variableCount * sizeof (Polynomial *), variableListLength * sizeof (Polynomial *));
+    }
+
+    p->index = variableCount;
+    p->id = nodeId;
+    // Insert the variable polynomial in the variable polynomial list
+    variableList[variableCount] = p;
+    variableCount++;
+    nodeId++;
   }
 
-  p->index = variableCount;
-  p->id = nodeId;
+  // Make sure we always have a name, either provided or based upon arrival order.
+  if (strlen (name) == 0)
+    sprintf (vPoly->vName, "u%d", p->index);
+  else
+    strcpy (vPoly->vName, name);
   p->key = key;
   p->valid = VALID_NOTDISC_FLAG;
+  p->evalEpoch = 0;
   p->count = 0;
 #ifdef USE_GMP
   mpf_init (p->mpfValue);
 #endif
 
-  // Insert the variable polynomial in the variable polynomial list
-  variableList[variableCount] = p;
-  variableCount++;
-  nodeId++;
-
   // Record the variable polynomial in the hash table of the variable polynomials
-  insertHashTable (&variableHash[hIndex], location, key, variableCount - 1);
+  insertHashTable (&variableHash[hIndex], location, key, p->index);
+  UNLOCK_POLY_HASH (T_VARIABLE, hIndex);
 
   return polyReturnWrapper (p);
 };
@@ -1131,16 +1863,16 @@ static inline int searchPolynomialList (Polynomial ** p, int length, Polynomial
 {
   int binaryStart, binaryEnd, binaryMiddle;
 
-  totalSPLLengths += length;
-  totalSPLCalls++;
+  ADD_POLY_STAT (totalSPLLengths, length);
+  COUNT_POLY_STAT (totalSPLCalls);
 
   if (length == 0) {
-    lowSPLCount++;
+    COUNT_POLY_STAT (lowSPLCount);
     *location = 0;
     return 0;
   }
   if (target->index > p[length - 1]->index) {
-    highSPLCount++;
+    COUNT_POLY_STAT (highSPLCount);
     *location = length;
     return 0;
   }
@@ -1188,7 +1920,7 @@ static inline void collectSumTerms (double **factor,   ///< Container, pointer t
   // If container is full, apply for more memory
   if (*counter >= *containerLength - 1) {
     (*containerLength) += 50;
-    containerExpansions++;
+    COUNT_POLY_STAT (containerExpansions);
     REALCHOKE (*factor, (*containerLength) * sizeof (double), double *);
     REALCHOKE (*p, (*containerLength) * sizeof (Polynomial *), Polynomial **);
   }
@@ -1307,12 +2039,12 @@ void expPrinting (Polynomial * p)
     importTermList (p);
     if (p->e.s->factor[0] != 1)
       fprintf (stderr, "%G*", p->e.s->factor[0]);
-    expPrinting (p->e.s->sum[0]);
+    expPrinting (POLY_TERM (p->e.s->sum[0]));
     for (i = 1; i < p->e.s->num; i++) {
       fprintf (stderr, "+");
       if (p->e.s->factor[i] != 1)
         fprintf (stderr, "%G*", p->e.s->factor[i]);
-      expPrinting (p->e.s->sum[i]);
+      expPrinting (POLY_TERM (p->e.s->sum[i]));
     }
     exportTermList (p, FALSE);
     if (p->e.s->num > 1)
@@ -1321,12 +2053,12 @@ void expPrinting (Polynomial * p)
   case T_PRODUCT:
     if (p->e.p->num > 1)
       fprintf (stderr, "(");
-    expPrinting (p->e.p->product[0]);
+    expPrinting (POLY_TERM (p->e.p->product[0]));
     if (p->e.p->exponent[0] != 1)
       fprintf (stderr, "^%d", p->e.p->exponent[0]);
     for (i = 1; i < p->e.s->num; i++) {
       fprintf (stderr, "*");
-      expPrinting (p->e.p->product[i]);
+      expPrinting (POLY_TERM (p->e.p->product[i]));
       if (p->e.p->exponent[i] != 1)
         fprintf (stderr, "^%d", p->e.p->exponent[i]);
     }
@@ -1383,13 +2115,13 @@ void expTermPrinting (FILE * output, Polynomial * p, int depth)
     fprintf (output, "(s%d:", p->index);
     if (p->e.s->factor[0] != 1)
       fprintf (output, "%G*", p->e.s->factor[0]);
-    expTermPrinting (output, p->e.s->sum[0], depth - 1);
+    expTermPrinting (output, POLY_TERM (p->e.s->sum[0]), depth - 1);
     importTermList (p);
     for (i = 1; i < p->e.s->num; i++) {
       fprintf (output, "+");
       if (p->e.s->factor[i] != 1)
         fprintf (output, "%G*", p->e.s->factor[i]);
-      expTermPrinting (output, p->e.s->sum[i], depth - 1);
+      expTermPrinting (output, POLY_TERM (p->e.s->sum[i]), depth - 1);
     }
     exportTermList (p, FALSE);
     fprintf (output, ")");
@@ -1400,12 +2132,12 @@ void expTermPrinting (FILE * output, Polynomial * p, int depth)
       return;
     }
     fprintf (output, "(p%d:", p->index);
-    expTermPrinting (output, p->e.p->product[0], depth - 1);
+    expTermPrinting (output, POLY_TERM (p->e.p->product[0]), depth - 1);
     if (p->e.p->exponent[0] != 1)
       fprintf (output, "^%d", p->e.p->exponent[0]);
     for (i = 1; i < p->e.s->num; i++) {
       fprintf (output, "*");
-      expTermPrinting (output, p->e.p->product[i], depth - 1);
+      expTermPrinting (output, POLY_TERM (p->e.p->product[i]), depth - 1);
       if (p->e.p->exponent[i] != 1)
         fprintf (output, "^%d", p->e.p->exponent[i]);
     }
@@ -1443,8 +2175,11 @@ inline void discardPoly (Polynomial *p)
     //    fprintf (stderr, "Not discarding a 1, 0 or 0.5 constant\n");
     return;
   }
+  // Another thread could have found it by now
+  if (POLY_CONCURRENT)
+    return;
 
-  if ((p->valid & ~VALID_NOTDISC_FLAG) != 0) {
+  if ((POLY_FLAGS (p) & ~VALID_NOTDISC_FLAG) != 0) {
     FATAL ("Can't discard already flagged poly!");
   }
 
@@ -1487,10 +2222,32 @@ inline void discardPoly (Polynomial *p)
      freed.
 
 */
+static Polynomial *plusExpCore (char *fileName, int lineNo, int num, va_list *args,
+				double *argFactor, Polynomial **argTerm, int argFlag);
+
 Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
 {
-  int i, k, l;
   va_list args; ///< Variable list of parameters
+  Polynomial *rp;
+
+  va_start (args, num);
+  rp = plusExpCore (fileName, lineNo, num, &args, NULL, NULL, 0);
+  va_end (args);
+  return rp;
+}
+
+/**
+
+  Does the work of plusExp, taking the <factor, poly> pairs and the flag
+  either from args or, when argTerm isn't NULL, from the argFactor and
+  argTerm arrays and argFlag, so that a sum of any number of terms can be
+  built in one call.
+
+*/
+static Polynomial *plusExpCore (char *fileName, int lineNo, int num, va_list *args,
+				double *argFactor, Polynomial **argTerm, int argFlag)
+{
+  int i, k, l;
   struct sumPoly *sP;   ///< Element of a sum polynomial
   Polynomial *rp;       ///< Pointer of the new sum polynomial
   int counterSum;       ///< Counter of the number of terms in the new sum polynomial
@@ -1510,10 +2267,11 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
       p0Index = 0,      ///< Index in the polynomial list
       p0Id = 0, p0Key, p0Valid;
   enum expressionType p0EType;
+  long terms;   ///< Raw terms so far, for progress reporting
 
-  termCount++;
-  if ((termCount & 0x1FFFFF) == 0) {
-    if ((termCount & 0xFFFFFF) == 0) {
+  terms = countPolyTerm ();
+  if ((terms & 0x1FFFFF) == 0) {
+    if ((terms & 0xFFFFFF) == 0 && !POLY_CONCURRENT) {
 #ifdef POLYSTATISTICS
       polyStatistics ("At 8M raw term multiple");
 #endif
@@ -1530,23 +2288,25 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
   counter_p1 = 0;
   counter_f1 = 0;
 
-  // Get the number of items for this sum from the parameter list of the function
-  va_start (args, num);
-
 #ifdef SOURCEDIGRAPH
   memset (originalChildren, 0, sizeof (originalChildren));
 #endif
 
   // Iterate through all the items in the parameter list
   for (i = 0; i < num; i++) {
-    f1 = va_arg (args, double); // Get the coefficient
-    p1 = va_arg (args, Polynomial *);   // ...and the polynomial
+    if (argTerm != NULL) {
+      f1 = argFactor[i];
+      p1 = argTerm[i];
+    } else {
+      f1 = va_arg (*args, double);      // Get the coefficient
+      p1 = va_arg (*args, Polynomial *);        // ...and the polynomial
+    }
     if (p1->eType == T_OFFLINE) importPoly (p1);
 
     //    if (p1->count == 0 && !((p1->valid & VALID_TOP_FLAG) == 0))
     //      fprintf (stderr, "UnHeld, non-top SUM %d referenced!\n", p1->id);
 
-    p1->valid &= ~VALID_TOP_FLAG;       // No longer unreferenced
+    CLEAR_POLY_VALID (p1, VALID_TOP_FLAG);      // No longer unreferenced
 
 #ifdef SOURCEDIGRAPH
     originalChildren[p1->source]++;     // Bump the count of children of this subpoly source for this parent
@@ -1589,25 +2349,25 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
       // Fold the components of the sum subpolynomial up into this sum polynomial
       importTermList (p1);
       for (l = 0; l < p1->e.s->num; l++) {
-        switch (p1->e.s->sum[l]->eType) {
+        switch (POLY_TERM (p1->e.s->sum[l])->eType) {
 	case T_OFFLINE:
-	  importPoly(p1->e.s->sum[l]);
+	  importPoly(POLY_TERM (p1->e.s->sum[l]));
 	// Notice that there's no break here...
 
         case T_CONSTANT:       // Item is a constant, collected it into con
-          con += f1 * p1->e.s->sum[l]->value * p1->e.s->factor[l];
+          con += f1 * POLY_TERM (p1->e.s->sum[l])->value * p1->e.s->factor[l];
           break;
         case T_VARIABLE:
-          collectSumTerms (&factor_v1, &p_v1, &counter_v1, &containerLength_v1, f1 * p1->e.s->factor[l], p1->e.s->sum[l]);
+          collectSumTerms (&factor_v1, &p_v1, &counter_v1, &containerLength_v1, f1 * p1->e.s->factor[l], POLY_TERM (p1->e.s->sum[l]));
           break;
         case T_PRODUCT:
-          collectSumTerms (&factor_p1, &p_p1, &counter_p1, &containerLength_p1, f1 * p1->e.s->factor[l], p1->e.s->sum[l]);
+          collectSumTerms (&factor_p1, &p_p1, &counter_p1, &containerLength_p1, f1 * p1->e.s->factor[l], POLY_TERM (p1->e.s->sum[l]));
           break;
         case T_FUNCTIONCALL:
-          collectSumTerms (&factor_f1, &p_f1, &counter_f1, &containerLength_f1, f1 * p1->e.s->factor[l], p1->e.s->sum[l]);
+          collectSumTerms (&factor_f1, &p_f1, &counter_f1, &containerLength_f1, f1 * p1->e.s->factor[l], POLY_TERM (p1->e.s->sum[l]));
           break;
         default:
-          FATAL ("In plusExp, unknown expression type %d", p1->e.s->sum[l]->eType);
+          FATAL ("In plusExp, unknown expression type %d", POLY_TERM (p1->e.s->sum[l])->eType);
         }
       }
       exportTermList (p1, FALSE);
@@ -1621,14 +2381,16 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
       FATAL ("In plusExp, unknown polynomial type %d", p1->eType);
     }
   }
-  flag = va_arg (args, int);
+  flag = (argTerm != NULL) ? argFlag : va_arg (*args, int);
 
-  va_end (args);
+  // Another thread could have found the first term by now
+  if (POLY_CONCURRENT)
+    flag = 0;
 
   if (flag == 0)
-    sumNotReleaseableCount++;
+    COUNT_POLY_STAT (sumNotReleaseableCount);
   else
-    sumReleaseableCount++;
+    COUNT_POLY_STAT (sumReleaseableCount);
 
   // Merge the collected polynomial terms to form a sum polynomial
   counterSum = counter_v1 + counter_p1 + counter_f1;
@@ -1655,11 +2417,11 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
   if (counterSum == 0) {
     // After we go through all the items in the sum, we get only a constant.
     if (p0->eType == T_CONSTANT && p0->value == con) {
-      sumReturnSameConstantCount++;
+      COUNT_POLY_STAT (sumReturnSameConstantCount);
       return polyReturnWrapper (p0); // No net change at all from first term. Just return it.
     }
-    sumReturnConstantCount++;
-    if (flag != 0 && (p0->valid & ~VALID_NOTDISC_FLAG) == 0)
+    COUNT_POLY_STAT (sumReturnConstantCount);
+    if (flag != 0 && (POLY_FLAGS (p0) & ~VALID_NOTDISC_FLAG) == 0)
       discardPoly (p0);
     rp = constantExp (__FILE__, __LINE__, con);
     if (polynomialDebugLevel >= 60)
@@ -1668,7 +2430,7 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
   } else if (con == 0.0 && counterSum == 1 && factorSum[0] == 1.0) {
     // We have only one term, no need to create a new polynomial
     rp = pSum[0];
-    sumReturn1TermCount++;
+    COUNT_POLY_STAT (sumReturn1TermCount);
     if (polynomialDebugLevel >= 60) {
       fprintf (stderr, "Returning a single term sum\n");
       expTermPrinting (stderr, rp, 1);
@@ -1691,6 +2453,7 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
   hIndex = key % SUM_HASH_SIZE;
   if (hIndex < 0)
     hIndex += SUM_HASH_SIZE;
+  LOCK_POLY_HASH (T_SUM, hIndex);
 
   /* If the hash table item is not empty, look for the sum in the sum polynomial 
    * list. If it is not there, determine a position in the hash table to
@@ -1700,33 +2463,35 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
     if (searchHashTable (&sumHash[hIndex], &first, &last, key)) {
       for (i = first; i <= last; i++) {
         sIndex = sumHash[hIndex].index[i];
-        if (counterSum == sumList[sIndex]->e.s->num) {
+        rp = LISTED_POLY (T_SUM, sumList, sIndex);
+        if (counterSum == rp->e.s->num) {
           // Compare the two sums term-by-term
-	  importTermList (sumList[sIndex]);
+	  importTermList (rp);
           for (k = 0; k < counterSum; k++) {
             // If the terms are identical, compare their factors
-            if (pSum[k] == sumList[sIndex]->e.s->sum[k]) {
+            if (pSum[k] == POLY_TERM (rp->e.s->sum[k])) {
               tempD = frexp (factorSum[k], &tempI);
-              tempD2 = frexp (sumList[sIndex]->e.s->factor[k], &tempI2);
+              tempD2 = frexp (rp->e.s->factor[k], &tempI2);
               if (tempI2 != tempI || (int) (tempD2 * 100000000) != (int) (tempD * 100000000))
                 break;
             } else
               break;
           }
-	  exportTermList (sumList[sIndex], FALSE);
+	  exportTermList (rp, FALSE);
           if (k >= counterSum) {
-            sumList[sIndex]->valid |= VALID_REF_FLAG;
-            sumHashHits++;
+            SET_POLY_VALID (rp, VALID_REF_FLAG);
+            COUNT_POLY_STAT (sumHashHits);
             if (polynomialDebugLevel >= 60) {
               fprintf (stderr, "Returning an existing sum...\n");
               if (polynomialDebugLevel >= 70) {
-                expPrinting (sumList[sIndex]);
+                expPrinting (rp);
                 fprintf (stderr, "\n");
               }
             }
-	    //	    if (flag != 0 && (p0->valid & ~VALID_NOTDISC_FLAG) == 0)
+	    //	    if (flag != 0 && (POLY_FLAGS (p0) & ~VALID_NOTDISC_FLAG) == 0)
 	    //	      discardPoly (p0); // Causes a crash, but shouldn't! Maybe sumList == p0?
-            return polyReturnWrapper (sumList[sIndex]);
+            UNLOCK_POLY_HASH (T_SUM, hIndex);
+            return polyReturnWrapper (rp);
           }
         }
       }
@@ -1773,19 +2538,19 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
     }
 
     // Free the memory of the first polynomial in the parameter list
-    sum1stTermsFreedCount++;
+    COUNT_POLY_STAT (sum1stTermsFreedCount);
 #ifndef USE_SSD
-    free (p0->e.s->sum);
-    free (p0->e.s->factor);
+    polyTermFree (SUM_TERM_ARENA, p0->e.s->sum, p0->e.s->num * sizeof (polyHandle));
+    polyTermFree (SUM_TERM_ARENA, p0->e.s->factor, p0->e.s->num * sizeof (double));
 #else
     deportTermList (p0);
 #endif
-    free (p0->e.s);
+    polyArenaFree (&sumPolyArena, p0->e.s);
 #ifdef FREEDEBUG
     p0->value = -sumList[i]->eType;
     p0->eType = T_FREED;
 #else
-    free (p0);
+    polyArenaFree (&sumArena, p0);
 #endif
   } else {
     // Flag not set or not sum or actually valid
@@ -1794,17 +2559,17 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
   }
 
   // Since the sum was not found in the sum list, a new polynomial is built
-  MALCHOKE(rp, sizeof (Polynomial), Polynomial *);
+  rp = (Polynomial *) polyArenaAlloc (&sumArena);
   rp->eType = T_SUM;
-  MALCHOKE(sP, sizeof (struct sumPoly), struct sumPoly *);
+  sP = (struct sumPoly *) polyArenaAlloc (&sumPolyArena);
   sP->num = counterSum;
-  // When usage is up to around 32Gb, these two mallocs can take seconds and even minutes!
-  MALCHOKE(sP->factor, counterSum * sizeof (double),double *);
-  MALCHOKE(sP->sum, counterSum * sizeof (Polynomial *),Polynomial **);
+  // When usage is up to around 32Gb, mallocs of these two can take seconds and even minutes!
+  sP->factor = (double *) polyTermAlloc (SUM_TERM_ARENA, counterSum * sizeof (double));
+  sP->sum = (polyHandle *) polyTermAlloc (SUM_TERM_ARENA, counterSum * sizeof (polyHandle));
   for (i = 0; i < sP->num; i++) {
     sP->factor[i] = factorSum[i];
-    sP->sum[i] = pSum[i];
-    sP->sum[i]->valid |= VALID_REF_FLAG;
+    sP->sum[i] = POLY_HANDLE (pSum[i]);
+    SET_POLY_VALID (pSum[i], VALID_REF_FLAG);
   }
   // Assign values to some attributes of the sum polynomial
 #ifdef USE_SSD
@@ -1813,6 +2578,7 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
   rp->e.s = sP;
   rp->key = key;
   rp->valid = VALID_NOTDISC_FLAG;
+  rp->evalEpoch = 0;
   rp->count = 0;
 #ifdef USE_GMP
   mpf_init (rp->mpfValue);
@@ -1826,15 +2592,19 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
   /* If the first polynomial is the parameter list is freed, its position
    * in the polynomial list is occupied by the newly created sum polynomial. */
   if (flag != 0 && p0EType == T_SUM && p0Valid == 0) {
-    sumListReplacementCount++;
+    COUNT_POLY_STAT (sumListReplacementCount);
     sumList[p0Index] = rp;
     sumList[p0Index]->index = p0Index;
     sumList[p0Index]->id = p0Id;
+  } else if (POLY_CONCURRENT) {
+    COUNT_POLY_STAT (sumListNewCount);
+    listConcurrentPoly (rp);
+    rp->valid |= VALID_TOP_FLAG; // Currently unreferenced
   } else {
     if (sumCount >= sumListLength) {
       sumListLength += SUM_LIST_INCREASE;
       sumPListExpansions++;
-      REALCHOKE (sumList, sumListLength * sizeof (Polynomial *), void *);
+      sumList = growPolyTable (sumList, sumCount * sizeof (Polynomial *), sumListLength * sizeof (Polynomial *));
     }
     sumListNewCount++;
     sumList[sumCount] = rp;
@@ -1867,9 +2637,10 @@ Polynomial *plusExp (char *fileName, int lineNo, int num, ...)
        * new one. */
       sumHash[hIndex].key[location] = key;
   } else
-    insertHashTable (&sumHash[hIndex], location, key, sumCount - 1);
+    insertHashTable (&sumHash[hIndex], location, key, rp->index);
+  UNLOCK_POLY_HASH (T_SUM, hIndex);
 
-  sumNewCount++;
+  COUNT_POLY_STAT (sumNewCount);
   if (polynomialDebugLevel >= 60) {
     fprintf (stderr, "Returning a new sum...\n");
     if (polynomialDebugLevel >= 70) {
@@ -1978,11 +2749,32 @@ static inline void collectProductTerms (int **exponent,        ///< Container, p
      can be freed.
 
 */
+static Polynomial *timesExpCore (char *fileName, int lineNo, int num, va_list *args,
+				 Polynomial **argTerm, int *argExponent, int argFlag);
+
 Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
+{
+  va_list args; ///< Variable list of parameters
+  Polynomial *rp;
+
+  va_start (args, num);
+  rp = timesExpCore (fileName, lineNo, num, &args, NULL, NULL, 0);
+  va_end (args);
+  return rp;
+}
+
+/**
+
+  Does the work of timesExp, taking the <poly, exponent> pairs and the
+  flag either from args or, when argTerm isn't NULL, from the argTerm and
+  argExponent arrays and argFlag.
+
+*/
+static Polynomial *timesExpCore (char *fileName, int lineNo, int num, va_list *args,
+				 Polynomial **argTerm, int *argExponent, int argFlag)
 {
   int i, k, l;
   int counterProd;      ///< Number of terms in the new product polynomial
-  va_list args; ///< Variable list of parameters
   struct productPoly *pP;       ///< Product structure for the new polynomial
   Polynomial *rp;       ///< New product polynomial
   Polynomial *p1 = 0, *p0 = 0;  ///< Some polynomial terms
@@ -2002,10 +2794,11 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
       p0Key,    ///< Key
       p0Valid;  ///< Valid byte
   enum expressionType p0EType;
+  long terms;   ///< Raw terms so far, for progress reporting
 
-  termCount++;
-  if ((termCount & 0x1FFFFF) == 0) {
-    if ((termCount & 0xFFFFFF) == 0) {
+  terms = countPolyTerm ();
+  if ((terms & 0x1FFFFF) == 0) {
+    if ((terms & 0xFFFFFF) == 0 && !POLY_CONCURRENT) {
 #ifdef POLYSTATISTICS
       polyStatistics ("At 8M raw term multiple");
 #endif
@@ -2026,19 +2819,16 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
   memset (originalChildren, 0, sizeof (originalChildren));
 #endif
 
-  // Get the number of operands for this times operation
-  va_start (args, num);
-
   // Go through operand and its exponent of the product
   for (i = 0; i < num; i++) {
-    p1 = va_arg (args, Polynomial *);
+    p1 = (argTerm != NULL) ? argTerm[i] : va_arg (*args, Polynomial *);
     if (p1->eType == T_OFFLINE) importPoly (p1);
-    e1 = va_arg (args, int);
+    e1 = (argTerm != NULL) ? argExponent[i] : va_arg (*args, int);
 
     //    if (p1->count == 0 && !((p1->valid & VALID_TOP_FLAG) == 0))
     //      fprintf (stderr, "UnHeld, non-top PRODUCT %d referenced!\n", p1->id);
 
-    p1->valid &= ~VALID_TOP_FLAG;       // No longer unreferenced
+    CLEAR_POLY_VALID (p1, VALID_TOP_FLAG);      // No longer unreferenced
 
 #ifdef SOURCEDIGRAPH
     originalChildren[p1->source]++;     // Bump the count of children of this subpoly source for this parent
@@ -2072,7 +2862,7 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
 	Polynomial *q = p1;
 	importTermList (q);
 	factor *= pow (p1->e.s->factor[0], e1);
-	p1 = p1->e.s->sum[0];
+	p1 = POLY_TERM (p1->e.s->sum[0]);
 	exportTermList (q, FALSE);
       }
       /* If this operand is a variable, a sum that has more than one items, or a function call, 
@@ -2096,24 +2886,24 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
         // For a product term, we open it and check each of its terms
       case T_PRODUCT:
         for (l = 0; l < p1->e.p->num; l++) {
-          switch (p1->e.p->product[l]->eType) {
+          switch (POLY_TERM (p1->e.p->product[l])->eType) {
 	  case T_OFFLINE:
-	    importPoly(p1->e.p->product[l]);
+	    importPoly(POLY_TERM (p1->e.p->product[l]));
 	    // Notice that there's no break here...
 
           case T_VARIABLE:
-            collectProductTerms (&exponent_v2, &p_v2, &counter_v2, &containerLength_v2, e1 * p1->e.p->exponent[l], p1->e.p->product[l]);
+            collectProductTerms (&exponent_v2, &p_v2, &counter_v2, &containerLength_v2, e1 * p1->e.p->exponent[l], POLY_TERM (p1->e.p->product[l]));
             break;
           case T_SUM:
-	    importTermList (p1->e.p->product[l]);
-            collectProductTerms (&exponent_s2, &p_s2, &counter_s2, &containerLength_s2, e1 * p1->e.p->exponent[l], p1->e.p->product[l]);
-	    exportTermList (p1->e.p->product[l], FALSE);
+	    importTermList (POLY_TERM (p1->e.p->product[l]));
+            collectProductTerms (&exponent_s2, &p_s2, &counter_s2, &containerLength_s2, e1 * p1->e.p->exponent[l], POLY_TERM (p1->e.p->product[l]));
+	    exportTermList (POLY_TERM (p1->e.p->product[l]), FALSE);
             break;
           case T_FUNCTIONCALL:
-            collectProductTerms (&exponent_f2, &p_f2, &counter_f2, &containerLength_f2, e1 * p1->e.p->exponent[l], p1->e.p->product[l]);
+            collectProductTerms (&exponent_f2, &p_f2, &counter_f2, &containerLength_f2, e1 * p1->e.p->exponent[l], POLY_TERM (p1->e.p->product[l]));
             break;
           default:
-            FATAL ("In timesExp, unknown expression type %d", p1->e.p->product[l]->eType);
+            FATAL ("In timesExp, unknown expression type %d", POLY_TERM (p1->e.p->product[l])->eType);
           }
         }
         break;
@@ -2128,19 +2918,21 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
       }
     }
   }
-  flag = va_arg (args, int);
+  flag = (argTerm != NULL) ? argFlag : va_arg (*args, int);
 
-  va_end (args);
+  // Another thread could have found the first term by now
+  if (POLY_CONCURRENT)
+    flag = 0;
 
   if (flag == 0)
-    productNotReleaseableCount++;
+    COUNT_POLY_STAT (productNotReleaseableCount);
   else
-    productReleaseableCount++;
+    COUNT_POLY_STAT (productReleaseableCount);
 
   if (isZero) {
     // The product is zero, a zero polynomial is returned
-    productReturn0Count++;
-    if (flag != 0 && (p0->valid & ~VALID_NOTDISC_FLAG) == 0)
+    COUNT_POLY_STAT (productReturn0Count);
+    if (flag != 0 && (POLY_FLAGS (p0) & ~VALID_NOTDISC_FLAG) == 0)
       discardPoly (p0);
     rp = constantExp (__FILE__, __LINE__, 0.0);
     if (polynomialDebugLevel >= 60)
@@ -2170,11 +2962,11 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
   if (counterProd == 0) {
     // The product has 0 items, the result is a constant polynomial
     if (p0->eType == T_CONSTANT && p0->value == factor) {
-      productReturnSameConstantCount++;
+      COUNT_POLY_STAT (productReturnSameConstantCount);
       return polyReturnWrapper (p0); // No net change at all from first term. Just return it.
     }
-    productReturnConstantCount++;
-    if (flag != 0 && (p0->valid & ~VALID_NOTDISC_FLAG) == 0)
+    COUNT_POLY_STAT (productReturnConstantCount);
+    if (flag != 0 && (POLY_FLAGS (p0) & ~VALID_NOTDISC_FLAG) == 0)
       discardPoly (p0);
     rp = constantExp (__FILE__, __LINE__, factor);
     if (polynomialDebugLevel >= 60)
@@ -2188,14 +2980,14 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
       rp = pProd[0];
       if (polynomialDebugLevel >= 60)
         fprintf (stderr, "Returning first term from caller\n");
-      productReturn1stTermCount++;
+      COUNT_POLY_STAT (productReturn1stTermCount);
       return polyReturnWrapper (rp);
     } else {
       // If the factor is not 1, then the result polynomial is a sum polynomial
       rp = plusExp (fileName, lineNo, 1, factor, pProd[0], flag);
       if (polynomialDebugLevel >= 60)
         fprintf (stderr, "Returning via plusExp\n");
-      productReturn1TermSumCount++;
+      COUNT_POLY_STAT (productReturn1TermSumCount);
       return polyReturnWrapper (rp);
     }
   } else {
@@ -2205,6 +2997,7 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
     hIndex = key % PRODUCT_HASH_SIZE;
     if (hIndex < 0)
       hIndex += PRODUCT_HASH_SIZE;
+    LOCK_POLY_HASH (T_PRODUCT, hIndex);
     /* If the hash table item is not empty, look for the product in the product polynomial
      * list.  If it is not there, determine a position in the hash table to save the 
      * key and the index in the hash table. */
@@ -2213,36 +3006,39 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
       if (searchHashTable (&productHash[hIndex], &first, &last, key)) {
         for (i = first; i <= last; i++) {
           pIndex = productHash[hIndex].index[i];
+          rp = LISTED_POLY (T_PRODUCT, productList, pIndex);
           // Compare the two products term-by-term
-          if (counterProd == productList[pIndex]->e.p->num) {
+          if (counterProd == rp->e.p->num) {
             for (k = 0; k < counterProd; k++)
-              if (pProd[k] != productList[pIndex]->e.p->product[k]
-                  || exponentProd[k] != productList[pIndex]->e.p->exponent[k])
+              if (pProd[k] != POLY_TERM (rp->e.p->product[k])
+                  || exponentProd[k] != rp->e.p->exponent[k])
                 break;
             if (k >= counterProd) {
               // If the polynomials are the same compare the exponents
               if (factor == 1.0) {
-                productList[pIndex]->valid |= VALID_REF_FLAG;
-                productHashHits++;
+                SET_POLY_VALID (rp, VALID_REF_FLAG);
+                COUNT_POLY_STAT (productHashHits);
                 if (polynomialDebugLevel >= 60) {
                   fprintf (stderr, "Returning an existing product...\n");
                   if (polynomialDebugLevel >= 70) {
-                    expPrinting (productList[pIndex]);
+                    expPrinting (rp);
                     fprintf (stderr, "\n");
                   }
                 }
-		if (flag != 0 && (p0->valid & ~VALID_NOTDISC_FLAG) == 0)
+		if (flag != 0 && (POLY_FLAGS (p0) & ~VALID_NOTDISC_FLAG) == 0)
 		  discardPoly (p0);
-                return polyReturnWrapper (productList[pIndex]);
+                UNLOCK_POLY_HASH (T_PRODUCT, hIndex);
+                return polyReturnWrapper (rp);
               } else {
                 /* This product polynomial already exists so we don't need to construct a
                  * new one, however, the factor is not 1, therefore the result polynomial is
                  * a sum polynomial */
-                productHashHitIsSumCount++;
-                productList[pIndex]->valid |= VALID_REF_FLAG;
+                COUNT_POLY_STAT (productHashHitIsSumCount);
+                SET_POLY_VALID (rp, VALID_REF_FLAG);
+                UNLOCK_POLY_HASH (T_PRODUCT, hIndex);
                 if (polynomialDebugLevel >= 60)
                   fprintf (stderr, "Returning existing product via plusExp\n");
-                return plusExp (fileName, lineNo, 1, factor, polyReturnWrapper(productList[pIndex]), flag);
+                return plusExp (fileName, lineNo, 1, factor, polyReturnWrapper(rp), flag);
               }
             }
           }
@@ -2292,15 +3088,15 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
       }
 
       // Free the first operand
-      product1stTermsFreedCount++;
-      free (p0->e.p->exponent);
-      free (p0->e.p->product);
-      free (p0->e.p);
+      COUNT_POLY_STAT (product1stTermsFreedCount);
+      polyTermFree (productTermArena, p0->e.p->exponent, p0->e.p->num * sizeof (polyExponent));
+      polyTermFree (productTermArena, p0->e.p->product, p0->e.p->num * sizeof (polyHandle));
+      polyArenaFree (&productPolyArena, p0->e.p);
 #ifdef FREEDEBUG
       p0->value = -productList[i]->eType;
       p0->eType = T_FREED;
 #else
-      free (p0);
+      polyArenaFree (&productArena, p0);
 #endif
     } else {
       p0EType = T_FREED;
@@ -2308,23 +3104,24 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
     }
 
     // Construct a new product polynomial from the terms saved in the container
-    MALCHOKE(rp, sizeof (Polynomial), Polynomial *);
+    rp = (Polynomial *) polyArenaAlloc (&productArena);
     rp->eType = T_PRODUCT;
-    MALCHOKE(pP, sizeof (struct productPoly), struct productPoly *);
+    pP = (struct productPoly *) polyArenaAlloc (&productPolyArena);
     pP->num = counterProd;
-    MALCHOKE(pP->product, counterProd * sizeof (Polynomial *),Polynomial **);
-    MALCHOKE(pP->exponent, counterProd * sizeof (int),int *);
+    pP->product = (polyHandle *) polyTermAlloc (productTermArena, counterProd * sizeof (polyHandle));
+    pP->exponent = (polyExponent *) polyTermAlloc (productTermArena, counterProd * sizeof (polyExponent));
     // Copy the collected terms and exponents into the product polynomial structure
     for (i = 0; i < counterProd; i++) {
-      pP->product[i] = pProd[i];
+      pP->product[i] = POLY_HANDLE (pProd[i]);
+      if (exponentProd[i] > SHRT_MAX || exponentProd[i] < SHRT_MIN)
+	FATAL ("Exponent %d of a product term won't fit in a polyExponent", exponentProd[i]);
       pP->exponent[i] = exponentProd[i];
-      pP->product[i]->valid |= VALID_REF_FLAG;
+      SET_POLY_VALID (pProd[i], VALID_REF_FLAG);
     }
     rp->e.p = pP;
-    rp->index = productCount;
-    rp->id = nodeId;
     rp->key = key;
     rp->valid = VALID_NOTDISC_FLAG;
+    rp->evalEpoch = 0;
     rp->count = 0;
 #ifdef USE_GMP
   mpf_init (rp->mpfValue);
@@ -2334,11 +3131,6 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
 #endif
 
     // After the new polynomial is built, it is saved in the product polynomial list
-    if (productCount >= productListLength) {
-      productListLength += PRODUCT_LIST_INCREASE;
-      productPListExpansions++;
-      REALCHOKE (productList, productListLength * sizeof (Polynomial *), void *);
-    }
     /* We either use a new position in the product list for this polynomial, or
      * replace an existing polynomial with the newly created polynomial at the position
      * occupied by the existing polynomial. */
@@ -2348,7 +3140,16 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
       productList[p0Index] = rp;
       productList[p0Index]->index = p0Index;
       productList[p0Index]->id = p0Id;
+    } else if (POLY_CONCURRENT) {
+      COUNT_POLY_STAT (productListNewCount);
+      listConcurrentPoly (rp);
+      rp->valid |= VALID_TOP_FLAG;       // Currently unreferenced
     } else {
+      if (productCount >= productListLength) {
+        productListLength += PRODUCT_LIST_INCREASE;
+        productPListExpansions++;
+        productList = growPolyTable (productList, productCount * sizeof (Polynomial *), productListLength * sizeof (Polynomial *));
+      }
       // Save the newly-constructed polynomial in the polynomial list
       productListNewCount++;
       productList[productCount] = rp;
@@ -2390,11 +3191,12 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
         productHash[hIndex].key[location] = key;
     } else
       // Just insert the newly-created polynomial into the hash table
-      insertHashTable (&productHash[hIndex], location, key, productCount - 1);
+      insertHashTable (&productHash[hIndex], location, key, rp->index);
+    UNLOCK_POLY_HASH (T_PRODUCT, hIndex);
 
     // If the factor is 1, return a product polynomial
     if (factor == 1.0) {
-      productReturnNormalCount++;
+      COUNT_POLY_STAT (productReturnNormalCount);
       if (polynomialDebugLevel >= 60) {
         fprintf (stderr, "Returning a new product\n");
         if (polynomialDebugLevel >= 70) {
@@ -2405,7 +3207,7 @@ Polynomial *timesExp (char *fileName, int lineNo, int num, ...)
       return polyReturnWrapper (rp);
     } else {
       // If the factor is not 1, return a sum polynomial
-      productNon1FactorIsSumCount++;
+      COUNT_POLY_STAT (productNon1FactorIsSumCount);
       if (polynomialDebugLevel >= 60)
         fprintf (stderr, "Returning new product via plusExp\n");
       return (plusExp (fileName, lineNo, 1, factor, polyReturnWrapper(rp), 0 /* Already handled flag */));
@@ -2462,7 +3264,7 @@ Polynomial *functionCallExp (int num, ...)
     location;   ///< Position of the new polynomial in a hash bucket
 
 #ifdef POLYSTATISTICS
-  if ((termCount++ & 0x7FFFFF) == 0) ///< New term from an external standpoint.
+  if (((countPolyTerm () - 1) & 0x7FFFFF) == 0) ///< New term from an external standpoint.
     polyStatistics ("At 8M raw term multiple");
 #endif
 
@@ -2492,6 +3294,7 @@ Polynomial *functionCallExp (int num, ...)
   hIndex = key % FUNCTIONCALL_HASH_SIZE;
   if (hIndex < 0)
     hIndex += FUNCTIONCALL_HASH_SIZE;
+  LOCK_POLY_HASH (T_FUNCTIONCALL, hIndex);
 
   /* Compare the key of this polynomial with the keys of other polynomials 
      already in the function list. */
@@ -2503,18 +3306,20 @@ Polynomial *functionCallExp (int num, ...)
       // Compare the new function call polynomials with a set of possible matching polynomials
       for (i = first; i <= last; i++) {
         fIndex = functionCallHash[hIndex].index[i];
+        rp = LISTED_POLY (T_FUNCTIONCALL, functionCallList, fIndex);
         /* If the names of the called functions are identical and the numbers of parameters are 
 	   identical, we compare their parameters. */
-        if (strcmp (fName, functionCallList[fIndex]->e.f->name) == 0 && num - 1 == functionCallList[fIndex]->e.f->num) {
+        if (strcmp (fName, rp->e.f->name) == 0 && num - 1 == rp->e.f->num) {
           // Compare the two function calls item by item
           for (k = 0; k < num - 1; k++)
-            if (p[k] != functionCallList[fIndex]->e.f->para[k])
+            if (p[k] != rp->e.f->para[k])
               break;
           // The two function calls are the same, return the existing one
           if (k >= num - 1) {
             free (p);
-            functionHashHits++;
-            return polyReturnWrapper (functionCallList[fIndex]);
+            COUNT_POLY_STAT (functionHashHits);
+            UNLOCK_POLY_HASH (T_FUNCTIONCALL, hIndex);
+            return polyReturnWrapper (rp);
           }
         }
       }
@@ -2526,7 +3331,7 @@ Polynomial *functionCallExp (int num, ...)
 
   // The function call ws not found in the list, insert it in the list.
   // Build a new polynomial
-  MALCHOKE(rp, sizeof (Polynomial), Polynomial *);
+  rp = (Polynomial *) polyArenaAlloc (&functionCallArena);
   MALCHOKE(fP, sizeof (struct functionPoly), struct functionPoly *);
   rp->eType = T_FUNCTIONCALL;
   fP->num = num - 1;
@@ -2537,30 +3342,37 @@ Polynomial *functionCallExp (int num, ...)
     fP->para[i] = p[i];
   }
   rp->e.f = fP;
-  rp->index = functionCallCount;
-  rp->id = nodeId;
   rp->key = key;
   rp->valid = VALID_NOTDISC_FLAG;
+  rp->evalEpoch = 0;
   rp->count = 0;
 #ifdef USE_GMP
   mpf_init (rp->mpfValue);
 #endif
 
   // Insert the newly-built polynomial in function call list
-  if (functionCallCount >= functionCallListLength) {
-    functionCallListLength += FUNCTIONCALL_LIST_INCREASE;
-    functionCallPListExpansions++;
-    REALCHOKE (functionCallList, functionCallListLength * sizeof (Polynomial *), void *);
-  }
-  functionCallList[functionCallCount] = rp;
-  functionCallCount++;
-  if (polynomialDebugLevel >= 40)
-    fprintf (stderr, "Polynomial %ld, (function %d) added\n", nodeId, functionCallCount);
-  nodeId++;
-
-  // Insert the polynomial in the hash table of function call polynomials
-  insertHashTable (&functionCallHash[hIndex], location, key, functionCallCount - 1);
-
+  if (POLY_CONCURRENT)
+    listConcurrentPoly (rp);
+  else {
+    if (functionCallCount >= functionCallListLength) {
+      functionCallListLength += FUNCTIONCALL_LIST_INCREASE;
+      functionCallPListExpansions++;
+      functionCallList = growPolyTable (functionCallList, functionCallCount * sizeof (Polynomial *),
+					functionCallListLength * sizeof (Polynomial *));
+    }
+    rp->index = functionCallCount;
+    rp->id = nodeId;
+    functionCallList[functionCallCount] = rp;
+    functionCallCount++;
+    if (polynomialDebugLevel >= 40)
+      fprintf (stderr, "Polynomial %ld, (function %d) added\n", nodeId, functionCallCount);
+    nodeId++;
+  }
+
+  // Insert the polynomial in the hash table of function call polynomials
+  insertHashTable (&functionCallHash[hIndex], location, key, rp->index);
+  UNLOCK_POLY_HASH (T_FUNCTIONCALL, hIndex);
+
   free (p);
 
   return polyReturnWrapper (rp);
@@ -2580,6 +3392,8 @@ struct polyList *buildPolyList ()
   MALCHOKE(l, sizeof (struct polyList), struct polyList *);
   l->listSize = 1000;
   l->listNext = 0;
+  l->serial = 0;
+  l->tape = NULL;
   MALCHOKE(l->pList, sizeof (Polynomial *) * l->listSize, Polynomial **);
 
   return l;
@@ -2593,7 +3407,7 @@ struct polyList *buildPolyList ()
 void polyListAppend (struct polyList *l, Polynomial * p)
 {
   // Valid is a flag indicating that this polynomial appears on a sorting list.
-  p->valid |= VALID_EVAL_FLAG;
+  SET_EVAL_VALID (p);
 
   if (l->listNext >= l->listSize) {
     REALCHOKE (l->pList, sizeof (Polynomial *) * (l->listSize + 1000), void *);
@@ -2616,6 +3430,7 @@ void polyListAppend (struct polyList *l, Polynomial * p)
 void doPolyListSorting (Polynomial * p, struct polyList *l)
 {
   int i;
+  Polynomial *term;
 
   switch (p->eType) {
   case T_OFFLINE:
@@ -2629,18 +3444,18 @@ void doPolyListSorting (Polynomial * p, struct polyList *l)
 
     // If the polynomial is a variable, put it in the evaluation list
   case T_VARIABLE:
-    if (!(p->valid & VALID_EVAL_FLAG)) {
+    if (!EVAL_VALID (p)) {
       polyListAppend (l, p);
     }
     break;
 
     // If the polynomial is an external, put it in the evaluation list after all variables
   case T_EXTERNAL:
-    if (p->valid & VALID_EVAL_FLAG)
+    if (EVAL_VALID (p))
       break;
 
     for (i = 0; i < variableCount; i++)
-      if (!(variableList[i]->valid & VALID_EVAL_FLAG))
+      if (!EVAL_VALID (variableList[i]))
         doPolyListSorting (variableList[i], l);
 
     polyListAppend (l, p);
@@ -2650,14 +3465,15 @@ void doPolyListSorting (Polynomial * p, struct polyList *l)
     //except constants and then put the sum in the evaluation list
   case T_SUM:
 
-    if (p->valid & VALID_EVAL_FLAG)
+    if (EVAL_VALID (p))
       break;
 
     importTermList (p);
     for (i = 0; i < p->e.s->num; i++) {
-      if (p->e.s->sum[i]->eType == T_OFFLINE) importPoly (p->e.s->sum[i]);
-      if (p->e.s->sum[i]->eType != T_CONSTANT && (!(p->e.s->sum[i]->valid & VALID_EVAL_FLAG))) {
-        doPolyListSorting (p->e.s->sum[i], l);
+      term = POLY_TERM (p->e.s->sum[i]);
+      if (term->eType == T_OFFLINE) importPoly (term);
+      if (term->eType != T_CONSTANT && !EVAL_VALID (term)) {
+        doPolyListSorting (term, l);
       }
     }
     exportTermList (p, FALSE);
@@ -2669,13 +3485,14 @@ void doPolyListSorting (Polynomial * p, struct polyList *l)
        evaluation list. */
   case T_PRODUCT:
 
-    if (p->valid & VALID_EVAL_FLAG)
+    if (EVAL_VALID (p))
       break;
 
     for (i = 0; i < p->e.p->num; i++) {
-      if (p->e.p->product[i]->eType == T_OFFLINE) importPoly (p->e.p->product[i]);
-      if (p->e.p->product[i]->eType != T_CONSTANT && (!(p->e.p->product[i]->valid & VALID_EVAL_FLAG))) {
-        doPolyListSorting (p->e.p->product[i], l);
+      term = POLY_TERM (p->e.p->product[i]);
+      if (term->eType == T_OFFLINE) importPoly (term);
+      if (term->eType != T_CONSTANT && !EVAL_VALID (term)) {
+        doPolyListSorting (term, l);
       }
     }
     polyListAppend (l, p);
@@ -2685,12 +3502,12 @@ void doPolyListSorting (Polynomial * p, struct polyList *l)
        and then put the functionCall in the evaluation list. */
   case T_FUNCTIONCALL:
 
-    if (p->valid & VALID_EVAL_FLAG)
+    if (EVAL_VALID (p))
       break;
 
     for (i = 0; i < p->e.f->num; i++) {
       if (p->e.f->para[i]->eType == T_OFFLINE) importPoly (p->e.f->para[i]);
-      if (p->e.f->para[i]->eType != T_CONSTANT && (!(p->e.f->para[i]->valid & VALID_EVAL_FLAG))) {
+      if (p->e.f->para[i]->eType != T_CONSTANT && !EVAL_VALID (p->e.f->para[i])) {
         doPolyListSorting (p->e.f->para[i], l);
       }
     }
@@ -2715,9 +3532,1169 @@ void polyListSorting (Polynomial * p, struct polyList *l)
   dependencyFlagging (p);
 #endif
   //  writePolyDigraph(p);
-  /* Clear all of the VALID_EVAL_FLAGs */
+  /* Invalidate all evaluation marks by starting a new epoch */
   clearValidEvalFlag ();
   doPolyListSorting (p, l);
+  l->serial = ++polyListSerial;
+#ifndef NO_POLY_TAPE
+  buildPolyTape (l);
+#endif
+}
+
+/// Pairing of a polynomial with its value[] slot on a tape, for lookup while building
+struct tapeSlot
+{
+  Polynomial *p;
+  int slot;
+};
+
+int compareTapeSlots (const void *left, const void *right)
+{
+  Polynomial *pLeft = ((struct tapeSlot *) left)->p, *pRight = ((struct tapeSlot *) right)->p;
+
+  return (pLeft > pRight) - (pLeft < pRight);
+}
+
+/// Bytes allocated for a tape, for polyMemory
+static unsigned long polyTapeSize (struct polyTape *t)
+{
+  return t->nodeCount * (2 * sizeof (unsigned char) + sizeof (int) + sizeof (Polynomial *)) +
+    t->slotCount * sizeof (double) + t->operandCount * (sizeof (int) + sizeof (double) + sizeof (int)) +
+    (t->variableCount + t->levelCount + 2 * t->rootCount) * sizeof (int) + t->nodeCount * sizeof (uint64_t);
+}
+
+static void releasePolyTape (struct polyTape *t)
+{
+  polyTapeMemory -= polyTapeSize (t);
+  free (t->variable);
+  free (t->dependsOn);
+  free (t->levelFirst);
+  free (t->root);
+  free (t->listSerial);
+  free (t->opCode);
+  free (t->code);
+  free (t->first);
+  free (t->operand);
+  free (t->factor);
+  free (t->exponent);
+  free (t->value);
+  free (t->node);
+  free (t);
+}
+
+/**
+
+  Release the tape compiled for an evaluation list, if any.
+
+*/
+void freePolyTape (struct polyList *l)
+{
+  if (l->tape == NULL)
+    return;
+  releasePolyTape (l->tape);
+  l->tape = NULL;
+}
+
+/**
+
+  Compile polynomials in dependency order into a tape. All we have to
+  do is replace every term reference with the position of the term,
+  which is found by binary search of the polynomials sorted by address.
+  Constant terms aren't on the list, so each reference to one gets its
+  own slot with the value preset.
+
+*/
+static struct polyTape *newPolyTape (int nodeCount, Polynomial **nodes)
+{
+  struct polyTape *t;
+  struct tapeSlot *slots, target, *found;
+  Polynomial *p, *term;
+  int i, j, k, num = 0, constantSlots = 0;
+
+  MALCHOKE(slots, sizeof (struct tapeSlot) * nodeCount, struct tapeSlot *);
+  for (j = 0; j < nodeCount; j++) {
+    slots[j].p = nodes[j];
+    slots[j].slot = j;
+  }
+  qsort (slots, nodeCount, sizeof (struct tapeSlot), compareTapeSlots);
+
+  MALCHOKE(t, sizeof (struct polyTape), struct polyTape *);
+  t->nodeCount = nodeCount;
+  t->operandCount = 0;
+  t->variableCount = 0;
+  t->levelCount = 0;
+  t->levelFirst = NULL;
+  t->wideLevelCount = 0;
+  t->rootCount = 0;
+  t->root = NULL;
+  t->listSerial = NULL;
+  for (j = 0; j < nodeCount; j++) {
+    p = nodes[j];
+    if (p->eType == T_VARIABLE)
+      t->variableCount++;
+    else if (p->eType == T_SUM)
+      t->operandCount += p->e.s->num;
+    else if (p->eType == T_PRODUCT)
+      t->operandCount += p->e.p->num;
+    else if (p->eType == T_FUNCTIONCALL)
+      t->operandCount += p->e.f->num;
+  }
+  MALCHOKE(t->opCode, sizeof (unsigned char) * t->nodeCount, unsigned char *);
+  MALCHOKE(t->first, sizeof (int) * (t->nodeCount + 1), int *);
+  MALCHOKE(t->node, sizeof (Polynomial *) * t->nodeCount, Polynomial **);
+  MALCHOKE(t->operand, sizeof (int) * (t->operandCount + 1), int *);
+  MALCHOKE(t->factor, sizeof (double) * (t->operandCount + 1), double *);
+  MALCHOKE(t->exponent, sizeof (int) * (t->operandCount + 1), int *);
+  // Worst case is every operand being a constant, trimmed once we know better
+  MALCHOKE(t->value, sizeof (double) * (t->nodeCount + t->operandCount), double *);
+
+  k = 0;
+  for (j = 0; j < nodeCount; j++) {
+    p = nodes[j];
+    t->opCode[j] = p->eType;
+    t->node[j] = p;
+    t->first[j] = k;
+    t->value[j] = p->value;
+    switch (p->eType) {
+    case T_SUM:
+      num = p->e.s->num;
+      memcpy (&t->factor[k], p->e.s->factor, sizeof (double) * num);
+      break;
+    case T_PRODUCT:
+      num = p->e.p->num;
+      for (i = 0; i < num; i++)
+	t->exponent[k + i] = p->e.p->exponent[i];
+      break;
+    case T_FUNCTIONCALL:
+      num = p->e.f->num;
+      break;
+    default:
+      num = 0;
+      break;
+    }
+    for (i = 0; i < num; i++, k++) {
+      term = polyTerm (p, i);
+      if (term->eType == T_CONSTANT) {
+        t->operand[k] = t->nodeCount + constantSlots;
+        t->value[t->nodeCount + constantSlots++] = term->value;
+        continue;
+      }
+      target.p = term;
+      if ((found = bsearch (&target, slots, nodeCount, sizeof (struct tapeSlot), compareTapeSlots)) == NULL)
+        FATAL ("Term %d of %s[%d] is not on the evaluation list", i, eTypes[p->eType], p->id);
+      t->operand[k] = found->slot;
+    }
+  }
+  t->first[t->nodeCount] = k;
+  t->slotCount = t->nodeCount + constantSlots;
+  REALCHOKE(t->value, sizeof (double) * t->slotCount, double *);
+  free (slots);
+
+  MALCHOKE(t->variable, sizeof (int) * (t->variableCount + 1), int *);
+  for (j = 0, k = 0; j < t->nodeCount; j++)
+    if (t->opCode[j] == T_VARIABLE)
+      t->variable[k++] = j;
+
+  /* Note which variables each entry depends upon. Operands always come
+   before the entries that use them, so one pass does it. */
+  MALCHOKE(t->dependsOn, sizeof (uint64_t) * (t->nodeCount + 1), uint64_t *);
+  t->incremental = TRUE;
+  t->evaluated = FALSE;
+  for (j = 0, k = 0; j < t->nodeCount; j++) {
+    t->dependsOn[j] = 0;
+    if (t->opCode[j] == T_VARIABLE) {
+      t->dependsOn[j] = TAPE_VARIABLE_BIT (k);
+      k++;
+    } else if (t->opCode[j] == T_EXTERNAL) {
+      // We can't tell what variables a compiled polynomial uses
+      t->dependsOn[j] = ~UINT64_C (0);
+      t->incremental = FALSE;
+    } else
+      for (i = t->first[j]; i < t->first[j + 1]; i++)
+	if (t->operand[i] < t->nodeCount)
+	  t->dependsOn[j] |= t->dependsOn[t->operand[i]];
+  }
+
+  // Specialize each entry's operation for the interpreter
+  MALCHOKE(t->code, sizeof (unsigned char) * (t->nodeCount + 1), unsigned char *);
+  for (j = 0; j < t->nodeCount; j++) {
+    num = t->first[j + 1] - t->first[j];
+    switch (t->opCode[j]) {
+    case T_VARIABLE:
+      p = t->node[j];
+      if (p->e.v->vType == 'D')
+	t->code[j] = TAPE_VARIABLE_D;
+      else if (p->e.v->vType == 'I')
+	t->code[j] = TAPE_VARIABLE_I;
+      else
+	FATAL ("Unknown variable type '%c'", p->e.v->vType);
+      break;
+    case T_EXTERNAL:
+      t->code[j] = TAPE_EXTERNAL;
+      break;
+    case T_SUM:
+      t->code[j] = num == 2 ? TAPE_SUM2 : num < MIN_SIMD_TERMS ? TAPE_SUM : TAPE_SUM_KERNEL;
+      break;
+    case T_PRODUCT:
+      for (i = t->first[j]; i < t->first[j + 1]; i++)
+	if (t->exponent[i] != 1)
+	  break;
+      if (num >= MIN_SIMD_TERMS)
+	t->code[j] = TAPE_PRODUCT_KERNEL;
+      else if (i < t->first[j + 1])
+	t->code[j] = TAPE_PRODUCT;
+      else
+	t->code[j] = num == 2 ? TAPE_PRODUCT2 : TAPE_PRODUCT_LINEAR;
+      break;
+    case T_FUNCTIONCALL:
+      t->code[j] = TAPE_FUNCTIONCALL;
+      break;
+    default:
+      t->code[j] = TAPE_CONSTANT;
+      break;
+    }
+  }
+
+  return t;
+}
+
+/**
+
+  Compile a sorted evaluation list into a tape. This is done once per
+  list, and then every evaluatePoly call walks the tape instead.
+
+*/
+void buildPolyTape (struct polyList *l)
+{
+  freePolyTape (l);
+  if (l->listNext == 0)
+    return;
+  l->tape = newPolyTape (l->listNext, l->pList);
+  polyTapeMemory += polyTapeSize (l->tape);
+}
+
+/**
+
+  Release an evaluation list built by buildPolyList along with any tape
+  compiled for it. The polynomials on the list are not affected.
+
+*/
+void freePolyList (struct polyList *l)
+{
+  freePolyTape (l);
+  free (l->pList);
+  free (l);
+}
+
+/**
+
+  Evaluate a function call given the values of its parameters.
+
+*/
+static inline double functionCallValue (char *name, double *para)
+{
+  if (strcmp (name, "log10") == 0) {
+    return log10 (para[0]);
+  } else if (strcmp (name, "log") == 0) {
+    return log (para[0]);
+  } else if (strcmp (name, "tanh") == 0) {
+    return tanh (para[0]);
+  } else if (strcmp (name, "atanh") == 0) {
+    return atanh (para[0]);
+    /*
+  } else if (strcmp (name, "gsl_ran_tdist_pdf") == 0) {
+    return gsl_ran_tdist_pdf (para[0], para[1]);
+  } else if (strcmp (name, "gsl_cdf_tdist_Q") == 0) {
+    return gsl_cdf_tdist_Q (para[0], para[1]);
+  } else if (strcmp (name, "gsl_cdf_tdist_P") == 0) {
+    return gsl_cdf_tdist_P (para[0], para[1]);
+    */
+  } else if (strcmp (name, "gsl_ran_tdist_pdf") == 0) {
+    return t_pdf_30 (para[0], para[1]);
+  } else if (strcmp (name, "gsl_cdf_tdist_Q") == 0) {
+    return ((double) 1.0) - t_cdf (para[0], para[1]);
+  } else if (strcmp (name, "gsl_cdf_tdist_P") == 0) {
+    return t_cdf (para[0], para[1]);
+    /*
+  } else if (strcmp (name, "gsl_ran_ugaussian_pdf") == 0) {
+    return gsl_ran_ugaussian_pdf (para[0]);
+  } else if (strcmp (name, "gsl_cdf_ugaussian_Q") == 0) {
+    return gsl_cdf_ugaussian_Q (para[0]);
+  } else if (strcmp (name, "gsl_cdf_ugaussian_P") == 0) {
+    return gsl_cdf_ugaussian_P (para[0]);
+    */
+  } else if (strcmp (name, "gsl_ran_ugaussian_pdf") == 0) {
+    return gaussian_pdf (para[0], (double) 0.0, (double) 1.0);
+  } else if (strcmp (name, "gsl_cdf_ugaussian_Q") == 0) {
+    return ((double) 1.0) - gaussian_cdf (para[0], (double) 0.0, (double) 1.0);
+  } else if (strcmp (name, "gsl_cdf_ugaussian_P") == 0) {
+    return gaussian_cdf (para[0], (double) 0.0, (double) 1.0);
+    /*
+  } else if (strcmp (name, "gsl_cdf_chisq_P") == 0) {
+    return gsl_cdf_chisq_P (para[0], para[1]);
+  } else if (strcmp (name, "gsl_cdf_chisq_Q") == 0) {
+    return gsl_cdf_chisq_Q (para[0], para[1]);
+  } else if (strcmp (name, "gsl_ran_chisq_pdf") == 0) {
+    return gsl_ran_chisq_pdf (para[0], para[1]);
+    */
+  } else if (strcmp (name, "gsl_cdf_chisq_P") == 0) {
+    return chisq_cdf (para[0], para[1]);
+  } else if (strcmp (name, "gsl_cdf_chisq_Q") == 0) {
+    return ((double) 1.0) - chisq_cdf (para[0], para[1]);
+  } else if (strcmp (name, "gsl_ran_chisq_pdf") == 0) {
+    return chisq_pdf (para[0], para[1]);
+
+  } else if (strcmp (name, "pow") == 0) {
+    return pow (para[0], para[1]);
+
+  } else if (strcmp (name, "exp") == 0) {
+    return exp (para[0]);
+  } else if (strcmp (name, "sqrt") == 0) {
+    return sqrt (para[0]);
+  } else
+    FATAL ("Unknown function name %s in polynomial", name);
+  return 0;
+}
+
+/**
+
+  Sum and product kernels for tape evaluation. Each reduces the num
+  operands of one entry, gathering their values from the tape's value[]
+  by slot index. The scalar versions give exactly the results of the
+  list-driven loop in evaluatePoly. The vector versions are selected
+  at runtime by polynomialInitialization when the processor supports
+  them, and accumulate in several lanes at once, so results can differ
+  from the scalar ones in the last bits. They must clear the upper
+  vector state before returning to (or calling) code built for plain
+  SSE, since GCC won't do it for target-specific functions and the
+  transition penalty otherwise costs more than the vectors gain.
+
+*/
+static double sumTermsScalar (int num, const int *operand, const double *factor, const double *value)
+{
+  double v = 0;
+  int k;
+
+  for (k = 0; k < num; k++) {
+    if (factor[k] == 1)
+      v += value[operand[k]];
+    else
+      v += value[operand[k]] * factor[k];
+  }
+  return v;
+}
+
+static double productTermsScalar (int num, const int *operand, const int *exponent, const double *value)
+{
+  double v = 1;
+  int k;
+
+  for (k = 0; k < num; k++) {
+    switch (exponent[k]) {
+    case 1:
+      v *= value[operand[k]];
+      break;
+    case 2:
+      v *= value[operand[k]] * value[operand[k]];
+      break;
+    case 3:
+      v *= value[operand[k]] * value[operand[k]] * value[operand[k]];
+      break;
+    case 4:
+      v *= value[operand[k]] * value[operand[k]] * value[operand[k]] * value[operand[k]];
+      break;
+    default:
+      v *= integerPower (value[operand[k]], exponent[k]);
+      break;
+    }
+  }
+  return v;
+}
+
+#ifdef POLY_SIMD
+__attribute__ ((target ("avx2")))
+static double sumTermsAVX2 (int num, const int *operand, const double *factor, const double *value)
+{
+  __m256d acc = _mm256_setzero_pd ();
+  double lane[4], v;
+  int k;
+
+  for (k = 0; k + 4 <= num; k += 4)
+    acc = _mm256_add_pd (acc, _mm256_mul_pd (_mm256_i32gather_pd (value, _mm_loadu_si128 ((const __m128i *) &operand[k]), 8),
+					      _mm256_loadu_pd (&factor[k])));
+  _mm256_storeu_pd (lane, acc);
+  _mm256_zeroupper ();
+  v = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+  for (; k < num; k++)
+    v += value[operand[k]] * factor[k];
+  return v;
+}
+
+__attribute__ ((target ("avx2")))
+static double productTermsAVX2 (int num, const int *operand, const int *exponent, const double *value)
+{
+  const __m256d one = _mm256_set1_pd (1.0);
+  const __m256i lsb = _mm256_set1_epi64x (1);
+  __m256d acc = one, x, power, negative;
+  __m256i e;
+  __m128i e32;
+  double lane[4], v;
+  int k;
+
+  for (k = 0; k + 4 <= num; k += 4) {
+    x = _mm256_i32gather_pd (value, _mm_loadu_si128 ((const __m128i *) &operand[k]), 8);
+    e32 = _mm_loadu_si128 ((const __m128i *) &exponent[k]);
+    negative = _mm256_castsi256_pd (_mm256_cvtepi32_epi64 (_mm_cmplt_epi32 (e32, _mm_setzero_si128 ())));
+    e = _mm256_cvtepi32_epi64 (_mm_abs_epi32 (e32));
+    power = one;
+    while (!_mm256_testz_si256 (e, e)) {
+      power = _mm256_mul_pd (power, _mm256_blendv_pd (one, x, _mm256_castsi256_pd (_mm256_cmpeq_epi64 (_mm256_and_si256 (e, lsb), lsb))));
+      x = _mm256_mul_pd (x, x);
+      e = _mm256_srli_epi64 (e, 1);
+    }
+    power = _mm256_blendv_pd (power, _mm256_div_pd (one, power), negative);
+    acc = _mm256_mul_pd (acc, power);
+  }
+  _mm256_storeu_pd (lane, acc);
+  _mm256_zeroupper ();
+  v = (lane[0] * lane[1]) * (lane[2] * lane[3]);
+  return v * productTermsScalar (num - k, &operand[k], &exponent[k], value);
+}
+
+__attribute__ ((target ("avx512f")))
+static double sumTermsAVX512 (int num, const int *operand, const double *factor, const double *value)
+{
+  __m512d acc = _mm512_setzero_pd ();
+  double v;
+  int k;
+
+  for (k = 0; k + 8 <= num; k += 8)
+    acc = _mm512_add_pd (acc, _mm512_mul_pd (_mm512_i32gather_pd (_mm256_loadu_si256 ((const __m256i *) &operand[k]), value, 8),
+					      _mm512_loadu_pd (&factor[k])));
+  v = _mm512_reduce_add_pd (acc);
+  _mm256_zeroupper ();
+  for (; k < num; k++)
+    v += value[operand[k]] * factor[k];
+  return v;
+}
+
+__attribute__ ((target ("avx512f")))
+static double productTermsAVX512 (int num, const int *operand, const int *exponent, const double *value)
+{
+  const __m512d one = _mm512_set1_pd (1.0);
+  const __m512i lsb = _mm512_set1_epi64 (1);
+  __m512d acc = one, x, power;
+  __m512i e;
+  __m256i e32;
+  __mmask8 negative;
+  double v;
+  int k;
+
+  for (k = 0; k + 8 <= num; k += 8) {
+    x = _mm512_i32gather_pd (_mm256_loadu_si256 ((const __m256i *) &operand[k]), value, 8);
+    e32 = _mm256_loadu_si256 ((const __m256i *) &exponent[k]);
+    e = _mm512_cvtepi32_epi64 (e32);
+    negative = _mm512_cmplt_epi64_mask (e, _mm512_setzero_si512 ());
+    e = _mm512_abs_epi64 (e);
+    power = one;
+    while (_mm512_test_epi64_mask (e, e)) {
+      power = _mm512_mask_mul_pd (power, _mm512_test_epi64_mask (e, lsb), power, x);
+      x = _mm512_mul_pd (x, x);
+      e = _mm512_srli_epi64 (e, 1);
+    }
+    power = _mm512_mask_div_pd (power, negative, one, power);
+    acc = _mm512_mul_pd (acc, power);
+  }
+  v = _mm512_reduce_mul_pd (acc);
+  _mm256_zeroupper ();
+  return v * productTermsScalar (num - k, &operand[k], &exponent[k], value);
+}
+#endif
+
+static double (*sumTermsKernel) (int, const int *, const double *, const double *) = sumTermsScalar;
+static double (*productTermsKernel) (int, const int *, const int *, const double *) = productTermsScalar;
+
+/**
+
+  Pick the widest sum and product kernels the processor can run.
+
+*/
+void selectPolyKernels ()
+{
+#ifdef POLY_SIMD
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx512f")) {
+    sumTermsKernel = sumTermsAVX512;
+    productTermsKernel = productTermsAVX512;
+    DIAG (POLYNOMIAL, 1, {fprintf (stderr, "Using AVX-512 kernels for polynomial evaluation\n");});
+  } else if (__builtin_cpu_supports ("avx2")) {
+    sumTermsKernel = sumTermsAVX2;
+    productTermsKernel = productTermsAVX2;
+    DIAG (POLYNOMIAL, 1, {fprintf (stderr, "Using AVX2 kernels for polynomial evaluation\n");});
+  }
+#endif
+}
+
+/**
+
+  Evaluate entries from thru to-1 of a compiled tape, skipping those
+  that don't depend upon any of the changed variables unless all of
+  them are flagged as changed. Operands of the entries must already
+  have been evaluated. This is the same computation as the list-driven
+  loop in evaluatePoly, term for term and in the same order. Values
+  land in the tape's own value[] and not in the polynomials, so
+  different tapes can be evaluated at the same time even when they
+  share terms, as can independent entries of the same tape.
+
+  This is a threaded-code interpreter: with GCC-compatible compilers
+  each operation ends by jumping directly to the code for the next
+  entry's operation, so there is no central dispatch and the branch
+  predictor gets a chance at the operation sequence. That and the
+  operations specialized by newPolyTape give most of the benefit of
+  generating and compiling code for the polynomial (see codePoly) in
+  none of the time.
+
+*/
+static void runPolyTape (struct polyTape *t, int from, int to, uint64_t changed)
+{
+  const unsigned char *code = t->code;
+  const uint64_t *dependsOn = t->dependsOn;
+  const int *operand = t->operand, *first = t->first;
+  double *value = t->value, v, para[2];
+  int j = from, k, all = (changed == ~UINT64_C (0));
+
+#if defined (__GNUC__) && !defined (NO_POLY_THREADED)
+  static const void *dispatch[TAPE_OPS] = {
+    &&op_TAPE_CONSTANT, &&op_TAPE_VARIABLE_D, &&op_TAPE_VARIABLE_I, &&op_TAPE_EXTERNAL,
+    &&op_TAPE_SUM2, &&op_TAPE_SUM, &&op_TAPE_SUM_KERNEL, &&op_TAPE_PRODUCT2,
+    &&op_TAPE_PRODUCT_LINEAR, &&op_TAPE_PRODUCT, &&op_TAPE_PRODUCT_KERNEL, &&op_TAPE_FUNCTIONCALL
+  };
+#define DISPATCH goto *dispatch[code[j]]
+#else
+#define DISPATCH \
+  switch (code[j]) { \
+  case TAPE_CONSTANT: goto op_TAPE_CONSTANT; \
+  case TAPE_VARIABLE_D: goto op_TAPE_VARIABLE_D; \
+  case TAPE_VARIABLE_I: goto op_TAPE_VARIABLE_I; \
+  case TAPE_EXTERNAL: goto op_TAPE_EXTERNAL; \
+  case TAPE_SUM2: goto op_TAPE_SUM2; \
+  case TAPE_SUM: goto op_TAPE_SUM; \
+  case TAPE_SUM_KERNEL: goto op_TAPE_SUM_KERNEL; \
+  case TAPE_PRODUCT2: goto op_TAPE_PRODUCT2; \
+  case TAPE_PRODUCT_LINEAR: goto op_TAPE_PRODUCT_LINEAR; \
+  case TAPE_PRODUCT: goto op_TAPE_PRODUCT; \
+  case TAPE_PRODUCT_KERNEL: goto op_TAPE_PRODUCT_KERNEL; \
+  case TAPE_FUNCTIONCALL: goto op_TAPE_FUNCTIONCALL; \
+  default: FATAL ("In evaluatePoly, unknown tape operation: [%d]", code[j]); \
+  }
+#endif
+  // Check the result of entry j and move on to the next one that needs evaluation
+#define NEXT \
+  if (isnan (value[j])) \
+    ERROR ("In evaluatePoly, evaluated value of type %d as not a number (NaN)", t->opCode[j]); \
+  while (++j < to && !all && !(dependsOn[j] & changed)); \
+  if (j >= to) \
+    return; \
+  DISPATCH
+
+  // Start with the first entry that needs evaluation
+  for (; j < to && !all && !(dependsOn[j] & changed); j++);
+  if (j >= to)
+    return;
+  DISPATCH;
+
+op_TAPE_CONSTANT:
+  NEXT;
+
+op_TAPE_VARIABLE_D:
+  value[j] = *(t->node[j]->e.v->vAddr.vAddrD);
+  NEXT;
+
+op_TAPE_VARIABLE_I:
+  value[j] = *(t->node[j]->e.v->vAddr.vAddrI);
+  NEXT;
+
+op_TAPE_EXTERNAL:
+#ifdef POLYUSE_DL
+  if (!t->node[j]->e.e->entryOK)
+    if (!loadPolyDL (t->node[j]))
+      FATAL ("Cannot (re)load DL-based polynomial %s for evaluatePoly",
+	     t->node[j]->e.e->polynomialFunctionName);
+  value[j] = t->node[j]->e.e->polynomialFunctionRoutine (1, variableList);
+#endif
+  NEXT;
+
+op_TAPE_SUM2:
+  k = first[j];
+  value[j] = 0.0 + value[operand[k]] * t->factor[k] + value[operand[k + 1]] * t->factor[k + 1];
+  NEXT;
+
+op_TAPE_SUM:
+  k = first[j];
+  value[j] = sumTermsScalar (first[j + 1] - k, &operand[k], &t->factor[k], value);
+  NEXT;
+
+op_TAPE_SUM_KERNEL:
+  k = first[j];
+  value[j] = sumTermsKernel (first[j + 1] - k, &operand[k], &t->factor[k], value);
+  NEXT;
+
+op_TAPE_PRODUCT2:
+  k = first[j];
+  value[j] = value[operand[k]] * value[operand[k + 1]];
+  NEXT;
+
+op_TAPE_PRODUCT_LINEAR:
+  k = first[j];
+  for (v = value[operand[k++]]; k < first[j + 1]; k++)
+    v *= value[operand[k]];
+  value[j] = v;
+  NEXT;
+
+op_TAPE_PRODUCT:
+  k = first[j];
+  value[j] = productTermsScalar (first[j + 1] - k, &operand[k], &t->exponent[k], value);
+  NEXT;
+
+op_TAPE_PRODUCT_KERNEL:
+  k = first[j];
+  value[j] = productTermsKernel (first[j + 1] - k, &operand[k], &t->exponent[k], value);
+  NEXT;
+
+op_TAPE_FUNCTIONCALL:
+  for (k = first[j]; k < first[j + 1] && k - first[j] < 2; k++)
+    para[k - first[j]] = value[operand[k]];
+  value[j] = functionCallValue (t->node[j]->e.f->name, para);
+  NEXT;
+
+#undef NEXT
+#undef DISPATCH
+}
+
+/**
+
+  Read the variables of a compiled tape, and return the set of those
+  whose values have changed since the tape was last evaluated, as
+  TAPE_VARIABLE_BITs. Only entries that depend upon one of them need to
+  be evaluated again, since the rest still hold the values they'd get.
+  All bits are set when everything must be evaluated, i.e. when the
+  tape hasn't been evaluated before (entries that depend upon no
+  variables at all need to be evaluated that once), or when it can't be
+  evaluated incrementally.
+
+*/
+static uint64_t tapeVariableChanges (struct polyTape *t)
+{
+  uint64_t changed = 0;
+  double v;
+  Polynomial *p;
+  int i;
+
+  for (i = 0; i < t->variableCount; i++) {
+    p = t->node[t->variable[i]];
+    if (p->e.v->vType == 'D')
+      v = *(p->e.v->vAddr.vAddrD);
+    else if (p->e.v->vType == 'I')
+      v = *(p->e.v->vAddr.vAddrI);
+    else
+      FATAL ("Unknown variable type '%c'", p->e.v->vType);
+    // Compare representations so that a change in sign of zero counts
+    if (memcmp (&v, &t->value[t->variable[i]], sizeof (double)) != 0) {
+      t->value[t->variable[i]] = v;
+      changed |= TAPE_VARIABLE_BIT (i);
+    }
+  }
+#ifndef NO_POLY_INCREMENTAL
+  if (t->evaluated && t->incremental)
+    return changed;
+#endif
+  t->evaluated = TRUE;
+  return ~UINT64_C (0);
+}
+
+/// Evaluate all entries of a compiled tape affected by changed variables.
+static void evaluatePolyTape (struct polyTape *t)
+{
+  uint64_t changed;
+
+  if ((changed = tapeVariableChanges (t)) != 0)
+    runPolyTape (t, 0, t->nodeCount, changed);
+}
+
+/// Fewest entries in a level worth sharing-out amongst threads
+#define MIN_PARALLEL_LEVEL 64
+
+/**
+
+  Merge the sorted evaluation lists of several polynomials into a
+  single tape, so that terms they share are evaluated only once, and
+  group its entries into dependency levels. Every entry depends only on
+  entries of lower levels, so all of the entries of a level can be
+  evaluated in parallel, which is done by evaluateMergedPolyTape.
+  Entries are evaluated into the tape and never into the polynomials,
+  so there's no contention over shared terms.
+
+  The lists must have been sorted by polyListSorting, and the merged
+  tape must be rebuilt (see mergedPolyTapeIsCurrent) when any of them
+  has been re-sorted or replaced.
+
+*/
+struct polyTape *buildMergedPolyTape (int count, Polynomial **roots, struct polyList **lists)
+{
+  struct polyTape *t;
+  struct tapeSlot *slots, *unique, target, *found;
+  Polynomial *p, *term, **merged, **ordered;
+  int *level, *levelCount, i, j, k, num, total = 0, mergedCount = 0, levels = 0;
+
+  for (i = 0; i < count; i++)
+    total += lists[i]->listNext;
+
+  /* Concatenate all of the lists and keep the first occurrence of each
+   polynomial. Each list is in dependency order, so the terms of any
+   polynomial first occur before it does, and the result is too. */
+  MALCHOKE(slots, sizeof (struct tapeSlot) * (total + 1), struct tapeSlot *);
+  for (i = 0, k = 0; i < count; i++)
+    for (j = 0; j < lists[i]->listNext; j++, k++) {
+      slots[k].p = lists[i]->pList[j];
+      slots[k].slot = k;
+    }
+  qsort (slots, total, sizeof (struct tapeSlot), compareTapeSlots);
+  MALCHOKE(merged, sizeof (Polynomial *) * (total + 1), Polynomial **);
+  for (k = 0; k < total; k++)
+    merged[k] = NULL;
+  for (k = 0; k < total; k++)
+    if (k == 0 || slots[k].p != slots[k - 1].p)
+      merged[slots[k].slot] = slots[k].p;
+  for (k = 0; k < total; k++)
+    if (merged[k] != NULL)
+      merged[mergedCount++] = merged[k];
+
+  /* Find the level of every polynomial, one more than the highest level
+   of any of its terms. Variables and compiled polynomials are level 0. */
+  MALCHOKE(unique, sizeof (struct tapeSlot) * (mergedCount + 1), struct tapeSlot *);
+  for (j = 0; j < mergedCount; j++) {
+    unique[j].p = merged[j];
+    unique[j].slot = j;
+  }
+  qsort (unique, mergedCount, sizeof (struct tapeSlot), compareTapeSlots);
+  MALCHOKE(level, sizeof (int) * (mergedCount + 1), int *);
+  for (j = 0; j < mergedCount; j++) {
+    p = merged[j];
+    level[j] = 0;
+    if (p->eType == T_SUM)
+      num = p->e.s->num;
+    else if (p->eType == T_PRODUCT)
+      num = p->e.p->num;
+    else if (p->eType == T_FUNCTIONCALL)
+      num = p->e.f->num;
+    else
+      continue;
+    for (i = 0; i < num; i++) {
+      term = polyTerm (p, i);
+      if (term->eType == T_CONSTANT)
+	continue;
+      target.p = term;
+      if ((found = bsearch (&target, unique, mergedCount, sizeof (struct tapeSlot), compareTapeSlots)) == NULL)
+        FATAL ("Term %d of %s[%d] is not on any evaluation list", i, eTypes[p->eType], p->id);
+      if (level[found->slot] + 1 > level[j])
+	level[j] = level[found->slot] + 1;
+    }
+    if (level[j] + 1 > levels)
+      levels = level[j] + 1;
+  }
+  if (mergedCount > 0 && levels == 0)
+    levels = 1;
+
+  // Stable counting sort by level keeps the order within each level
+  CALCHOKE(levelCount, sizeof (int), levels + 1, int *);
+  for (j = 0; j < mergedCount; j++)
+    levelCount[level[j] + 1]++;
+  for (i = 0; i < levels; i++)
+    levelCount[i + 1] += levelCount[i];
+  MALCHOKE(ordered, sizeof (Polynomial *) * (mergedCount + 1), Polynomial **);
+  for (j = 0; j < mergedCount; j++)
+    ordered[levelCount[level[j]]++] = merged[j];
+
+  t = newPolyTape (mergedCount, ordered);
+  t->levelCount = levels;
+  MALCHOKE(t->levelFirst, sizeof (int) * (levels + 1), int *);
+  t->levelFirst[0] = 0;
+  for (i = 0; i < levels; i++) {
+    t->levelFirst[i + 1] = levelCount[i];
+    if (t->levelFirst[i + 1] - t->levelFirst[i] >= MIN_PARALLEL_LEVEL)
+      t->wideLevelCount++;
+  }
+
+  /* Now find where each list's polynomial ended-up. Constant ones aren't
+   on their lists at all, so they get slots of their own. */
+  for (j = 0; j < mergedCount; j++) {
+    unique[j].p = ordered[j];
+    unique[j].slot = j;
+  }
+  qsort (unique, mergedCount, sizeof (struct tapeSlot), compareTapeSlots);
+  t->rootCount = count;
+  MALCHOKE(t->root, sizeof (int) * (count + 1), int *);
+  MALCHOKE(t->listSerial, sizeof (int) * (count + 1), int *);
+  REALCHOKE(t->value, sizeof (double) * (t->slotCount + count), double *);
+  for (i = 0; i < count; i++) {
+    t->listSerial[i] = lists[i]->serial;
+    if (roots[i]->eType == T_CONSTANT || lists[i]->listNext == 0) {
+      t->root[i] = t->slotCount;
+      t->value[t->slotCount++] = roots[i]->value;
+      continue;
+    }
+    target.p = roots[i];
+    if ((found = bsearch (&target, unique, mergedCount, sizeof (struct tapeSlot), compareTapeSlots)) == NULL)
+      FATAL ("Polynomial %s[%d] is not on its own evaluation list", eTypes[roots[i]->eType], roots[i]->id);
+    t->root[i] = found->slot;
+  }
+
+  free (slots);
+  free (merged);
+  free (unique);
+  free (level);
+  free (levelCount);
+  free (ordered);
+  polyTapeMemory += polyTapeSize (t);
+  return t;
+}
+
+/**
+
+  Check that a merged tape was built from exactly these evaluation
+  lists as they are now sorted.
+
+*/
+int mergedPolyTapeIsCurrent (struct polyTape *t, int count, struct polyList **lists)
+{
+  int i;
+
+  if (t->rootCount != count)
+    return FALSE;
+  for (i = 0; i < count; i++)
+    if (lists[i] == NULL || lists[i]->serial != t->listSerial[i])
+      return FALSE;
+  return TRUE;
+}
+
+/**
+
+  Evaluate all of the polynomials merged into a tape by
+  buildMergedPolyTape, returning their values in the same order as they
+  were given. Levels are evaluated in turn, with the entries of each
+  wide level divided amongst the threads. Each run of narrower levels
+  is evaluated by one thread in one go, since it isn't worth the
+  threads waiting for each other after every level of it. Without any
+  wide levels, or more than one processor, the threads aren't started.
+
+*/
+void evaluateMergedPolyTape (struct polyTape *t, double *returnValues)
+{
+  uint64_t changed;
+  int i;
+#ifdef _OPENMP
+  int level, from, to, count, thread, threads;
+#endif
+
+  if (((evaluatePolyCount + t->rootCount) & ~0x3FF) != (evaluatePolyCount & ~0x3FF))
+    DETAIL (0, "Evaluating polynomials, currently at %1.2g iterations", (double) evaluatePolyCount + t->rootCount);
+  evaluatePolyCount += t->rootCount;
+#ifdef EVALUATESW
+  swStart (evaluatePolySW);
+#endif
+
+  if ((changed = tapeVariableChanges (t)) != 0) {
+#ifdef _OPENMP
+    // More threads than processors would only wait on each other
+    if ((threads = omp_get_max_threads ()) > omp_get_num_procs ())
+      threads = omp_get_num_procs ();
+    if (threads > 1 && t->wideLevelCount > 0) {
+#pragma omp parallel private(level, from, to, count, thread) firstprivate(threads) num_threads(threads)
+      for (level = 0; level < t->levelCount;) {
+	from = t->levelFirst[level];
+	count = t->levelFirst[level + 1] - from;
+	if (count < MIN_PARALLEL_LEVEL) {
+	  // Levels are in order, so the whole run of narrow ones can go at once
+	  while (level < t->levelCount && t->levelFirst[level + 1] - t->levelFirst[level] < MIN_PARALLEL_LEVEL)
+	    level++;
+	  to = t->levelFirst[level];
+#pragma omp single
+	  runPolyTape (t, from, to, changed);
+	} else {
+	  // Split the level evenly, as schedule(static) would
+	  thread = omp_get_thread_num ();
+	  threads = omp_get_num_threads ();
+	  runPolyTape (t, from + (int) ((long) count * thread / threads),
+		       from + (int) ((long) count * (thread + 1) / threads), changed);
+	  level++;
+#pragma omp barrier
+	}
+      }
+    } else
+#endif
+      // Levels are in order, so a single thread can run them all at once
+      runPolyTape (t, 0, t->nodeCount, changed);
+  }
+  for (i = 0; i < t->rootCount; i++)
+    returnValues[i] = t->value[t->root[i]];
+
+#ifdef EVALUATESW
+  swStop (evaluatePolySW);
+#endif
+}
+
+/// Release a tape built by buildMergedPolyTape.
+void freeMergedPolyTape (struct polyTape *t)
+{
+  if (t != NULL)
+    releasePolyTape (t);
+}
+
+/**
+
+  Get the number of variable values evaluateMergedPolyTapeBatch expects
+  per point.
+
+*/
+int mergedPolyTapeVariableCount (struct polyTape *t)
+{
+  return t->variableCount;
+}
+
+/**
+
+  Copy the current values of the variables of a merged tape into one
+  row of the matrix for evaluateMergedPolyTapeBatch. Set up the
+  variables the usual way for each point and capture them, then
+  evaluate all of the points at once.
+
+*/
+void captureMergedPolyTapeVariables (struct polyTape *t, double *row)
+{
+  Polynomial *p;
+  int v;
+
+  for (v = 0; v < t->variableCount; v++) {
+    p = t->node[t->variable[v]];
+    if (p->e.v->vType == 'D')
+      row[v] = *(p->e.v->vAddr.vAddrD);
+    else if (p->e.v->vType == 'I')
+      row[v] = *(p->e.v->vAddr.vAddrI);
+    else
+      FATAL ("Unknown variable type '%c'", p->e.v->vType);
+  }
+}
+
+/**
+
+  Evaluate every entry of a tape at pointCount points, one row of
+  variableCount values per point. value holds a column of pointCount
+  values for each slot, and constant slots must already be filled-in.
+  varies flags the slots whose values differ between the points, and
+  is filled-in here for the entries.
+
+  Each tape entry is computed for every point before moving on to the
+  next, so the inner loops run over the points with unit stride. An
+  entry whose operands are the same at every point, such as those of
+  the markers alone, is computed once and copied, as incremental
+  evaluation wouldn't compute it again either. Every point sees the
+  same arithmetic as runPolyTape in the same order, so results are
+  identical to evaluating the points one at a time.
+
+*/
+static void runPolyTapeBatch (struct polyTape *t, int pointCount, double *variableValues, double *value, char *varies)
+{
+  double *out, *in, f, para[2];
+  int i, j, k, v, n, end, same;
+
+  v = 0;
+  for (j = 0; j < t->nodeCount; j++) {
+    out = &value[j * pointCount];
+    end = t->first[j + 1];
+    varies[j] = FALSE;
+    if (t->opCode[j] == T_VARIABLE) {
+      for (i = 1; i < pointCount && !varies[j]; i++)
+        if (variableValues[i * t->variableCount + v] != variableValues[v])
+          varies[j] = TRUE;
+    } else
+      for (k = t->first[j]; k < end && !varies[j]; k++)
+        varies[j] = varies[t->operand[k]];
+    n = varies[j] ? pointCount : 1;
+
+    switch (t->opCode[j]) {
+    case T_VARIABLE:
+      for (i = 0; i < n; i++)
+        out[i] = variableValues[i * t->variableCount + v];
+      v++;
+      break;
+
+    case T_EXTERNAL:
+      FATAL ("Batch evaluation of compiled polynomial %s is not supported",
+             t->node[j]->e.e->polynomialFunctionName);
+      break;
+
+    case T_SUM:
+      for (i = 0; i < n; i++)
+        out[i] = 0;
+      for (k = t->first[j]; k < end; k++) {
+        in = &value[t->operand[k] * pointCount];
+        if ((f = t->factor[k]) == 1)
+          for (i = 0; i < n; i++)
+            out[i] += in[i];
+        else
+          for (i = 0; i < n; i++)
+            out[i] += in[i] * f;
+      }
+      break;
+
+    case T_PRODUCT:
+      for (i = 0; i < n; i++)
+        out[i] = 1;
+      for (k = t->first[j]; k < end; k++) {
+        in = &value[t->operand[k] * pointCount];
+        switch (t->exponent[k]) {
+        case 1:
+          for (i = 0; i < n; i++)
+            out[i] *= in[i];
+          break;
+        case 2:
+          for (i = 0; i < n; i++)
+            out[i] *= in[i] * in[i];
+          break;
+        case 3:
+          for (i = 0; i < n; i++)
+            out[i] *= in[i] * in[i] * in[i];
+          break;
+        case 4:
+          for (i = 0; i < n; i++)
+            out[i] *= in[i] * in[i] * in[i] * in[i];
+          break;
+        default:
+          for (i = 0; i < n; i++)
+            out[i] *= integerPower (in[i], t->exponent[k]);
+          break;
+        }
+      }
+      break;
+
+    case T_FUNCTIONCALL:
+      /* Neighbouring points often share a function call's parameters, as
+         the two hypotheses of a point or points along one axis do, and
+         incremental evaluation wouldn't call it again for them either */
+      for (i = 0; i < n; i++) {
+        same = (i > 0);
+        for (k = t->first[j]; k < end && k - t->first[j] < 2; k++) {
+          para[k - t->first[j]] = value[t->operand[k] * pointCount + i];
+          if (same && value[t->operand[k] * pointCount + i - 1] != para[k - t->first[j]])
+            same = FALSE;
+        }
+        out[i] = same ? out[i - 1] : functionCallValue (t->node[j]->e.f->name, para);
+      }
+      break;
+
+    default:
+      FATAL ("In runPolyTapeBatch, unknown expression type: [%d]", t->opCode[j]);
+      break;
+    }
+    for (i = 0; i < n; i++)
+      if (isnan (out[i]))
+        ERROR ("In runPolyTapeBatch, evaluated value of type %d at point %d as not a number (NaN)", t->opCode[j], i);
+    for (i = n; i < pointCount; i++)
+      out[i] = out[0];
+  }
+}
+
+/// Most memory for the slot values of one batch of points
+#define POLY_BATCH_BYTES (16 * 1024 * 1024)
+
+/// Fewest operands times points worth sharing-out amongst threads
+#define MIN_PARALLEL_BATCH (64 * 1024)
+
+/// Evaluate the points from first to first+pointCount of a batch, as many at a time as fit in POLY_BATCH_BYTES
+static void runPolyTapeBatches (struct polyTape *t, int first, int pointCount, double *variableValues, double *returnValues)
+{
+  double *value, *out;
+  char *varies;
+  int batch, last, count, i, j, r;
+
+  if ((batch = POLY_BATCH_BYTES / (sizeof (double) * (t->slotCount + 1))) < 1)
+    batch = 1;
+  if (batch > pointCount)
+    batch = pointCount;
+  MALCHOKE(value, sizeof (double) * (t->slotCount + 1) * batch, double *);
+  MALCHOKE(varies, sizeof (char) * (t->slotCount + 1), char *);
+  for (j = t->nodeCount; j < t->slotCount; j++)
+    varies[j] = FALSE;
+
+  for (last = first + pointCount; first < last; first += count) {
+    count = last - first < batch ? last - first : batch;
+    for (j = t->nodeCount; j < t->slotCount; j++)
+      for (i = 0, out = &value[j * count]; i < count; i++)
+        out[i] = t->value[j];
+    runPolyTapeBatch (t, count, &variableValues[first * t->variableCount], value, varies);
+    for (i = 0; i < count; i++)
+      for (r = 0; r < t->rootCount; r++)
+        returnValues[(first + i) * t->rootCount + r] = value[t->root[r] * count + i];
+  }
+  free (varies);
+  free (value);
+}
+
+/**
+
+  Evaluate all of the polynomials merged into a tape at pointCount
+  points in one pass over it. variableValues holds one row per point of
+  mergedPolyTapeVariableCount values, as filled-in by
+  captureMergedPolyTapeVariables. The values of the polynomials at each
+  point are returned as a row of returnValues, in the order they were
+  given to buildMergedPolyTape. The tape's own values, kept for
+  incremental evaluation by evaluateMergedPolyTape, are left alone.
+
+  Points are independent, each with its own variable values, so with
+  several threads and processors, and enough work between them, each
+  thread evaluates its share of the points in a value matrix of its
+  own. Within a parallel region, as for concurrent integrations, the
+  calling thread evaluates them all.
+
+*/
+void evaluateMergedPolyTapeBatch (struct polyTape *t, int pointCount, double *variableValues, double *returnValues)
+{
+#ifdef _OPENMP
+  int from, to, thread, threads;
+#endif
+
+  if (pointCount < 1)
+    return;
+  // Concurrent integrations evaluate their batches alongside one another
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+  evaluatePolyCount += (long) pointCount * t->rootCount;
+
+#ifdef _OPENMP
+  // More threads than processors would only wait on each other, as they
+  // would within a parallel region, where the processors are already busy
+  if ((threads = omp_get_max_threads ()) > omp_get_num_procs ())
+    threads = omp_get_num_procs ();
+  if (threads > pointCount)
+    threads = pointCount;
+  if (omp_in_parallel ())
+    threads = 1;
+  if (threads > 1 && (long) pointCount * (t->operandCount + t->nodeCount) >= MIN_PARALLEL_BATCH) {
+#pragma omp parallel private(from, to, thread) firstprivate(threads) num_threads(threads)
+    {
+      // Split the points evenly, as schedule(static) would
+      thread = omp_get_thread_num ();
+      threads = omp_get_num_threads ();
+      from = (int) ((long) pointCount * thread / threads);
+      to = (int) ((long) pointCount * (thread + 1) / threads);
+      if (to > from)
+	runPolyTapeBatches (t, from, to - from, variableValues, returnValues);
+    }
+    return;
+  }
+#endif
+  runPolyTapeBatches (t, 0, pointCount, variableValues, returnValues);
 }
 
 /**
@@ -2736,12 +4713,17 @@ void evaluatePoly (Polynomial * pp, struct polyList *l, double *pReturnValue)
   struct sumPoly *sP;
   struct productPoly *pP;
   register int i, j;
-  double v, term;
+  double v, term, para[2];
 #ifdef USE_GMP
   mpf_t mpfV, mpfTerm;
   mpf_init (mpfV);
   mpf_init (mpfTerm);
 #endif
+#ifdef USE_SSD
+  /* Positions of the cold term lists being read ahead, in list order */
+  int prefetchQueue[PREFETCH_TERM_LISTS];
+  int prefetchHead = 0, prefetchCount = 0, ahead = 0;
+#endif
 
   if ((evaluatePolyCount++ & 0x3FF) == 0)
     DETAIL (0, "Evaluating polynomials, currently at %1.2g iterations", (double) evaluatePolyCount);
@@ -2763,6 +4745,23 @@ void evaluatePoly (Polynomial * pp, struct polyList *l, double *pReturnValue)
     return;
   }
 
+  if (l->tape != NULL) {
+    evaluatePolyTape (l->tape);
+    pp->value = l->tape->value[l->tape->nodeCount - 1];
+    if (polynomialDebugLevel >= 10)
+      fprintf (stderr, "...finished evaluatePoly with %G\n", pp->value);
+    *pReturnValue = pp->value;
+#ifdef EVALUATESW
+    swStop (evaluatePolySW);
+#endif
+    return;
+  }
+
+#ifdef USE_SSD
+  while (prefetchCount < PREFETCH_TERM_LISTS && (ahead = prefetchNextTermList (l, ahead)) < l->listNext)
+    prefetchQueue[prefetchCount++] = ahead++;
+#endif
+
   for (j = 0; j <= l->listNext - 1; j++) {
     p = l->pList[j];
     switch (p->eType) {
@@ -2803,20 +4802,29 @@ void evaluatePoly (Polynomial * pp, struct polyList *l, double *pReturnValue)
       v = 0;
 #ifdef USE_GMP
       mpf_set_ui (mpfV, 0UL);
+#endif
+#ifdef USE_SSD
+      // Reaching a read-ahead term list means starting on the next one, so reads overlap the sums
+      if (prefetchCount > 0 && prefetchQueue[prefetchHead] == j) {
+	prefetchHead = (prefetchHead + 1) % PREFETCH_TERM_LISTS;
+	prefetchCount--;
+	if ((ahead = prefetchNextTermList (l, ahead)) < l->listNext)
+	  prefetchQueue[(prefetchHead + prefetchCount++) % PREFETCH_TERM_LISTS] = ahead++;
+      }
 #endif
       importTermList (p);
       sP = p->e.s;
       for (i = 0; i < sP->num; i++) {
         if (sP->factor[i] == 1)
-          term = sP->sum[i]->value;
+          term = POLY_TERM (sP->sum[i])->value;
         else
-          term = sP->sum[i]->value * sP->factor[i];
+          term = POLY_TERM (sP->sum[i])->value * sP->factor[i];
 #ifdef USE_GMP
         if (sP->factor[i] == 1)
-          mpf_set (mpfTerm, sP->sum[i]->mpfValue);
+          mpf_set (mpfTerm, POLY_TERM (sP->sum[i])->mpfValue);
         else {
 	  mpf_set_d (mpfTerm, sP->factor[i]);
-          mpf_mul (mpfTerm, sP->sum[i]->mpfValue, mpfTerm);
+          mpf_mul (mpfTerm, POLY_TERM (sP->sum[i])->mpfValue, mpfTerm);
 	}
 #endif
 	
@@ -2830,7 +4838,7 @@ void evaluatePoly (Polynomial * pp, struct polyList *l, double *pReturnValue)
 	  fprintf (stderr, "Total precision loss (abs(%d-%d) = %d of 52 bits) in addition %d of %g and %g from  %d terms:\n", 
 		   abs(vPower), abs(termPower), abs(vPower - termPower), i, v, term, sP->num);
 	  for (j = 0; j < sP->num; j++)
-	    fprintf (stderr, "%c %g*%g ",  j > 0 ? '+' : ' ', sP->factor[j], sP->sum[j]->value);
+	    fprintf (stderr, "%c %g*%g ",  j > 0 ? '+' : ' ', sP->factor[j], POLY_TERM (sP->sum[j])->value);
 	  fprintf (stderr, "\n");
 	}
 	*/
@@ -2851,21 +4859,22 @@ void evaluatePoly (Polynomial * pp, struct polyList *l, double *pReturnValue)
       pP = p->e.p;
       v = 1;
       for (i = 0; i < pP->num; i++) {
+        term = POLY_TERM (pP->product[i])->value;
         switch (pP->exponent[i]) {
         case 1:
-          v *= pP->product[i]->value;
+          v *= term;
           break;
         case 2:
-          v *= pP->product[i]->value * pP->product[i]->value;
+          v *= term * term;
           break;
         case 3:
-          v *= pP->product[i]->value * pP->product[i]->value * pP->product[i]->value;
+          v *= term * term * term;
           break;
         case 4:
-          v *= pP->product[i]->value * pP->product[i]->value * pP->product[i]->value * pP->product[i]->value;
+          v *= term * term * term * term;
           break;
         default:
-          v *= pow (pP->product[i]->value, pP->exponent[i]);
+          v *= integerPower (term, pP->exponent[i]);
           break;
         }
       }
@@ -2873,7 +4882,7 @@ void evaluatePoly (Polynomial * pp, struct polyList *l, double *pReturnValue)
 #ifdef USE_GMP
       mpf_set_ui (mpfV, 1UL);
       for (i = 0; i < pP->num; i++) {
-	mpf_pow_ui (mpfTerm, pP->product[i]->mpfValue, pP->exponent[i]);
+	mpf_pow_ui (mpfTerm, POLY_TERM (pP->product[i])->mpfValue, pP->exponent[i]);
 	mpf_mul (mpfV, mpfV, mpfTerm);
       }
       mpf_set (p->mpfValue, mpfV);
@@ -2884,66 +4893,9 @@ void evaluatePoly (Polynomial * pp, struct polyList *l, double *pReturnValue)
       //The referred function must be included in the linked library.
       //Otherwise, the program will exit.
     case T_FUNCTIONCALL:
-      if (strcmp (p->e.f->name, "log10") == 0) {
-        p->value = log10 (p->e.f->para[0]->value);
-      } else if (strcmp (p->e.f->name, "log") == 0) {
-        p->value = log (p->e.f->para[0]->value);
-      } else if (strcmp (p->e.f->name, "tanh") == 0) {
-        p->value = tanh (p->e.f->para[0]->value);
-      } else if (strcmp (p->e.f->name, "atanh") == 0) {
-        p->value = atanh (p->e.f->para[0]->value);
-	/*
-      } else if (strcmp (p->e.f->name, "gsl_ran_tdist_pdf") == 0) {
-        p->value = gsl_ran_tdist_pdf (p->e.f->para[0]->value, p->e.f->para[1]->value);
-      } else if (strcmp (p->e.f->name, "gsl_cdf_tdist_Q") == 0) {
-        p->value = gsl_cdf_tdist_Q (p->e.f->para[0]->value, p->e.f->para[1]->value);
-      } else if (strcmp (p->e.f->name, "gsl_cdf_tdist_P") == 0) {
-        p->value = gsl_cdf_tdist_P (p->e.f->para[0]->value, p->e.f->para[1]->value);
-	*/
-      } else if (strcmp (p->e.f->name, "gsl_ran_tdist_pdf") == 0) {
-        p->value = t_pdf_30 (p->e.f->para[0]->value, p->e.f->para[1]->value);
-      } else if (strcmp (p->e.f->name, "gsl_cdf_tdist_Q") == 0) {
-        p->value = ((double) 1.0) - t_cdf (p->e.f->para[0]->value, p->e.f->para[1]->value);
-      } else if (strcmp (p->e.f->name, "gsl_cdf_tdist_P") == 0) {
-        p->value = t_cdf (p->e.f->para[0]->value, p->e.f->para[1]->value);
-	/*
-      } else if (strcmp (p->e.f->name, "gsl_ran_ugaussian_pdf") == 0) {
-        p->value = gsl_ran_ugaussian_pdf (p->e.f->para[0]->value);
-      } else if (strcmp (p->e.f->name, "gsl_cdf_ugaussian_Q") == 0) {
-        p->value = gsl_cdf_ugaussian_Q (p->e.f->para[0]->value);
-      } else if (strcmp (p->e.f->name, "gsl_cdf_ugaussian_P") == 0) {
-        p->value = gsl_cdf_ugaussian_P (p->e.f->para[0]->value);
-	*/
-      } else if (strcmp (p->e.f->name, "gsl_ran_ugaussian_pdf") == 0) {
-        p->value = gaussian_pdf (p->e.f->para[0]->value, (double) 0.0, (double) 1.0);
-      } else if (strcmp (p->e.f->name, "gsl_cdf_ugaussian_Q") == 0) {
-        p->value = ((double) 1.0) - gaussian_cdf (p->e.f->para[0]->value, (double) 0.0, (double) 1.0);
-      } else if (strcmp (p->e.f->name, "gsl_cdf_ugaussian_P") == 0) {
-        p->value = gaussian_cdf (p->e.f->para[0]->value, (double) 0.0, (double) 1.0);
-	/*
-      } else if (strcmp (p->e.f->name, "gsl_cdf_chisq_P") == 0) {
-        p->value = gsl_cdf_chisq_P (p->e.f->para[0]->value, p->e.f->para[1]->value);
-      } else if (strcmp (p->e.f->name, "gsl_cdf_chisq_Q") == 0) {
-        p->value = gsl_cdf_chisq_Q (p->e.f->para[0]->value, p->e.f->para[1]->value);
-      } else if (strcmp (p->e.f->name, "gsl_ran_chisq_pdf") == 0) {
-        p->value = gsl_ran_chisq_pdf (p->e.f->para[0]->value, p->e.f->para[1]->value);
-	*/
-      } else if (strcmp (p->e.f->name, "gsl_cdf_chisq_P") == 0) {
-        p->value = chisq_cdf (p->e.f->para[0]->value, p->e.f->para[1]->value);
-      } else if (strcmp (p->e.f->name, "gsl_cdf_chisq_Q") == 0) {
-        p->value = ((double) 1.0) - chisq_cdf (p->e.f->para[0]->value, p->e.f->para[1]->value);
-      } else if (strcmp (p->e.f->name, "gsl_ran_chisq_pdf") == 0) {
-        p->value = chisq_pdf (p->e.f->para[0]->value, p->e.f->para[1]->value);
-
-      } else if (strcmp (p->e.f->name, "pow") == 0) {
-        p->value = pow (p->e.f->para[0]->value, p->e.f->para[1]->value);
-
-      } else if (strcmp (p->e.f->name, "exp") == 0) {
-        p->value = exp (p->e.f->para[0]->value);
-      } else if (strcmp (p->e.f->name, "sqrt") == 0) {
-        p->value = sqrt (p->e.f->para[0]->value);
-      } else
-        FATAL ("Unknown function name %s in polynomial", p->e.f->name);
+      for (i = 0; i < p->e.f->num && i < 2; i++)
+        para[i] = p->e.f->para[i]->value;
+      p->value = functionCallValue (p->e.f->name, para);
 #ifdef USE_GMP
       mpf_set_d (p->mpfValue, p->value);
 #endif
@@ -3002,6 +4954,8 @@ void polynomialInitialization (int newPolynomialScale)
   // Get our maximum so we can react to depletion.
   maximumPMK = swGetMaximumPMK ();
 
+  selectPolyKernels ();
+
 #ifdef FREEDEBUG
 #warning "freePoly protection is turned on, so memory will purposefully leak!"
   swLogMsg (stdout, "freePoly protection is turned on, so memory will purposefully leak!");
@@ -3034,10 +4988,6 @@ void polynomialInitialization (int newPolynomialScale)
 
 #ifdef USE_SSD
   initSSD ();
-  for (i=0; i<IMTL_COUNT; i++) {
-    iMTL[i].cT.doublePairCount = 0;
-    iMTL[i].lastNodeId = 0;
-  }
 #endif
 
 #ifdef USE_GMP
@@ -3066,6 +5016,37 @@ void polynomialInitialization (int newPolynomialScale)
   FUNCTIONCALL_LIST_INITIAL = MIN_FUNCTIONCALL_LIST_INITIAL * polynomialScale;
   FUNCTIONCALL_LIST_INCREASE = MIN_FUNCTIONCALL_LIST_INCREASE * polynomialScale;
 
+  // Slabs grow with the lists, but stay a power of 2 so structures can find theirs
+  for (polySlabSize = MIN_POLY_SLAB_SIZE; polySlabSize < MIN_POLY_SLAB_SIZE * polynomialScale; polySlabSize *= 2);
+  for (i = 0; i < sizeof (handleArena) / sizeof (handleArena[0]); i++) {
+    handleArena[i]->size = sizeof (Polynomial);
+    handleArena[i]->handles = TRUE;
+    handleArena[i]->handleType = i;
+  }
+  for (polyHandleSlotBits = 0; 1U << polyHandleSlotBits < (polySlabSize - POLY_SLAB_HEADER) / sizeof (Polynomial);
+       polyHandleSlotBits++);
+  sumPolyArena.size = sizeof (struct sumPoly);
+  productPolyArena.size = sizeof (struct productPoly);
+  for (i = 0; i < POLY_TERM_CLASSES; i++)
+    sumTermArena[i].size = productTermArena[i].size = (i + 1) * sizeof (double);
+#ifndef NO_POLY_CONCURRENT_BUILD
+  for (i = 0; i < 6; i++)
+    allPolyArenas[i] = handleArena[i];
+  allPolyArenas[6] = &sumPolyArena;
+  allPolyArenas[7] = &productPolyArena;
+  for (i = 0; i < POLY_TERM_CLASSES; i++) {
+    allPolyArenas[8 + 2 * i] = &sumTermArena[i];
+    allPolyArenas[9 + 2 * i] = &productTermArena[i];
+  }
+  for (i = 0; i < POLY_ARENAS; i++) {
+    allPolyArenas[i]->number = i;
+    omp_init_lock (&allPolyArenas[i]->lock);
+  }
+  for (i = 0; i < POLY_HASH_STRIPES; i++)
+    omp_init_lock (&polyHashStripes[i]);
+  omp_init_lock (&polyListLock);
+#endif
+
   if ((envVar = getenv ("polynomialLostNodeId")) != NULL) {
     polynomialLostNodeId = atoi (envVar);
   }
@@ -3228,36 +5209,39 @@ void polynomialClearance ()
   nodeId = 0;
   // Clear constant polynomials
   for (j = 0; j < constantCount; j++)
-    free (constantList[j]);
+    polyArenaFree (&constantArena, constantList[j]);
+  releasePolyArenaSlabs (&constantArena);
   constantCount = 0;
   // Clear variable polynomials
   for (j = 0; j < variableCount; j++) {
     free (variableList[j]->e.v);
-    free (variableList[j]);
+    polyArenaFree (&variableArena, variableList[j]);
   }
   variableCount = 0;
   // Clear sum polynomials
   for (j = 0; j < sumCount; j++) {
-    free (sumList[j]->e.s->sum);
-    free (sumList[j]->e.s->factor);
-    free (sumList[j]->e.s);
-    free (sumList[j]);
+    polyTermFree (SUM_TERM_ARENA, sumList[j]->e.s->sum, sumList[j]->e.s->num * sizeof (polyHandle));
+    polyTermFree (SUM_TERM_ARENA, sumList[j]->e.s->factor, sumList[j]->e.s->num * sizeof (double));
+    polyArenaFree (&sumPolyArena, sumList[j]->e.s);
+    polyArenaFree (&sumArena, sumList[j]);
   }
+  releaseSumArenaSlabs ();
   sumCount = 0;
   // Clear product polynomials
   for (j = 0; j < productCount; j++) {
-    free (productList[j]->e.p->product);
-    free (productList[j]->e.p->exponent);
-    free (productList[j]->e.p);
-    free (productList[j]);
+    polyTermFree (productTermArena, productList[j]->e.p->product, productList[j]->e.p->num * sizeof (polyHandle));
+    polyTermFree (productTermArena, productList[j]->e.p->exponent, productList[j]->e.p->num * sizeof (polyExponent));
+    polyArenaFree (&productPolyArena, productList[j]->e.p);
+    polyArenaFree (&productArena, productList[j]);
   }
+  releaseProductArenaSlabs ();
   productCount = 0;
   // Clear function call polynomials
   for (j = 0; j < functionCallCount; j++) {
     free (functionCallList[j]->e.f->name);
     free (functionCallList[j]->e.f->para);
     free (functionCallList[j]->e.f);
-    free (functionCallList[j]);
+    polyArenaFree (&functionCallArena, functionCallList[j]);
   }
   functionCallCount = 0;
   // Release memory occupied by constant hash table
@@ -3352,9 +5336,9 @@ void doPrintSummaryPoly (Polynomial * p, int currentTier)
   int i;
 
   if (p->eType == T_OFFLINE) importPoly (p);
-  if (p->valid & VALID_EVAL_FLAG)
+  if (EVAL_VALID (p))
     return;
-  p->valid |= VALID_EVAL_FLAG;
+  SET_EVAL_VALID (p);
 
   if (currentTier > peakPolyTiers)
     peakPolyTiers = currentTier;
@@ -3373,13 +5357,13 @@ void doPrintSummaryPoly (Polynomial * p, int currentTier)
   case T_SUM:
     importTermList (p);
     for (i = 0; i < p->e.s->num; i++) {
-      doPrintSummaryPoly (p->e.s->sum[i], currentTier + 1);
+      doPrintSummaryPoly (POLY_TERM (p->e.s->sum[i]), currentTier + 1);
     }
     exportTermList (p, FALSE);
     break;
   case T_PRODUCT:
     for (i = 0; i < p->e.p->num; i++) {
-      doPrintSummaryPoly (p->e.p->product[i], currentTier + 1);
+      doPrintSummaryPoly (POLY_TERM (p->e.p->product[i]), currentTier + 1);
     }
     break;
   case T_FUNCTIONCALL:
@@ -3493,9 +5477,9 @@ void doWritePolyDigraph (Polynomial * p, FILE * diGraph)
 {
   int i;
 
-  if (p->valid & VALID_EVAL_FLAG)
+  if (EVAL_VALID (p))
     return;
-  p->valid |= VALID_EVAL_FLAG;
+  SET_EVAL_VALID (p);
 
   switch (p->eType) {
   case T_OFFLINE:
@@ -3519,8 +5503,8 @@ void doWritePolyDigraph (Polynomial * p, FILE * diGraph)
     fprintf (diGraph, "%d [label=\"+\"];\n", p->id);
     importTermList (p);
     for (i = 0; i < p->e.s->num; i++) {
-      doWritePolyDigraph (p->e.s->sum[i], diGraph);
-      fprintf (diGraph, "%d -> %d;\n", p->id, p->e.s->sum[i]->id);
+      doWritePolyDigraph (POLY_TERM (p->e.s->sum[i]), diGraph);
+      fprintf (diGraph, "%d -> %d;\n", p->id, POLY_TERM (p->e.s->sum[i])->id);
     }
     exportTermList (p, FALSE);
     break;
@@ -3531,8 +5515,8 @@ void doWritePolyDigraph (Polynomial * p, FILE * diGraph)
     }
     fprintf (diGraph, "%d [label=\"*\"];\n", p->id);
     for (i = 0; i < p->e.p->num; i++) {
-      doWritePolyDigraph (p->e.p->product[i], diGraph);
-      fprintf (diGraph, "%d -> %d;\n", p->id, p->e.p->product[i]->id);
+      doWritePolyDigraph (POLY_TERM (p->e.p->product[i]), diGraph);
+      fprintf (diGraph, "%d -> %d;\n", p->id, POLY_TERM (p->e.p->product[i])->id);
     }
     break;
   case T_FUNCTIONCALL:
@@ -3635,6 +5619,11 @@ void polyDynamicStatistics (char *title)
   fprintf (stderr,
 	   "TermCount: %ld NodeId: %ld Hash: max len=%d, init size=%lu, SPL: eff=%lu%%, avg len=%lu\n", termCount, nodeId, maxHashLength, initialHashSize, 100 * (lowSPLCount + highSPLCount) / (totalSPLCalls ? totalSPLCalls : 1), totalSPLLengths / (totalSPLCalls ? totalSPLCalls : 1));
 
+  fprintf (stderr,
+      "Slabs: %.1fMb in %luKb slabs for c=%lu, s=%lu/%lu, p=%lu/%lu\n",
+      polyArenaMemory () / (1024 * 1024), (unsigned long) polySlabSize / 1024, constantArena.inUse,
+      sumArena.inUse, sumPolyArena.inUse, productArena.inUse, productPolyArena.inUse);
+
   fprintf (stderr,
       "Calls: pLS=%d eP=%ld eV=%ld hAP=%d kP=%d hP=%d uHP=%d fP=%d(%d) fKP=%d\n",
       polyListSortingCount, evaluatePolyCount, evaluateValueCount, holdAllPolysCount, keepPolyCount, holdPolyCount, unHoldPolyCount, freePolysAttemptCount, freePolysCount, freeKeptPolysCount);
@@ -3764,8 +5753,9 @@ void polyStatistics (char *title)
 
   grandTotal = constantHashSize + variableHashSize + sumHashSize + productHashSize +
       functionCallHashSize + constantSize + variableSize +
-      sumSize + (sumTerms * (sizeof (Polynomial *) + sizeof (double))) +
-      productSize + (productTerms * (sizeof (Polynomial *) + sizeof (int))) + functionCallSize + ((constantListLength + variableListLength + sumListLength + productListLength + functionCallListLength) * sizeof (void *));
+      sumSize + (sumTerms * (sizeof (polyHandle) + sizeof (double))) +
+      productSize + (productTerms * (sizeof (polyHandle) + sizeof (polyExponent))) + functionCallSize + ((constantListLength + variableListLength + sumListLength + productListLength + functionCallListLength) * sizeof (void *)) +
+      polyTapeMemory;
 
   fprintf (stderr, "---Total data storage estimate: %.0fKb---\n", grandTotal / 1024);
 
@@ -3841,8 +5831,9 @@ double polyMemory ()
 
   grandTotal = constantHashSize + variableHashSize + sumHashSize + productHashSize +
       functionCallHashSize + constantSize + variableSize +
-      sumSize + (sumTerms * (sizeof (Polynomial *) + sizeof (double))) +
-      productSize + (productTerms * (sizeof (Polynomial *) + sizeof (int))) + functionCallSize + ((constantListLength + variableListLength + sumListLength + productListLength + functionCallListLength) * sizeof (void *));
+      sumSize + (sumTerms * (sizeof (polyHandle) + sizeof (double))) +
+      productSize + (productTerms * (sizeof (polyHandle) + sizeof (polyExponent))) + functionCallSize + ((constantListLength + variableListLength + sumListLength + productListLength + functionCallListLength) * sizeof (void *)) +
+      polyTapeMemory;
 
   return (grandTotal);
 }
@@ -4063,14 +6054,18 @@ void doKeepPoly (Polynomial * p)
   case T_SUM:
     importTermList (p);
     for (i = 0; i < p->e.s->num; i++) {
-      doKeepPoly (p->e.s->sum[i]);
+      doKeepPoly (POLY_TERM (p->e.s->sum[i]));
     }
     exportTermList (p, FALSE);
     break;
   case T_PRODUCT:
-  case T_FUNCTIONCALL:
     for (i = 0; i < p->e.p->num; i++) {
-      doKeepPoly (p->e.p->product[i]);
+      doKeepPoly (POLY_TERM (p->e.p->product[i]));
+    }
+    break;
+  case T_FUNCTIONCALL:
+    for (i = 0; i < p->e.f->num; i++) {
+      doKeepPoly (p->e.f->para[i]);
     }
     break;
   case T_FREED:
@@ -4087,6 +6082,9 @@ void keepPoly (Polynomial * p)
   //  writePolyDigraph(p);
   if (p->valid & VALID_KEEP_FLAG)
     return;
+  // Nothing is freed until the concurrent build is over, and then only what's held
+  if (POLY_CONCURRENT)
+    return;
   keepPolyCount++;
   if (polynomialDebugLevel >= 10)
     fprintf (stderr, "Into keepPoly\n");
@@ -4101,9 +6099,9 @@ void doHoldPoly (Polynomial * p)
 {
   int i;
 
-  if (p->valid & VALID_EVAL_FLAG)
+  if (EVAL_VALID (p))
     return;
-  p->valid |= VALID_EVAL_FLAG;
+  SET_EVAL_VALID (p);
 
   if (p->id == polynomialLostNodeId)
     fprintf (stderr, "holdPoly sees id %d and is bumping hold count from %d\n", polynomialLostNodeId, p->count);
@@ -4122,15 +6120,20 @@ void doHoldPoly (Polynomial * p)
     importTermList (p);
     p->count++;
     for (i = 0; i < p->e.s->num; i++) {
-      doHoldPoly (p->e.s->sum[i]);
+      doHoldPoly (POLY_TERM (p->e.s->sum[i]));
     }
     exportTermList (p, FALSE);
     break;
   case T_PRODUCT:
-  case T_FUNCTIONCALL:
     p->count++;
     for (i = 0; i < p->e.p->num; i++) {
-      doHoldPoly (p->e.p->product[i]);
+      doHoldPoly (POLY_TERM (p->e.p->product[i]));
+    }
+    break;
+  case T_FUNCTIONCALL:
+    p->count++;
+    for (i = 0; i < p->e.f->num; i++) {
+      doHoldPoly (p->e.f->para[i]);
     }
     break;
   default:
@@ -4157,9 +6160,9 @@ void doUnHoldPoly (Polynomial * p)
 {
   int i;
 
-  if (p->valid & VALID_EVAL_FLAG)
+  if (EVAL_VALID (p))
     return;
-  p->valid |= VALID_EVAL_FLAG;
+  SET_EVAL_VALID (p);
 
   if (p->id == polynomialLostNodeId)
     fprintf (stderr, "UnHoldPoly sees id %d and is decrementing hold count from %d\n",
@@ -4170,51 +6173,224 @@ void doUnHoldPoly (Polynomial * p)
     importPoly(p);
     // Notice that there's no break here...
 
-  case T_CONSTANT:
-  case T_VARIABLE:
-  case T_EXTERNAL:
-    p->count--;
-    break;
-  case T_SUM:
-    p->count--;
-    importTermList (p);
-    for (i = 0; i < p->e.s->num; i++) {
-      doUnHoldPoly (p->e.s->sum[i]);
-    }
-    exportTermList (p, FALSE);
-    break;
-  case T_PRODUCT:
-  case T_FUNCTIONCALL:
-    p->count--;
-    for (i = 0; i < p->e.p->num; i++) {
-      doUnHoldPoly (p->e.p->product[i]);
+  case T_CONSTANT:
+  case T_VARIABLE:
+  case T_EXTERNAL:
+    p->count--;
+    break;
+  case T_SUM:
+    p->count--;
+    importTermList (p);
+    for (i = 0; i < p->e.s->num; i++) {
+      doUnHoldPoly (POLY_TERM (p->e.s->sum[i]));
+    }
+    exportTermList (p, FALSE);
+    break;
+  case T_PRODUCT:
+    p->count--;
+    for (i = 0; i < p->e.p->num; i++) {
+      doUnHoldPoly (POLY_TERM (p->e.p->product[i]));
+    }
+    break;
+  case T_FUNCTIONCALL:
+    p->count--;
+    for (i = 0; i < p->e.f->num; i++) {
+      doUnHoldPoly (p->e.f->para[i]);
+    }
+    break;
+  default:
+    FATAL ("In holdPoly, unknown expression type %d", p->eType);
+  }
+  return;
+}
+
+void unHoldPoly (Polynomial * p)
+{
+  unHoldPolyCount++;
+  // Probably should do a clearSubtreeValidEvalFlag (p) call instead
+  clearValidEvalFlag ();
+  doUnHoldPoly (p);
+  // The held generation could have garbage in it now
+  heldPolysReleased = TRUE;
+  return;
+}
+
+/**
+
+  Release one of the constants, variables, sums or products that a
+  collection found to be garbage.
+
+*/
+static void releaseConstantPoly (Polynomial * p)
+{
+#ifndef FREEDEBUG
+  polyArenaFree (&constantArena, p);
+#else
+  // These are for debugging mis-freed pointers
+  p->value = p->eType;
+  p->eType = T_FREED;
+#endif
+}
+
+#ifdef VARIABLE_C_MESSES_UP_COMPILED_DL_ARGUMENTS
+static void releaseVariablePoly (Polynomial * p)
+{
+#ifndef FREEDEBUG
+#ifdef USE_GMP
+  mpf_clear (p->mpfValue);
+#endif
+  polyArenaFree (&variableArena, p);
+#else
+  // These are for debugging mis-freed pointers
+  p->value = p->eType;
+  p->eType = T_FREED;
+#endif
+}
+#endif
+
+static void releaseSumPoly (Polynomial * p)
+{
+  sumFreedCount++;
+#ifndef USE_SSD
+  polyTermFree (SUM_TERM_ARENA, p->e.s->sum, p->e.s->num * sizeof (polyHandle));
+  polyTermFree (SUM_TERM_ARENA, p->e.s->factor, p->e.s->num * sizeof (double));
+#else
+  deportTermList (p);
+#endif
+  polyArenaFree (&sumPolyArena, p->e.s);
+#ifndef FREEDEBUG
+#ifdef USE_GMP
+  mpf_clear (p->mpfValue);
+#endif
+  polyArenaFree (&sumArena, p);
+#else
+  // These are for debugging mis-freed pointers
+  p->value = p->eType;
+  p->eType = T_FREED;
+#endif
+}
+
+static void releaseProductPoly (Polynomial * p)
+{
+  productFreedCount++;
+  polyTermFree (productTermArena, p->e.p->product, p->e.p->num * sizeof (polyHandle));
+  polyTermFree (productTermArena, p->e.p->exponent, p->e.p->num * sizeof (polyExponent));
+  polyArenaFree (&productPolyArena, p->e.p);
+#ifndef FREEDEBUG
+#ifdef USE_GMP
+  mpf_clear (p->mpfValue);
+#endif
+  polyArenaFree (&productArena, p);
+#else
+  // These are for debugging mis-freed pointers
+  p->value = p->eType;
+  p->eType = T_FREED;
+#endif
+}
+
+/**
+
+  Find the hash table entry of the polynomial at position oldIndex of its list. Entries
+  of polynomials with the same key are adjacent, so only they need to be looked at.
+
+*/
+static struct hashStruct *findHashEntry (struct hashStruct *hash, int hashSize, int key, int oldIndex,
+					 int *location)
+{
+  struct hashStruct *bucket;
+  int hIndex, start, end;
+
+  hIndex = key % hashSize;
+  if (hIndex < 0)
+    hIndex += hashSize;
+  bucket = &hash[hIndex];
+  if (searchHashTable (bucket, &start, &end, key))
+    for (*location = start; *location <= end; (*location)++)
+      if (bucket->index[*location] == oldIndex)
+	return bucket;
+  FATAL ("Polynomial at list position %d with key %d is missing from its hash table", oldIndex, key);
+  return NULL;
+}
+
+/**
+
+  Collect the garbage among the polynomials from position from of a list
+  on, and return how many of the list's polynomials are left. Those
+  left are slid down over the garbage as it goes, and their hash table
+  entries follow them, so the cost is in proportion to what's looked
+  at, not to the whole population.
+
+*/
+static int collectPolyList (Polynomial ** list, int count, int from, struct hashStruct *hash, int hashSize,
+			    unsigned short keepMask, void (*release) (Polynomial *))
+{
+  int i, k, location;
+  struct hashStruct *bucket;
+  Polynomial *p;
+
+  k = from;
+  for (i = from; i < count; i++) {
+    p = list[i];
+    if (p->eType == T_OFFLINE) importPoly (p);
+    if (p->id == polynomialLostNodeId)
+      fprintf (stderr, "doFreePolys sees id %d with valid %d and count %d during pass with mask %d\n",
+	       polynomialLostNodeId, p->valid, p->count, keepMask);
+    bucket = findHashEntry (hash, hashSize, p->key, i, &location);
+    if ((p->count > 0) || (POLY_FLAGS (p) & keepMask)) {
+      // It's a keeper, slide it down
+      bucket->index[location] = k;
+      p->index = k;
+      list[k++] = p;
+    } else {
+      deleteHashTable (bucket, location);
+      release (p);
     }
-    break;
-  default:
-    FATAL ("In holdPoly, unknown expression type %d", p->eType);
   }
-  return;
+  return k;
 }
 
-void unHoldPoly (Polynomial * p)
+/*
+
+  Polynomials are collected by generation. Each type's list is in the
+  order the polynomials were made in, and a collection slides the ones
+  left down to the front, so the list is always oldest first. The
+  polynomials made since the last collection (the young) are mostly
+  temporaries of one peel, and are all that freePolys has to look at,
+  since older ones had to be kept or held to survive, and stay that
+  way. Survivors of freePolys are promoted to the kept generation, and
+  of freeKeptPolys to the held generation. Only freeKeptPolys looks at
+  the kept generation, since that's when keeps expire, and only after
+  an unHoldPoly does it look at the held generation too. Explicit
+  discards are collected from the young without promoting any of them,
+  since they survive on flags that don't last.
+
+  Garbage in an older generation than is looked at just waits for a
+  later collection that does look at it.
+
+*/
+static void collectPolyGeneration (struct polyGeneration *g, Polynomial ** list, int *count,
+				   struct hashStruct *hash, int hashSize, unsigned short keepMask,
+				   void (*release) (Polynomial *))
 {
-  unHoldPolyCount++;
-  // Probably should do a clearSubtreeValidEvalFlag (p) call instead
-  clearValidEvalFlag ();
-  doUnHoldPoly (p);
-  return;
+  int from;
+
+  if (keepMask == 0)
+    from = heldPolysReleased ? 0 : g->held;
+  else
+    from = g->kept;
+  *count = collectPolyList (list, *count, from, hash, hashSize, keepMask, release);
+  if (keepMask == 0)
+    g->held = g->kept = *count;
+  else if (keepMask == VALID_KEEP_FLAG)
+    g->kept = *count;
 }
 
 void doFreePolys (unsigned short keepMask)
 {
-  int i, j, k;
-  Polynomial **newConstantList,
-#ifdef VARIABLE_C_MESSES_UP_COMPILED_DL_ARGUMENTS
-    **newVariableList,
-#endif
-    **newSumList,
-    **newProductList;
+  int oldCount;
 
+  if (POLY_CONCURRENT)
+    FATAL ("Polynomials can't be freed while they're being built concurrently");
   if (polynomialDebugLevel >= 5)
     fprintf (stderr, "Starting doFreePolys with keepMask of %uh\n", keepMask);
   if (polynomialDebugLevel >= 70) {
@@ -4222,71 +6398,20 @@ void doFreePolys (unsigned short keepMask)
     printAllPolynomials ();
   }
 #ifdef _OPENMP
-#pragma omp sections
+#pragma omp sections private(oldCount)
 #endif
   {
 #ifdef _OPENMP
 #pragma omp section
 #endif
     {
-      /* First create a new polynomial-specific list to transcribe entries
-       * we're keeping, and then go thru the old polynomial-specific list flagging
-       * entries we're not keeping and replacing pointers with new indexes
-       * for the ones we are keeping. */
-
-      MALCHOKE(newConstantList, sizeof (Polynomial *) * (constantListLength),Polynomial **);
-      k = 0;
-      for (i = 0; i < constantCount; i++) {
-	if (constantList[i]->eType == T_OFFLINE) importPoly (constantList[i]);
-        if (constantList[i]->id == polynomialLostNodeId)
-          fprintf (stderr, "doFreePolys sees id %d with valid %d and count %d during pass with mask %d\n",
-		   polynomialLostNodeId, constantList[i]->valid, constantList[i]->count, keepMask);
-        if ((constantList[i]->count > 0)
-            || (constantList[i]->valid & keepMask)) {
-          newConstantList[k] = constantList[i];
-          constantList[i] = newConstantList[k];
-          //      fprintf(stderr, "Index %d is now %d\n", newConstantList[k]->index, k);
-          newConstantList[k]->index = k;
-          k++;
-        } else {
-#ifndef FREEDEBUG
-          free (constantList[i]);
-#else
-          // These are for debugging mis-freed pointers
-          constantList[i]->value = constantList[i]->eType;
-          constantList[i]->eType = T_FREED;
-#endif
-          constantList[i] = NULL;
-        }
-      }
+      oldCount = constantCount;
+      collectPolyGeneration (&constantGeneration, constantList, &constantCount,
+			     constantHash, CONSTANT_HASH_SIZE, keepMask, releaseConstantPoly);
       if (polynomialDebugLevel >= 5)
-        fprintf (stderr, "%d/%d constant(s) ", k, constantCount);
-      constantCount = k;
-
-      /* Go thru the hash collapsing entries and freeing the corresponding
-       * polynomials and terms. Zero polynomial-specific list entries so they
-       * can be collapsed next. */
-#ifdef _OPENMP
-#pragma omp parallel for private(i,j,k)
-#endif
-      for (j = 0; j < CONSTANT_HASH_SIZE; j++) {
-        if (constantHash[j].num > 0) {
-          k = 0;
-          for (i = 0; i < constantHash[j].num; i++) {
-            if (constantList[constantHash[j].index[i]] != NULL) {
-              /* It's a keeper, slide it down and bump the count */
-              //        fprintf(stderr, "Hash keeper index %d is now %d\n", constantHash[j].index[i],
-              //              constantList[constantHash[j].index[i]]->index);
-              constantHash[j].index[k] = constantList[constantHash[j].index[i]]->index;
-              constantHash[j].key[k] = constantHash[j].key[i];
-              k++;
-            }
-          }
-          constantHash[j].num = k;
-        }
-      }
-      free (constantList);
-      constantList = newConstantList;
+        fprintf (stderr, "%d/%d constant(s) ", constantCount, oldCount);
+      if (constantCount < oldCount)
+	releasePolyArenaSlabs (&constantArena);
     }
 
 #ifdef VARIABLE_C_MESSES_UP_COMPILED_DL_ARGUMENTS
@@ -4294,59 +6419,11 @@ void doFreePolys (unsigned short keepMask)
 #pragma omp section
 #endif
     {
-      MALCHOKE(newVariableList, sizeof (Polynomial *) * (variableListLength),Polynomial **);
-      k = 0;
-      for (i = 0; i < variableCount; i++) {
-	if (variableList[i]->eType == T_OFFLINE) importPoly (variableList[i]);
-        if (variableList[i]->id == polynomialLostNodeId)
-          fprintf (stderr, "doFreePolys sees id %d with valid %d and count %d during pass with mask %d\n",
-		   polynomialLostNodeId, variableList[i]->valid, variableList[i]->count, keepMask);
-        if ((variableList[i]->count > 0)
-            || (variableList[i]->valid & keepMask)) {
-          newVariableList[k] = variableList[i];
-          variableList[i] = newVariableList[k];
-          //      fprintf(stderr, "Index %d is now %d\n", newVariableList[k]->index, k);
-          newVariableList[k]->index = k;
-          k++;
-        } else {
-#ifndef FREEDEBUG
-          free (variableList[i]);
-#ifdef USE_GMP
-	  mpf_clear (variableList[i]->mpfValue);
-#endif
-#else
-          // These are for debugging mis-freed pointers
-          variableList[i]->value = variableList[i]->eType;
-          variableList[i]->eType = T_FREED;
-#endif
-          variableList[i] = NULL;
-        }
-      }
+      oldCount = variableCount;
+      collectPolyGeneration (&variableGeneration, variableList, &variableCount,
+			     variableHash, VARIABLE_HASH_SIZE, keepMask, releaseVariablePoly);
       if (polynomialDebugLevel >= 5)
-        fprintf (stderr, "%d/%d variable(s) ", k, variableCount);
-      variableCount = k;
-
-      /* Go thru the hash collapsing entries and freeing the corresponding
-       * polynomials and terms. Zero polynomial-specific list entries so they
-       * can be collapsed next. */
-      for (j = 0; j < VARIABLE_HASH_SIZE; j++) {
-        if (variableHash[j].num > 0) {
-          k = 0;
-          for (i = 0; i < variableHash[j].num; i++) {
-            if (variableList[variableHash[j].index[i]] != NULL) {
-              /* It's a keeper, slide it down and bump the count */
-              //        fprintf(stderr, "Hash keeper index %d is now %d\n", variableHash[j].index[i],
-              //              variableList[variableHash[j].index[i]]->index);
-              variableHash[j].index[k] = variableList[variableHash[j].index[i]]->index;
-              variableHash[j].key[k] = variableHash[j].key[i];
-              k++;
-            }
-          }
-          variableHash[j].num = k;
-        }
-      }
-      free (variableList);
-      variableList = newVariableList;
+        fprintf (stderr, "%d/%d variable(s) ", variableCount, oldCount);
     }
 #endif
 
@@ -4354,69 +6431,13 @@ void doFreePolys (unsigned short keepMask)
 #pragma omp section
 #endif
     {
-      MALCHOKE(newSumList, sizeof (Polynomial *) * (sumListLength),Polynomial **);
-      k = 0;
-      for (i = 0; i < sumCount; i++) {
-	if (sumList[i]->eType == T_OFFLINE) importPoly (sumList[i]);
-        if (sumList[i]->id == polynomialLostNodeId)
-          fprintf (stderr, "doFreePolys sees id %d with valid %d and count %d during pass with mask %d\n",
-		   polynomialLostNodeId, sumList[i]->valid, sumList[i]->count, keepMask);
-        if ((sumList[i]->count > 0) || (sumList[i]->valid & keepMask)) {
-          newSumList[k] = sumList[i];
-          sumList[i] = newSumList[k];
-          //      fprintf(stderr, "Index %d is now %d\n", newSumList[k]->index, k);
-          newSumList[k]->index = k;
-          k++;
-        } else {
-          sumFreedCount++;
-#ifndef USE_SSD
-          free (sumList[i]->e.s->sum);
-          free (sumList[i]->e.s->factor);
-#else
-	  deportTermList (sumList[i]);
-#endif
-          free (sumList[i]->e.s);
-#ifndef FREEDEBUG
-#ifdef USE_GMP
-	  mpf_clear (sumList[i]->mpfValue);
-#endif
-          free (sumList[i]);
-#else
-          // These are for debugging mis-freed pointers
-          sumList[i]->value = sumList[i]->eType;
-          sumList[i]->eType = T_FREED;
-#endif
-          sumList[i] = NULL;
-        }
-      }
+      oldCount = sumCount;
+      collectPolyGeneration (&sumGeneration, sumList, &sumCount,
+			     sumHash, SUM_HASH_SIZE, keepMask, releaseSumPoly);
       if (polynomialDebugLevel >= 5)
-        fprintf (stderr, "%d/%d sum(s) ", k, sumCount);
-      sumCount = k;
-
-      /* Go thru the hash collapsing entries and freeing the corresponding
-       * polynomials and terms. Zero polynomial-specific list entries so they
-       * can be collapsed next. */
-#ifdef _OPENMP
-#pragma omp parallel for private(i,j,k)
-#endif
-      for (j = 0; j < SUM_HASH_SIZE; j++) {
-        if (sumHash[j].num > 0) {
-          k = 0;
-          for (i = 0; i < sumHash[j].num; i++) {
-            if (sumList[sumHash[j].index[i]] != NULL) {
-              /* It's a keeper, slide it down and bump the count */
-              //        fprintf(stderr, "Hash keeper index %d is now %d\n", sumHash[j].index[i],
-              //              sumList[sumHash[j].index[i]]->index);
-              sumHash[j].index[k] = sumList[sumHash[j].index[i]]->index;
-              sumHash[j].key[k] = sumHash[j].key[i];
-              k++;
-            }
-          }
-          sumHash[j].num = k;
-        }
-      }
-      free (sumList);
-      sumList = newSumList;
+        fprintf (stderr, "%d/%d sum(s) ", sumCount, oldCount);
+      if (sumCount < oldCount)
+	releaseSumArenaSlabs ();
       if ((sumCount + (2 * SUM_LIST_INITIAL)) < sumListLength) {
         //      fprintf (stderr, "Reducing sumListLength from %d to %d\n",
         //               sumListLength, sumCount + SUM_LIST_INITIAL);
@@ -4429,65 +6450,13 @@ void doFreePolys (unsigned short keepMask)
 #pragma omp section
 #endif
     {
-      MALCHOKE(newProductList, sizeof (Polynomial *) * (productListLength),Polynomial **);
-      k = 0;
-      for (i = 0; i < productCount; i++) {
-	if (productList[i]->eType == T_OFFLINE) importPoly (productList[i]);
-        if (productList[i]->id == polynomialLostNodeId)
-          fprintf (stderr, "doFreePolys sees id %d with valid %d and count %d during pass with mask %d\n",
-		   polynomialLostNodeId, productList[i]->valid, productList[i]->count, keepMask);
-        if ((productList[i]->count > 0) || (productList[i]->valid & keepMask)) {
-          newProductList[k] = productList[i];
-          productList[i] = newProductList[k];
-          //      fprintf(stderr, "Index %d is now %d\n", newProductList[k]->index, k);
-          newProductList[k]->index = k;
-          k++;
-        } else {
-          productFreedCount++;
-          free (productList[i]->e.p->product);
-          free (productList[i]->e.p->exponent);
-          free (productList[i]->e.p);
-#ifndef FREEDEBUG
-#ifdef USE_GMP
-	  mpf_clear (productList[i]->mpfValue);
-#endif
-          free (productList[i]);
-#else
-          // These are for debugging mis-freed pointers
-          productList[i]->value = productList[i]->eType;
-          productList[i]->eType = T_FREED;
-#endif
-          productList[i] = NULL;
-        }
-      }
+      oldCount = productCount;
+      collectPolyGeneration (&productGeneration, productList, &productCount,
+			     productHash, PRODUCT_HASH_SIZE, keepMask, releaseProductPoly);
       if (polynomialDebugLevel >= 5)
-        fprintf (stderr, "%d/%d product(s) ", k, productCount);
-      productCount = k;
-
-      /* Go thru the hash collapsing entries and freeing the corresponding
-       * polynomials and terms. Zero polynomial-specific list entries so they
-       * can be collapsed next. */
-#ifdef _OPENMP
-#pragma omp parallel for private(i,j,k)
-#endif
-      for (j = 0; j < PRODUCT_HASH_SIZE; j++) {
-        if (productHash[j].num > 0) {
-          k = 0;
-          for (i = 0; i < productHash[j].num; i++) {
-            if (productList[productHash[j].index[i]] != NULL) {
-              /* It's a keeper, slide it down and bump the count */
-              //        fprintf(stderr, "Hash keeper index %d is now %d\n", productHash[j].index[i],
-              //              productList[productHash[j].index[i]]->index);
-              productHash[j].index[k] = productList[productHash[j].index[i]]->index;
-              productHash[j].key[k] = productHash[j].key[i];
-              k++;
-            }
-          }
-          productHash[j].num = k;
-        }
-      }
-      free (productList);
-      productList = newProductList;
+        fprintf (stderr, "%d/%d product(s) ", productCount, oldCount);
+      if (productCount < oldCount)
+	releaseProductArenaSlabs ();
       if ((productCount + (2 * PRODUCT_LIST_INITIAL)) < productListLength) {
         //      fprintf (stderr, "Reducing productListLength from %d to %d\n",
         //               productListLength, productCount + PRODUCT_LIST_INITIAL);
@@ -4496,6 +6465,8 @@ void doFreePolys (unsigned short keepMask)
       }
     }
   }
+  if (keepMask == 0)
+    heldPolysReleased = FALSE;
   /* Reset building statistics. */
   constantHashHits = variableHashHits = functionHashHits = 0;
   sumReleaseableCount = sumNotReleaseableCount = sumReturnConstantCount = sumReturnSameConstantCount = sumReturn1TermCount = sumHashHits = sumNewCount = sumListNewCount = sumListReplacementCount = 0;
@@ -4525,7 +6496,7 @@ void freePolys ()
   statSSD ();
 #endif
   */
-  if (sumNotReleaseableCount + productNotReleaseableCount < 1024 * 512) {
+  if (sumNotReleaseableCount + productNotReleaseableCount < 1024 * 512 || POLY_CONCURRENT) {
     freePolysAttemptCount++;
     return;
   }
@@ -4551,23 +6522,123 @@ void freeKeptPolys ()
   return;
 }
 
+/**
+
+  Start a concurrent build (see POLY_CONCURRENT). From here until
+  endConcurrentPolyBuild, any thread can construct polynomials, but none
+  can be kept, held, freed or evaluated. Call both from outside of any
+  parallel region.
+
+*/
+void beginConcurrentPolyBuild ()
+{
+#ifndef NO_POLY_CONCURRENT_BUILD
+  polyBuildSerial++;
+  listBlocks[T_CONSTANT].base = constantCount;
+  listBlocks[T_VARIABLE].base = variableCount;
+  listBlocks[T_SUM].base = sumCount;
+  listBlocks[T_PRODUCT].base = productCount;
+  listBlocks[T_FUNCTIONCALL].base = functionCallCount;
+  polyConcurrentBuild = TRUE;
+#endif
+}
+
+/**
+
+  Finish a concurrent build, merging the threads' list blocks into the
+  lists and their slabs back into the arenas, and freeing the tables
+  retired during it.
+
+*/
+void endConcurrentPolyBuild ()
+{
+#ifndef NO_POLY_CONCURRENT_BUILD
+  int i;
+
+  polyConcurrentBuild = FALSE;
+  mergeListBlocks (T_CONSTANT, &constantList, &constantCount, &constantListLength, CONSTANT_LIST_INCREASE,
+		   &constantPListExpansions, constantHash, CONSTANT_HASH_SIZE);
+  mergeListBlocks (T_VARIABLE, &variableList, &variableCount, &variableListLength, VARIABLE_LIST_INCREASE,
+		   &variablePListExpansions, variableHash, VARIABLE_HASH_SIZE);
+  mergeListBlocks (T_SUM, &sumList, &sumCount, &sumListLength, SUM_LIST_INCREASE,
+		   &sumPListExpansions, sumHash, SUM_HASH_SIZE);
+  mergeListBlocks (T_PRODUCT, &productList, &productCount, &productListLength, PRODUCT_LIST_INCREASE,
+		   &productPListExpansions, productHash, PRODUCT_HASH_SIZE);
+  mergeListBlocks (T_FUNCTIONCALL, &functionCallList, &functionCallCount, &functionCallListLength,
+		   FUNCTIONCALL_LIST_INCREASE, &functionCallPListExpansions, functionCallHash, FUNCTIONCALL_HASH_SIZE);
+  for (i = 0; i < POLY_ARENAS; i++)
+    settlePolyArena (allPolyArenas[i]);
+  for (i = 0; i < retiredPolyTableCount; i++)
+    free (retiredPolyTables[i]);
+  retiredPolyTableCount = 0;
+#endif
+}
+
 /*
   We need to track the pieces of the chunkTicket whether the term list is in 
-  or out of memory. The new sumPoly.iMTLIndex will tell us the status of the
+  or out of memory. The sumPoly.iMTLIndex will tell us the status of the
   term list: -1 means dynamically allocated in-memory (inital state), -2 means 
-  not in-memory (exported), anything else means statically allocated in-memory.
+  on the SSD and cold, anything else is the index of its iMTL entry, which
+  says whether it's pinned (imported, and used in place in the mapped SSD
+  cache file), or warm (exported, but likely still in physical memory).
 
-  When the term list is out of memory, we need to keep the chunkTicket pieces
+  When the term list is not imported, we need to keep the chunkTicket pieces
   in order to get it back. Since we're not using the sumPoly sum and factor 
   list pointers, they'll work for that, so the sum list pointer will be the
   chunkOffset and the factor list pointer will be the doublePairCount.
 
-  When the term list is in memory, we need to keep the chunkTicket somewhere 
-  else because sum and factor are used. Fortunately, being in-memory and having
-  caching means that we can keep the chunkTicket in the cache entry.
+  When the term list is imported, sum and factor point into the mapping,
+  so the chunkTicket is kept in the iMTL entry.
+
+  There's no limit on how many term lists can be imported at once, since
+  the kernel pages them in and out of the mapping as physical memory allows.
+  A polynomial too big for memory gets slower, not fatal.
 
 */  
 
+#ifdef USE_SSD
+/* Take an iMTL entry off of the warm LRU list */
+static void unlinkWarmTermList (int i)
+{
+  if (iMTL[i].prev == -1)
+    iMTLWarmest = iMTL[i].next;
+  else
+    iMTL[iMTL[i].prev].next = iMTL[i].next;
+  if (iMTL[i].next == -1)
+    iMTLCoolest = iMTL[i].prev;
+  else
+    iMTL[iMTL[i].next].prev = iMTL[i].prev;
+  warmTermDPs -= iMTL[i].cT.doublePairCount;
+}
+
+/* Give an iMTL entry back for reuse */
+static void releaseTermListEntry (int i)
+{
+  iMTL[i].sP = NULL;
+  iMTL[i].next = iMTLFree;
+  iMTLFree = i;
+}
+
+/* Get an unused iMTL entry for a sum's term list, growing the table if need be */
+static int takeTermListEntry (struct sumPoly *sP)
+{
+  int i;
+
+  if (iMTLFree == -1) {
+    int newSize = (iMTLSize == 0) ? 1024 : iMTLSize * 2;
+    REALCHOKE (iMTL, sizeof (struct inMemoryTermList) * newSize, struct inMemoryTermList *);
+    for (i = newSize - 1; i >= iMTLSize; i--)
+      releaseTermListEntry (i);
+    iMTLSize = newSize;
+  }
+  i = iMTLFree;
+  iMTLFree = iMTL[i].next;
+  iMTL[i].sP = sP;
+  sP->iMTLIndex = i;
+  return i;
+}
+#endif
+
 void importTermList (Polynomial * p)
 {
 #ifdef USE_SSD
@@ -4582,64 +6653,70 @@ void importTermList (Polynomial * p)
   if (sP->num < MIN_USE_SSD_DPS)
     return;
 
-  // You can only import what you've exported before
-  if (sP->iMTLIndex != -2)
+  // You can only import what you've exported before, and only once
+  if (sP->iMTLIndex == -1 || (sP->iMTLIndex >= 0 && iMTL[sP->iMTLIndex].pinned))
     return;
 
-  //  printf ("Import p%d of %d sum %lu and factor %lu\n", 
-  //	  p->id, sP->num, (unsigned long) sP->sum, (unsigned long) sP->factor);
-
   importedTerms++;
   if ((importedTerms-(exportedWrittenTerms+exportedDroppedTerms)) > peakInMemoryTerms)
     peakInMemoryTerms = importedTerms-(exportedWrittenTerms+exportedDroppedTerms);
 
-  // Actually bring it back in...
-
-  for (i=0; i<=IMTL_COUNT; i++)
-    if (iMTL[i].lastNodeId == p->id) {
-      // Found it still hanging about!
-      iMTL[i].cT.chunkOffset = (unsigned long) sP->sum;
-      iMTL[i].cT.doublePairCount = (unsigned long) sP->factor;
-      sP->iMTLIndex = i;
-      sP->sum = (Polynomial **) &iMTL[i].buffer[0];
-      sP->factor = (double *) &iMTL[i].buffer[sP->num];
-      //      printf ("Import hit cache for p%d iMTLIndex %d of %d sum %lu and factor %lu\n",
-      //	      p->id, sP->iMTLIndex, sP->num, (unsigned long) sP->sum, (unsigned long) sP->factor);
-      return;
-    }
-
-  // Not still hanging about, so let's go get it...
+  if ((i = sP->iMTLIndex) >= 0)
+    // Found it still warm!
+    unlinkWarmTermList (i);
+  else {
+    // Cold, so it needs an entry
+    i = takeTermListEntry (sP);
+    iMTL[i].cT.chunkOffset = (unsigned long) sP->sum;
+    iMTL[i].cT.doublePairCount = (unsigned long) sP->factor;
+  }
+  iMTL[i].pinned = TRUE;
+  sP->sum = (Polynomial **) mapSSD (&iMTL[i].cT);
+  sP->factor = (double *) &sP->sum[sP->num];
 
-  for (i=0; i<=IMTL_COUNT; i++)
-    if (iMTL[i].cT.doublePairCount == 0)
-      break;
+#endif
+}
 
-  if (i >= IMTL_COUNT)
-    FATAL ("Exhausted in-memory term lists for sum term lists!");
+#ifdef USE_SSD
+/*
 
-  iMTL[i].cT.chunkOffset = (unsigned long) sP->sum;
-  iMTL[i].cT.doublePairCount = (unsigned long) sP->factor;
-  iMTL[i].lastNodeId = p->id;
-  getSSD (&iMTL[i].cT, iMTL[i].buffer);
-  sP->iMTLIndex = i;
-  sP->sum = (Polynomial **) &iMTL[i].buffer[0];
-  sP->factor = (double *) &iMTL[i].buffer[sP->num];
+  Find the next sum with a cold term list on an evaluation list, starting at
+  position from, and have its reading started so that it's likely to be in
+  memory by the time importTermList gets to it. Returns the position of the
+  sum, or listNext if there isn't one.
 
-  //  printf ("Imported p%d iMTLIndex %d of %d sum %lu and factor %lu\n",
-  //	  p->id, sP->iMTLIndex, sP->num, (unsigned long) sP->sum, (unsigned long) sP->factor);
+*/
+static int prefetchNextTermList (struct polyList *l, int from)
+{
+  struct chunkTicket cT;
+  struct sumPoly *sP;
 
-#endif
+  for (; from < l->listNext; from++) {
+    if (l->pList[from]->eType != T_SUM)
+      continue;
+    sP = l->pList[from]->e.s;
+    if (sP->num < MIN_USE_SSD_DPS || sP->iMTLIndex != -2)
+      continue;
+    cT.chunkOffset = (unsigned long) sP->sum;
+    cT.doublePairCount = (unsigned long) sP->factor;
+    prefetchSSD (&cT);
+    break;
+  }
+  return from;
 }
+#endif
 
 /**
 
-  Write a list of sum terms out to SSD storage for later import.
+  Finish with a list of sum terms for now, writing it out to SSD storage for
+  later import if it isn't there already.
 
 */
 void exportTermList (Polynomial * p, int writeFlag)
 {
 #ifdef USE_SSD
   struct sumPoly *sP;
+  int i;
 
   // Only handle sum polynomials
   if (p->eType != T_SUM)
@@ -4652,68 +6729,66 @@ void exportTermList (Polynomial * p, int writeFlag)
     return;
 
   // Can't export something already exported.
-  if (sP->iMTLIndex == -2)
+  if (sP->iMTLIndex == -2 || (sP->iMTLIndex >= 0 && !iMTL[sP->iMTLIndex].pinned))
     return;
 
-  //  printf ("Export (%d) p%d w/iMTLIndex %d of %d sum %lu and factor %lu\n", 
-  //	  writeFlag, p->id, sP->iMTLIndex, sP->num, (unsigned long) sP->sum, (unsigned long) sP->factor);
-
-  if (writeFlag) {
-    // Actually write it out...
-
+  if (sP->iMTLIndex == -1) {
+    // ...and it's a term list in allocated (discontiguous) memory
     struct chunkTicket *cT;
-    if (sP->iMTLIndex == -1) {
-      // ...and it's a new term list in allocated (discontiguous) memory
-
-      // Only do exports when we're below some available physical memory threshold.
-      if (memoryLow != TRUE)
-	return;
+    Polynomial **sum;
 
-      if (sSDDebt > 0)
-	return; // ...no can do.
-
-      double buffer[MAX_SSD_BUFFER];
+    // Only do exports when asked to write and below some available physical memory threshold.
+    if (writeFlag != TRUE || memoryLow != TRUE)
+      return;
 
-      if (sP->num > (MAX_SSD_BUFFER / 2)) {
-	WARNING ("MAX_SSD_BUFFER of %d is too small for request for %d double pairs",
-		 MAX_SSD_BUFFER, sP->num);
-	return; // ...leave it in memory.
-      }
+    if (sSDDebt > 0)
+      return; // ...no can do.
 
-      // Avoid this painful mistake by changing sSDHandler's get and putSSD to have two separate pointers
-      memcpy (&buffer[0], sP->sum, 8 * sP->num);
-      memcpy (&buffer[sP->num], sP->factor, 8 * sP->num);
-      if ((cT = putSSD (buffer, sP->num)) == NULL) {
-	// We're out of business, put up the "Closed" sign until we get enough back.
-	sSDDebt = sP->num << 2;
-	WARNING ("In SSD debt for %ludps, reverting to memory allocation", sSDDebt);
-	return;
-      }
-      free (sP->sum);
-      free (sP->factor);
-      sP->sum = (Polynomial **) cT->chunkOffset;
-      sP->factor = (double *) cT->doublePairCount;
-    } else {
-      // ...and it's an old term list in a static buffer, so just rewrite it
-      flushSSD (iMTL[sP->iMTLIndex].buffer, iMTL[sP->iMTLIndex].cT.chunkOffset, 
-		iMTL[sP->iMTLIndex].cT.doublePairCount);
-      sP->sum = (Polynomial **) iMTL[sP->iMTLIndex].cT.chunkOffset;
-      sP->factor = (double *) iMTL[sP->iMTLIndex].cT.doublePairCount;
-      iMTL[sP->iMTLIndex].cT.doublePairCount = 0;
+    if ((cT = putSSD (NULL, sP->num)) == NULL) {
+      // We're out of business, put up the "Closed" sign until we get enough back.
+      sSDDebt = sP->num << 2;
+      WARNING ("In SSD debt for %ludps, reverting to memory allocation", sSDDebt);
+      return;
     }
-    //    printf ("Exported sum %lu and factor %lu\n", (unsigned long) sP->sum, (unsigned long) sP->factor);
+    sum = (Polynomial **) mapSSD (cT);
+    memcpy (sum, sP->sum, sizeof (Polynomial *) * sP->num);
+    memcpy (&sum[sP->num], sP->factor, sizeof (double) * sP->num);
+    free (sP->sum);
+    free (sP->factor);
+    i = takeTermListEntry (sP);
+    iMTL[i].cT = *cT;
+    free (cT);
     exportedWrittenTerms++;
   } else {
-    if (sP->iMTLIndex == -1)
-      // ...and it's a term list in allocated (discontiguous) memory, so this is a no-op
-      return;
-    // ...and it's an old term list in a static buffer, so just rewrite it
-    sP->sum = (Polynomial **) iMTL[sP->iMTLIndex].cT.chunkOffset;
-    sP->factor = (double *) iMTL[sP->iMTLIndex].cT.doublePairCount;
-    iMTL[sP->iMTLIndex].cT.doublePairCount = 0;
-    exportedDroppedTerms++;
+    // ...and it's an imported term list, which was used in place so there's nothing to write
+    i = sP->iMTLIndex;
+    if (writeFlag)
+      exportedWrittenTerms++;
+    else
+      exportedDroppedTerms++;
+  }
+
+  // It's now the warmest of the warm
+  sP->sum = (Polynomial **) iMTL[i].cT.chunkOffset;
+  sP->factor = (double *) iMTL[i].cT.doublePairCount;
+  iMTL[i].pinned = FALSE;
+  iMTL[i].prev = -1;
+  iMTL[i].next = iMTLWarmest;
+  if (iMTLWarmest == -1)
+    iMTLCoolest = i;
+  else
+    iMTL[iMTLWarmest].prev = i;
+  iMTLWarmest = i;
+  warmTermDPs += iMTL[i].cT.doublePairCount;
+
+  // ...and too many warm ones means the coolest go cold
+  while (warmTermDPs > WARM_TERM_DPS && iMTLCoolest != i) {
+    int j = iMTLCoolest;
+    unlinkWarmTermList (j);
+    coolSSD (&iMTL[j].cT);
+    iMTL[j].sP->iMTLIndex = -2;
+    releaseTermListEntry (j);
   }
-  sP->iMTLIndex = -2;
 
 #endif
 }
@@ -4738,17 +6813,18 @@ void deportTermList (Polynomial * p)
 
   sP = (struct sumPoly *) p->e.s;
 
-  //  printf ("Deport p%d w/iMTLIndex %d of %d sum %lu and factor %lu\n", 
-  //	  p->id, sP->iMTLIndex, sP->num, (unsigned long) sP->sum, (unsigned long) sP->factor);
-
   if (sP->iMTLIndex != -1) {
-    for (i=0; i<=IMTL_COUNT; i++)
-      if (iMTL[i].lastNodeId == p->id)
-	iMTL[i].lastNodeId = 0;
     struct chunkTicket *cT;
     MALCHOKE(cT, sizeof(struct chunkTicket),struct chunkTicket *);
-    cT->chunkOffset = (unsigned long) sP->sum;
-    cT->doublePairCount = (unsigned long) sP->factor;
+    if ((i = sP->iMTLIndex) >= 0) {
+      *cT = iMTL[i].cT;
+      if (!iMTL[i].pinned)
+	unlinkWarmTermList (i);
+      releaseTermListEntry (i);
+    } else {
+      cT->chunkOffset = (unsigned long) sP->sum;
+      cT->doublePairCount = (unsigned long) sP->factor;
+    }
     // Pay-off some (eventually all?) of our debt
     if (sSDDebt > 0) {
       sSDDebt -= cT->doublePairCount;
@@ -4813,14 +6889,14 @@ Polynomial *restoreExternalPoly (char *functionName)
 
   // New polynomial to create!
 
-  MALCHOKE(rp, sizeof (Polynomial),Polynomial *);
+  rp = (Polynomial *) polyArenaAlloc (&externalArena);
   MALCHOKE(eP, sizeof (struct externalPoly),struct externalPoly *);
   rp->e.e = eP;
   strcpy (eP->polynomialFunctionName, functionName);
 #ifdef POLYUSE_DL
   if (!loadPolyDL(rp)) {
     free (eP);
-    free (rp);
+    polyArenaFree (&externalArena, rp);
     return NULL;
   }
 #endif
@@ -4828,6 +6904,7 @@ Polynomial *restoreExternalPoly (char *functionName)
   rp->id = nodeId;
   rp->eType = T_EXTERNAL;
   rp->valid = VALID_NOTDISC_FLAG;
+  rp->evalEpoch = 0;
   rp->count = 0;
   externalList[externalCount] = rp;
   externalCount++;
@@ -4935,7 +7012,7 @@ void codePoly (Polynomial * p, struct polyList *l, char *name)
   FILE *srcFile, *srcCalledFile = NULL, *includeFile;
   int i, j, srcSize = 0, fileCount = 0, totalSourceSize = 0, totalInternalSize = 0;
   int sumsUsed = 0, productsUsed = 0, functionCallsUsed = 0;
-  Polynomial *result;
+  Polynomial *result, *tP;
   struct sumPoly *sP;
   struct productPoly *pP;
   struct strSV *sV = NULL;
@@ -5073,19 +7150,20 @@ void codePoly (Polynomial * p, struct polyList *l, char *name)
     case T_SUM:
       srcSize += fprintf (srcCalledFile, "\t%s[%d] = ", eTypes[p->eType], sumsUsed);
       sP = p->e.s;
-      totalInternalSize += sizeof (struct sumPoly) + sP->num * (sizeof (Polynomial *) + sizeof (double *));
+      totalInternalSize += sizeof (struct sumPoly) + sP->num * (sizeof (polyHandle) + sizeof (double));
       importTermList (p);
       for (i = 0; i < sP->num; i++) {
-	if (sP->sum[i]->eType == T_OFFLINE) importPoly (sP->sum[i]);
+	tP = POLY_TERM (sP->sum[i]);
+	if (tP->eType == T_OFFLINE) importPoly (tP);
         if (i != 0)
           srcSize += fprintf (srcCalledFile, "+");
-        if (sP->sum[i]->eType == T_CONSTANT)
-          srcSize += fprintf (srcCalledFile, "%.*g", DBL_DIG, sP->sum[i]->value /* still the constant */ );
+        if (tP->eType == T_CONSTANT)
+          srcSize += fprintf (srcCalledFile, "%.*g", DBL_DIG, tP->value /* still the constant */ );
         else {
           if (sP->factor[i] == 1)
-            srcSize += fprintf (srcCalledFile, "%s[%lu]", eTypes[sP->sum[i]->eType], (unsigned long) sP->sum[i]->value /* actually <whatever>Used */ );
+            srcSize += fprintf (srcCalledFile, "%s[%lu]", eTypes[tP->eType], (unsigned long) tP->value /* actually <whatever>Used */ );
           else
-            srcSize += fprintf (srcCalledFile, "%.*g*%s[%lu]", DBL_DIG, sP->factor[i], eTypes[sP->sum[i]->eType], (unsigned long) sP->sum[i]->value /* actually <whatever>Used */ );
+            srcSize += fprintf (srcCalledFile, "%.*g*%s[%lu]", DBL_DIG, sP->factor[i], eTypes[tP->eType], (unsigned long) tP->value /* actually <whatever>Used */ );
         }
       }
       exportTermList (p, FALSE);
@@ -5095,32 +7173,33 @@ void codePoly (Polynomial * p, struct polyList *l, char *name)
     case T_PRODUCT:
       srcSize += fprintf (srcCalledFile, "\t%s[%d] = ", eTypes[p->eType], productsUsed);
       pP = p->e.p;
-      totalInternalSize += sizeof (struct productPoly) + pP->num * (sizeof (Polynomial *) + sizeof (int *));
+      totalInternalSize += sizeof (struct productPoly) + pP->num * (sizeof (polyHandle) + sizeof (polyExponent));
       for (i = 0; i < pP->num; i++) {
-	if (pP->product[i]->eType == T_OFFLINE) importPoly (pP->product[i]);
+	tP = POLY_TERM (pP->product[i]);
+	if (tP->eType == T_OFFLINE) importPoly (tP);
         if (i != 0)
           srcSize += fprintf (srcCalledFile, "*");
-        if (pP->product[i]->eType == T_CONSTANT)
-          srcSize += fprintf (srcCalledFile, "%.*g", DBL_DIG, pP->product[i]->value /* still the constant */ );
+        if (tP->eType == T_CONSTANT)
+          srcSize += fprintf (srcCalledFile, "%.*g", DBL_DIG, tP->value /* still the constant */ );
         else {
           switch (pP->exponent[i]) {
           case 1:
-            srcSize += fprintf (srcCalledFile, "%s[%lu]", eTypes[pP->product[i]->eType], (unsigned long) pP->product[i]->value);
+            srcSize += fprintf (srcCalledFile, "%s[%lu]", eTypes[tP->eType], (unsigned long) tP->value);
             break;
           case 2:
-            srcSize += fprintf (srcCalledFile, "%s[%lu]*%s[%lu]", eTypes[pP->product[i]->eType], (unsigned long) pP->product[i]->value, eTypes[pP->product[i]->eType], (unsigned long) pP->product[i]->value);
+            srcSize += fprintf (srcCalledFile, "%s[%lu]*%s[%lu]", eTypes[tP->eType], (unsigned long) tP->value, eTypes[tP->eType], (unsigned long) tP->value);
             break;
           case 3:
-            srcSize += fprintf (srcCalledFile, "%s[%lu]*%s[%lu]*%s[%lu]", eTypes[pP->product[i]->eType],
-                (unsigned long) pP->product[i]->value, eTypes[pP->product[i]->eType], (unsigned long) pP->product[i]->value, eTypes[pP->product[i]->eType], (unsigned long) pP->product[i]->value);
+            srcSize += fprintf (srcCalledFile, "%s[%lu]*%s[%lu]*%s[%lu]", eTypes[tP->eType],
+                (unsigned long) tP->value, eTypes[tP->eType], (unsigned long) tP->value, eTypes[tP->eType], (unsigned long) tP->value);
             break;
           case 4:
-            srcSize += fprintf (srcCalledFile, "%s[%lu]*%s[%lu]*%s[%lu]*%s[%lu]", eTypes[pP->product[i]->eType],
-                (unsigned long) pP->product[i]->value, eTypes[pP->product[i]->eType],
-                (unsigned long) pP->product[i]->value, eTypes[pP->product[i]->eType], (unsigned long) pP->product[i]->value, eTypes[pP->product[i]->eType], (unsigned long) pP->product[i]->value);
+            srcSize += fprintf (srcCalledFile, "%s[%lu]*%s[%lu]*%s[%lu]*%s[%lu]", eTypes[tP->eType],
+                (unsigned long) tP->value, eTypes[tP->eType],
+                (unsigned long) tP->value, eTypes[tP->eType], (unsigned long) tP->value, eTypes[tP->eType], (unsigned long) tP->value);
             break;
           default:
-            srcSize += fprintf (srcCalledFile, "pow(%s[%lu],%d)", eTypes[pP->product[i]->eType], (unsigned long) pP->product[i]->value, pP->exponent[i]);
+            srcSize += fprintf (srcCalledFile, "pow(%s[%lu],%d)", eTypes[tP->eType], (unsigned long) tP->value, pP->exponent[i]);
             break;
           }
         }
@@ -5215,6 +7294,317 @@ void codePoly (Polynomial * p, struct polyList *l, char *name)
   return;
 }
 
+/**
+
+  Polynomial cache files.
+
+  A cache file holds a sorted evaluation list in the same flattened
+  form as a tape (see newPolyTape), so that a later run can rebuild the
+  polynomial without repeating whatever computation produced it in the
+  first place. Entry j of the file is pList[j]. Operands refer to
+  entries by index, or to the constant table if they are past the last
+  entry. Variables are bound by their position in the variableList,
+  and their names are checked to catch a run that creates them in a
+  different order. The caller supplies a key summarizing everything
+  else the polynomial depends upon, and a file with a different key is
+  ignored.
+
+  Files are written under a temporary name and then renamed, so that
+  concurrent runs sharing a cache never see partial files.
+
+*/
+
+#define POLY_CACHE_MAGIC "KPOLYC01"
+#define POLY_CACHE_NAME_LEN 100
+
+struct polyCacheHeader
+{
+  char magic[8];		// POLY_CACHE_MAGIC
+  uint64_t key;			// caller's summary of polynomial dependencies
+  int nodeCount;		// entries, i.e. listNext of the list
+  int operandCount;		// total operands of all entries
+  int constantCount;		// constant operands, and the root if it is constant
+  int nameCount;		// variable and function call entries
+  int root;			// entry, or past the last entry for a constant
+  int pad;
+};
+
+/// Bytes in a cache file following the header, in the order they appear.
+static size_t polyCacheSize (struct polyCacheHeader *h)
+{
+  return (size_t) h->operandCount * sizeof (double) + (size_t) h->constantCount * sizeof (double) +
+    (3 * (size_t) h->nodeCount + 1 + 2 * (size_t) h->operandCount) * sizeof (int) + (size_t) h->nameCount * POLY_CACHE_NAME_LEN;
+}
+
+/**
+
+  Check a cache file of size bytes before anything is built from it.
+  Its counts must account for exactly its size, each entry's operands
+  must follow on from the previous entry's and refer only to earlier
+  entries or to constants, and there must be a name for every variable
+  and function call. Anything else, say from a truncated or damaged
+  file, would have restorePolyCache read past the end of it.
+
+*/
+static int polyCacheIsValid (struct polyCacheHeader *h, size_t size)
+{
+  int *eType, *first, *operand, i, j, names = 0;
+
+  if (h->nodeCount < 0 || h->operandCount < 0 || h->constantCount < 0 || h->nameCount < 0 ||
+      size != sizeof (struct polyCacheHeader) + polyCacheSize (h))
+    return FALSE;
+  eType = (int *) ((double *) (h + 1) + h->operandCount + h->constantCount);
+  first = eType + h->nodeCount;
+  operand = first + h->nodeCount + 1 + h->nodeCount;
+
+  if (first[0] != 0 || first[h->nodeCount] != h->operandCount)
+    return FALSE;
+  for (j = 0; j < h->nodeCount; j++) {
+    if (first[j + 1] < first[j])
+      return FALSE;
+    for (i = first[j]; i < first[j + 1]; i++)
+      if ((operand[i] < 0 || operand[i] >= j) &&
+	  (operand[i] < h->nodeCount || operand[i] - h->nodeCount >= h->constantCount))
+	return FALSE;
+    if (eType[j] == T_VARIABLE || eType[j] == T_FUNCTIONCALL)
+      names++;
+  }
+  if (names != h->nameCount || h->root < 0 || h->root - h->nodeCount >= h->constantCount)
+    return FALSE;
+  return TRUE;
+}
+
+/**
+
+  Write polynomial p, sorted onto list l, to a cache file under the
+  given key. Returns TRUE if the file was written. Polynomials that
+  reference compiled DLs can't be cached, since they'd be no use
+  without the DLs.
+
+*/
+int savePolyCache (Polynomial *p, struct polyList *l, char *fileName, uint64_t key)
+{
+  struct polyCacheHeader h;
+  struct polyTape *t = l->tape;
+  char tempFileName[PATH_MAX + 16], name[POLY_CACHE_NAME_LEN], *source;
+  int *eType, *reference, *operand, i, j, status = TRUE;
+  FILE *cacheFile;
+
+  for (j = 0; j < l->listNext; j++)
+    if (l->pList[j]->eType == T_EXTERNAL)
+      return FALSE;
+
+  // Use the list's own tape if it has one, otherwise build a temporary one
+  if (t == NULL) {
+    t = newPolyTape (l->listNext, l->pList);
+    polyTapeMemory += polyTapeSize (t);
+  }
+
+  memset (&h, 0, sizeof (h));
+  memcpy (h.magic, POLY_CACHE_MAGIC, sizeof (h.magic));
+  h.key = key;
+  h.nodeCount = t->nodeCount;
+  h.operandCount = t->first[t->nodeCount];
+  h.constantCount = t->slotCount - t->nodeCount;
+  if (p->eType == T_CONSTANT || l->listNext == 0) {
+    h.root = t->slotCount;
+    h.constantCount++;
+  } else {
+    for (h.root = t->nodeCount - 1; h.root > 0 && t->node[h.root] != p; h.root--);
+    if (t->node[h.root] != p) {
+      WARNING ("Polynomial %d isn't in its list, not saving it to cache file %s", p->id, fileName);
+      if (t != l->tape)
+	releasePolyTape (t);
+      return FALSE;
+    }
+  }
+  for (j = 0; j < t->nodeCount; j++)
+    if (t->opCode[j] == T_VARIABLE || t->opCode[j] == T_FUNCTIONCALL)
+      h.nameCount++;
+
+  MALCHOKE(eType, sizeof (int) * (t->nodeCount + 1), int *);
+  MALCHOKE(reference, sizeof (int) * (t->nodeCount + 1), int *);
+  MALCHOKE(operand, sizeof (int) * (h.operandCount + 1), int *);
+  for (j = 0; j < t->nodeCount; j++) {
+    eType[j] = t->opCode[j];
+    reference[j] = (t->opCode[j] == T_VARIABLE) ? t->node[j]->index : -1;
+  }
+  // Constant slots follow the entries, so constant operands need no translation
+  for (i = 0; i < h.operandCount; i++)
+    operand[i] = t->operand[i];
+
+  sprintf (tempFileName, "%s.%d", fileName, (int) getpid ());
+  if ((cacheFile = fopen (tempFileName, "w")) == NULL) {
+    WARNING ("Cannot create polynomial cache file %s (%s)", fileName, strerror (errno));
+    status = FALSE;
+  } else {
+    fwrite (&h, sizeof (h), 1, cacheFile);
+    fwrite (t->factor, sizeof (double), h.operandCount, cacheFile);
+    fwrite (&t->value[t->nodeCount], sizeof (double), t->slotCount - t->nodeCount, cacheFile);
+    if (h.root == t->slotCount)
+      fwrite (&p->value, sizeof (double), 1, cacheFile);
+    fwrite (eType, sizeof (int), t->nodeCount, cacheFile);
+    fwrite (t->first, sizeof (int), t->nodeCount + 1, cacheFile);
+    fwrite (reference, sizeof (int), t->nodeCount, cacheFile);
+    fwrite (operand, sizeof (int), h.operandCount, cacheFile);
+    fwrite (t->exponent, sizeof (int), h.operandCount, cacheFile);
+    for (j = 0; j < t->nodeCount; j++) {
+      if (t->opCode[j] == T_VARIABLE)
+	source = t->node[j]->e.v->vName;
+      else if (t->opCode[j] == T_FUNCTIONCALL)
+	source = t->node[j]->e.f->name;
+      else
+	continue;
+      memset (name, 0, sizeof (name));
+      memcpy (name, source, MIN (strlen (source), POLY_CACHE_NAME_LEN - 1));
+      fwrite (name, POLY_CACHE_NAME_LEN, 1, cacheFile);
+    }
+    if (ferror (cacheFile))
+      status = FALSE;
+    if (fclose (cacheFile) != 0)
+      status = FALSE;
+    if (status == FALSE || rename (tempFileName, fileName) != 0) {
+      WARNING ("Cannot write polynomial cache file %s (%s)", fileName, strerror (errno));
+      unlink (tempFileName);
+      status = FALSE;
+    }
+  }
+
+  free (eType);
+  free (reference);
+  free (operand);
+  if (t != l->tape)
+    releasePolyTape (t);
+  if (status)
+    swLogProgress(3 /* DETAIL + 1 */, 0, "Saved polynomial of %d terms to cache file %s", h.nodeCount, fileName);
+  return status;
+}
+
+/**
+
+  Rebuild a polynomial from a cache file written by savePolyCache.
+  Returns NULL if there's no such file, it's for a different key, it
+  isn't valid (see polyCacheIsValid), or its variables don't match those
+  that currently exist, in which case the caller will have to build the
+  polynomial itself. Invalid and mismatched files are removed, and the
+  caller's rebuilt polynomial is saved in their place. The file is
+  mapped rather than read, and entries are rebuilt in order with the
+  usual constructors, each sum or product in one call with all of its
+  terms, so they come out the same as when they were first built.
+
+  The rebuilt polynomial and its subpolynomials aren't held, so the
+  caller should hold it before the next freeKeptPolys.
+
+*/
+Polynomial *restorePolyCache (char *fileName, uint64_t key)
+{
+  struct polyCacheHeader *h;
+  struct stat cacheStat;
+  void *cache;
+  double *factor, *constant;
+  int *eType, *first, *reference, *operand, *exponent;
+  char *name;
+  Polynomial **nodes, **terms, *rp = NULL;
+  int cacheFD, i, j, num, names = 0, maxNum = 0;
+
+  if ((cacheFD = open (fileName, O_RDONLY)) == -1)
+    return NULL;
+  if (fstat (cacheFD, &cacheStat) != 0 || cacheStat.st_size < (off_t) sizeof (struct polyCacheHeader) ||
+      (cache = mmap (NULL, cacheStat.st_size, PROT_READ, MAP_PRIVATE, cacheFD, 0)) == MAP_FAILED) {
+    close (cacheFD);
+    return NULL;
+  }
+  close (cacheFD);
+
+  h = (struct polyCacheHeader *) cache;
+  if (memcmp (h->magic, POLY_CACHE_MAGIC, sizeof (h->magic)) != 0 || h->key != key) {
+    DETAIL (0, "Ignoring stale polynomial cache file %s", fileName);
+    munmap (cache, cacheStat.st_size);
+    return NULL;
+  }
+  if (!polyCacheIsValid (h, (size_t) cacheStat.st_size)) {
+    DETAIL (0, "Discarding damaged polynomial cache file %s", fileName);
+    munmap (cache, cacheStat.st_size);
+    unlink (fileName);
+    return NULL;
+  }
+  factor = (double *) (h + 1);
+  constant = factor + h->operandCount;
+  eType = (int *) (constant + h->constantCount);
+  first = eType + h->nodeCount;
+  reference = first + h->nodeCount + 1;
+  operand = reference + h->nodeCount;
+  exponent = operand + h->operandCount;
+  name = (char *) (exponent + h->operandCount);
+
+  for (j = 0; j < h->nodeCount; j++)
+    if (first[j + 1] - first[j] > maxNum)
+      maxNum = first[j + 1] - first[j];
+  MALCHOKE(nodes, sizeof (Polynomial *) * (h->nodeCount + 1), Polynomial **);
+  MALCHOKE(terms, sizeof (Polynomial *) * (maxNum + 1), Polynomial **);
+
+  for (j = 0; j < h->nodeCount; j++) {
+    num = first[j + 1] - first[j];
+    for (i = 0; i < num; i++) {
+      if (operand[first[j] + i] < h->nodeCount)
+	terms[i] = nodes[operand[first[j] + i]];
+      else
+	terms[i] = constantExp (__FILE__, __LINE__, constant[operand[first[j] + i] - h->nodeCount]);
+    }
+    if (num == 0 && eType[j] != T_VARIABLE) {
+      DETAIL (0, "Polynomial cache file %s has an entry with no terms", fileName);
+      goto fail;
+    }
+    switch (eType[j]) {
+    case T_VARIABLE:
+      if (reference[j] < 0 || reference[j] >= variableCount ||
+	  strncmp (variableList[reference[j]]->e.v->vName, &name[names * POLY_CACHE_NAME_LEN], POLY_CACHE_NAME_LEN - 1) != 0) {
+	DETAIL (0, "Variable %s of polynomial cache file %s doesn't exist in this run",
+		&name[names * POLY_CACHE_NAME_LEN], fileName);
+	goto fail;
+      }
+      nodes[j] = variableList[reference[j]];
+      names++;
+      break;
+
+    case T_SUM:
+      nodes[j] = plusExpCore (__FILE__, __LINE__, num, NULL, &factor[first[j]], terms, 0);
+      break;
+
+    case T_PRODUCT:
+      nodes[j] = timesExpCore (__FILE__, __LINE__, num, NULL, terms, &exponent[first[j]], 0);
+      break;
+
+    case T_FUNCTIONCALL:
+      if (num == 1)
+	nodes[j] = functionCallExp (2, &name[names * POLY_CACHE_NAME_LEN], terms[0]);
+      else if (num == 2)
+	nodes[j] = functionCallExp (3, &name[names * POLY_CACHE_NAME_LEN], terms[0], terms[1]);
+      else {
+	DETAIL (0, "Function call %s of polynomial cache file %s has %d parameters",
+		&name[names * POLY_CACHE_NAME_LEN], fileName, num);
+	goto fail;
+      }
+      names++;
+      break;
+
+    default:
+      DETAIL (0, "Polynomial cache file %s has an entry of type %d", fileName, eType[j]);
+      goto fail;
+    }
+  }
+  rp = (h->root < h->nodeCount) ? nodes[h->root] : constantExp (__FILE__, __LINE__, constant[h->root - h->nodeCount]);
+  swLogProgress(3 /* DETAIL + 1 */, 0, "Restored polynomial of %d terms from cache file %s", h->nodeCount, fileName);
+
+ fail:
+  if (rp == NULL)
+    unlink (fileName);
+  free (nodes);
+  free (terms);
+  munmap (cache, cacheStat.st_size);
+  return rp;
+}
+
 #ifdef DEPENDENCYFLAGGING
 unsigned long totalNodes = 0;
 /**
@@ -5227,9 +7617,9 @@ void doDependencyFlagging (Polynomial * p)
 {
   int i;
 
-  if (p->valid & VALID_EVAL_FLAG)
+  if (EVAL_VALID (p))
     return;
-  p->valid |= VALID_EVAL_FLAG;
+  SET_EVAL_VALID (p);
 
   switch (p->eType) {
   case T_OFFLINE:
@@ -5249,8 +7639,8 @@ void doDependencyFlagging (Polynomial * p)
     totalNodes++;
     importTermList (p);
     for (i = 0; i < p->e.s->num; i++) {
-      doDependencyFlagging (p->e.s->sum[i]);
-      p->dependencyFlag |= p->e.s->sum[i]->dependencyFlag;
+      doDependencyFlagging (POLY_TERM (p->e.s->sum[i]));
+      p->dependencyFlag |= POLY_TERM (p->e.s->sum[i])->dependencyFlag;
     }
     exportTermList (p, FALSE);
   for (i = 0; i < variableCount; i++)
@@ -5260,8 +7650,8 @@ void doDependencyFlagging (Polynomial * p)
   case T_PRODUCT:
     totalNodes++;
     for (i = 0; i < p->e.p->num; i++) {
-      doDependencyFlagging (p->e.p->product[i]);
-      p->dependencyFlag |= p->e.p->product[i]->dependencyFlag;
+      doDependencyFlagging (POLY_TERM (p->e.p->product[i]));
+      p->dependencyFlag |= POLY_TERM (p->e.p->product[i])->dependencyFlag;
     }
   for (i = 0; i < variableCount; i++)
     if (p->dependencyFlag & (1UL << i))
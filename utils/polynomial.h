@@ -13,6 +13,22 @@
 #define __POLYNOMIAL_H__
 
 #include <stdio.h>
+#include <stdint.h>
+
+/* Multi-precision values live in the polynomials and SSD term lists get
+   swapped-out, so neither can be evaluated from a compiled tape. */
+#if defined (USE_GMP) || defined (USE_SSD)
+  #define NO_POLY_TAPE
+#endif
+
+/* Pedigrees' polynomials are only built concurrently with OpenMP, and not
+   when anything expects a single builder: term lists being swapped-out,
+   construction source tracking, statistics traversals during the build,
+   compiled DLs, or pedigrees being farmed-out to a study database. */
+#if !defined (_OPENMP) || defined (USE_SSD) || defined (SOURCEDIGRAPH) || defined (POLYSTATISTICS) || \
+  defined (POLYCODE_DL) || defined (POLYUSE_DL) || defined (POLYCHECK_DL) || defined (STUDYDB)
+  #define NO_POLY_CONCURRENT_BUILD
+#endif
 
 /* The following dynamically-maintained variables are for debugging. See
    their definition in polynomial.c for descriptions. */
@@ -68,6 +84,7 @@ enum expressionType
 typedef struct polynomial
 {
   unsigned char eType;		// polynomial type
+  unsigned int evalEpoch;	// traversal mark
   double value;			// the value of the polynomial
   unsigned int id;		// unique id - 4 bytes
 } Polynomial;
@@ -86,6 +103,8 @@ typedef struct polyList
   int listSize;			// size of the preallocated pList
   int listNext;			// next free position
   struct polynomial **pList;	// list of polynomials for evaluation
+  int serial;			// distinct for every sorting of every list
+  struct polyTape *tape;	// compiled form of pList, NULL if not built
 } polynomialList;
 
 #endif
@@ -129,6 +148,30 @@ void polyListSorting (Polynomial *p, struct polyList *l);
 //Evaluate a polynomial with the help of the evaluation list 
 void evaluatePoly (Polynomial *pp, struct polyList *l, double *pd);
 
+// Release an evaluation list and its compiled tape
+void freePolyList (struct polyList *l);
+
+// Merge the sorted lists of several polynomials into one level-scheduled tape
+struct polyTape *buildMergedPolyTape (int count, Polynomial **roots, struct polyList **lists);
+
+// Check that a merged tape was built from the lists as they are now
+int mergedPolyTapeIsCurrent (struct polyTape *t, int count, struct polyList **lists);
+
+// Evaluate all of the polynomials of a merged tape
+void evaluateMergedPolyTape (struct polyTape *t, double *returnValues);
+
+// Number of variable values per point for evaluateMergedPolyTapeBatch
+int mergedPolyTapeVariableCount (struct polyTape *t);
+
+// Record the current values of a merged tape's variables as one point for evaluateMergedPolyTapeBatch
+void captureMergedPolyTapeVariables (struct polyTape *t, double *row);
+
+// Evaluate all of the polynomials of a merged tape at many points, one row of variable values per point
+void evaluateMergedPolyTapeBatch (struct polyTape *t, int pointCount, double *variableValues, double *returnValues);
+
+// Release a merged tape
+void freeMergedPolyTape (struct polyTape *t);
+
 // Recursively print a polynomial with full expansion and no annotation.
 void expPrinting (Polynomial *p);
 
@@ -159,6 +202,10 @@ void freePolys ();
 // Deallocate all polynomials not held
 void freeKeptPolys ();
 
+// Let several threads construct polynomials at once, and stop again
+void beginConcurrentPolyBuild ();
+void endConcurrentPolyBuild ();
+
 // Flag all polynomials so they survive freePolys() & freeKeptPolys() calls
 void holdAllPolys ();
 
@@ -174,6 +221,10 @@ void printSummaryPoly (Polynomial *p);
 Polynomial *restoreExternalPoly (char * name);
 void codePoly (Polynomial * p, struct polyList * l, char * name);
 
+// Write a sorted polynomial to a cache file, and rebuild one from it in a later run
+int savePolyCache (Polynomial *p, struct polyList *l, char *fileName, uint64_t key);
+Polynomial *restorePolyCache (char *fileName, uint64_t key);
+
 #ifdef SOURCEDIGRAPH
 // Dump data for a Dot digraph of polynomial construction-to-use source lines
 void dumpSourceParenting ();
@@ -13,6 +13,7 @@
 #define __POLYNOMIAL_INTERNAL_H__
 
 #include <stdio.h>
+#include <stdint.h>
 #ifdef USE_GMP
 #include <gmp.h>                /* GNU Multi-Precision library. */
 #endif
@@ -65,6 +66,22 @@ struct variablePoly
 #endif
 };
 
+/* Terms of sums and products are referenced by 32-bit handles rather than
+   pointers. The top bits of a handle say which arena the polynomial came
+   from, and the rest which slab and slot within the slab (see
+   polyArenaAlloc). Exponents are likewise narrowed to 16 bits. Without
+   arenas, or under USE_SSD, which moves term lists about as blocks of
+   pointers, handles are just the pointers themselves. */
+#if defined (NO_POLY_ARENA) || defined (USE_SSD)
+  #define NO_POLY_HANDLES
+#endif
+#ifndef NO_POLY_HANDLES
+typedef unsigned int polyHandle;
+#else
+typedef struct polynomial *polyHandle;
+#endif
+typedef short polyExponent;
+
 /* This structure represents the elements of a sum. A sum is composed of a list
    of subpolynomial terms and their factors. */
 
@@ -72,10 +89,10 @@ struct sumPoly
 {
   int num;			// number of terms - 4 bytes
 #ifdef MIN_USE_SSD_DPS
-  int iMTLIndex;                // -1 if not in-memory, otherwise the index to the iMTL.
+  int iMTLIndex;                // -1 if allocated, -2 if cold on the SSD, otherwise the index to the iMTL.
 #endif
-  struct polynomial **sum;	// polynomial terms - 8 bytes
-  double *factor;		// factors for polynomial terms - 8 bytes
+  polyHandle *sum;		// polynomial terms, 4 bytes each - 8 byte pointer
+  double *factor;		// factors for polynomial terms, 8 bytes each - 8 byte pointer
 }; // 20(24) bytes
 
 /* This structure represents the elements of a product. A product is composed of a 
@@ -84,9 +101,9 @@ struct sumPoly
 struct productPoly
 {
   int num;			// number of terms - 4 bytes
-  struct polynomial **product;	// polynomial terms - 8 bytes
-  int *exponent;		// exponents for polynomial terms - 4 bytes
-}; // 16 bytes
+  polyHandle *product;		// polynomial terms, 4 bytes each - 8 byte pointer
+  polyExponent *exponent;	// exponents for polynomial terms, 2 bytes each - 8 byte pointer
+}; // 20(24) bytes
 
 /* This structure represents the elements of a function call. Each function call is 
    composed of the function name, and a list of parameters. */
@@ -122,6 +139,7 @@ struct externalPoly
 typedef struct polynomial
 {
   unsigned char eType;		// polynomial type:  - 1 byte
+  unsigned int evalEpoch;	// traversal mark, see EVAL_VALID - 4 bytes (in alignment padding)
   double value;			// the value of the polynomial - 8 bytes
   unsigned int id;		// unique id (from nodeId) - 4 bytes
   int index;			// index in a polynomial list - 4 bytes
@@ -146,15 +164,26 @@ typedef struct polynomial
   unsigned long dependencyFlag; // Flags up to 64 variable dependencies
 #endif
   //  unsigned char oldEType;
-} Polynomial; // 1 + 8 + 4 + 4 + 4 + 2 + 1 (+ 1) + 8 = 32 (33) bytes
+} Polynomial; // 1 + 4 + 8 + 4 + 4 + 4 + 2 + 1 (+ 1) + 8 = 36 (37) bytes, 40 with padding
 
 /* Bit masks for the polynomial valid flag. */
-#define VALID_EVAL_FLAG 1	// Used by tree traversal routines to limit to unique terms
+#define VALID_EVAL_FLAG 1	// Not stored, see POLY_FLAGS
 #define VALID_KEEP_FLAG 2	// Kept. Weaker than HOLD, only kept until a freeKeptPolys() call
 #define VALID_REF_FLAG 4	// Multiply-referenced
 #define VALID_TOP_FLAG 8        // Explicitly kept or held (top polynomial in call)
 #define VALID_NOTDISC_FLAG 16 // Not explicitly user-discarded (first-term discards)
 
+/* Tree traversal routines mark polynomials they've visited to limit
+   themselves to unique terms. Rather than setting a flag that has to be
+   cleared on every polynomial before the next traversal, they stamp the
+   polynomial with the current epoch, and clearValidEvalFlag just starts
+   a new one. POLY_FLAGS gives the valid flag with VALID_EVAL_FLAG as it
+   would have been. */
+extern unsigned int polyEvalEpoch;
+#define EVAL_VALID(p) ((p)->evalEpoch == polyEvalEpoch)
+#define SET_EVAL_VALID(p) ((p)->evalEpoch = polyEvalEpoch)
+#define POLY_FLAGS(p) ((p)->valid | (EVAL_VALID (p) ? VALID_EVAL_FLAG : 0))
+
 /* Track the full source code module name and line number of calls to create
    polynomials so that we only have to store an index (unsigned char) with 
    the polynomial itself to know it's origin. */
@@ -172,8 +201,72 @@ typedef struct polyList
   int listSize;			// size of the preallocated pList
   int listNext;			// next free position
   struct polynomial **pList;	// list of polynomials for evaluation
+  int serial;			// distinct for every sorting of every list
+  struct polyTape *tape;	// compiled form of pList, NULL if not built
 } polynomialList;
 
+/* Variable i of a tape as a dependency bit. There are only so many bits,
+   so the last stands for all variables from there on. */
+#define TAPE_VARIABLE_BIT(i) (UINT64_C (1) << ((i) < 63 ? (i) : 63))
+
+/* Operations of a compiled tape's entries. Each is the entry's eType
+   specialized for what is known when the tape is built, so that the
+   threaded-code interpreter doesn't decide the same things every time. */
+enum tapeOp
+{
+  TAPE_CONSTANT = 0,		// nothing to do
+  TAPE_VARIABLE_D,		// load a double variable
+  TAPE_VARIABLE_I,		// load an integer variable
+  TAPE_EXTERNAL,		// call a compiled DL
+  TAPE_SUM2,			// sum of two terms
+  TAPE_SUM,			// sum of too few terms for sumTermsKernel
+  TAPE_SUM_KERNEL,		// sum handed to sumTermsKernel
+  TAPE_PRODUCT2,		// product of two terms, both to the first power
+  TAPE_PRODUCT_LINEAR,		// product of terms all to the first power
+  TAPE_PRODUCT,			// product of too few terms for productTermsKernel
+  TAPE_PRODUCT_KERNEL,		// product handed to productTermsKernel
+  TAPE_FUNCTIONCALL,		// function call
+  TAPE_OPS
+};
+
+/* Fewest terms worth handing to a vector kernel, below which the call
+   costs more than it saves */
+#define MIN_SIMD_TERMS 8
+
+/* Compiled evaluation tape for a sorted polynomial list. Once sorted, the
+   pList is flattened into contiguous structure-of-arrays form so that an
+   evaluation walks a few dense arrays instead of chasing Polynomial nodes
+   and their separately-allocated term arrays all over the heap. Entry j of
+   the tape is pList[j]. The operands of entry j are operand[first[j]] thru
+   operand[first[j+1]-1], and each is an index into value[]. Constant terms,
+   which are not on the pList, get value[] slots after the last entry. */
+
+struct polyTape
+{
+  int nodeCount;		// number of entries, same as listNext
+  int slotCount;		// nodeCount plus constant term slots
+  int operandCount;		// total operands of all entries
+  int variableCount;		// number of T_VARIABLE entries
+  unsigned char *opCode;	// eType of each entry
+  unsigned char *code;		// tapeOp of each entry
+  int *first;			// index of first operand of each entry, nodeCount+1 long
+  int *operand;			// value[] index of each operand
+  double *factor;		// factor of each sum operand
+  int *exponent;		// exponent of each product operand
+  double *value;		// value of each slot, private to this list
+  struct polynomial **node;	// originating polynomial of each entry
+  int *variable;		// entry index of each variable, in list order
+  uint64_t *dependsOn;		// TAPE_VARIABLE_BITs of variables each entry depends upon
+  int incremental;		// TRUE if only entries affected by changed variables need evaluation
+  int evaluated;		// TRUE once value[] holds a full evaluation
+  int levelCount;		// number of dependency levels, merged tapes only
+  int *levelFirst;		// index of first entry of each level, levelCount+1 long
+  int wideLevelCount;		// number of levels of at least MIN_PARALLEL_LEVEL entries
+  int rootCount;		// number of polynomials merged
+  int *root;			// value[] slot of each merged polynomial
+  int *listSerial;		// serial of each merged polynomial's list when built
+};
+
 /* hashStruct is used for facilitating the identification of redundant polynomials,
    which is the key to efficient storage and evaluation. Identification of redundancy
    is a two-step process. First a type-specific hash is performed on the polynomial to
@@ -238,5 +331,8 @@ double polyMemory ();
 void dependencyFlagging (Polynomial * p);
 #endif
 void doFreePolys (unsigned short keepMask);
+void buildPolyTape (struct polyList *l);
+void freePolyTape (struct polyList *l);
+void selectPolyKernels ();
 
 #endif
@@ -3,14 +3,17 @@
 
  sSDHandler - manage storage on a Solid State Drive for polynomial term lists.
 
- We're out of memory, but have an SSD to help. Memory mapping a file
- on the SSD doesn't improve our situation because every page actually
- referenced has to be in physical memory. What we need is a "window"
- of fixed-memory size thru which we can access the full span of SSD
- space. That's normal file I/O, albeit with arbitrarily-sized chunks of
- data and an eye on efficient reuse. I searched and searched for a tool
- that would manage the space in the SSD efficiently and came up with
- nothing, so I wrote this.
+ We're out of memory, but have an SSD to help. The cache file on the
+ SSD is memory mapped shared, so every page referenced has to be in
+ physical memory only while it's being used -- the kernel can write
+ it back and drop it whenever it needs the memory, just like the rest
+ of the page cache. What we need beyond that is the management of
+ arbitrarily-sized chunks of the span of SSD space, with an eye on
+ efficient reuse. I searched and searched for a tool that would manage
+ the space in the SSD efficiently and came up with nothing, so I wrote
+ this. Callers can copy chunks in and out with putSSD and getSSD, or
+ use them in place with mapSSD, and tell us when they're done for a
+ while with coolSSD so their pages go first.
 
  Philosophy:
 
@@ -60,7 +63,7 @@
  operations in 9 minutes.
 
  Caching aside (because I leave that to the OS), there is a fixed irreducible cost of 1 write 
- for a putSSD, 1 read for a getSSD. Anything beyond that is overhead. This algorithm's overhead is:
+ for a putSSD, 1 read for a getSSD, or none at all for a mapSSD. Anything beyond that is overhead. This algorithm's overhead is:
 
  - nothing for putSSD calls utilizing free lists where the remainder of the list head entry still
  belongs on the same list, e.g. 33 bytes taken from a 102 byte head entry on list 6 (2^6 = 64)
@@ -121,6 +124,9 @@
 #endif
 
 #include <libgen.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #include "utils.h"
 #include "sSDHandler.h"
@@ -134,7 +140,12 @@ unsigned long maxSSDDPC;
 
 char messageBuffer[256];
 
-FILE *sSDFD;
+int sSDFD;
+char *sSDMap; // The entire cache file, mapped shared
+size_t sSDPageSize;
+
+// Address of an offset in double pairs in the mapped cache file
+#define SSD_ADDRESS(chunkOffset) (sSDMap + (chunkOffset) * DOUBLE_PAIR_SIZE)
 
 struct listEntry {
   unsigned long doublePairCount; /* Size in double pairs of this chunk, largest feasible is 
@@ -189,19 +200,22 @@ void statSSD () {
 
    Finish using the SSD.
 
-   Nothing fancy here. Just close the open file on the SSD.
+   Nothing fancy here. Just unmap and close the open file on the SSD.
 
   @par Global Inputs
 
   sSDFD - File descriptor for the open file on the SSD.
 
+  sSDMap - Where the file is mapped.
+
   @par Global Outputs
 
   @return void.
 
 */  
 void termSSD () {
-  fclose (sSDFD);
+  munmap (sSDMap, maxSSDDPC * DOUBLE_PAIR_SIZE);
+  close (sSDFD);
 }
 
 /**
@@ -209,7 +223,7 @@ void termSSD () {
    Prepare for using the SSD.
 
    Use environment variables to identify the name and size of the SSD file
-   to open. Open the file and initialize free list pointers.
+   to open. Open the file, size and map it, and initialize free list pointers.
 
   @par Global Inputs
 
@@ -223,7 +237,7 @@ void termSSD () {
 
   @par Global Outputs
 
-  The open file handle sSDFD.
+  The open file descriptor sSDFD, and sSDMap, where it's mapped.
 
   @return void.
 
@@ -263,10 +277,23 @@ void initSSD() {
   fprintf (stderr, "Using SSD located at %s of %luGb, or %ludps\n", 
 	   sSDFileName, sSDFileSizeInGb, maxSSDDPC);
 
-  if ((sSDFD = fopen(sSDFileName,"wb+")) == NULL) {
+  if ((sSDFD = open(sSDFileName, O_RDWR | O_CREAT | O_TRUNC, 0600)) == -1) {
     perror ("Failed to open SSD cache file");
     exit (EXIT_FAILURE);
   }
+  // Sparse, so only what we actually use takes space on the SSD
+  if (ftruncate (sSDFD, (off_t) (maxSSDDPC * DOUBLE_PAIR_SIZE)) != 0) {
+    perror ("Failed to size SSD cache file");
+    exit (EXIT_FAILURE);
+  }
+  if ((sSDMap = mmap (NULL, maxSSDDPC * DOUBLE_PAIR_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+		      sSDFD, 0)) == MAP_FAILED) {
+    perror ("Failed to map SSD cache file");
+    exit (EXIT_FAILURE);
+  }
+  // Term lists are visited whole, but which ones is anyone's guess
+  madvise (sSDMap, maxSSDDPC * DOUBLE_PAIR_SIZE, MADV_RANDOM);
+  sSDPageSize = sysconf (_SC_PAGESIZE);
   for (i=0; i<16; i++) {
     listHead[i].doublePairCount = listHead[i].chunkOffset = listDepth[i] = 0;
     listHead[i].nextFree = ULONG_MAX;
@@ -310,14 +337,7 @@ void removeFreeListHead (unsigned short freeList) {
   } else {
     // Pull-in the next entry and shlorp-up the listEntry space!
     listDepth[freeList]--;
-    if (fseek (sSDFD, listHead[freeList].nextFree * DOUBLE_PAIR_SIZE, SEEK_SET) != 0) {
-      perror ("Failed to seek in SSD cache file");
-      exit (EXIT_FAILURE);
-    }
-    if ((fread (&listHead[freeList], sizeof (struct listEntry), 1, sSDFD)) != 1) {
-      perror ("Failed to read SSD cache file");
-      exit (EXIT_FAILURE);
-    }
+    memcpy (&listHead[freeList], SSD_ADDRESS (listHead[freeList].nextFree), sizeof (struct listEntry));
     listHead[freeList].chunkOffset--;
     listHead[freeList].doublePairCount++;
 #ifdef DEBUG
@@ -382,17 +402,10 @@ void insertFreeListHead (unsigned long chunkOffset, unsigned long doublePairCoun
   
   listDepth[freeList]++;
   
-  if (fseek (sSDFD, listHead[freeList].chunkOffset * DOUBLE_PAIR_SIZE, SEEK_SET) != 0) {
-    sprintf (messageBuffer, "Failed to seek to %ludps in SSD cache file", listHead[freeList].chunkOffset);
-    perror (messageBuffer);
-    exit (EXIT_FAILURE);
-  }
+  unsigned long entryOffset = listHead[freeList].chunkOffset;
   listHead[freeList].chunkOffset++;
   listHead[freeList].doublePairCount--;
-  if ((fwrite (&listHead[freeList], sizeof (struct listEntry), 1, sSDFD)) != 1) {
-    perror ("Failed to write SSD cache file");
-    exit (EXIT_FAILURE);
-  }
+  memcpy (SSD_ADDRESS (entryOffset), &listHead[freeList], sizeof (struct listEntry));
   listHead[freeList].nextFree = listHead[freeList].chunkOffset - 1UL;
   listHead[freeList].chunkOffset = chunkOffset;
   listHead[freeList].doublePairCount = doublePairCount;
@@ -669,18 +682,7 @@ void flushSSD (double *buffer, unsigned long chunkOffset, unsigned long doublePa
     statSSD ();
 
   // Chunk in SSD file is assigned, put the buffer out there...
-  if (fseek (sSDFD, chunkOffset * DOUBLE_PAIR_SIZE, SEEK_SET) != 0) {
-    sprintf (messageBuffer, "Failed to seek to offset co%lu in SSD cache file",
-	     chunkOffset);
-    perror (messageBuffer);
-    exit (EXIT_FAILURE);
-  }
-  if ((fwrite (buffer, DOUBLE_PAIR_SIZE, doublePairCount, sSDFD)) != doublePairCount) {
-    sprintf (messageBuffer, "Failed to write %ludps at offset co%lu in SSD cache file",
-	     doublePairCount, chunkOffset);
-    perror (messageBuffer);
-    exit (EXIT_FAILURE);
-  }
+  memcpy (SSD_ADDRESS (chunkOffset), buffer, doublePairCount * DOUBLE_PAIR_SIZE);
 }
 
 /*
@@ -723,7 +725,8 @@ struct chunkTicket *doPutSSD (double *buffer, unsigned long myDPC, unsigned shor
     // This list head goes away completely due to no real leftovers
     removeFreeListHead (freeList);
   }
-  flushSSD (buffer, newCT->chunkOffset, newCT->doublePairCount);
+  if (buffer != NULL)
+    flushSSD (buffer, newCT->chunkOffset, newCT->doublePairCount);
   usedDPCs += newCT->doublePairCount;
   handledDPCs += newCT->doublePairCount;
   return newCT;
@@ -737,7 +740,8 @@ struct chunkTicket *doPutSSD (double *buffer, unsigned long myDPC, unsigned shor
    Accepts a pointer to a contiguous chunk of double-aligned memory
    up to maxSSDDPC*16 bytes long for storage on the SSD. Returns a
    pointer to a chunkTicket that can be passed to getSSD to retrieve
-   that chunk of memory.
+   that chunk of memory. If the pointer is NULL, the chunk is only
+   reserved, to be filled in place thru mapSSD.
 
    @par Global Inputs
 
@@ -752,7 +756,7 @@ struct chunkTicket *doPutSSD (double *buffer, unsigned long myDPC, unsigned shor
 
 */
 struct chunkTicket *putSSD (
-			    double *buffer, ///< Pointer to double-aligned buffer of data to be stored
+			    double *buffer, ///< Pointer to double-aligned buffer of data to be stored, or NULL
 			    unsigned long myDPC ///< Count of double pairs to be stored (X 16 = bytes)
 			    ) {
   unsigned short freeList;
@@ -840,20 +844,87 @@ void getSSD (
 #ifdef DEBUG
   fprintf (stderr, "getSSD for %ludps at co%lu\n", myTicket->doublePairCount, myTicket->chunkOffset);
 #endif
-  // Simply seek and read...
-  if (fseek (sSDFD, myTicket->chunkOffset * DOUBLE_PAIR_SIZE, SEEK_SET) != 0) {
-    sprintf (messageBuffer, "Failed to seek to %ludps in SSD cache file", myTicket->chunkOffset);
-    perror (messageBuffer);
-    exit (EXIT_FAILURE);
-  }
-  if ((fread (buffer, DOUBLE_PAIR_SIZE, myTicket->doublePairCount, sSDFD)) != myTicket->doublePairCount) {
-    perror ("Failed to read SSD cache file");
-    exit (EXIT_FAILURE);
-  }
+  // Simply copy...
+  memcpy (buffer, SSD_ADDRESS (myTicket->chunkOffset), myTicket->doublePairCount * DOUBLE_PAIR_SIZE);
   handledDPCs += myTicket->doublePairCount;
   return;
 }
 
+/**
+
+  Present your chunkTicket to use a chunk of data in place.
+
+  Accepts a pointer to a chunkTicket issued by putSSD, and returns the
+  address of its chunk in the mapped cache file. Whatever is written
+  there is what later getSSD and mapSSD calls will find. The address
+  is good until the chunk is released by freeSSD. The kernel is asked
+  to start reading the chunk in, since it's about to be used.
+
+  @return The address of the chunk.
+
+*/
+double *mapSSD (
+		struct chunkTicket *myTicket ///< A pointer to a chunk ticket issued by putSSD
+		) {
+  getCallCount++;
+  if ((getCallCount & 0x3FFFF) == 0x3FFFF)
+    statSSD ();
+  prefetchSSD (myTicket);
+  handledDPCs += myTicket->doublePairCount;
+  return (double *) SSD_ADDRESS (myTicket->chunkOffset);
+}
+
+/**
+
+  Let the kernel know that a chunk will be wanted soon.
+
+  Accepts a pointer to a chunkTicket issued by putSSD, and starts
+  reading in whatever of its chunk isn't in physical memory already.
+  Doesn't wait for the reads, so a later mapSSD can find the chunk
+  there instead of faulting it in a page at a time.
+
+  @return void.
+
+*/
+void prefetchSSD (
+		  struct chunkTicket *myTicket ///< A pointer to a chunk ticket issued by putSSD
+		  ) {
+  char *start = SSD_ADDRESS (myTicket->chunkOffset);
+  char *pageStart = (char *) ((unsigned long) start & ~(sSDPageSize - 1));
+
+  madvise (pageStart, start - pageStart + myTicket->doublePairCount * DOUBLE_PAIR_SIZE, MADV_WILLNEED);
+}
+
+/**
+
+  Let the pages of a chunk go before anything else's.
+
+  Accepts a pointer to a chunkTicket issued by putSSD whose chunk won't
+  be used for a while. Pages that lie entirely within the chunk are
+  given up (written back first if need be), so they're the first to
+  leave physical memory. The data is still there for the next getSSD
+  or mapSSD.
+
+  @return void.
+
+*/
+void coolSSD (
+	      struct chunkTicket *myTicket ///< A pointer to a chunk ticket issued by putSSD
+	      ) {
+  unsigned long start = (unsigned long) SSD_ADDRESS (myTicket->chunkOffset);
+  unsigned long end = start + myTicket->doublePairCount * DOUBLE_PAIR_SIZE;
+
+  // Neighbouring chunks' pages are theirs to cool
+  start = (start + sSDPageSize - 1) & ~(sSDPageSize - 1);
+  end &= ~(sSDPageSize - 1);
+  if (end > start)
+#ifdef MADV_COLD
+    madvise ((void *) start, end - start, MADV_COLD);
+#else
+    madvise ((void *) start, end - start, MADV_DONTNEED);
+#endif
+}
+
 /**
 
   Release the resources associated with the chunkTicket, make it invalid.
@@ -949,7 +1020,7 @@ int main (int argc, char *argv[]) {
 	  fprintf (stderr, "At %dth position, wrote %g/%g at offset %ludps, got %g/%lu!\n",
 		  j, (double) cT, (double) -cT, listOTickets[cT]->chunkOffset,
 		  buffer[j], dPC+j);
-	  fclose (sSDFD);
+	  termSSD ();
 	  exit (EXIT_FAILURE);
 	}
       }
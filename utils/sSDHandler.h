@@ -36,6 +36,9 @@ struct chunkTicket {
 void initSSD ();
 struct chunkTicket *putSSD (double *buffer, unsigned long myDPC);
 void getSSD (struct chunkTicket *myTicket, double *buffer);
+double *mapSSD (struct chunkTicket *myTicket);
+void prefetchSSD (struct chunkTicket *myTicket);
+void coolSSD (struct chunkTicket *myTicket);
 void freeSSD (struct chunkTicket *myTicket);
 void statSSD ();
 void termSSD ();
@@ -1123,13 +1123,12 @@ char *formatElapsedTime (unsigned int t, char *buffer)
   return buffer;
 }
 
-void 
-swLogProgress(int level, float percentDone, char *format, ...) {
+static void
+logProgress(int level, float percentDone, char *format, va_list argp) {
   int length;
   char tabs[MAXPROGRESSLEVELS];
   char *pMessage = progressLevels[level].text;
   char timeBuffer[32];
-  va_list argp;
 
   /* This may look wrong, but we really do want to suppress any
      old lower-level messages if our new one is a higher level,
@@ -1155,9 +1154,7 @@ swLogProgress(int level, float percentDone, char *format, ...) {
     pMessage += length = snprintf (progressLevels[level].text, MAXLOGMSG, "%s@%s, ",
 				   tabs, formatElapsedTime ((int) progressLevels[level].eventTime, timeBuffer));
   
-  va_start (argp, format);
   vsnprintf (pMessage, MAXLOGMSG - length, format, argp);
-  va_end (argp);
 
   /* If we're not dumping everything the moment it happens, then
      skip any output */
@@ -1171,6 +1168,20 @@ swLogProgress(int level, float percentDone, char *format, ...) {
 
 }
 
+/* Progress can be logged by concurrent polynomial builds, which mustn't
+   write over each other's messages. */
+void 
+swLogProgress(int level, float percentDone, char *format, ...) {
+  va_list argp;
+
+  va_start (argp, format);
+#ifdef _OPENMP
+#pragma omp critical (swLogProgress)
+#endif
+  logProgress (level, percentDone, format, argp);
+  va_end (argp);
+}
+
 /// Global flag to indicate that a progress advisory has been requested.
 volatile sig_atomic_t swProgressRequestFlag = FALSE;
 